@@ -0,0 +1,73 @@
+'use strict';
+const common = require('../common.js');
+const { AsyncLocalStorage } = require('async_hooks');
+
+// Measures the cost of propagating AsyncLocalStorage stores through promises
+// and timers. Run it once as is and once with
+// NODE_BENCHMARK_FLAGS=--experimental-async-context-frame to compare the
+// async_hooks based implementation with the AsyncContextFrame based one.
+const bench = common.createBenchmark(main, {
+  n: [1e5],
+  type: ['await', 'then', 'immediate', 'nextTick'],
+  storages: [0, 1, 10],
+});
+
+const tasks = {
+  async await(n, check) {
+    for (let i = 0; i < n; i++) {
+      await null;
+      check();
+    }
+  },
+  async then(n, check) {
+    let p = Promise.resolve();
+    for (let i = 0; i < n; i++)
+      p = p.then(check);
+    return p;
+  },
+  immediate(n, check) {
+    return new Promise((resolve) => {
+      let i = 0;
+      (function next() {
+        check();
+        if (++i === n)
+          return resolve();
+        setImmediate(next);
+      })();
+    });
+  },
+  nextTick(n, check) {
+    return new Promise((resolve) => {
+      let i = 0;
+      (function next() {
+        check();
+        if (++i === n)
+          return resolve();
+        process.nextTick(next);
+      })();
+    });
+  },
+};
+
+function main({ n, type, storages }) {
+  const als = [];
+  for (let i = 0; i < storages; i++)
+    als.push(new AsyncLocalStorage());
+
+  function check() {
+    for (let i = 0; i < als.length; i++) {
+      if (als[i].getStore() !== i)
+        throw new Error('Lost the store');
+    }
+  }
+
+  function run(i) {
+    if (i === als.length) {
+      bench.start();
+      tasks[type](n, check).then(() => bench.end(n));
+      return;
+    }
+    als[i].run(i, run, i + 1);
+  }
+  run(0);
+}
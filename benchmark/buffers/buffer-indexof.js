@@ -15,12 +15,13 @@ const searchStrings = [
   'aaaaaaaaaaaaaaaaa',
   'venture to go near the house till she had brought herself down to',
   '</i> to the Caterpillar',
+  '\r\n--boundary',
 ];
 
 const bench = common.createBenchmark(main, {
   search: searchStrings,
   encoding: ['utf8', 'ucs2'],
-  type: ['buffer', 'string'],
+  type: ['buffer', 'string', 'any', 'list'],
   n: [5e4]
 });
 
@@ -41,6 +42,30 @@ function main({ n, search, encoding, type }) {
     search = Buffer.from(Buffer.from(search).toString(), encoding);
   }
 
+  if (type === 'any') {
+    // Search for the value and for something that does not occur.
+    const values = [search, '\r\n\r\n--'];
+    bench.start();
+    for (let i = 0; i < n; i++) {
+      aliceBuffer.indexOfAny(values, 0, encoding);
+    }
+    bench.end(n);
+    return;
+  }
+
+  if (type === 'list') {
+    // Search the buffer as it would arrive in chunks from a stream.
+    const chunks = [];
+    for (let i = 0; i < aliceBuffer.length; i += 16 * 1024)
+      chunks.push(aliceBuffer.slice(i, i + 16 * 1024));
+    bench.start();
+    for (let i = 0; i < n; i++) {
+      Buffer.indexOfList(chunks, search, 0, encoding);
+    }
+    bench.end(n);
+    return;
+  }
+
   bench.start();
   for (let i = 0; i < n; i++) {
     aliceBuffer.indexOf(search, 0, encoding);
@@ -0,0 +1,33 @@
+// Measure execSync() calls that capture megabytes of output each, which is
+// dominated by how the output is collected and handed to JS.
+'use strict';
+const common = require('../common.js');
+const { execSync } = require('child_process');
+
+const bench = common.createBenchmark(main, {
+  mb: [1, 16],
+  lines: ['false', 'true'],
+  n: [20]
+}, {
+  test: { n: 1 }
+});
+
+function main({ n, mb, lines }) {
+  const size = mb * 1024 * 1024;
+  // Lines of 64 bytes, including the newline.
+  const script = `process.stdout.write('${'x'.repeat(63)}\\n'.repeat(${size / 64}))`;
+  const cmd = `"${process.execPath}" -e "${script}"`;
+  const options = { maxBuffer: Infinity };
+  let count = 0;
+  if (lines === 'true')
+    options.onLine = () => count++;
+
+  bench.start();
+  for (let i = 0; i < n; i++) {
+    const output = execSync(cmd, options);
+    if (output.length !== size)
+      throw new Error(`Unexpected output length ${output.length}`);
+  }
+  // Bytes per second.
+  bench.end(n * size);
+}
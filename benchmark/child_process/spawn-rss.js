@@ -0,0 +1,32 @@
+// Measure how long it takes to create a child process depending on the
+// memory used by the parent process, with and without `fastSpawn`.
+'use strict';
+const common = require('../common.js');
+const { spawnSync } = require('child_process');
+
+const bench = common.createBenchmark(main, {
+  rss: [0, 512, 2048],
+  fastSpawn: ['false', 'true'],
+  n: [100]
+}, {
+  test: { rss: 0, n: 1 }
+});
+
+function main({ n, rss, fastSpawn }) {
+  // Touch every page, so that they are actually mapped.
+  const memory = [];
+  for (let i = 0; i < rss; i++)
+    memory.push(Buffer.alloc(1024 * 1024, 1));
+
+  const options = { fastSpawn: fastSpawn === 'true', stdio: 'ignore' };
+  bench.start();
+  for (let i = 0; i < n; i++) {
+    const { status } = spawnSync('echo', ['hello'], options);
+    if (status !== 0)
+      throw new Error(`Unexpected exit status ${status}`);
+  }
+  bench.end(n);
+  // Keep the memory alive until the end.
+  if (memory.length !== rss)
+    throw new Error('Unreachable');
+}
@@ -0,0 +1,68 @@
+// Test UDP send/recv throughput with and without batching
+'use strict';
+
+const common = require('../common.js');
+const dgram = require('dgram');
+const PORT = common.PORT;
+
+// `num` is the number of datagrams to send each time.
+// Keep it reasonably high (>10) otherwise you're benchmarking the speed of
+// event loop cycles more than anything else.
+const bench = common.createBenchmark(main, {
+  len: [64, 512],
+  num: [100],
+  batch: ['true', 'false'],
+  type: ['send', 'recv'],
+  dur: [5]
+});
+
+function main({ dur, len, num, type, batch }) {
+  batch = batch === 'true';
+  const chunk = Buffer.allocUnsafe(len);
+  const list = new Array(num).fill(chunk);
+  let sent = 0;
+  let received = 0;
+  const socket = dgram.createSocket({ type: 'udp4', recvBatch: batch });
+
+  function onsend() {
+    if (sent++ % num === 0) {
+      // The setImmediate() is necessary to have event loop progress on OSes
+      // that only perform synchronous I/O on nonblocking UDP sockets.
+      setImmediate(() => {
+        if (batch) {
+          // Count every datagram of the batch as sent.
+          sent += num - 1;
+          socket.sendBatch(list, PORT, '127.0.0.1', onsend);
+          return;
+        }
+        for (let i = 0; i < num; i++) {
+          socket.send(chunk, PORT, '127.0.0.1', onsend);
+        }
+      });
+    }
+  }
+
+  socket.on('listening', () => {
+    bench.start();
+    onsend();
+
+    setTimeout(() => {
+      const bytes = (type === 'send' ? sent : received) * chunk.length;
+      const gbits = (bytes * 8) / (1024 * 1024 * 1024);
+      bench.end(gbits);
+      process.exit(0);
+    }, dur * 1000);
+  });
+
+  if (batch) {
+    socket.on('messages', ({ count }) => {
+      received += count;
+    });
+  } else {
+    socket.on('message', () => {
+      received++;
+    });
+  }
+
+  socket.bind(PORT);
+}
@@ -0,0 +1,56 @@
+'use strict';
+
+// Measures the overhead of recording trace events from several threads at
+// once. `n` is the total number of events, split evenly between the threads.
+const common = require('../common.js');
+const { Worker } = require('worker_threads');
+
+const bench = common.createBenchmark(main, {
+  n: [10e6],
+  threads: [1, 8],
+}, {
+  flags: [
+    '--expose-internals',
+    '--no-warnings',
+    '--trace-event-categories', 'foo',
+    '--trace-event-file-pattern', '/dev/null',
+  ]
+});
+
+const source = `
+const { parentPort, workerData } = require('worker_threads');
+const { internalBinding } = require('internal/test/binding');
+const { trace } = internalBinding('trace_events');
+const {
+  TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN: kBeforeEvent
+} = internalBinding('constants').trace;
+parentPort.once('message', () => {
+  for (let i = 0; i < workerData; i++)
+    trace(kBeforeEvent, 'foo', 'test', i, 'test');
+  parentPort.postMessage('done');
+});
+parentPort.postMessage('ready');
+`;
+
+function main({ n, threads }) {
+  const perThread = Math.floor(n / threads);
+  const workers = [];
+  let ready = 0;
+  let done = 0;
+
+  for (let i = 0; i < threads; i++) {
+    const worker = new Worker(source, { eval: true, workerData: perThread });
+    worker.on('message', (message) => {
+      if (message === 'ready' && ++ready === threads) {
+        bench.start();
+        for (const w of workers)
+          w.postMessage('start');
+      } else if (message === 'done' && ++done === threads) {
+        bench.end(perThread * threads);
+        for (const w of workers)
+          w.terminate();
+      }
+    });
+    workers.push(worker);
+  }
+}
@@ -0,0 +1,55 @@
+// Measure the throughput of many sockets that each receive small chunks of
+// data, which is dominated by the cost of allocating read buffers.
+'use strict';
+
+const common = require('../common.js');
+const net = require('net');
+const PORT = common.PORT;
+
+const bench = common.createBenchmark(main, {
+  conns: [100, 1000],
+  len: [64, 1024],
+  dur: [5],
+}, {
+  test: { conns: 10 }
+});
+
+function main({ dur, len, conns }) {
+  const chunk = Buffer.alloc(len, 'x');
+  const sockets = [];
+  let received = 0;
+  let running = true;
+
+  function writeAll() {
+    if (!running)
+      return;
+    for (const socket of sockets)
+      socket.write(chunk);
+    setImmediate(writeAll);
+  }
+
+  const server = net.createServer((socket) => {
+    sockets.push(socket);
+    if (sockets.length === conns) {
+      const rss = process.memoryUsage.rss();
+      bench.start();
+      writeAll();
+      setTimeout(() => {
+        running = false;
+        // Reads per second. The growth of the RSS is reported on stderr to
+        // make it possible to compare memory churn as well.
+        bench.end(received);
+        process.stderr.write(
+          `rss growth: ${(process.memoryUsage.rss() - rss) / 1024} KiB\n`);
+        process.exit(0);
+      }, dur * 1000);
+    }
+  });
+
+  server.listen(PORT, () => {
+    for (let i = 0; i < conns; i++) {
+      const socket = net.connect(PORT);
+      socket.on('data', () => received++);
+    }
+  });
+}
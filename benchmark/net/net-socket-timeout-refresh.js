@@ -0,0 +1,55 @@
+// Measure the read throughput of many sockets that all have an idle timeout,
+// which has to be refreshed for every read.
+'use strict';
+
+const common = require('../common.js');
+const net = require('net');
+const PORT = common.PORT;
+
+const bench = common.createBenchmark(main, {
+  conns: [100, 1000],
+  timeout: [0, 60000],
+  dur: [5],
+}, {
+  test: { conns: 10 }
+});
+
+function main({ dur, timeout, conns }) {
+  const chunk = Buffer.alloc(16, 'x');
+  const sockets = [];
+  let received = 0;
+  let running = true;
+
+  function writeAll() {
+    if (!running)
+      return;
+    for (const socket of sockets)
+      socket.write(chunk);
+    setImmediate(writeAll);
+  }
+
+  const server = net.createServer((socket) => {
+    sockets.push(socket);
+    if (sockets.length === conns) {
+      bench.start();
+      writeAll();
+      setTimeout(() => {
+        running = false;
+        // Reads per second.
+        bench.end(received);
+        process.exit(0);
+      }, dur * 1000);
+    }
+  });
+
+  server.listen(PORT, () => {
+    for (let i = 0; i < conns; i++) {
+      const socket = net.connect(PORT, () => {
+        socket.setTimeout(timeout, () => {
+          throw new Error('timeout');
+        });
+      });
+      socket.on('data', () => received++);
+    }
+  });
+}
@@ -0,0 +1,108 @@
+// Measure the per-task overhead of running very short tasks on a
+// WorkerPool, compared to a pool that is built by hand on top of Workers
+// with one postMessage() round trip per task.
+'use strict';
+
+const common = require('../common.js');
+const {
+  isMainThread,
+  parentPort,
+  workerData,
+  Worker,
+  WorkerPool,
+} = require('worker_threads');
+
+// A task that takes about a microsecond.
+function task(n) {
+  let x = 0;
+  for (let i = 0; i < 500; i++)
+    x = (x + i * n) | 0;
+  return x;
+}
+
+function createPool(size) {
+  const pool = new WorkerPool(__filename, { size });
+  return {
+    run: (value) => pool.run(value),
+    close: () => pool.close(),
+  };
+}
+
+function createMessagePool(size) {
+  const workers = [];
+  const idle = [];
+  const queue = [];
+  let queueHead = 0;
+  const pending = new Map();
+  let nextId = 0;
+
+  function onMessage(worker, { id, result }) {
+    pending.get(id)(result);
+    pending.delete(id);
+    if (queueHead < queue.length) {
+      worker.postMessage(queue[queueHead++]);
+    } else {
+      idle.push(worker);
+    }
+  }
+
+  for (let i = 0; i < size; i++) {
+    const worker = new Worker(__filename, { workerData: 'postmessage' });
+    worker.on('message', (message) => onMessage(worker, message));
+    workers.push(worker);
+    idle.push(worker);
+  }
+
+  return {
+    run(value) {
+      return new Promise((resolve) => {
+        const id = nextId++;
+        pending.set(id, resolve);
+        const worker = idle.pop();
+        if (worker !== undefined)
+          worker.postMessage({ id, value });
+        else
+          queue.push({ id, value });
+      });
+    },
+    close: () => Promise.all(workers.map((worker) => worker.terminate())),
+  };
+}
+
+if (!isMainThread) {
+  if (workerData === 'postmessage') {
+    parentPort.on('message', ({ id, value }) => {
+      parentPort.postMessage({ id, result: task(value) });
+    });
+  } else {
+    module.exports = task;
+  }
+} else {
+  const bench = common.createBenchmark(main, {
+    style: ['pool', 'postmessage'],
+    workers: [1, 4],
+    n: [1e5],
+  }, {
+    test: { n: 100 }
+  });
+
+  async function main({ style, workers, n }) {
+    const pool = style === 'pool' ?
+      createPool(workers) : createMessagePool(workers);
+    const runAll = (count) => {
+      const tasks = [];
+      for (let i = 0; i < count; i++)
+        tasks.push(pool.run(i));
+      return Promise.all(tasks);
+    };
+
+    // Make sure that all workers are up before measuring.
+    await runAll(workers * 10);
+
+    bench.start();
+    await runAll(n);
+    // Tasks per second.
+    bench.end(n);
+    await pool.close();
+  }
+}
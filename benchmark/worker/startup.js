@@ -0,0 +1,37 @@
+'use strict';
+
+// Measures the latency from spawning a pool of workers to receiving the
+// first message from each of them. Run with --no-node-snapshot to compare
+// against workers that do not deserialize from the embedded snapshot.
+const common = require('../common.js');
+const { Worker } = require('worker_threads');
+
+const bench = common.createBenchmark(main, {
+  workers: [1, 8, 32],
+  n: [10]
+});
+
+const source = 'require("worker_threads").parentPort.postMessage("ready")';
+
+function main({ n, workers }) {
+  let spawned = 0;
+
+  bench.start();
+  spawnPool();
+
+  function spawnPool() {
+    if (spawned++ === n) {
+      bench.end(n * workers);
+      return;
+    }
+    let ready = 0;
+    for (let i = 0; i < workers; ++i) {
+      const worker = new Worker(source, { eval: true });
+      worker.once('message', () => {
+        worker.terminate();
+        if (++ready === workers)
+          spawnPool();
+      });
+    }
+  }
+}
@@ -0,0 +1,81 @@
+/**
+ * hdr_atomic.h
+ * Written by Philip Orwig and released to the public domain,
+ * as explained at http://creativecommons.org/publicdomain/zero/1.0/
+ */
+
+#ifndef HDR_ATOMIC_H__
+#define HDR_ATOMIC_H__
+
+
+#if defined(_MSC_VER) && !(defined(__clang__) && (defined(_M_ARM) || defined(_M_ARM64)))
+
+#include <stdint.h>
+#include <intrin.h>
+#include <stdbool.h>
+
+static int64_t __inline hdr_atomic_load_64(int64_t* field)
+{
+    _ReadBarrier();
+    return *field;
+}
+
+static void __inline hdr_atomic_store_64(int64_t* field, int64_t value)
+{
+    _WriteBarrier();
+    *field = value;
+}
+
+static bool __inline hdr_atomic_compare_exchange_64(volatile int64_t* field, int64_t* expected, int64_t desired)
+{
+    return *expected == _InterlockedCompareExchange64(field, desired, *expected);
+}
+
+static int64_t __inline hdr_atomic_add_fetch_64(volatile int64_t* field, int64_t value)
+{
+#if defined(_WIN64)
+    return _InterlockedExchangeAdd64(field, value) + value;
+#else
+    int64_t comparand;
+    int64_t initial_value;
+    do
+    {
+        comparand = *field;
+        initial_value = _InterlockedCompareExchange64(field, comparand + value, comparand);
+    }
+    while (comparand != initial_value);
+
+    return initial_value + value;
+#endif
+}
+
+#else
+
+#include <stdint.h>
+#include <stdbool.h>
+
+static inline int64_t hdr_atomic_load_64(int64_t* field)
+{
+    int64_t i;
+    __atomic_load(field, &i, __ATOMIC_ACQUIRE);
+    return i;
+}
+
+static inline void hdr_atomic_store_64(int64_t* field, int64_t value)
+{
+    __atomic_store_n(field, value, __ATOMIC_RELEASE);
+}
+
+static inline bool hdr_atomic_compare_exchange_64(volatile int64_t* field, int64_t* expected, int64_t desired)
+{
+    return __atomic_compare_exchange_n(field, expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static inline int64_t hdr_atomic_add_fetch_64(volatile int64_t* field, int64_t value)
+{
+    return __atomic_add_fetch(field, value, __ATOMIC_SEQ_CST);
+}
+
+#endif
+
+#endif /* HDR_ATOMIC_H__ */
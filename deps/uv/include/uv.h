@@ -1048,7 +1048,15 @@ enum uv_process_flags {
    * option is only meaningful on Windows systems. On Unix it is silently
    * ignored.
    */
-  UV_PROCESS_WINDOWS_HIDE_GUI = (1 << 6)
+  UV_PROCESS_WINDOWS_HIDE_GUI = (1 << 6),
+  /*
+   * Create the child process with vfork() rather than fork(), which does not
+   * copy the page tables of the parent process and is much faster when the
+   * parent uses a lot of memory. Only implemented on Linux; it is silently
+   * ignored on other platforms and when UV_PROCESS_SETUID or
+   * UV_PROCESS_SETGID is set.
+   */
+  UV_PROCESS_VFORK = (1 << 7)
 };
 
 /*
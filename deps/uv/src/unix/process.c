@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -197,15 +198,109 @@ static void uv__write_int(int fd, int val) {
 }
 
 
+#if defined(__linux__)
+/* Returns the search path for the executable: the PATH of `env` or, if `env`
+ * is NULL, of the parent process.
+ */
+static const char* uv__spawn_search_path(char** env) {
+  const char* path;
+
+  path = NULL;
+  if (env == NULL)
+    path = getenv("PATH");
+  else
+    for (; *env != NULL; env++)
+      if (strncmp(*env, "PATH=", 5) == 0)
+        path = *env + 5;
+
+  /* Same default as execvp(). */
+  if (path == NULL)
+    path = "/bin:/usr/bin";
+
+  return path;
+}
+
+
+/* Looks up `file` in `path` like execvp() does and executes it with `envp` as
+ * its environment. Unlike execvp(), this neither modifies `environ` nor
+ * allocates memory, so that it can be used in a child created with vfork():
+ * `buf` must have room for `path` and `file` and two more bytes. Unlike
+ * execvp(), files without a valid executable format are not run with
+ * /bin/sh. Only returns on error.
+ */
+static void uv__execvpe(const char* file,
+                        char* const* argv,
+                        char* const* envp,
+                        const char* path,
+                        char* buf) {
+  const char* dir;
+  const char* end;
+  size_t dir_len;
+  size_t file_len;
+  int saw_eacces;
+
+  if (strchr(file, '/') != NULL) {
+    execve(file, argv, envp);
+    return;
+  }
+
+  file_len = strlen(file);
+  saw_eacces = 0;
+  for (dir = path;; dir = end + 1) {
+    end = strchr(dir, ':');
+    if (end == NULL)
+      end = dir + strlen(dir);
+
+    /* An empty entry stands for the current directory. */
+    dir_len = end - dir;
+    if (dir_len > 0) {
+      memcpy(buf, dir, dir_len);
+      buf[dir_len++] = '/';
+    }
+    memcpy(buf + dir_len, file, file_len + 1);
+
+    execve(buf, argv, envp);
+    switch (errno) {
+      case EACCES:
+        saw_eacces = 1;
+        break;
+      case ENOENT:
+      case ENOTDIR:
+      case ELOOP:
+      case ENAMETOOLONG:
+      case ESTALE:
+      case ENODEV:
+      case ETIMEDOUT:
+        break;
+      default:
+        return;
+    }
+
+    if (*end == '\0')
+      break;
+  }
+
+  if (saw_eacces)
+    errno = EACCES;
+}
+#endif
+
+
 #if !(defined(__APPLE__) && (TARGET_OS_TV || TARGET_OS_WATCH))
 /* execvp is marked __WATCHOS_PROHIBITED __TVOS_PROHIBITED, so must be
  * avoided. Since this isn't called on those targets, the function
  * doesn't even need to be defined for them.
+ *
+ * When `exec_buf` is not NULL, the child has been created with vfork() and
+ * shares the memory of the parent: it must not change anything the parent
+ * relies on, and it looks up the executable in `exec_path` with uv__execvpe().
  */
 static void uv__process_child_init(const uv_process_options_t* options,
                                    int stdio_count,
                                    int (*pipes)[2],
-                                   int error_fd) {
+                                   int error_fd,
+                                   const char* exec_path,
+                                   char* exec_buf) {
   sigset_t set;
   int close_fd;
   int use_fd;
@@ -302,7 +397,7 @@ static void uv__process_child_init(const uv_process_options_t* options,
     _exit(127);
   }
 
-  if (options->env != NULL) {
+  if (options->env != NULL && exec_buf == NULL) {
     environ = options->env;
   }
 
@@ -336,7 +431,16 @@ static void uv__process_child_init(const uv_process_options_t* options,
     _exit(127);
   }
 
-  execvp(options->file, options->args);
+#if defined(__linux__)
+  if (exec_buf != NULL)
+    uv__execvpe(options->file,
+                options->args,
+                options->env != NULL ? options->env : environ,
+                exec_path,
+                exec_buf);
+  else
+#endif
+    execvp(options->file, options->args);
   uv__write_int(error_fd, UV__ERR(errno));
   _exit(127);
 }
@@ -353,6 +457,14 @@ int uv_spawn(uv_loop_t* loop,
   int signal_pipe[2] = { -1, -1 };
   int pipes_storage[8][2];
   int (*pipes)[2];
+  int (*child_pipes)[2];
+  const char* exec_path;
+  char* exec_buf;
+  int use_vfork;
+#if defined(__linux__)
+  sigset_t sigset;
+  sigset_t sigoldset;
+#endif
   int stdio_count;
   ssize_t r;
   pid_t pid;
@@ -368,7 +480,8 @@ int uv_spawn(uv_loop_t* loop,
                               UV_PROCESS_WINDOWS_HIDE |
                               UV_PROCESS_WINDOWS_HIDE_CONSOLE |
                               UV_PROCESS_WINDOWS_HIDE_GUI |
-                              UV_PROCESS_WINDOWS_VERBATIM_ARGUMENTS)));
+                              UV_PROCESS_WINDOWS_VERBATIM_ARGUMENTS |
+                              UV_PROCESS_VFORK)));
 
   uv__handle_init(loop, (uv_handle_t*)process, UV_PROCESS);
   QUEUE_INIT(&process->queue);
@@ -378,6 +491,10 @@ int uv_spawn(uv_loop_t* loop,
     stdio_count = 3;
 
   err = UV_ENOMEM;
+  child_pipes = NULL;
+  exec_path = NULL;
+  exec_buf = NULL;
+  use_vfork = 0;
   pipes = pipes_storage;
   if (stdio_count > (int) ARRAY_SIZE(pipes_storage))
     pipes = uv__malloc(stdio_count * sizeof(*pipes));
@@ -396,6 +513,28 @@ int uv_spawn(uv_loop_t* loop,
       goto error;
   }
 
+  child_pipes = pipes;
+#if defined(__linux__)
+  /* Changing the user or group in a child created with vfork() is not safe,
+   * glibc synchronizes that with the threads of the parent.
+   */
+  if ((options->flags & UV_PROCESS_VFORK) &&
+      !(options->flags & (UV_PROCESS_SETUID | UV_PROCESS_SETGID))) {
+    /* The child gets its own copy of the pipes, which it modifies, and the
+     * buffer it needs to look up the executable is allocated up front.
+     */
+    exec_path = uv__spawn_search_path(options->env);
+    child_pipes = uv__malloc(stdio_count * sizeof(*child_pipes));
+    exec_buf = uv__malloc(strlen(exec_path) + strlen(options->file) + 2);
+    if (child_pipes == NULL || exec_buf == NULL) {
+      err = UV_ENOMEM;
+      goto error;
+    }
+    memcpy(child_pipes, pipes, stdio_count * sizeof(*child_pipes));
+    use_vfork = 1;
+  }
+#endif
+
   /* This pipe is used by the parent to wait until
    * the child has called `execve()`. We need this
    * to avoid the following race condition:
@@ -424,21 +563,46 @@ int uv_spawn(uv_loop_t* loop,
 
   /* Acquire write lock to prevent opening new fds in worker threads */
   uv_rwlock_wrlock(&loop->cloexec_lock);
-  pid = fork();
+#if defined(__linux__)
+  if (use_vfork) {
+    /* A signal handler that runs in the child would run on the memory of the
+     * parent, so block all signals until the child has called execve(). The
+     * child resets its signal mask itself.
+     */
+    sigfillset(&sigset);
+    if (pthread_sigmask(SIG_SETMASK, &sigset, &sigoldset) != 0)
+      abort();
+    pid = vfork();
+  } else
+#endif
+    pid = fork();
 
-  if (pid == -1) {
+  if (pid == 0) {
+    uv__process_child_init(options,
+                           stdio_count,
+                           child_pipes,
+                           signal_pipe[1],
+                           exec_path,
+                           exec_buf);
+    abort();
+  }
+
+  if (pid == -1)
     err = UV__ERR(errno);
+
+#if defined(__linux__)
+  if (use_vfork)
+    if (pthread_sigmask(SIG_SETMASK, &sigoldset, NULL) != 0)
+      abort();
+#endif
+
+  if (pid == -1) {
     uv_rwlock_wrunlock(&loop->cloexec_lock);
     uv__close(signal_pipe[0]);
     uv__close(signal_pipe[1]);
     goto error;
   }
 
-  if (pid == 0) {
-    uv__process_child_init(options, stdio_count, pipes, signal_pipe[1]);
-    abort();
-  }
-
   /* Release lock in parent process */
   uv_rwlock_wrunlock(&loop->cloexec_lock);
   uv__close(signal_pipe[1]);
@@ -486,12 +650,20 @@ int uv_spawn(uv_loop_t* loop,
   process->pid = pid;
   process->exit_cb = options->exit_cb;
 
+  if (child_pipes != pipes)
+    uv__free(child_pipes);
+  uv__free(exec_buf);
+
   if (pipes != pipes_storage)
     uv__free(pipes);
 
   return exec_errorno;
 
 error:
+  if (child_pipes != pipes)
+    uv__free(child_pipes);
+  uv__free(exec_buf);
+
   if (pipes != NULL) {
     for (i = 0; i < stdio_count; i++) {
       if (i < options->stdio_count)
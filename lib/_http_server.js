@@ -27,6 +27,7 @@ const {
   ObjectKeys,
   ObjectSetPrototypeOf,
   RegExpPrototypeTest,
+  SafeMap,
   Symbol,
   SymbolFor,
 } = primordials;
@@ -47,10 +48,16 @@ const {
   _checkInvalidHeaderChar: checkInvalidHeaderChar,
   prepareError,
 } = require('_http_common');
-const { OutgoingMessage } = require('_http_outgoing');
+const {
+  OutgoingMessage,
+  validateHeaderName,
+  validateHeaderValue,
+} = require('_http_outgoing');
 const {
   kOutHeaders,
   kNeedDrain,
+  kRouteId,
+  routeMonitoring,
   emitStatistics
 } = require('internal/http');
 const {
@@ -73,9 +80,13 @@ const {
 } = codes;
 const {
   validateInteger,
-  validateBoolean
+  validateBoolean,
+  validateObject,
+  validateString,
 } = require('internal/validators');
 const Buffer = require('buffer').Buffer;
+const { isUint8Array } = require('internal/util/types');
+const { kUpdateTimer } = require('internal/stream_base_commons');
 const {
   DTRACE_HTTP_SERVER_REQUEST,
   DTRACE_HTTP_SERVER_RESPONSE
@@ -92,6 +103,9 @@ const onResponseFinishChannel = dc.channel('http.server.response.finish');
 
 const kServerResponse = Symbol('ServerResponse');
 const kServerResponseStatistics = Symbol('ServerResponseStatistics');
+const kStaticResponses = Symbol('kStaticResponses');
+
+const { StaticResponses } = internalBinding('http_parser');
 
 const {
   hasObserver,
@@ -428,6 +442,103 @@ Server.prototype[EE.captureRejectionSymbol] = function(err, event, ...args) {
   }
 };
 
+// Static responses are kept both natively, where the parser uses them for
+// requests that it can answer without calling into JS, and here, for the
+// requests that it leaves to JS.
+function getStaticResponseKey(method, path) {
+  validateString(method, 'method');
+  validateString(path, 'path');
+  return `${method} ${path}`;
+}
+
+const staticResponseReservedHeaders =
+  /^(?:connection|content-length|transfer-encoding)$/i;
+
+function matchStaticResponse(routes, method, path) {
+  return routes.get(`${method} ${path}`) ??
+         routes.get(`${method} *`) ??
+         routes.get(`* ${path}`) ??
+         routes.get('* *');
+}
+
+Server.prototype.setStaticResponse = function(method, path, options = {}) {
+  const key = getStaticResponseKey(method, path);
+  validateObject(options, 'options');
+  const { statusCode = 200, headers = {}, body = '' } = options;
+  validateInteger(statusCode, 'options.statusCode');
+  if (statusCode < 200 || statusCode > 599)
+    throw new ERR_HTTP_INVALID_STATUS_CODE(statusCode);
+  validateObject(headers, 'options.headers');
+  if (typeof body !== 'string' && !isUint8Array(body)) {
+    throw new ERR_INVALID_ARG_TYPE('options.body',
+                                   ['string', 'Buffer', 'Uint8Array'], body);
+  }
+
+  const hasBody = statusCode !== 204 && statusCode !== 304;
+  const bodyBuffer = hasBody ? Buffer.from(body) : Buffer.alloc(0);
+  let head = `HTTP/1.1 ${statusCode} ${STATUS_CODES[statusCode] || 'unknown'}` +
+             CRLF;
+  const names = ObjectKeys(headers);
+  for (let i = 0; i < names.length; i++) {
+    const name = names[i];
+    const values = ArrayIsArray(headers[name]) ?
+      headers[name] : [headers[name]];
+    validateHeaderName(name);
+    // These are generated from the body and the keep-alive handling of the
+    // parser, and must not be duplicated.
+    if (RegExpPrototypeTest(staticResponseReservedHeaders, name)) {
+      throw new ERR_INVALID_ARG_VALUE('options.headers', headers,
+                                      `must not contain "${name}"`);
+    }
+    for (let j = 0; j < values.length; j++) {
+      validateHeaderValue(name, values[j]);
+      head += `${name}: ${values[j]}${CRLF}`;
+    }
+  }
+  if (hasBody)
+    head += `Content-Length: ${bodyBuffer.length}${CRLF}`;
+  head += `Connection: keep-alive${CRLF}${CRLF}`;
+  const headBuffer = Buffer.from(head, 'latin1');
+
+  if (this[kStaticResponses] === undefined) {
+    this[kStaticResponses] = {
+      handle: new StaticResponses(),
+      routes: new SafeMap(),
+    };
+  }
+  const { handle, routes } = this[kStaticResponses];
+  handle.set(key,
+             Buffer.concat([headBuffer, bodyBuffer]),
+             headBuffer.length);
+  const previous = routes.get(key);
+  routes.set(key, {
+    statusCode,
+    headers,
+    body: bodyBuffer,
+    hits: previous !== undefined ? previous.hits : 0,
+  });
+  return this;
+};
+
+Server.prototype.deleteStaticResponse = function(method, path) {
+  const key = getStaticResponseKey(method, path);
+  if (this[kStaticResponses] !== undefined) {
+    this[kStaticResponses].handle.delete(key);
+    this[kStaticResponses].routes.delete(key);
+  }
+  return this;
+};
+
+Server.prototype.getStaticResponseHits = function(method, path) {
+  const key = getStaticResponseKey(method, path);
+  if (this[kStaticResponses] === undefined)
+    return 0;
+  const route = this[kStaticResponses].routes.get(key);
+  if (route === undefined)
+    return 0;
+  return this[kStaticResponses].handle.hits(key) + route.hits;
+};
+
 function connectionListener(socket) {
   defaultTriggerAsyncIdScope(
     getOrSetAsyncId(socket), connectionListenerInternal, this, socket
@@ -526,11 +637,19 @@ function connectionListenerInternal(server, socket) {
     onParserTimeout.bind(undefined,
                          server, socket);
 
-  // When receiving new requests on the same socket (pipelining or keep alive)
-  // make sure the requestTimeout is active.
-  parser[kOnMessageBegin] =
-    setRequestTimeout.bind(undefined,
-                           server, socket);
+  if (server[kStaticResponses] !== undefined && !server.requestTimeout) {
+    // Let the parser answer requests that have a static response by itself.
+    // There is no request timeout to set for new requests, so nothing needs
+    // to happen in JS for them.
+    parser.setStaticResponses(server[kStaticResponses].handle);
+    parser[kOnMessageBegin] = null;
+  } else {
+    // When receiving new requests on the same socket (pipelining or keep
+    // alive) make sure the requestTimeout is active.
+    parser[kOnMessageBegin] =
+      setRequestTimeout.bind(undefined,
+                             server, socket);
+  }
 
   // This protects from DOS attack where an attacker establish the connection
   // without sending any data on applications where server.timeout is left to
@@ -624,14 +743,29 @@ function onRequestTimeout(socket) {
   socketOnError.call(socket, new ERR_HTTP_REQUEST_TIMEOUT());
 }
 
-function onParserExecute(server, socket, parser, state, ret) {
+function onParserExecute(server, socket, parser, state, ret, staticResponses) {
   // When underlying `net.Socket` instance is consumed - no
   // `data` events are emitted, and thus `socket.setTimeout` fires the
   // callback even if the data is constantly flowing into the socket.
   // See, https://github.com/nodejs/node/commit/ec2822adaad76b126b5cccdeaa1addf2376c9aa6
-  socket._unrefTimer();
+  // Timeouts kept natively by the handle have already been refreshed by the
+  // read itself.
+  socket[kUpdateTimer]();
   debug('SERVER socketOnParserExecute %d', ret);
   onParserExecuteCommon(server, socket, parser, state, ret, undefined);
+
+  // Requests that the parser answered with a static response do not go
+  // through resOnFinish(), so the connection is switched to the keep-alive
+  // timeout here once there is no other response left to send.
+  if (staticResponses > 0 &&
+      socket._httpMessage == null &&
+      state.outgoing.length === 0 &&
+      !socket.destroyed &&
+      server.keepAliveTimeout &&
+      typeof socket.setTimeout === 'function') {
+    socket.setTimeout(server.keepAliveTimeout);
+    state.keepAliveTimeoutSet = true;
+  }
 }
 
 function onParserTimeout(server, socket) {
@@ -796,6 +930,11 @@ function resOnFinish(req, res, socket, state, server) {
 
   state.incoming.shift();
 
+  // Let the parser record the timings of the request, which it is keeping
+  // track of natively.
+  if (routeMonitoring.enabled && socket.parser)
+    socket.parser.recordResponse(req[kRouteId] ?? 0);
+
   // If the user never called req.read(), and didn't pipe() or
   // .resume() or .on('data'), then we call req._dump() so that the
   // bytes will be pulled off the wire.
@@ -901,6 +1040,17 @@ function parserOnIncoming(server, socket, state, req, keepAlive) {
          resOnFinish.bind(undefined,
                           req, res, socket, state, server));
 
+  if (server[kStaticResponses] !== undefined) {
+    const route = matchStaticResponse(server[kStaticResponses].routes,
+                                      req.method, req.url);
+    if (route !== undefined) {
+      route.hits++;
+      res.writeHead(route.statusCode, route.headers);
+      res.end(route.body);
+      return 0;
+    }
+  }
+
   if (req.headers.expect !== undefined &&
       (req.httpVersionMajor === 1 && req.httpVersionMinor === 1)) {
     if (RegExpPrototypeTest(continueExpression, req.headers.expect)) {
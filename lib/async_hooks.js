@@ -54,8 +54,9 @@ const {
 const {
   async_id_symbol, trigger_async_id_symbol,
   init_symbol, before_symbol, after_symbol, destroy_symbol,
-  promise_resolve_symbol
+  promise_resolve_symbol, async_context_frame
 } = internal_async_hooks.symbols;
+const AsyncContextFrame = require('internal/async_context_frame');
 
 // Get constants
 const {
@@ -173,6 +174,7 @@ class AsyncResource {
     const asyncId = newAsyncId();
     this[async_id_symbol] = asyncId;
     this[trigger_async_id_symbol] = triggerAsyncId;
+    this[async_context_frame] = AsyncContextFrame.current();
 
     if (initHooksExist()) {
       if (enabledHooksExist() && type.length === 0) {
@@ -193,6 +195,8 @@ class AsyncResource {
   runInAsyncScope(fn, thisArg, ...args) {
     const asyncId = this[async_id_symbol];
     emitBefore(asyncId, this[trigger_async_id_symbol], this);
+    const priorContextFrame =
+      AsyncContextFrame.exchange(this[async_context_frame]);
 
     try {
       const ret =
@@ -200,6 +204,7 @@ class AsyncResource {
 
       return ret;
     } finally {
+      AsyncContextFrame.set(priorContextFrame);
       if (hasAsyncIdStack())
         emitAfter(asyncId);
     }
@@ -343,7 +348,11 @@ class AsyncLocalStorage {
 // otherwise.
 module.exports = {
   // Public API
-  AsyncLocalStorage,
+  get AsyncLocalStorage() {
+    return AsyncContextFrame.enabled ?
+      require('internal/async_local_storage/async_context_frame') :
+      AsyncLocalStorage;
+  },
   createHook,
   executionAsyncId,
   triggerAsyncId,
@@ -27,6 +27,7 @@ const {
   ArrayPrototypeForEach,
   Error,
   MathFloor,
+  MathMax,
   MathMin,
   MathTrunc,
   NumberIsNaN,
@@ -56,7 +57,9 @@ const {
   compareOffset,
   createFromString,
   fill: bindingFill,
+  indexOfAny: _indexOfAny,
   indexOfBuffer,
+  indexOfList: _indexOfList,
   indexOfNumber,
   indexOfString,
   swap16: _swap16,
@@ -966,6 +969,71 @@ Buffer.prototype.includes = function includes(val, byteOffset, encoding) {
   return this.indexOf(val, byteOffset, encoding) !== -1;
 };
 
+// Converts a search value passed to indexOfAny() or Buffer.indexOfList() into
+// a Uint8Array. Numbers are searched for as a single byte, like in indexOf().
+function toSearchValue(val, encoding, name) {
+  if (isUint8Array(val))
+    return val;
+  if (typeof val === 'string')
+    return fromString(val, encoding);
+  if (typeof val === 'number')
+    return new FastBuffer([val & 255]);
+  throw new ERR_INVALID_ARG_TYPE(
+    name, ['number', 'string', 'Buffer', 'Uint8Array'], val
+  );
+}
+
+Buffer.prototype.indexOfAny =
+  function indexOfAny(values, byteOffset, encoding) {
+    validateArray(values, 'values');
+    if (typeof byteOffset === 'string') {
+      encoding = byteOffset;
+      byteOffset = 0;
+    } else if (byteOffset > 0x7fffffff) {
+      byteOffset = 0x7fffffff;
+    } else if (byteOffset < -0x80000000) {
+      byteOffset = -0x80000000;
+    }
+    byteOffset = +byteOffset;
+    if (NumberIsNaN(byteOffset))
+      byteOffset = 0;
+
+    const needles = new Array(values.length);
+    for (let i = 0; i < values.length; i++)
+      needles[i] = toSearchValue(values[i], encoding, `values[${i}]`);
+    return _indexOfAny(this, needles, byteOffset);
+  };
+
+Buffer.indexOfList = function indexOfList(list, val, byteOffset, encoding) {
+  validateArray(list, 'list');
+  let length = 0;
+  for (let i = 0; i < list.length; i++) {
+    if (!isUint8Array(list[i])) {
+      throw new ERR_INVALID_ARG_TYPE(
+        `list[${i}]`, ['Buffer', 'Uint8Array'], list[i]);
+    }
+    length += list[i].length;
+  }
+
+  if (typeof byteOffset === 'string') {
+    encoding = byteOffset;
+    byteOffset = 0;
+  }
+  byteOffset = MathTrunc(+byteOffset);
+  if (NumberIsNaN(byteOffset)) {
+    byteOffset = 0;
+  } else if (byteOffset < 0) {
+    byteOffset = MathMax(length + byteOffset, 0);
+  }
+
+  const needle = toSearchValue(val, encoding, 'value');
+  if (needle.length === 0)
+    return MathMin(byteOffset, length);
+  if (byteOffset + needle.length > length)
+    return -1;
+  return _indexOfList(list, needle, byteOffset);
+};
+
 // Usage:
 //    buffer.fill(number[, offset[, end]])
 //    buffer.fill(buffer[, offset[, end]])
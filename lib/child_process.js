@@ -76,6 +76,7 @@ const {
   isInt32,
   validateAbortSignal,
   validateBoolean,
+  validateFunction,
   validateObject,
   validateString,
 } = require('internal/validators');
@@ -464,6 +465,11 @@ function normalizeSpawnArguments(file, args, options) {
     validateBoolean(options.detached, 'options.detached');
   }
 
+  // Validate fastSpawn, if present.
+  if (options.fastSpawn != null) {
+    validateBoolean(options.fastSpawn, 'options.fastSpawn');
+  }
+
   // Validate the uid, if present.
   if (options.uid != null && !isInt32(options.uid)) {
     throw new ERR_INVALID_ARG_TYPE('options.uid', 'int32', options.uid);
@@ -578,6 +584,7 @@ function normalizeSpawnArguments(file, args, options) {
     cwd,
     detached: !!options.detached,
     envPairs,
+    fastSpawn: !!options.fastSpawn,
     file,
     windowsHide: !!options.windowsHide,
     windowsVerbatimArguments: !!windowsVerbatimArguments,
@@ -659,6 +666,9 @@ function spawnSync(file, args, options) {
   // Validate maxBuffer, if present.
   validateMaxBuffer(options.maxBuffer);
 
+  if (options.onLine !== undefined)
+    validateFunction(options.onLine, 'options.onLine');
+
   // Validate and translate the kill signal, if present.
   options.killSignal = sanitizeKillSignal(options.killSignal);
 
@@ -30,6 +30,8 @@ const {
   ObjectDefineProperty,
   ObjectSetPrototypeOf,
   ReflectApply,
+  TypedArrayPrototypeSubarray,
+  Uint32Array,
 } = primordials;
 
 const errors = require('internal/errors');
@@ -53,6 +55,9 @@ const {
 const {
   isInt32,
   validateAbortSignal,
+  validateBoolean,
+  validateFunction,
+  validateInteger,
   validateString,
   validateNumber,
   validatePort,
@@ -100,6 +105,7 @@ function Socket(type, listener) {
   let lookup;
   let recvBufferSize;
   let sendBufferSize;
+  let recvBatch = false;
 
   let options;
   if (type !== null && typeof type === 'object') {
@@ -108,9 +114,13 @@ function Socket(type, listener) {
     lookup = options.lookup;
     recvBufferSize = options.recvBufferSize;
     sendBufferSize = options.sendBufferSize;
+    if (options.recvBatch !== undefined) {
+      validateBoolean(options.recvBatch, 'options.recvBatch');
+      recvBatch = options.recvBatch;
+    }
   }
 
-  const handle = newHandle(type, lookup);
+  const handle = newHandle(type, lookup, recvBatch);
   handle[owner_symbol] = this;
 
   this[async_id_symbol] = handle.getAsyncId();
@@ -128,7 +138,8 @@ function Socket(type, listener) {
     reuseAddr: options && options.reuseAddr, // Use UV_UDP_REUSEADDR if true.
     ipv6Only: options && options.ipv6Only,
     recvBufferSize,
-    sendBufferSize
+    sendBufferSize,
+    recvBatch
   };
 
   if (options?.signal !== undefined) {
@@ -158,6 +169,7 @@ function startListening(socket) {
   const state = socket[kStateSymbol];
 
   state.handle.onmessage = onMessage;
+  state.handle.onmessages = onMessages;
   // Todo: handle errors
   state.handle.recvStart();
   state.receiving = true;
@@ -180,6 +192,7 @@ function replaceHandle(self, newHandle) {
   newHandle.lookup = oldHandle.lookup;
   newHandle.bind = oldHandle.bind;
   newHandle.send = oldHandle.send;
+  newHandle.sendBatch = oldHandle.sendBatch;
   newHandle[owner_symbol] = self;
 
   // Replace the existing handle by the handle we got from primary.
@@ -660,7 +673,79 @@ Socket.prototype.send = function(buffer,
     defaultTriggerAsyncIdScope(
       this[async_id_symbol],
       doSend,
-      ex, this, ip, list, address, port, callback
+      ex, this, ip, list, address, port, callback, false
+    );
+  };
+
+  if (!connected) {
+    state.handle.lookup(address, afterDns);
+  } else {
+    afterDns(null, null);
+  }
+};
+
+// sendBatch(list, port, address, callback)
+// sendBatch(list, port, address)
+// sendBatch(list, port, callback)
+// sendBatch(list, port)
+// For connected sockets
+// sendBatch(list, callback)
+// sendBatch(list)
+Socket.prototype.sendBatch = function(list, port, address, callback) {
+  const state = this[kStateSymbol];
+  const connected = state.connectState === CONNECT_STATE_CONNECTED;
+
+  if (typeof port === 'function') {
+    callback = port;
+    port = undefined;
+  } else if (typeof address === 'function') {
+    callback = address;
+    address = undefined;
+  }
+
+  let messages;
+  if (!ArrayIsArray(list) || !(messages = fixBufferList(list))) {
+    throw new ERR_INVALID_ARG_TYPE('list',
+                                   'an Array of Buffer, TypedArray, ' +
+                                   'DataView or string',
+                                   list);
+  }
+
+  if (connected) {
+    if (port || address)
+      throw new ERR_SOCKET_DGRAM_IS_CONNECTED();
+  } else {
+    port = validatePort(port, 'Port', { allowZero: false });
+  }
+
+  if (address && typeof address !== 'string')
+    throw new ERR_INVALID_ARG_TYPE('address', ['string', 'falsy'], address);
+
+  if (callback !== undefined)
+    validateFunction(callback, 'callback');
+
+  healthCheck(this);
+
+  if (messages.length === 0) {
+    if (callback)
+      process.nextTick(callback, null, 0);
+    return;
+  }
+
+  if (state.bindState === BIND_STATE_UNBOUND)
+    this.bind({ port: 0, exclusive: true }, null);
+
+  if (state.bindState !== BIND_STATE_BOUND) {
+    enqueue(this, FunctionPrototypeBind(this.sendBatch, this,
+                                        messages, port, address, callback));
+    return;
+  }
+
+  const afterDns = (ex, ip) => {
+    defaultTriggerAsyncIdScope(
+      this[async_id_symbol],
+      doSend,
+      ex, this, ip, messages, address, port, callback, true
     );
   };
 
@@ -671,7 +756,7 @@ Socket.prototype.send = function(buffer,
   }
 };
 
-function doSend(ex, self, ip, list, address, port, callback) {
+function doSend(ex, self, ip, list, address, port, callback, batch) {
   const state = self[kStateSymbol];
 
   if (ex) {
@@ -696,10 +781,19 @@ function doSend(ex, self, ip, list, address, port, callback) {
   }
 
   let err;
-  if (port)
+  if (batch) {
+    // Each element of the list is sent as a separate datagram.
+    if (port) {
+      err = state.handle.sendBatch(req, list, list.length, port, ip,
+                                   !!callback);
+    } else {
+      err = state.handle.sendBatch(req, list, list.length, !!callback);
+    }
+  } else if (port) {
     err = state.handle.send(req, list, list.length, port, ip, !!callback);
-  else
+  } else {
     err = state.handle.send(req, list, list.length, !!callback);
+  }
 
   if (err >= 1) {
     // Synchronous finish. The return code is msg_length + 1 so that we can
@@ -804,6 +898,16 @@ Socket.prototype.setTTL = function(ttl) {
 };
 
 
+Socket.prototype.setSendSegmentSize = function(size) {
+  validateInteger(size, 'size', 0, 65535);
+
+  const err = this[kStateSymbol].handle.setSendSegmentSize(size);
+  if (err) {
+    throw errnoException(err, 'setSendSegmentSize');
+  }
+};
+
+
 Socket.prototype.setMulticastTTL = function(ttl) {
   validateNumber(ttl, 'ttl');
 
@@ -927,11 +1031,44 @@ function onMessage(nread, handle, buf, rinfo) {
   if (nread < 0) {
     return self.emit('error', errnoException(nread, 'recvmsg'));
   }
+  if (self[kStateSymbol].recvBatch) {
+    // The handle may not batch datagrams itself, e.g. when it was shared by
+    // the cluster primary.
+    const info = new Uint32Array([0, buf.length, rinfo.port]);
+    return onMessages(1, handle, buf, info, [rinfo.address]);
+  }
   rinfo.size = buf.length; // compatibility
   self.emit('message', buf, rinfo);
 }
 
 
+function onMessages(count, handle, buffer, info, addresses) {
+  const self = handle[owner_symbol];
+  const batch = {
+    count,
+    buffer,
+    offsets: TypedArrayPrototypeSubarray(info, 0, count),
+    lengths: TypedArrayPrototypeSubarray(info, count, 2 * count),
+    addresses,
+    ports: TypedArrayPrototypeSubarray(info, 2 * count, 3 * count),
+    family: self.type === 'udp4' ? 'IPv4' : 'IPv6',
+  };
+  self.emit('messages', batch);
+
+  // Keep 'message' working for code that does not know about batches.
+  if (self.listenerCount('message') > 0) {
+    for (let i = 0; i < count; i++) {
+      const offset = batch.offsets[i];
+      const size = batch.lengths[i];
+      self.emit('message',
+                TypedArrayPrototypeSubarray(buffer, offset, offset + size),
+                { address: addresses[i], family: batch.family,
+                  port: batch.ports[i], size });
+    }
+  }
+}
+
+
 Socket.prototype.ref = function() {
   const handle = this[kStateSymbol].handle;
 
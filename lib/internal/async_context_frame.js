@@ -0,0 +1,74 @@
+'use strict';
+
+const {
+  ObjectSetPrototypeOf,
+  SafeMap,
+} = primordials;
+
+const {
+  getContinuationPreservedEmbedderData,
+  setContinuationPreservedEmbedderData,
+} = internalBinding('async_wrap');
+
+// An AsyncContextFrame maps AsyncLocalStorage instances to their stores. It
+// is never modified after creation, except by disable(), so that it can be
+// shared by all continuations that capture it. V8 saves the current frame on
+// promise reactions, and Node.js on its own asynchronous resources. When there
+// is no frame, null is stored rather than undefined, which V8 would not
+// restore for promise reactions.
+class ActiveAsyncContextFrame extends SafeMap {
+  constructor(store, data) {
+    super(ActiveAsyncContextFrame.current());
+    this.set(store, data);
+  }
+
+  static current() {
+    return getContinuationPreservedEmbedderData();
+  }
+
+  static set(frame) {
+    setContinuationPreservedEmbedderData(frame);
+  }
+
+  static exchange(frame) {
+    const prior = this.current();
+    this.set(frame);
+    return prior;
+  }
+
+  static disable(store) {
+    const frame = this.current();
+    frame?.disable(store);
+  }
+
+  disable(store) {
+    this.delete(store);
+  }
+}
+
+// Used until --experimental-async-context-frame is known to be set, so that
+// the call sites do not need to check for it.
+class InactiveAsyncContextFrame {
+  static current() {}
+  static set(frame) {}
+  static exchange(frame) {}
+  static disable(store) {}
+}
+
+let enabled = false;
+
+class AsyncContextFrame extends InactiveAsyncContextFrame {
+  static get enabled() {
+    return enabled;
+  }
+
+  static enable() {
+    enabled = true;
+    ObjectSetPrototypeOf(AsyncContextFrame, ActiveAsyncContextFrame);
+    ObjectSetPrototypeOf(AsyncContextFrame.prototype,
+                         ActiveAsyncContextFrame.prototype);
+    AsyncContextFrame.set(null);
+  }
+}
+
+module.exports = AsyncContextFrame;
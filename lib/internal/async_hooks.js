@@ -104,6 +104,8 @@ const before_symbol = Symbol('before');
 const after_symbol = Symbol('after');
 const destroy_symbol = Symbol('destroy');
 const promise_resolve_symbol = Symbol('promiseResolve');
+// Used by resources that are implemented in JS to save the AsyncContextFrame.
+const async_context_frame = Symbol('kAsyncContextFrame');
 const emitBeforeNative = emitHookFactory(before_symbol, 'emitBeforeNative');
 const emitAfterNative = emitHookFactory(after_symbol, 'emitAfterNative');
 const emitDestroyNative = emitHookFactory(destroy_symbol, 'emitDestroyNative');
@@ -554,7 +556,7 @@ module.exports = {
   symbols: {
     async_id_symbol, trigger_async_id_symbol,
     init_symbol, before_symbol, after_symbol, destroy_symbol,
-    promise_resolve_symbol, owner_symbol
+    promise_resolve_symbol, owner_symbol, async_context_frame
   },
   constants: {
     kInit, kBefore, kAfter, kDestroy, kTotals, kPromiseResolve
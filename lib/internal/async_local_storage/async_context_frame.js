@@ -0,0 +1,42 @@
+'use strict';
+
+const {
+  ReflectApply,
+} = primordials;
+
+const AsyncContextFrame = require('internal/async_context_frame');
+
+// The AsyncLocalStorage implementation that is used with
+// --experimental-async-context-frame. Stores are looked up in the current
+// AsyncContextFrame, and entering a store creates a new frame, so no
+// async_hooks are needed to propagate them.
+class AsyncLocalStorage {
+  disable() {
+    AsyncContextFrame.disable(this);
+  }
+
+  enterWith(store) {
+    const frame = new AsyncContextFrame(this, store);
+    AsyncContextFrame.set(frame);
+  }
+
+  run(store, callback, ...args) {
+    const prior = AsyncContextFrame.current();
+    this.enterWith(store);
+    try {
+      return ReflectApply(callback, null, args);
+    } finally {
+      AsyncContextFrame.set(prior);
+    }
+  }
+
+  exit(callback, ...args) {
+    return this.run(undefined, callback, ...args);
+  }
+
+  getStore() {
+    return AsyncContextFrame.current()?.get(this);
+  }
+}
+
+module.exports = AsyncLocalStorage;
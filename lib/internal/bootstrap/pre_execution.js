@@ -26,6 +26,7 @@ function prepareMainThreadExecution(expandArgv1 = false) {
 
   // Patch the process object with legacy properties and normalizations
   patchProcessObject(expandArgv1);
+  setupAsyncContextFrame();
   setupTraceCategoryState();
   setupInspectorHooks();
   setupWarningHandler();
@@ -49,6 +50,7 @@ function prepareMainThreadExecution(expandArgv1 = false) {
   initializeReportSignalHandlers();  // Main-thread-only.
 
   initializeHeapSnapshotSignalHandlers();
+  initializeHeapProfileSignalHandlers();
 
   // If the process is spawned with env NODE_CHANNEL_FD, it's probably
   // spawned by our child_process module, then initialize IPC.
@@ -74,6 +76,22 @@ function prepareMainThreadExecution(expandArgv1 = false) {
   assert(!CJSLoader.hasLoadedAnyUserCJSModule);
   loadPreloadModules();
   initializeFrozenIntrinsics();
+  runDeserializeCallbacks();
+}
+
+function setupAsyncContextFrame() {
+  if (getOptionValue('--experimental-async-context-frame')) {
+    require('internal/async_context_frame').enable();
+  }
+}
+
+// When the process is started from a user-land snapshot, run the callbacks
+// added by v8.startupSnapshot.addDeserializeCallback() while it was built.
+function runDeserializeCallbacks() {
+  if (getOptionValue('--snapshot-blob') === '') {
+    return;
+  }
+  require('internal/v8/startup_snapshot').runDeserializeCallbacks();
 }
 
 function patchProcessObject(expandArgv1) {
@@ -216,6 +234,31 @@ function initializeHeapSnapshotSignalHandlers() {
   });
 }
 
+function initializeHeapProfileSignalHandlers() {
+  const signal = getOptionValue('--heapprofile-signal');
+
+  if (!signal)
+    return;
+
+  require('internal/validators').validateSignalName(signal);
+  const {
+    isSamplingHeapProfilerRunning,
+    startSamplingHeapProfiler,
+    writeHeapProfile,
+  } = require('internal/heap_utils');
+  const directory = getOptionValue('--diagnostic-dir') || undefined;
+
+  // The first signal starts the profiler, and each of the following ones
+  // writes out the allocations sampled so far that are still alive.
+  process.on(signal, () => {
+    if (isSamplingHeapProfilerRunning()) {
+      writeHeapProfile();
+    } else {
+      startSamplingHeapProfiler({ directory });
+    }
+  });
+}
+
 function setupTraceCategoryState() {
   const { isTraceCategoryEnabled } = internalBinding('trace_events');
   const { toggleTraceCategoryState } = require('internal/process/per_thread');
@@ -471,6 +514,7 @@ function loadPreloadModules() {
 
 module.exports = {
   patchProcessObject,
+  setupAsyncContextFrame,
   setupCoverageHooks,
   setupWarningHandler,
   setupDebugEnv,
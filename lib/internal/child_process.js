@@ -1069,6 +1069,10 @@ function maybeClose(subprocess) {
 }
 
 function spawnSync(options) {
+  const { onLine, encoding } = options;
+  if (onLine !== undefined && encoding && encoding !== 'buffer')
+    options.onLine = (line, fd) => onLine(line.toString(encoding), fd);
+
   const result = spawn_sync.spawn(options);
 
   if (result.output && options.encoding && options.encoding !== 'buffer') {
@@ -8,6 +8,22 @@ const {
 } = require('internal/stream_base_commons');
 const { owner_symbol } = require('internal/async_hooks').symbols;
 const { Readable } = require('stream');
+const {
+  codes: {
+    ERR_INVALID_STATE,
+  },
+} = require('internal/errors');
+const { getValidatedPath } = require('internal/fs/utils');
+const {
+  validateInteger,
+  validateObject,
+} = require('internal/validators');
+const { toNamespacedPath } = require('path');
+const {
+  startSamplingHeapProfiler: _startSamplingHeapProfiler,
+  stopSamplingHeapProfiler: _stopSamplingHeapProfiler,
+  writeHeapProfile: _writeHeapProfile,
+} = internalBinding('heap_utils');
 
 const kHandle = Symbol('kHandle');
 
@@ -36,6 +52,72 @@ class HeapSnapshotStream extends Readable {
   }
 }
 
+// The state of the sampling heap profiler started through
+// startSamplingHeapProfiler(), or undefined if it is not running.
+let heapProfiler;
+
+function isSamplingHeapProfilerRunning() {
+  return heapProfiler !== undefined;
+}
+
+function startSamplingHeapProfiler(options = {}) {
+  validateObject(options, 'options');
+  const {
+    samplingInterval = 512 * 1024,
+    stackDepth = 16,
+    writeInterval = 0,
+  } = options;
+  let { directory } = options;
+  validateInteger(samplingInterval, 'options.samplingInterval', 1);
+  validateInteger(stackDepth, 'options.stackDepth', 1, 1024);
+  validateInteger(writeInterval, 'options.writeInterval', 0);
+  if (directory !== undefined) {
+    directory = toNamespacedPath(
+      getValidatedPath(directory, 'options.directory'));
+  }
+
+  // This also fails when the profiler has been started through other means,
+  // e.g. --heap-prof or the inspector.
+  if (heapProfiler !== undefined ||
+      !_startSamplingHeapProfiler(samplingInterval, stackDepth)) {
+    throw new ERR_INVALID_STATE(
+      'The sampling heap profiler is already running');
+  }
+  heapProfiler = { samplingInterval, directory, timer: undefined };
+  if (writeInterval > 0) {
+    const { setInterval } = require('timers');
+    heapProfiler.timer = setInterval(writeHeapProfile, writeInterval);
+    heapProfiler.timer.unref();
+  }
+}
+
+function stopSamplingHeapProfiler() {
+  if (heapProfiler === undefined)
+    return;
+  if (heapProfiler.timer !== undefined) {
+    const { clearInterval } = require('timers');
+    clearInterval(heapProfiler.timer);
+  }
+  heapProfiler = undefined;
+  _stopSamplingHeapProfiler();
+}
+
+function writeHeapProfile(filename) {
+  if (heapProfiler === undefined)
+    throw new ERR_INVALID_STATE('The sampling heap profiler is not running');
+  if (filename !== undefined) {
+    filename = getValidatedPath(filename);
+    filename = toNamespacedPath(filename);
+  }
+  return _writeHeapProfile(filename,
+                           heapProfiler.directory,
+                           heapProfiler.samplingInterval);
+}
+
 module.exports = {
-  HeapSnapshotStream
+  HeapSnapshotStream,
+  isSamplingHeapProfilerRunning,
+  startSamplingHeapProfiler,
+  stopSamplingHeapProfiler,
+  writeHeapProfile
 };
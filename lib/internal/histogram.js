@@ -11,7 +11,8 @@ const {
 } = primordials;
 
 const {
-  Histogram: _Histogram
+  Histogram: _Histogram,
+  decodeHistogram,
 } = internalBinding('performance');
 
 const {
@@ -29,9 +30,14 @@ const {
 } = require('internal/errors');
 
 const {
+  validateBoolean,
+  validateInteger,
   validateNumber,
+  validateObject,
 } = require('internal/validators');
 
+const { isArrayBufferView } = require('internal/util/types');
+
 const kDestroy = Symbol('kDestroy');
 const kHandle = Symbol('kHandle');
 const kMap = Symbol('kMap');
@@ -92,6 +98,10 @@ class Histogram extends JSTransferable {
     return this[kHandle]?.stddev();
   }
 
+  get count() {
+    return this[kHandle]?.count();
+  }
+
   percentile(percentile) {
     validateNumber(percentile, 'percentile');
 
@@ -111,6 +121,10 @@ class Histogram extends JSTransferable {
     this[kHandle]?.reset();
   }
 
+  export() {
+    return this[kHandle]?.encode();
+  }
+
   [kDestroy]() {
     this[kHandle] = undefined;
   }
@@ -153,6 +167,12 @@ class RecordableHistogram extends Histogram {
     this[kHandle]?.recordDelta();
   }
 
+  add(other) {
+    if (!isHistogram(other))
+      throw new ERR_INVALID_ARG_TYPE('other', 'Histogram', other);
+    this[kHandle]?.add(other[kHandle]);
+  }
+
   [kClone]() {
     const handle = this[kHandle];
     return {
@@ -188,8 +208,48 @@ ObjectSetPrototypeOf(
   InternalRecordableHistogram.prototype,
   RecordableHistogram.prototype);
 
-function createHistogram() {
-  return new InternalRecordableHistogram(new _Histogram());
+function validateHistogramValue(value, name) {
+  if (typeof value === 'bigint') {
+    if (value < 1n || value > 2n ** 63n - 1n)
+      throw new ERR_OUT_OF_RANGE(name, '>= 1 && < 2 ** 63', value);
+    return;
+  }
+  validateInteger(value, name, 1);
+}
+
+function createHistogram(options = {}) {
+  validateObject(options, 'options');
+  const {
+    min = 1,
+    max = NumberMAX_SAFE_INTEGER,
+    figures = 3,
+    atomic = false,
+  } = options;
+  validateHistogramValue(min, 'options.min');
+  validateHistogramValue(max, 'options.max');
+  // The histogram has to be able to tell apart at least two values.
+  if (max < min * (typeof min === 'bigint' ? 2n : 2))
+    throw new ERR_OUT_OF_RANGE('options.max', '>= 2 * options.min', max);
+  validateInteger(figures, 'options.figures', 1, 5);
+  validateBoolean(atomic, 'options.atomic');
+  return new InternalRecordableHistogram(
+    new _Histogram(min, max, figures, atomic));
+}
+
+function importHistogram(data, options = {}) {
+  if (!isArrayBufferView(data)) {
+    throw new ERR_INVALID_ARG_TYPE(
+      'data', ['Buffer', 'TypedArray', 'DataView'], data);
+  }
+  validateObject(options, 'options');
+  const { atomic = false } = options;
+  validateBoolean(atomic, 'options.atomic');
+  const handle = decodeHistogram(data, atomic);
+  if (handle === undefined) {
+    throw new ERR_INVALID_ARG_VALUE(
+      'data', data, 'is not a histogram in the HdrHistogram V2 encoding');
+  }
+  return new InternalRecordableHistogram(handle);
 }
 
 module.exports = {
@@ -201,4 +261,5 @@ module.exports = {
   kDestroy,
   kHandle,
   createHistogram,
+  importHistogram,
 };
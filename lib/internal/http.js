@@ -47,9 +47,14 @@ function emitStatistics(statistics) {
   enqueue(entry);
 }
 
+// Toggled by the monitor returned by perf_hooks.monitorHttpRoutes().
+const routeMonitoring = { enabled: false };
+
 module.exports = {
   kOutHeaders: Symbol('kOutHeaders'),
   kNeedDrain: Symbol('kNeedDrain'),
+  kRouteId: Symbol('kRouteId'),
+  routeMonitoring,
   utcDate,
   emitStatistics,
 };
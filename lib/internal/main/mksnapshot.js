@@ -0,0 +1,50 @@
+'use strict';
+
+// Run the entry point script of a user-land startup snapshot, see
+// --build-snapshot. The heap is serialized once the event loop is drained.
+
+const {
+  Error,
+  StringPrototypeSlice,
+  StringPrototypeStartsWith,
+} = primordials;
+
+const {
+  compileSnapshotMain,
+  getEntryPoint,
+} = internalBinding('mksnapshot');
+const { NativeModule } = require('internal/bootstrap/loaders');
+
+// Make sure that the serialize callbacks are registered before the user
+// code gets a chance to run.
+require('internal/v8/startup_snapshot');
+
+function requireForUserSnapshot(id) {
+  if (StringPrototypeStartsWith(id, 'node:')) {
+    id = StringPrototypeSlice(id, 5);
+  }
+  if (!NativeModule.canBeRequiredByUsers(id)) {
+    // eslint-disable-next-line no-restricted-syntax
+    const err = new Error(
+      `Cannot find module '${id}'. ` +
+      'User-land modules cannot be loaded when building a startup snapshot, ' +
+      'bundle the application into a single script instead.'
+    );
+    err.code = 'MODULE_NOT_FOUND';
+    throw err;
+  }
+  return require(id);
+}
+
+function main() {
+  const path = require('path');
+  const { readFileSync } = require('fs');
+
+  const filename = path.resolve(getEntryPoint());
+  const dirname = path.dirname(filename);
+  const source = readFileSync(filename, 'utf-8');
+  const fn = compileSnapshotMain(filename, source);
+  fn(requireForUserSnapshot, filename, dirname);
+}
+
+main();
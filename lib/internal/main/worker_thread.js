@@ -14,6 +14,7 @@ const {
 
 const {
   patchProcessObject,
+  setupAsyncContextFrame,
   setupCoverageHooks,
   setupInspectorHooks,
   setupWarningHandler,
@@ -42,6 +43,7 @@ const {
     UP_AND_RUNNING,
     ERROR_MESSAGE,
     COULD_NOT_SERIALIZE_ERROR,
+    POOL_WORKER_LOADED,
     // Messages that may be either received or posted
     STDIO_PAYLOAD,
     STDIO_WANTS_MORE_DATA,
@@ -61,6 +63,7 @@ let debug = require('internal/util/debuglog').debuglog('worker', (fn) => {
 const assert = require('internal/assert');
 
 patchProcessObject();
+setupAsyncContextFrame();
 setupInspectorHooks();
 setupDebugEnv();
 
@@ -107,6 +110,7 @@ port.on('message', (message) => {
       doEval,
       workerData,
       environmentData,
+      poolHandle,
       publicPort,
       manifestSrc,
       manifestURL,
@@ -158,7 +162,15 @@ port.on('message', (message) => {
     debug(`[${threadId}] starts worker script ${filename} ` +
           `(eval = ${eval}) at cwd = ${process.cwd()}`);
     port.postMessage({ type: UP_AND_RUNNING });
-    if (doEval === 'classic') {
+    if (poolHandle !== undefined) {
+      // A worker of a WorkerPool runs the tasks of the pool with the default
+      // export of the script.
+      ArrayPrototypeSplice(process.argv, 1, 0, filename);
+      const { runPoolWorker } = require('internal/worker/pool');
+      runPoolWorker(poolHandle, filename, () => {
+        port.postMessage({ type: POOL_WORKER_LOADED });
+      });
+    } else if (doEval === 'classic') {
       const { evalScript } = require('internal/process/execution');
       const name = '[worker eval]';
       // This is necessary for CJS module compilation.
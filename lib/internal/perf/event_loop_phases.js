@@ -0,0 +1,84 @@
+'use strict';
+
+const {
+  ObjectKeys,
+  TypeError,
+} = primordials;
+
+const {
+  getLoopMetrics,
+  resetLoopMetrics,
+  setLoopMetricsEnabled,
+} = internalBinding('performance');
+
+const { Providers } = internalBinding('async_wrap');
+
+// The phases in the order in which they are counted natively.
+const kPhases = ['timers', 'pending', 'poll', 'check', 'close'];
+
+const providerNames = [];
+for (const name of ObjectKeys(Providers))
+  providerNames[Providers[name]] = name;
+
+let monitor;
+let enabled = false;
+
+// The metrics are kept by the Environment, so there is a single monitor for
+// each thread.
+class EventLoopPhaseMonitor {
+  constructor() {
+    if (monitor !== undefined) {
+      // eslint-disable-next-line no-restricted-syntax
+      throw new TypeError('illegal constructor');
+    }
+  }
+
+  enable() {
+    if (enabled) return false;
+    enabled = true;
+    setLoopMetricsEnabled(true);
+    return true;
+  }
+
+  disable() {
+    if (!enabled) return false;
+    enabled = false;
+    setLoopMetricsEnabled(false);
+    return true;
+  }
+
+  reset() {
+    resetLoopMetrics();
+  }
+
+  snapshot() {
+    const metrics = getLoopMetrics();
+    let index = 0;
+    const result = {
+      iterations: metrics[index++],
+      phases: {},
+      providers: {},
+    };
+    for (let i = 0; i < kPhases.length; i++) {
+      result.phases[kPhases[i]] = {
+        count: metrics[index++],
+        duration: metrics[index++],
+      };
+    }
+    for (let i = 0; i < providerNames.length; i++) {
+      const count = metrics[index++];
+      const duration = metrics[index++];
+      if (count > 0)
+        result.providers[providerNames[i]] = { count, duration };
+    }
+    return result;
+  }
+}
+
+function monitorEventLoopPhases() {
+  if (monitor === undefined)
+    monitor = new EventLoopPhaseMonitor();
+  return monitor;
+}
+
+module.exports = monitorEventLoopPhases;
@@ -0,0 +1,62 @@
+'use strict';
+
+const {
+  Symbol,
+  TypeError,
+} = primordials;
+
+const {
+  LoopStallWatchdog,
+} = internalBinding('watchdog');
+
+const EventEmitter = require('events');
+
+const {
+  validateBoolean,
+  validateInteger,
+  validateObject,
+} = require('internal/validators');
+
+const kHandle = Symbol('kHandle');
+const kEnabled = Symbol('kEnabled');
+
+class EventLoopStallMonitor extends EventEmitter {
+  constructor(handle) {
+    if (!(handle instanceof LoopStallWatchdog)) {
+      // eslint-disable-next-line no-restricted-syntax
+      throw new TypeError('illegal constructor');
+    }
+    super();
+    this[kHandle] = handle;
+    this[kEnabled] = false;
+    handle.onstall = (duration, stack) => {
+      this.emit('stall', { duration, stack });
+    };
+  }
+
+  enable() {
+    if (this[kEnabled]) return false;
+    this[kEnabled] = true;
+    this[kHandle].start();
+    return true;
+  }
+
+  disable() {
+    if (!this[kEnabled]) return false;
+    this[kEnabled] = false;
+    this[kHandle].stop();
+    return true;
+  }
+}
+
+function monitorEventLoopStalls(options = {}) {
+  validateObject(options, 'options');
+
+  const { threshold = 1000, report = false } = options;
+  validateInteger(threshold, 'options.threshold', 1, 2 ** 32 - 1);
+  validateBoolean(report, 'options.report');
+
+  return new EventLoopStallMonitor(new LoopStallWatchdog(threshold, report));
+}
+
+module.exports = monitorEventLoopStalls;
@@ -0,0 +1,96 @@
+'use strict';
+
+const {
+  TypeError,
+} = primordials;
+
+const {
+  setRouteHistograms,
+  setRouteMonitoring,
+} = internalBinding('http_parser');
+
+const {
+  codes: {
+    ERR_INVALID_ARG_TYPE,
+  },
+} = require('internal/errors');
+
+const {
+  validateInteger,
+  validateObject,
+} = require('internal/validators');
+
+const {
+  isHistogram,
+  kHandle,
+} = require('internal/histogram');
+
+const {
+  kRouteId,
+  routeMonitoring,
+} = require('internal/http');
+
+const kMaxRouteId = 0xffff;
+
+let monitor;
+
+function getHistogramHandle(histogram, name) {
+  if (histogram === undefined)
+    return undefined;
+  if (!isHistogram(histogram) || typeof histogram.record !== 'function')
+    throw new ERR_INVALID_ARG_TYPE(name, 'RecordableHistogram', histogram);
+  return histogram[kHandle];
+}
+
+// The timings are recorded by the HTTP parser, and the histograms that they
+// are recorded into are kept by the http_parser binding, so there is a
+// single monitor for each thread.
+class HttpRouteMonitor {
+  constructor() {
+    if (monitor !== undefined) {
+      // eslint-disable-next-line no-restricted-syntax
+      throw new TypeError('illegal constructor');
+    }
+  }
+
+  enable() {
+    if (routeMonitoring.enabled) return false;
+    routeMonitoring.enabled = true;
+    setRouteMonitoring(true);
+    return true;
+  }
+
+  disable() {
+    if (!routeMonitoring.enabled) return false;
+    routeMonitoring.enabled = false;
+    setRouteMonitoring(false);
+    return true;
+  }
+
+  setRoute(id, histograms) {
+    validateInteger(id, 'id', 0, kMaxRouteId);
+    validateObject(histograms, 'histograms');
+    const { parse, response, bytes } = histograms;
+    setRouteHistograms(
+      id,
+      getHistogramHandle(parse, 'histograms.parse'),
+      getHistogramHandle(response, 'histograms.response'),
+      getHistogramHandle(bytes, 'histograms.bytes'));
+  }
+
+  setRequestRoute(req, id) {
+    const { IncomingMessage } = require('_http_incoming');
+    if (!(req instanceof IncomingMessage))
+      throw new ERR_INVALID_ARG_TYPE('req', 'http.IncomingMessage', req);
+    validateInteger(id, 'id', 0, kMaxRouteId);
+    req[kRouteId] = id;
+  }
+}
+
+function monitorHttpRoutes() {
+  if (monitor === undefined)
+    monitor = new HttpRouteMonitor();
+  return monitor;
+}
+
+module.exports = monitorHttpRoutes;
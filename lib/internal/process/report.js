@@ -5,6 +5,7 @@ const {
 } = require('internal/errors').codes;
 const {
   validateBoolean,
+  validateFunction,
   validateObject,
   validateSignalName,
   validateString,
@@ -14,7 +15,15 @@ const {
   JSONParse,
 } = primordials;
 const report = {
-  writeReport(file, err) {
+  writeReport(file, err, callback) {
+    if (typeof err === 'function') {
+      callback = err;
+      err = undefined;
+    } else if (typeof file === 'function') {
+      callback = file;
+      file = undefined;
+    }
+
     if (typeof file === 'object' && file !== null) {
       err = file;
       file = undefined;
@@ -26,7 +35,20 @@ const report = {
       validateObject(err, 'err');
     }
 
-    return nr.writeReport('JavaScript API', 'API', file, err);
+    if (callback === undefined)
+      return nr.writeReport('JavaScript API', 'API', file, err);
+
+    validateFunction(callback, 'callback');
+    let result;
+    const req = new nr.ReportWriteWrap();
+    req.oncomplete = (err) => {
+      if (err)
+        callback(err);
+      else
+        callback(null, result);
+    };
+    result = nr.writeReport('JavaScript API', 'API', file, err, req);
+    return result;
   },
   getReport(err) {
     if (err === undefined)
@@ -31,8 +31,9 @@ const {
   emitBefore,
   emitAfter,
   emitDestroy,
-  symbols: { async_id_symbol, trigger_async_id_symbol }
+  symbols: { async_id_symbol, trigger_async_id_symbol, async_context_frame }
 } = require('internal/async_hooks');
+const AsyncContextFrame = require('internal/async_context_frame');
 const FixedQueue = require('internal/fixed_queue');
 
 const {
@@ -71,6 +72,8 @@ function processTicksAndRejections() {
     while (tock = queue.shift()) {
       const asyncId = tock[async_id_symbol];
       emitBefore(asyncId, tock[trigger_async_id_symbol], tock);
+      const priorContextFrame =
+        AsyncContextFrame.exchange(tock[async_context_frame]);
 
       try {
         const callback = tock.callback;
@@ -92,6 +95,7 @@ function processTicksAndRejections() {
       }
 
       emitAfter(asyncId);
+      AsyncContextFrame.set(priorContextFrame);
     }
     runMicrotasks();
   } while (!queue.isEmpty() || processPromiseRejections());
@@ -126,6 +130,7 @@ function nextTick(callback) {
   const tickObject = {
     [async_id_symbol]: asyncId,
     [trigger_async_id_symbol]: triggerAsyncId,
+    [async_context_frame]: AsyncContextFrame.current(),
     callback,
     args
   };
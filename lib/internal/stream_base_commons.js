@@ -242,6 +242,13 @@ function onStreamRead(arrayBuffer) {
   }
 }
 
+function onStreamTimeout() {
+  // Called on the handle when a timeout that was set natively expires.
+  const stream = this[owner_symbol];
+  if (stream !== undefined && !stream.destroyed)
+    stream._onTimeout();
+}
+
 function setStreamTimeout(msecs, callback) {
   if (this.destroyed)
     return this;
@@ -255,13 +262,25 @@ function setStreamTimeout(msecs, callback) {
   //  even if it will be rescheduled we don't want to leak an existing timer.
   clearTimeout(this[kTimeout]);
 
+  // TCP and pipe handles keep track of the timeout natively and refresh it
+  // whenever they read or write, without a JS timer.
+  const handle = this._handle;
+  const native = handle != null && typeof handle.setTimeout === 'function';
+  if (native) {
+    this[kTimeout] = null;
+    if (msecs !== 0 && handle.ontimeout === undefined)
+      handle.ontimeout = onStreamTimeout;
+    handle.setTimeout(msecs);
+  }
+
   if (msecs === 0) {
     if (callback !== undefined) {
       validateCallback(callback);
       this.removeListener('timeout', callback);
     }
   } else {
-    this[kTimeout] = setUnrefTimeout(this._onTimeout.bind(this), msecs);
+    if (!native)
+      this[kTimeout] = setUnrefTimeout(this._onTimeout.bind(this), msecs);
     if (this[kSession]) this[kSession][kUpdateTimer]();
 
     if (callback !== undefined) {
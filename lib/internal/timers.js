@@ -100,7 +100,9 @@ const {
   emitBefore,
   emitAfter,
   emitDestroy,
+  symbols: { async_context_frame },
 } = require('internal/async_hooks');
+const AsyncContextFrame = require('internal/async_context_frame');
 
 // Symbols for storing async id state.
 const async_id_symbol = Symbol('asyncId');
@@ -158,6 +160,7 @@ function initAsyncResource(resource, type) {
   const asyncId = resource[async_id_symbol] = newAsyncId();
   const triggerAsyncId =
     resource[trigger_async_id_symbol] = getDefaultTriggerAsyncId();
+  resource[async_context_frame] = AsyncContextFrame.current();
   if (initHooksExist())
     emitInit(asyncId, type, triggerAsyncId, resource);
 }
@@ -457,6 +460,8 @@ function getTimerCallbacks(runNextTicks) {
 
       const asyncId = immediate[async_id_symbol];
       emitBefore(asyncId, immediate[trigger_async_id_symbol], immediate);
+      const priorContextFrame =
+        AsyncContextFrame.exchange(immediate[async_context_frame]);
 
       try {
         const argv = immediate._argv;
@@ -474,6 +479,7 @@ function getTimerCallbacks(runNextTicks) {
       }
 
       emitAfter(asyncId);
+      AsyncContextFrame.set(priorContextFrame);
     }
 
     if (queue === outstandingQueue)
@@ -546,6 +552,8 @@ function getTimerCallbacks(runNextTicks) {
       }
 
       emitBefore(asyncId, timer[trigger_async_id_symbol], timer);
+      const priorContextFrame =
+        AsyncContextFrame.exchange(timer[async_context_frame]);
 
       let start;
       if (timer._repeat)
@@ -573,6 +581,7 @@ function getTimerCallbacks(runNextTicks) {
       }
 
       emitAfter(asyncId);
+      AsyncContextFrame.set(priorContextFrame);
     }
 
     // If `L.peek(list)` returned nothing, the list was either empty or we have
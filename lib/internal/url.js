@@ -30,6 +30,7 @@ const {
   Symbol,
   SymbolIterator,
   SymbolToStringTag,
+  Uint32Array,
   decodeURIComponent,
 } = primordials;
 
@@ -81,6 +82,7 @@ const {
   encodeAuth,
   toUSVString: _toUSVString,
   parse,
+  parseHref,
   setURLConstructor,
   URL_FLAGS_CANNOT_BE_BASE,
   URL_FLAGS_HAS_FRAGMENT,
@@ -97,7 +99,22 @@ const {
   kPathStart,
   kPort,
   kQuery,
-  kSchemeStart
+  kSchemeStart,
+  kURLComponentFlags,
+  kURLComponentSchemeEnd,
+  kURLComponentUsernameStart,
+  kURLComponentUsernameEnd,
+  kURLComponentPasswordStart,
+  kURLComponentPasswordEnd,
+  kURLComponentHostStart,
+  kURLComponentHostEnd,
+  kURLComponentPort,
+  kURLComponentPathStart,
+  kURLComponentPathEnd,
+  kURLComponentQueryStart,
+  kURLComponentFragmentStart,
+  kURLComponentsCount,
+  kURLComponentOmitted,
 } = internalBinding('url');
 
 const context = Symbol('context');
@@ -138,19 +155,223 @@ function serializeTupleOrigin(scheme, host, port) {
 // and getters. It roughly corresponds to the concept of a URL record in the
 // URL Standard, with a few differences. It is also the object transported to
 // the C++ binding.
+// The record is stored as the serialized URL plus a Uint32Array holding the
+// flags and the offsets of the components within it (see URL_COMPONENTS in
+// src/node_url.h), so that parsing a URL only allocates these two objects.
+// The components are sliced out of the serialized URL lazily, and assigning
+// one re-serializes the URL.
 // Refs: https://url.spec.whatwg.org/#concept-url
 class URLContext {
-  constructor() {
-    this.flags = 0;
-    this.scheme = ':';
-    this.username = '';
-    this.password = '';
-    this.host = null;
-    this.port = null;
-    this.path = [];
-    this.query = null;
-    this.fragment = null;
+  constructor(href, components) {
+    if (href === undefined) {
+      this.href = '';
+      this.components = new Uint32Array(kURLComponentsCount);
+      serializeContext(this, 0, ':', '', '', null, null, [], null, null);
+    } else {
+      this.href = href;
+      this.components = components;
+    }
+  }
+
+  get flags() {
+    return this.components[kURLComponentFlags];
+  }
+
+  set flags(flags) {
+    this.components[kURLComponentFlags] = flags;
+  }
+
+  get scheme() {
+    return StringPrototypeSlice(this.href, 0,
+                                this.components[kURLComponentSchemeEnd]);
+  }
+
+  set scheme(scheme) {
+    serializeContext(this, this.flags, scheme, this.username, this.password,
+                     this.host, this.port, this.path, this.query,
+                     this.fragment);
+  }
+
+  get username() {
+    const components = this.components;
+    return StringPrototypeSlice(this.href,
+                                components[kURLComponentUsernameStart],
+                                components[kURLComponentUsernameEnd]);
+  }
+
+  set username(username) {
+    serializeContext(this, this.flags, this.scheme, username, this.password,
+                     this.host, this.port, this.path, this.query,
+                     this.fragment);
+  }
+
+  get password() {
+    const components = this.components;
+    return StringPrototypeSlice(this.href,
+                                components[kURLComponentPasswordStart],
+                                components[kURLComponentPasswordEnd]);
+  }
+
+  set password(password) {
+    serializeContext(this, this.flags, this.scheme, this.username, password,
+                     this.host, this.port, this.path, this.query,
+                     this.fragment);
+  }
+
+  get host() {
+    const components = this.components;
+    const start = components[kURLComponentHostStart];
+    if (start === kURLComponentOmitted)
+      return null;
+    return StringPrototypeSlice(this.href, start,
+                                components[kURLComponentHostEnd]);
+  }
+
+  set host(host) {
+    serializeContext(this, this.flags, this.scheme, this.username,
+                     this.password, host, this.port, this.path, this.query,
+                     this.fragment);
+  }
+
+  get port() {
+    const port = this.components[kURLComponentPort];
+    return port === kURLComponentOmitted ? null : port;
+  }
+
+  set port(port) {
+    serializeContext(this, this.flags, this.scheme, this.username,
+                     this.password, this.host, port, this.path, this.query,
+                     this.fragment);
+  }
+
+  get path() {
+    const components = this.components;
+    const start = components[kURLComponentPathStart];
+    const end = components[kURLComponentPathEnd];
+    if ((components[kURLComponentFlags] & URL_FLAGS_CANNOT_BE_BASE) !== 0)
+      return [StringPrototypeSlice(this.href, start, end)];
+    if (start === end)
+      return [];
+    return StringPrototypeSplit(
+      StringPrototypeSlice(this.href, start + 1, end), '/');
   }
+
+  set path(path) {
+    serializeContext(this, this.flags, this.scheme, this.username,
+                     this.password, this.host, this.port, path, this.query,
+                     this.fragment);
+  }
+
+  get query() {
+    const components = this.components;
+    const start = components[kURLComponentQueryStart];
+    if (start === kURLComponentOmitted)
+      return null;
+    const fragmentStart = components[kURLComponentFragmentStart];
+    return StringPrototypeSlice(
+      this.href, start,
+      fragmentStart === kURLComponentOmitted ? undefined : fragmentStart - 1);
+  }
+
+  set query(query) {
+    serializeContext(this, this.flags, this.scheme, this.username,
+                     this.password, this.host, this.port, this.path, query,
+                     this.fragment);
+  }
+
+  get fragment() {
+    const start = this.components[kURLComponentFragmentStart];
+    if (start === kURLComponentOmitted)
+      return null;
+    return StringPrototypeSlice(this.href, start);
+  }
+
+  set fragment(fragment) {
+    serializeContext(this, this.flags, this.scheme, this.username,
+                     this.password, this.host, this.port, this.path,
+                     this.query, fragment);
+  }
+
+  // Show the URL record rather than the offsets.
+  [inspect.custom](depth, opts) {
+    const obj = ObjectCreate({ constructor: URLContext });
+    obj.flags = this.flags;
+    obj.scheme = this.scheme;
+    obj.username = this.username;
+    obj.password = this.password;
+    obj.host = this.host;
+    obj.port = this.port;
+    obj.path = this.path;
+    obj.query = this.query;
+    obj.fragment = this.fragment;
+    return obj;
+  }
+}
+
+// Serializes the URL record into ctx.href and stores the offsets of the
+// components in ctx.components, like URL::SerializeURL() in C++ does.
+// Refs: https://url.spec.whatwg.org/#url-serializing
+function serializeContext(ctx, flags, scheme, username, password, host, port,
+                          path, query, fragment) {
+  const components = ctx.components;
+  components[kURLComponentFlags] = flags;
+  let href = scheme;
+  components[kURLComponentSchemeEnd] = href.length;
+  if (host !== null)
+    href += '//';
+  components[kURLComponentUsernameStart] = href.length;
+  if (host !== null && (username !== '' || password !== '')) {
+    href += username;
+    components[kURLComponentUsernameEnd] = href.length;
+    if (password !== '')
+      href += ':';
+    components[kURLComponentPasswordStart] = href.length;
+    href += password;
+    components[kURLComponentPasswordEnd] = href.length;
+    href += '@';
+  } else {
+    components[kURLComponentUsernameEnd] = href.length;
+    components[kURLComponentPasswordStart] = href.length;
+    components[kURLComponentPasswordEnd] = href.length;
+  }
+  if (host !== null) {
+    components[kURLComponentHostStart] = href.length;
+    href += host;
+    components[kURLComponentHostEnd] = href.length;
+    if (port !== null)
+      href += `:${port}`;
+  } else {
+    components[kURLComponentHostStart] = kURLComponentOmitted;
+    components[kURLComponentHostEnd] = kURLComponentOmitted;
+  }
+  components[kURLComponentPort] = port === null ? kURLComponentOmitted : port;
+  if ((flags & URL_FLAGS_CANNOT_BE_BASE) !== 0) {
+    components[kURLComponentPathStart] = href.length;
+    if (path.length > 0)
+      href += path[0];
+  } else {
+    if (host === null && path.length > 1 && path[0] === '')
+      href += '/.';
+    components[kURLComponentPathStart] = href.length;
+    if (path.length > 0)
+      href += `/${ArrayPrototypeJoin(path, '/')}`;
+  }
+  components[kURLComponentPathEnd] = href.length;
+  if (query !== null) {
+    href += '?';
+    components[kURLComponentQueryStart] = href.length;
+    href += query;
+  } else {
+    components[kURLComponentQueryStart] = kURLComponentOmitted;
+  }
+  if (fragment !== null) {
+    href += '#';
+    components[kURLComponentFragmentStart] = href.length;
+    href += fragment;
+  } else {
+    components[kURLComponentFragmentStart] = kURLComponentOmitted;
+  }
+  ctx.href = href;
 }
 
 class URLSearchParams {
@@ -513,27 +734,24 @@ ObjectDefineProperties(URLSearchParams.prototype, {
   },
 });
 
-function onParseComplete(flags, protocol, username, password,
-                         host, port, path, query, fragment) {
-  const ctx = this[context];
-  ctx.flags = flags;
-  ctx.scheme = protocol;
-  ctx.username = (flags & URL_FLAGS_HAS_USERNAME) !== 0 ? username : '';
-  ctx.password = (flags & URL_FLAGS_HAS_PASSWORD) !== 0 ? password : '';
-  ctx.port = port;
-  ctx.path = (flags & URL_FLAGS_HAS_PATH) !== 0 ? path : [];
-  ctx.query = query;
-  ctx.fragment = fragment;
-  ctx.host = host;
-  if (!this[searchParams]) { // Invoked from URL constructor
-    this[searchParams] = new URLSearchParams();
-    this[searchParams][context] = this;
-  }
-  initSearchParams(this[searchParams], query);
-}
-
-function onParseError(flags, input) {
-  throw new ERR_INVALID_URL(input);
+// Parses the input into the URL object, or throws if it is invalid.
+function parseInto(url, input, base) {
+  const components = new Uint32Array(kURLComponentsCount);
+  const href = parseHref(input, base, components);
+  if (href === undefined) {
+    if (base !== undefined &&
+        parseHref(base, undefined, components) === undefined) {
+      throw new ERR_INVALID_URL(base);
+    }
+    throw new ERR_INVALID_URL(input);
+  }
+  url[context] = new URLContext(href, components);
+  const query = url[context].query;
+  if (!url[searchParams]) { // Invoked from URL constructor
+    url[searchParams] = new URLSearchParams();
+    url[searchParams][context] = url;
+  }
+  initSearchParams(url[searchParams], query);
 }
 
 function onParseProtocolComplete(flags, protocol, username, password,
@@ -604,13 +822,10 @@ class URL {
   constructor(input, base) {
     // toUSVString is not needed.
     input = `${input}`;
-    let base_context;
     if (base !== undefined) {
-      base_context = new URL(base)[context];
+      base = `${base}`;
     }
-    this[context] = new URLContext();
-    parse(input, -1, base_context, undefined,
-          FunctionPrototypeBind(onParseComplete, this), onParseError);
+    parseInto(this, input, base);
   }
 
   get [special]() {
@@ -712,18 +927,17 @@ class URL {
 
   // https://heycam.github.io/webidl/#es-stringifier
   toString() {
-    return this[kFormat]({});
+    return this[context].href;
   }
 
   get href() {
-    return this[kFormat]({});
+    return this[context].href;
   }
 
   set href(input) {
     // toUSVString is not needed.
     input = `${input}`;
-    parse(input, -1, undefined, undefined,
-          FunctionPrototypeBind(onParseComplete, this), onParseError);
+    parseInto(this, input, undefined);
   }
 
   // readonly
@@ -928,7 +1142,7 @@ class URL {
   }
 
   toJSON() {
-    return this[kFormat]({});
+    return this[context].href;
   }
 }
 
@@ -1454,16 +1668,18 @@ function toPathIfFileURL(fileURLOrPath) {
 
 function constructUrl(flags, protocol, username, password,
                       host, port, path, query, fragment) {
-  const ctx = new URLContext();
-  ctx.flags = flags;
-  ctx.scheme = protocol;
-  ctx.username = (flags & URL_FLAGS_HAS_USERNAME) !== 0 ? username : '';
-  ctx.password = (flags & URL_FLAGS_HAS_PASSWORD) !== 0 ? password : '';
-  ctx.port = port;
-  ctx.path = (flags & URL_FLAGS_HAS_PATH) !== 0 ? path : [];
-  ctx.query = query;
-  ctx.fragment = fragment;
-  ctx.host = host;
+  const ctx = new URLContext('', new Uint32Array(kURLComponentsCount));
+  serializeContext(
+    ctx,
+    flags,
+    protocol,
+    (flags & URL_FLAGS_HAS_USERNAME) !== 0 ? username : '',
+    (flags & URL_FLAGS_HAS_PASSWORD) !== 0 ? password : '',
+    host,
+    port,
+    (flags & URL_FLAGS_HAS_PATH) !== 0 ? path : [],
+    query,
+    fragment);
 
   const url = ObjectCreate(URL.prototype);
   url[context] = ctx;
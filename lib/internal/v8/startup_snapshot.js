@@ -0,0 +1,99 @@
+'use strict';
+
+const {
+  ArrayPrototypePush,
+  ArrayPrototypeShift,
+  globalThis,
+} = primordials;
+
+const {
+  validateFunction,
+} = require('internal/validators');
+const {
+  ERR_NOT_BUILDING_SNAPSHOT,
+  ERR_DUPLICATE_STARTUP_SNAPSHOT_MAIN_FUNCTION,
+} = require('internal/errors').codes;
+
+const {
+  setSerializeCallback,
+  setDeserializeMainFunction: _setDeserializeMainFunction,
+} = internalBinding('mksnapshot');
+
+function isBuildingSnapshot() {
+  // For now this is the only way to build a snapshot.
+  return require('internal/options').getOptionValue('--build-snapshot');
+}
+
+function throwIfNotBuildingSnapshot() {
+  if (!isBuildingSnapshot()) {
+    throw new ERR_NOT_BUILDING_SNAPSHOT();
+  }
+}
+
+const deserializeCallbacks = [];
+function runDeserializeCallbacks() {
+  while (deserializeCallbacks.length > 0) {
+    const { 0: callback, 1: data } = ArrayPrototypeShift(deserializeCallbacks);
+    callback(data);
+  }
+}
+
+function addDeserializeCallback(callback, data) {
+  throwIfNotBuildingSnapshot();
+  validateFunction(callback, 'callback');
+  ArrayPrototypePush(deserializeCallbacks, [callback, data]);
+}
+
+const serializeCallbacks = [];
+function runSerializeCallbacks() {
+  while (serializeCallbacks.length > 0) {
+    const { 0: callback, 1: data } = ArrayPrototypeShift(serializeCallbacks);
+    callback(data);
+  }
+  // The stdio handles are closed before the heap gets serialized, so drop
+  // the cached streams and let them be re-created on first access after
+  // deserialization.
+  internalBinding('process_methods').resetStdioForTesting();
+  const { kBindStreamsLazy } = require('internal/console/constructor');
+  globalThis.console[kBindStreamsLazy](process);
+}
+
+function addSerializeCallback(callback, data) {
+  throwIfNotBuildingSnapshot();
+  validateFunction(callback, 'callback');
+  ArrayPrototypePush(serializeCallbacks, [callback, data]);
+}
+
+let deserializeMainIsSet = false;
+function setDeserializeMainFunction(callback, data) {
+  throwIfNotBuildingSnapshot();
+  validateFunction(callback, 'callback');
+  if (deserializeMainIsSet) {
+    throw new ERR_DUPLICATE_STARTUP_SNAPSHOT_MAIN_FUNCTION();
+  }
+  deserializeMainIsSet = true;
+
+  _setDeserializeMainFunction(function deserializeMain(markBootstrapComplete) {
+    const {
+      prepareMainThreadExecution
+    } = require('internal/bootstrap/pre_execution');
+
+    // This should be in sync with run_main_module.js until we make that
+    // a built-in main function.
+    prepareMainThreadExecution(false);
+    markBootstrapComplete();
+    callback(data);
+  });
+}
+
+setSerializeCallback(runSerializeCallbacks);
+
+module.exports = {
+  runDeserializeCallbacks,
+  namespace: {
+    addSerializeCallback,
+    addDeserializeCallback,
+    setDeserializeMainFunction,
+    isBuildingSnapshot
+  }
+};
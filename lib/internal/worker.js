@@ -82,6 +82,10 @@ const kOnErrorMessage = Symbol('kOnErrorMessage');
 const kParentSideStdio = Symbol('kParentSideStdio');
 const kLoopStartTime = Symbol('kLoopStartTime');
 const kIsOnline = Symbol('kIsOnline');
+// Option used by WorkerPool to hand its task queue to the worker.
+const kWorkerPoolHandle = Symbol('kWorkerPoolHandle');
+// Emitted once the script of a WorkerPool's worker has been loaded.
+const kPoolWorkerLoaded = Symbol('kPoolWorkerLoaded');
 
 const SHARE_ENV = SymbolFor('nodejs.worker_threads.SHARE_ENV');
 let debug = require('internal/util/debuglog').debuglog('worker', (fn) => {
@@ -249,6 +253,7 @@ class Worker extends EventEmitter {
       cwdCounter: cwdCounter || workerIo.sharedCwdCounter,
       workerData: options.workerData,
       environmentData,
+      poolHandle: options[kWorkerPoolHandle],
       publicPort: port2,
       manifestURL: getOptionValue('--experimental-policy') ?
         require('internal/process/policy').url :
@@ -316,6 +321,8 @@ class Worker extends EventEmitter {
         });
         return;
       }
+      case messageTypes.POOL_WORKER_LOADED:
+        return this.emit(kPoolWorkerLoaded);
       case messageTypes.STDIO_WANTS_MORE_DATA:
       {
         const { stream } = message;
@@ -521,4 +528,6 @@ module.exports = {
   assignEnvironmentData,
   threadId,
   Worker,
+  kPoolWorkerLoaded,
+  kWorkerPoolHandle,
 };
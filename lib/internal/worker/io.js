@@ -81,7 +81,8 @@ const messageTypes = {
   ERROR_MESSAGE: 'errorMessage',
   STDIO_PAYLOAD: 'stdioPayload',
   STDIO_WANTS_MORE_DATA: 'stdioWantsMoreData',
-  LOAD_SCRIPT: 'loadScript'
+  LOAD_SCRIPT: 'loadScript',
+  POOL_WORKER_LOADED: 'poolWorkerLoaded'
 };
 
 // We have to mess with the MessagePort prototype a bit, so that a) we can make
@@ -0,0 +1,250 @@
+'use strict';
+
+const {
+  ArrayFrom,
+  ArrayPrototypeMap,
+  PromiseAll,
+  PromisePrototypeThen,
+  PromiseReject,
+  SafeArrayIterator,
+  SafeMap,
+  SafeSet,
+  Symbol,
+} = primordials;
+
+const EventEmitter = require('events');
+const {
+  WorkerPoolHandle,
+  kTaskFulfilled,
+  kTaskRejected,
+} = internalBinding('worker');
+const {
+  ERR_INVALID_URL_SCHEME,
+  ERR_WORKER_NOT_RUNNING,
+} = require('internal/errors').codes;
+const { isURLInstance } = require('internal/url');
+const { createDeferredPromise } = require('internal/util');
+const { isPromise } = require('internal/util/types');
+const {
+  validateArray,
+  validateFunction,
+  validateObject,
+  validateUint32,
+} = require('internal/validators');
+const {
+  Worker,
+  kPoolWorkerLoaded,
+  kWorkerPoolHandle,
+} = require('internal/worker');
+
+const kHandle = Symbol('kHandle');
+const kFilename = Symbol('kFilename');
+const kWorkerOptions = Symbol('kWorkerOptions');
+const kWorkers = Symbol('kWorkers');
+const kTasks = Symbol('kTasks');
+const kClosing = Symbol('kClosing');
+const kStartWorker = Symbol('kStartWorker');
+const kOnComplete = Symbol('kOnComplete');
+const kOnWorkerExit = Symbol('kOnWorkerExit');
+const kFinishClose = Symbol('kFinishClose');
+
+class WorkerPool extends EventEmitter {
+  constructor(filename, options = {}) {
+    super();
+    if (isURLInstance(filename) && filename.protocol !== 'file:')
+      throw new ERR_INVALID_URL_SCHEME('file');
+    validateObject(options, 'options');
+    let { size } = options;
+    if (size === undefined)
+      size = require('os').cpus().length || 1;
+    else
+      validateUint32(size, 'options.size', true);
+
+    this[kFilename] = filename;
+    this[kWorkerOptions] = {
+      env: options.env,
+      execArgv: options.execArgv,
+      resourceLimits: options.resourceLimits,
+      workerData: options.workerData,
+    };
+    this[kWorkers] = new SafeSet();
+    // Maps the ids of the tasks that have not settled yet to their deferred
+    // promises.
+    this[kTasks] = new SafeMap();
+    this[kClosing] = null;
+    this[kHandle] = new WorkerPoolHandle();
+    this[kHandle].oncomplete = (results) => this[kOnComplete](results);
+
+    for (let i = 0; i < size; i++)
+      this[kStartWorker]();
+  }
+
+  get size() {
+    return this[kWorkers].size;
+  }
+
+  run(task, options = {}) {
+    validateObject(options, 'options');
+    const { transferList } = options;
+    if (transferList !== undefined)
+      validateArray(transferList, 'options.transferList');
+    if (this[kClosing] !== null)
+      return PromiseReject(new ERR_WORKER_NOT_RUNNING());
+
+    let id;
+    try {
+      id = this[kHandle].post(task, transferList);
+    } catch (err) {
+      return PromiseReject(err);
+    }
+    const deferred = createDeferredPromise();
+    this[kTasks].set(id, deferred);
+    // The pool keeps the event loop alive only while there are tasks to
+    // wait for.
+    if (this[kTasks].size === 1)
+      this[kHandle].ref();
+    return deferred.promise;
+  }
+
+  close() {
+    if (this[kClosing] === null) {
+      this[kClosing] = createDeferredPromise();
+      if (this[kTasks].size === 0)
+        this[kFinishClose]();
+    }
+    return this[kClosing].promise;
+  }
+
+  [kStartWorker]() {
+    const worker = new Worker(this[kFilename], {
+      ...this[kWorkerOptions],
+      [kWorkerPoolHandle]: this[kHandle],
+    });
+    let loaded = false;
+    worker.unref();
+    worker.once(kPoolWorkerLoaded, () => loaded = true);
+    worker.on('error', (err) => this.emit('error', err));
+    worker.on('exit', () => this[kOnWorkerExit](worker, loaded));
+    this[kWorkers].add(worker);
+  }
+
+  [kOnWorkerExit](worker, loaded) {
+    this[kWorkers].delete(worker);
+    if (this[kClosing] !== null)
+      return;
+    // A worker that exits after its script has been loaded is replaced,
+    // whether it failed or not. One that exits before is not, so that a
+    // script that cannot be loaded does not restart workers forever.
+    if (loaded) {
+      this[kStartWorker]();
+      return;
+    }
+    if (this[kWorkers].size > 0)
+      return;
+    // There is no worker left to run the tasks.
+    this[kClosing] = createDeferredPromise();
+    for (const { reject } of this[kTasks].values())
+      reject(new ERR_WORKER_NOT_RUNNING());
+    this[kTasks].clear();
+    this[kFinishClose]();
+  }
+
+  [kOnComplete](results) {
+    const tasks = this[kTasks];
+    for (let i = 0; i < results.length; i += 3) {
+      const deferred = tasks.get(results[i]);
+      if (deferred === undefined)
+        continue;
+      tasks.delete(results[i]);
+      const status = results[i + 1];
+      if (status === kTaskFulfilled)
+        deferred.resolve(results[i + 2]);
+      else if (status === kTaskRejected)
+        deferred.reject(results[i + 2]);
+      else
+        deferred.reject(new ERR_WORKER_NOT_RUNNING());
+    }
+    if (tasks.size === 0) {
+      this[kHandle].unref();
+      if (this[kClosing] !== null)
+        this[kFinishClose]();
+    }
+  }
+
+  [kFinishClose]() {
+    this[kHandle].close();
+    const workers = ArrayFrom(this[kWorkers]);
+    const terminated = ArrayPrototypeMap(workers, (worker) => {
+      // Keep the event loop alive until the workers have exited.
+      worker.ref();
+      return worker.terminate();
+    });
+    PromisePrototypeThen(PromiseAll(new SafeArrayIterator(terminated)),
+                         () => this[kClosing].resolve());
+  }
+}
+
+// Runs the tasks of a pool in one of its workers, with the default export of
+// the worker's script. `onLoaded` is called once the script has been loaded.
+function runPoolWorker(handle, filename, onLoaded) {
+  const { loadESM } = require('internal/process/esm_loader');
+  const { pathToFileURL } = require('internal/url');
+
+  loadESM(async (loader) => {
+    const namespace = await loader.import(pathToFileURL(filename).href);
+    const handler = namespace.default;
+    validateFunction(handler, 'default export');
+
+    function complete(id, fulfilled, value) {
+      try {
+        handle.complete(id, fulfilled, value);
+      } catch (err) {
+        // The value could not be cloned, the task is rejected with the error
+        // for that instead.
+        handle.complete(id, false, err);
+      }
+    }
+
+    let running = false;
+    function drain() {
+      if (running)
+        return;
+      running = true;
+      let task;
+      while ((task = handle.receive()) !== undefined) {
+        const { 0: id, 1: value } = task;
+        let result;
+        try {
+          result = handler(value);
+        } catch (err) {
+          complete(id, false, err);
+          continue;
+        }
+        if (isPromise(result)) {
+          // Tasks are run one at a time, the next one is taken once this
+          // one has settled.
+          const next = (fulfilled, settled) => {
+            complete(id, fulfilled, settled);
+            running = false;
+            drain();
+          };
+          PromisePrototypeThen(result,
+                               (settled) => next(true, settled),
+                               (err) => next(false, err));
+          return;
+        }
+        complete(id, true, result);
+      }
+      running = false;
+    }
+
+    handle.onwork = drain;
+    onLoaded();
+    drain();
+  });
+}
+
+module.exports = {
+  WorkerPool,
+  runPoolWorker,
+};
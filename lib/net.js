@@ -26,6 +26,7 @@ const {
   ArrayPrototypeIndexOf,
   Boolean,
   Error,
+  FunctionPrototypeCall,
   Number,
   NumberIsNaN,
   NumberParseInt,
@@ -102,6 +103,7 @@ const {
 const { isUint8Array } = require('internal/util/types');
 const {
   validateAbortSignal,
+  validateBoolean,
   validateFunction,
   validateInt32,
   validateNumber,
@@ -109,6 +111,8 @@ const {
   validateString
 } = require('internal/validators');
 const kLastWriteQueueSize = Symbol('lastWriteQueueSize');
+const kAcceptBatch = Symbol('kAcceptBatch');
+const kBlockList = Symbol('kBlockList');
 const {
   DTRACE_NET_SERVER_CONNECTION,
   DTRACE_NET_STREAM_END
@@ -118,6 +122,7 @@ const {
 let cluster;
 let dns;
 let BlockList;
+let BlockListHandle;
 let SocketAddress;
 
 const { clearTimeout } = require('timers');
@@ -130,8 +135,11 @@ const isWindows = process.platform === 'win32';
 
 const noop = () => {};
 
-function getFlags(ipv6Only) {
-  return ipv6Only === true ? TCPConstants.UV_TCP_IPV6ONLY : 0;
+function getFlags(ipv6Only, reusePort) {
+  let flags = ipv6Only === true ? TCPConstants.UV_TCP_IPV6ONLY : 0;
+  if (reusePort === true)
+    flags |= TCPConstants.TCP_REUSEPORT;
+  return flags;
 }
 
 function createHandle(fd, is_server) {
@@ -393,9 +401,20 @@ Socket.prototype._unrefTimer = function _unrefTimer() {
   for (let s = this; s !== null; s = s._parent) {
     if (s[kTimeout])
       s[kTimeout].refresh();
+    else if (s.timeout && s._handle?.refreshTimeout !== undefined)
+      s._handle.refreshTimeout();
   }
 };
 
+// Like _unrefTimer(), but leaves out timeouts that are kept natively by the
+// handle, which refreshes them by itself on every read and write.
+function refreshJSTimers() {
+  for (let s = this; s !== null; s = s._parent) {
+    if (s[kTimeout])
+      s[kTimeout].refresh();
+  }
+}
+
 
 // The user has called .end(), and all the bytes have been
 // sent out to the other side.
@@ -495,6 +514,32 @@ Socket.prototype.setNoDelay = function(enable) {
 };
 
 
+Socket.prototype.setWriteCoalescing = function(enable = true) {
+  validateBoolean(enable, 'enable');
+
+  if (!this._handle) {
+    this.once('connect', () => this.setWriteCoalescing(enable));
+    return this;
+  }
+
+  if (this._handle.setWriteCoalescing) {
+    // Errors from writing out coalesced data after the writes themselves have
+    // completed are reported through `onerror`.
+    this._handle.onerror = onCoalescedWriteError;
+    const err = this._handle.setWriteCoalescing(enable);
+    if (err)
+      this.destroy(errnoException(err, 'write'));
+  }
+
+  return this;
+};
+
+
+function onCoalescedWriteError(status) {
+  this[owner_symbol].destroy(errnoException(status, 'write'));
+}
+
+
 Socket.prototype.setKeepAlive = function(setting, msecs) {
   if (!this._handle) {
     this.once('connect', () => this.setKeepAlive(setting, msecs));
@@ -553,7 +598,7 @@ ObjectDefineProperty(Socket.prototype, 'bufferSize', {
 
 ObjectDefineProperty(Socket.prototype, kUpdateTimer, {
   get: function() {
-    return this._unrefTimer;
+    return refreshJSTimers;
   }
 });
 
@@ -1189,6 +1234,20 @@ function Server(options, connectionListener) {
 
   this.allowHalfOpen = options.allowHalfOpen || false;
   this.pauseOnConnect = !!options.pauseOnConnect;
+
+  if (options.acceptBatch !== undefined)
+    validateBoolean(options.acceptBatch, 'options.acceptBatch');
+  this[kAcceptBatch] = options.acceptBatch === true;
+
+  if (options.blockList !== undefined) {
+    BlockList ??= require('internal/blocklist').BlockList;
+    if (!(options.blockList instanceof BlockList)) {
+      throw new ERR_INVALID_ARG_TYPE('options.blockList',
+                                     'net.BlockList',
+                                     options.blockList);
+    }
+  }
+  this[kBlockList] = options.blockList;
 }
 ObjectSetPrototypeOf(Server.prototype, EventEmitter.prototype);
 ObjectSetPrototypeOf(Server, EventEmitter);
@@ -1238,12 +1297,13 @@ function createServerHandle(address, port, addressType, fd, flags) {
       if (err) {
         handle.close();
         // Fallback to ipv4
-        return createServerHandle(DEFAULT_IPV4_ADDR, port);
+        return createServerHandle(DEFAULT_IPV4_ADDR, port, 4, undefined,
+                                  flags);
       }
     } else if (addressType === 6) {
       err = handle.bind6(address, port, flags);
     } else {
-      err = handle.bind(address, port);
+      err = handle.bind(address, port, flags);
     }
   }
 
@@ -1296,6 +1356,18 @@ function setupListenHandle(address, port, addressType, backlog, fd, flags) {
   this._handle.onconnection = onconnection;
   this._handle[owner_symbol] = this;
 
+  // Handles that are shared by the cluster primary in round-robin mode and
+  // pipes do not accept connections natively, so these options do not apply.
+  if (this[kAcceptBatch] && typeof this._handle.setAcceptBatch === 'function') {
+    this._handle.setAcceptBatch(true);
+    this._handle.onconnection = onconnections;
+  }
+  if (this[kBlockList] !== undefined &&
+      typeof this._handle.setBlockList === 'function') {
+    BlockListHandle ??= require('internal/blocklist').kHandle;
+    this._handle.setBlockList(this[kBlockList][BlockListHandle]);
+  }
+
   // Use a backlog of 512 entries. We pass 511 to the listen() call because
   // the kernel does: backlogsize = roundup_pow_of_two(backlogsize + 1);
   // which will thus give us a backlog of 512 entries.
@@ -1400,7 +1472,12 @@ Server.prototype.listen = function(...args) {
     toNumber(args.length > 2 && args[2]);  // (port, host, backlog)
 
   options = options._handle || options.handle || options;
-  const flags = getFlags(options.ipv6Only);
+  if (options.reusePort !== undefined)
+    validateBoolean(options.reusePort, 'options.reusePort');
+  const flags = getFlags(options.ipv6Only, options.reusePort);
+  // Each server that uses SO_REUSEPORT binds its own socket, even in cluster
+  // workers, and the kernel distributes the connections between them.
+  const exclusive = options.exclusive || options.reusePort === true;
   // (handle[, backlog][, cb]) where handle is an object with a handle
   if (options instanceof TCP) {
     this._handle = options;
@@ -1434,11 +1511,12 @@ Server.prototype.listen = function(...args) {
     // start TCP server listening on host:port
     if (options.host) {
       lookupAndListen(this, options.port | 0, options.host, backlog,
-                      options.exclusive, flags);
+                      exclusive, flags);
     } else { // Undefined host, listens on unspecified address
       // Default addressType 4 will be used to search for primary server
       listenInCluster(this, null, options.port | 0, 4,
-                      backlog, undefined, options.exclusive);
+                      backlog, undefined, exclusive,
+                      flags & TCPConstants.TCP_REUSEPORT);
     }
     return this;
   }
@@ -1548,6 +1626,19 @@ function onconnection(err, clientHandle) {
   self.emit('connection', socket);
 }
 
+// Used instead of onconnection() when the acceptBatch option is set, in which
+// case all of the connections accepted in one event loop iteration are
+// passed at once.
+function onconnections(err, clientHandles) {
+  if (err) {
+    FunctionPrototypeCall(onconnection, this, err);
+    return;
+  }
+
+  for (let i = 0; i < clientHandles.length; i++)
+    FunctionPrototypeCall(onconnection, this, err, clientHandles[i]);
+}
+
 
 Server.prototype.getConnections = function(cb) {
   const self = this;
@@ -30,11 +30,15 @@ const {
 } = require('internal/perf/usertiming');
 
 const {
-  createHistogram
+  createHistogram,
+  importHistogram,
 } = require('internal/histogram');
 
 const eventLoopUtilization = require('internal/perf/event_loop_utilization');
 const monitorEventLoopDelay = require('internal/perf/event_loop_delay');
+const monitorEventLoopPhases = require('internal/perf/event_loop_phases');
+const monitorEventLoopStalls = require('internal/perf/event_loop_stall');
+const monitorHttpRoutes = require('internal/perf/http_routes');
 const nodeTiming = require('internal/perf/nodetiming');
 const timerify = require('internal/perf/timerify');
 const { customInspectSymbol: kInspect } = require('internal/util');
@@ -127,7 +131,11 @@ module.exports = {
   PerformanceMark,
   PerformanceObserver,
   monitorEventLoopDelay,
+  monitorEventLoopPhases,
+  monitorEventLoopStalls,
+  monitorHttpRoutes,
   createHistogram,
+  importHistogram,
   performance: new InternalPerformance(),
 };
 
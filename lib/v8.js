@@ -35,7 +35,13 @@ const {
 } = primordials;
 
 const { Buffer } = require('buffer');
-const { validateString } = require('internal/validators');
+const {
+  validateBoolean,
+  validateFunction,
+  validateInt32,
+  validateObject,
+  validateString,
+} = require('internal/validators');
 const {
   Serializer,
   Deserializer
@@ -53,17 +59,53 @@ const { FastBuffer } = require('internal/buffer');
 const { getValidatedPath } = require('internal/fs/utils');
 const { toNamespacedPath } = require('path');
 const {
+  HeapSnapshotWriteWrap,
   createHeapSnapshotStream,
   triggerHeapSnapshot
 } = internalBinding('heap_utils');
-const { HeapSnapshotStream } = require('internal/heap_utils');
-
-function writeHeapSnapshot(filename) {
+const {
+  HeapSnapshotStream,
+  startSamplingHeapProfiler,
+  stopSamplingHeapProfiler,
+  writeHeapProfile,
+} = require('internal/heap_utils');
+const {
+  namespace: startupSnapshot
+} = require('internal/v8/startup_snapshot');
+
+function writeHeapSnapshot(filename, options = {}, callback) {
+  if (typeof filename === 'function') {
+    callback = filename;
+    filename = undefined;
+  } else if (typeof options === 'function') {
+    callback = options;
+    options = {};
+  }
   if (filename !== undefined) {
     filename = getValidatedPath(filename);
     filename = toNamespacedPath(filename);
   }
-  return triggerHeapSnapshot(filename);
+  validateObject(options, 'options');
+  const { compress = false, maxStringLength } = options;
+  validateBoolean(compress, 'options.compress');
+  if (maxStringLength !== undefined)
+    validateInt32(maxStringLength, 'options.maxStringLength', 0);
+
+  let req;
+  let result;
+  if (callback !== undefined) {
+    validateFunction(callback, 'callback');
+    req = new HeapSnapshotWriteWrap();
+    req.oncomplete = (err) => {
+      if (err)
+        callback(err);
+      else
+        callback(null, result);
+    };
+  }
+
+  result = triggerHeapSnapshot(filename, compress, req, maxStringLength);
+  return result;
 }
 
 function getHeapSnapshot() {
@@ -282,5 +324,9 @@ module.exports = {
   takeCoverage: profiler.takeCoverage,
   stopCoverage: profiler.stopCoverage,
   serialize,
+  startSamplingHeapProfiler,
+  stopSamplingHeapProfiler,
+  writeHeapProfile,
   writeHeapSnapshot,
+  startupSnapshot,
 };
@@ -18,6 +18,10 @@ const {
   BroadcastChannel,
 } = require('internal/worker/io');
 
+const {
+  WorkerPool,
+} = require('internal/worker/pool');
+
 const {
   markAsUntransferable,
 } = require('internal/buffer');
@@ -33,6 +37,7 @@ module.exports = {
   threadId,
   SHARE_ENV,
   Worker,
+  WorkerPool,
   parentPort: null,
   workerData: null,
   BroadcastChannel,
@@ -107,7 +107,9 @@
       'lib/internal/assert.js',
       'lib/internal/assert/assertion_error.js',
       'lib/internal/assert/calltracker.js',
+      'lib/internal/async_context_frame.js',
       'lib/internal/async_hooks.js',
+      'lib/internal/async_local_storage/async_context_frame.js',
       'lib/internal/blob.js',
       'lib/internal/blocklist.js',
       'lib/internal/buffer.js',
@@ -177,6 +179,7 @@
       'lib/internal/main/eval_string.js',
       'lib/internal/main/eval_stdin.js',
       'lib/internal/main/inspect.js',
+      'lib/internal/main/mksnapshot.js',
       'lib/internal/main/print_help.js',
       'lib/internal/main/prof_process.js',
       'lib/internal/main/repl.js',
@@ -202,6 +205,9 @@
       'lib/internal/perf/usertiming.js',
       'lib/internal/perf/observe.js',
       'lib/internal/perf/event_loop_delay.js',
+      'lib/internal/perf/event_loop_phases.js',
+      'lib/internal/perf/event_loop_stall.js',
+      'lib/internal/perf/http_routes.js',
       'lib/internal/perf/event_loop_utilization.js',
       'lib/internal/perf/timerify.js',
       'lib/internal/policy/manifest.js',
@@ -247,6 +253,7 @@
       'lib/internal/http2/core.js',
       'lib/internal/http2/compat.js',
       'lib/internal/http2/util.js',
+      'lib/internal/v8/startup_snapshot.js',
       'lib/internal/v8_prof_polyfill.js',
       'lib/internal/v8_prof_processor.js',
       'lib/internal/validators.js',
@@ -255,6 +262,7 @@
       'lib/internal/worker.js',
       'lib/internal/worker/io.js',
       'lib/internal/worker/js_transferable.js',
+      'lib/internal/worker/pool.js',
       'lib/internal/watchdog.js',
       'lib/internal/streams/lazy_transform.js',
       'lib/internal/streams/add-abort-signal.js',
@@ -642,6 +650,7 @@
         'src/node_perf.cc',
         'src/node_platform.cc',
         'src/node_postmortem_metadata.cc',
+        'src/node_pprof.cc',
         'src/node_process_events.cc',
         'src/node_process_methods.cc',
         'src/node_process_object.cc',
@@ -662,6 +671,7 @@
         'src/node_wasi.cc',
         'src/node_watchdog.cc',
         'src/node_worker.cc',
+        'src/node_worker_pool.cc',
         'src/node_zlib.cc',
         'src/pipe_wrap.cc',
         'src/process_wrap.cc',
@@ -674,10 +684,12 @@
         'src/string_decoder.cc',
         'src/tcp_wrap.cc',
         'src/timers.cc',
+        'src/timer_wheel.cc',
         'src/timer_wrap.cc',
         'src/tracing/agent.cc',
         'src/tracing/node_trace_buffer.cc',
         'src/tracing/node_trace_writer.cc',
+        'src/tracing/proto_trace_writer.cc',
         'src/tracing/trace_event.cc',
         'src/tracing/traced_value.cc',
         'src/tty_wrap.cc',
@@ -748,6 +760,7 @@
         'src/node_perf.h',
         'src/node_perf_common.h',
         'src/node_platform.h',
+        'src/node_pprof.h',
         'src/node_process.h',
         'src/node_process-inl.h',
         'src/node_report.h',
@@ -765,6 +778,7 @@
         'src/node_wasi.h',
         'src/node_watchdog.h',
         'src/node_worker.h',
+        'src/node_worker_pool.h',
         'src/pipe_wrap.h',
         'src/req_wrap.h',
         'src/req_wrap-inl.h',
@@ -781,9 +795,11 @@
         'src/tracing/agent.h',
         'src/tracing/node_trace_buffer.h',
         'src/tracing/node_trace_writer.h',
+        'src/tracing/proto_trace_writer.h',
         'src/tracing/trace_event.h',
         'src/tracing/trace_event_common.h',
         'src/tracing/traced_value.h',
+        'src/timer_wheel.h',
         'src/timer_wrap.h',
         'src/tty_wrap.h',
         'src/udp_wrap.h',
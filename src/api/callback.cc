@@ -37,20 +37,30 @@ InternalCallbackScope::InternalCallbackScope(AsyncWrap* async_wrap, int flags)
                             async_wrap->object(),
                             { async_wrap->get_async_id(),
                               async_wrap->get_trigger_async_id() },
-                            flags) {}
+                            flags,
+                            async_wrap->provider_type()) {}
 
 InternalCallbackScope::InternalCallbackScope(Environment* env,
                                              Local<Object> object,
                                              const async_context& asyncContext,
-                                             int flags)
+                                             int flags,
+                                             AsyncWrap::ProviderType provider)
   : env_(env),
     async_context_(asyncContext),
     object_(object),
     skip_hooks_(flags & kSkipAsyncHooks),
-    skip_task_queues_(flags & kSkipTaskQueues) {
+    skip_task_queues_(flags & kSkipTaskQueues),
+    provider_(provider) {
   CHECK_NOT_NULL(env);
   env->PushAsyncCallbackScope();
 
+  // Only time the outermost scope, which includes the nested ones and the
+  // processing of the task queues when it is closed.
+  if (env->loop_metrics()->enabled() &&
+      env->async_callback_scope_depth() == 1) {
+    start_time_ = uv_hrtime();
+  }
+
   if (!env->can_call_into_js()) {
     failed_ = true;
     return;
@@ -79,6 +89,8 @@ InternalCallbackScope::InternalCallbackScope(Environment* env,
 InternalCallbackScope::~InternalCallbackScope() {
   Close();
   env_->PopAsyncCallbackScope();
+  if (start_time_ != 0)
+    env_->loop_metrics()->RecordCallback(provider_, uv_hrtime() - start_time_);
 }
 
 void InternalCallbackScope::Close() {
@@ -157,7 +169,8 @@ MaybeLocal<Value> InternalMakeCallback(Environment* env,
                                        const Local<Function> callback,
                                        int argc,
                                        Local<Value> argv[],
-                                       async_context asyncContext) {
+                                       async_context asyncContext,
+                                       AsyncWrap::ProviderType provider) {
   CHECK(!recv.IsEmpty());
 #ifdef DEBUG
   for (int i = 0; i < argc; i++)
@@ -178,7 +191,7 @@ MaybeLocal<Value> InternalMakeCallback(Environment* env,
         async_hooks->fields()[AsyncHooks::kUsesExecutionAsyncResource] > 0;
   }
 
-  InternalCallbackScope scope(env, resource, asyncContext, flags);
+  InternalCallbackScope scope(env, resource, asyncContext, flags, provider);
   if (scope.Failed()) {
     return MaybeLocal<Value>();
   }
@@ -45,6 +45,7 @@ using v8::Maybe;
 using v8::MaybeLocal;
 using v8::Name;
 using v8::Nothing;
+using v8::Null;
 using v8::Number;
 using v8::Object;
 using v8::ObjectTemplate;
@@ -472,6 +473,33 @@ static void DisablePromiseHook(const FunctionCallbackInfo<Value>& args) {
   args.GetIsolate()->SetPromiseHook(nullptr);
 }
 
+// The AsyncContextFrame of --experimental-async-context-frame, which V8 saves
+// on promise reactions and restores while they run.
+//
+// V8 does not restore an undefined value, so a reaction that was created
+// without a frame would run in whatever frame is current at that point. The
+// absence of a frame is therefore stored as null.
+static Local<Value> EmptyContextFrameToNull(Environment* env,
+                                            Local<Value> frame) {
+  if (frame.IsEmpty() || frame->IsUndefined())
+    return Null(env->isolate());
+  return frame;
+}
+
+static void GetContinuationPreservedEmbedderData(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  args.GetReturnValue().Set(
+      env->context()->GetContinuationPreservedEmbedderData());
+}
+
+static void SetContinuationPreservedEmbedderData(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  env->context()->SetContinuationPreservedEmbedderData(
+      EmptyContextFrameToNull(env, args[0]));
+}
+
 
 class DestroyParam {
  public:
@@ -643,6 +671,12 @@ void AsyncWrap::Initialize(Local<Object> target,
   env->SetMethod(target, "setPromiseHooks", SetPromiseHooks);
   env->SetMethod(target, "disablePromiseHook", DisablePromiseHook);
   env->SetMethod(target, "registerDestroyHook", RegisterDestroyHook);
+  env->SetMethod(target,
+                 "getContinuationPreservedEmbedderData",
+                 GetContinuationPreservedEmbedderData);
+  env->SetMethod(target,
+                 "setContinuationPreservedEmbedderData",
+                 SetContinuationPreservedEmbedderData);
 
   PropertyAttribute ReadOnlyDontDelete =
       static_cast<PropertyAttribute>(ReadOnly | DontDelete);
@@ -738,6 +772,8 @@ void AsyncWrap::RegisterExternalReferences(
   registry->Register(SetPromiseHooks);
   registry->Register(DisablePromiseHook);
   registry->Register(RegisterDestroyHook);
+  registry->Register(GetContinuationPreservedEmbedderData);
+  registry->Register(SetContinuationPreservedEmbedderData);
   registry->Register(AsyncWrap::GetAsyncId);
   registry->Register(AsyncWrap::AsyncReset);
   registry->Register(AsyncWrap::GetProviderType);
@@ -875,6 +911,11 @@ void AsyncWrap::AsyncReset(Local<Object> resource, double execution_async_id,
     if (resource != obj) {
       USE(obj->Set(env()->context(), env()->resource_symbol(), resource));
     }
+    if (env()->options()->experimental_async_context_frame) {
+      context_frame_.Reset(
+          env()->isolate(),
+          env()->context()->GetContinuationPreservedEmbedderData());
+    }
   }
 
   switch (provider_type()) {
@@ -943,8 +984,26 @@ MaybeLocal<Value> AsyncWrap::MakeCallback(const Local<Function> cb,
 
   ProviderType provider = provider_type();
   async_context context { get_async_id(), get_trigger_async_id() };
+
+  // Run the callback in the AsyncContextFrame that was current when this
+  // resource was created.
+  Environment* env = this->env();
+  Local<Value> prior_context_frame;
+  if (env->options()->experimental_async_context_frame) {
+    Local<Context> v8_context = env->context();
+    prior_context_frame = v8_context->GetContinuationPreservedEmbedderData();
+    v8_context->SetContinuationPreservedEmbedderData(
+        EmptyContextFrameToNull(
+            env, PersistentToLocal::Strong(context_frame_)));
+  }
+
   MaybeLocal<Value> ret = InternalMakeCallback(
-      env(), object(), object(), cb, argc, argv, context);
+      env, object(), object(), cb, argc, argv, context, provider);
+
+  if (!prior_context_frame.IsEmpty()) {
+    env->context()->SetContinuationPreservedEmbedderData(
+        EmptyContextFrameToNull(env, prior_context_frame));
+  }
 
   // This is a static call with cached values because the `this` object may
   // no longer be alive at this point.
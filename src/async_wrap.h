@@ -53,6 +53,7 @@ namespace node {
   V(HTTPCLIENTREQUEST)                                                        \
   V(JSSTREAM)                                                                 \
   V(JSUDPWRAP)                                                                \
+  V(LOOPSTALLWATCHDOG)                                                        \
   V(MESSAGEPORT)                                                              \
   V(PIPECONNECTWRAP)                                                          \
   V(PIPESERVERWRAP)                                                           \
@@ -60,6 +61,7 @@ namespace node {
   V(PROCESSWRAP)                                                              \
   V(PROMISE)                                                                  \
   V(QUERYWRAP)                                                                \
+  V(REPORTWRITEWRAP)                                                          \
   V(SHUTDOWNWRAP)                                                             \
   V(SIGNALWRAP)                                                               \
   V(STATWATCHER)                                                              \
@@ -73,6 +75,7 @@ namespace node {
   V(SIGINTWATCHDOG)                                                           \
   V(WORKER)                                                                   \
   V(WORKERHEAPSNAPSHOT)                                                       \
+  V(WORKERPOOL)                                                               \
   V(WRITEWRAP)                                                                \
   V(ZLIB)
 
@@ -237,6 +240,9 @@ class AsyncWrap : public BaseObject {
   // Because the values may be Reset(), cannot be made const.
   double async_id_ = kInvalidAsyncId;
   double trigger_async_id_;
+  // The AsyncContextFrame at the time of the last AsyncReset(), only used
+  // with --experimental-async-context-frame.
+  v8::Global<v8::Value> context_frame_;
 };
 
 }  // namespace node
@@ -12,9 +12,11 @@ namespace node {
 
 using v8::Boolean;
 using v8::Context;
+using v8::EscapableHandleScope;
 using v8::HandleScope;
 using v8::Integer;
 using v8::Local;
+using v8::MaybeLocal;
 using v8::Object;
 using v8::Value;
 
@@ -47,20 +49,8 @@ void ConnectionWrap<WrapType, UVType>::OnConnection(uv_stream_t* handle,
   Local<Value> client_handle;
 
   if (status == 0) {
-    // Instantiate the client javascript object and handle.
     Local<Object> client_obj;
-    if (!WrapType::Instantiate(env, wrap_data, WrapType::SOCKET)
-             .ToLocal(&client_obj))
-      return;
-
-    // Unwrap the client javascript object.
-    WrapType* wrap;
-    ASSIGN_OR_RETURN_UNWRAP(&wrap, client_obj);
-    uv_stream_t* client = reinterpret_cast<uv_stream_t*>(&wrap->handle_);
-    // uv_accept can fail if the new connection has already been closed, in
-    // which case an EAGAIN (resource temporarily unavailable) will be
-    // returned.
-    if (uv_accept(handle, client))
+    if (!wrap_data->AcceptConnection().ToLocal(&client_obj))
       return;
 
     // Successful accept. Call the onconnection callback in JavaScript land.
@@ -74,6 +64,31 @@ void ConnectionWrap<WrapType, UVType>::OnConnection(uv_stream_t* handle,
 }
 
 
+template <typename WrapType, typename UVType>
+MaybeLocal<Object> ConnectionWrap<WrapType, UVType>::AcceptConnection() {
+  Environment* env = this->env();
+  EscapableHandleScope handle_scope(env->isolate());
+
+  // Instantiate the client javascript object and handle.
+  Local<Object> client_obj;
+  if (!WrapType::Instantiate(env, this, WrapType::SOCKET).ToLocal(&client_obj))
+    return MaybeLocal<Object>();
+
+  // Unwrap the client javascript object.
+  WrapType* wrap = Unwrap<WrapType>(client_obj);
+  if (wrap == nullptr)
+    return MaybeLocal<Object>();
+  uv_stream_t* client = reinterpret_cast<uv_stream_t*>(&wrap->handle_);
+  // uv_accept can fail if the new connection has already been closed, in
+  // which case an EAGAIN (resource temporarily unavailable) will be
+  // returned.
+  if (uv_accept(reinterpret_cast<uv_stream_t*>(&handle_), client))
+    return MaybeLocal<Object>();
+
+  return handle_scope.Escape(client_obj);
+}
+
+
 template <typename WrapType, typename UVType>
 void ConnectionWrap<WrapType, UVType>::AfterConnect(uv_connect_t* req,
                                                     int status) {
@@ -127,6 +142,12 @@ template void ConnectionWrap<PipeWrap, uv_pipe_t>::OnConnection(
 template void ConnectionWrap<TCPWrap, uv_tcp_t>::OnConnection(
     uv_stream_t* handle, int status);
 
+template MaybeLocal<Object>
+ConnectionWrap<PipeWrap, uv_pipe_t>::AcceptConnection();
+
+template MaybeLocal<Object>
+ConnectionWrap<TCPWrap, uv_tcp_t>::AcceptConnection();
+
 template void ConnectionWrap<PipeWrap, uv_pipe_t>::AfterConnect(
     uv_connect_t* handle, int status);
 
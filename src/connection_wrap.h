@@ -20,6 +20,10 @@ class ConnectionWrap : public LibuvStreamWrap {
                  v8::Local<v8::Object> object,
                  ProviderType provider);
 
+  // Creates a client object and accepts the pending connection into it.
+  // Returns an empty handle if either of these fails.
+  v8::MaybeLocal<v8::Object> AcceptConnection();
+
   UVType handle_;
 };
 
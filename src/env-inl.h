@@ -339,6 +339,46 @@ inline bool TickInfo::has_rejection_to_warn() const {
   return fields_[kHasRejectionToWarn] == 1;
 }
 
+LoopMetrics::PhaseScope::PhaseScope(LoopMetrics* metrics, Phase phase)
+    : metrics_(metrics), previous_(metrics->phase_) {
+  metrics_->phase_ = phase;
+}
+
+LoopMetrics::PhaseScope::~PhaseScope() {
+  metrics_->phase_ = previous_;
+}
+
+inline bool LoopMetrics::enabled() const {
+  return enabled_;
+}
+
+inline void LoopMetrics::set_enabled(bool enabled) {
+  enabled_ = enabled;
+}
+
+inline void LoopMetrics::EnterPoll() {
+  phase_ = kPoll;
+}
+
+inline void LoopMetrics::LeavePoll() {
+  // Anything that is not attributed to a specific phase by a PhaseScope
+  // until the next poll runs in the pending phase.
+  phase_ = kPending;
+  if (enabled_) iterations_++;
+}
+
+inline void LoopMetrics::RecordCallback(AsyncWrap::ProviderType provider,
+                                        uint64_t duration) {
+  // The metrics may have been disabled while the callback was running.
+  if (!enabled_) return;
+  Counter& phase = phases_[phase_];
+  phase.count++;
+  phase.time += duration;
+  Counter& type = providers_[provider];
+  type.count++;
+  type.time += duration;
+}
+
 inline void Environment::AssignToContext(v8::Local<v8::Context> context,
                                          const ContextInfo& info) {
   context->SetAlignedPointerInEmbedderData(
@@ -532,6 +572,10 @@ inline TickInfo* Environment::tick_info() {
   return &tick_info_;
 }
 
+inline LoopMetrics* Environment::loop_metrics() {
+  return &loop_metrics_;
+}
+
 inline uint64_t Environment::timer_base() const {
   return timer_base_;
 }
@@ -707,6 +751,17 @@ Environment::cpu_profiler_connection() {
   return cpu_profiler_connection_.get();
 }
 
+inline void Environment::set_continuous_cpu_profiler(
+    std::unique_ptr<profiler::V8ContinuousCpuProfiler> profiler) {
+  CHECK_NULL(continuous_cpu_profiler_);
+  std::swap(continuous_cpu_profiler_, profiler);
+}
+
+inline profiler::V8ContinuousCpuProfiler*
+Environment::continuous_cpu_profiler() {
+  return continuous_cpu_profiler_.get();
+}
+
 inline void Environment::set_cpu_prof_interval(uint64_t interval) {
   cpu_prof_interval_ = interval;
 }
@@ -15,6 +15,7 @@
 #include "node_worker.h"
 #include "req_wrap-inl.h"
 #include "stream_base.h"
+#include "timer_wheel.h"
 #include "tracing/agent.h"
 #include "tracing/traced_value.h"
 #include "util-inl.h"
@@ -650,13 +651,35 @@ void Environment::StartProfilerIdleNotifier() {
   uv_prepare_start(&idle_prepare_handle_, [](uv_prepare_t* handle) {
     Environment* env = ContainerOf(&Environment::idle_prepare_handle_, handle);
     env->isolate()->SetIdle(true);
+    env->loop_metrics()->EnterPoll();
   });
+  // This runs before CheckImmediate(), since check handles that are started
+  // later run first.
   uv_check_start(&idle_check_handle_, [](uv_check_t* handle) {
     Environment* env = ContainerOf(&Environment::idle_check_handle_, handle);
     env->isolate()->SetIdle(false);
+    env->loop_metrics()->LeavePoll();
   });
 }
 
+void LoopMetrics::Reset() {
+  iterations_ = 0;
+  phases_.fill(Counter());
+  providers_.fill(Counter());
+}
+
+void LoopMetrics::Snapshot(double* out) const {
+  *out++ = static_cast<double>(iterations_);
+  for (const Counter& counter : phases_) {
+    *out++ = static_cast<double>(counter.count);
+    *out++ = counter.time / 1e6;
+  }
+  for (const Counter& counter : providers_) {
+    *out++ = static_cast<double>(counter.count);
+    *out++ = counter.time / 1e6;
+  }
+}
+
 void Environment::PrintSyncTrace() const {
   if (!trace_sync_io_) return;
 
@@ -855,6 +878,8 @@ void Environment::RunTimers(uv_timer_t* handle) {
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
 
+  LoopMetrics::PhaseScope phase_scope(env->loop_metrics(),
+                                      LoopMetrics::kTimers);
   Local<Object> process = env->process_object();
   InternalCallbackScope scope(env, process, {0, 0});
 
@@ -913,6 +938,8 @@ void Environment::CheckImmediate(uv_check_t* handle) {
 
   HandleScope scope(env->isolate());
   Context::Scope context_scope(env->context());
+  LoopMetrics::PhaseScope phase_scope(env->loop_metrics(),
+                                      LoopMetrics::kCheck);
 
   env->RunAndClearNativeImmediates();
 
@@ -72,6 +72,7 @@ class AgentWriterHandle;
 namespace profiler {
 class V8CoverageConnection;
 class V8CpuProfilerConnection;
+class V8ContinuousCpuProfiler;
 class V8HeapProfilerConnection;
 }  // namespace profiler
 
@@ -84,6 +85,9 @@ namespace worker {
 class Worker;
 }
 
+class StreamReadPool;
+class TimerWheel;
+
 namespace loader {
 class ModuleWrap;
 
@@ -250,6 +254,7 @@ constexpr size_t kFsStatsBufferLength =
   V(ext_key_usage_string, "ext_key_usage")                                     \
   V(external_stream_string, "_externalStream")                                 \
   V(family_string, "family")                                                   \
+  V(fast_spawn_string, "fastSpawn")                                            \
   V(fatal_exception_string, "_fatalException")                                 \
   V(fd_string, "fd")                                                           \
   V(fields_string, "fields")                                                   \
@@ -339,14 +344,19 @@ constexpr size_t kFsStatsBufferLength =
   V(onhandshakedone_string, "onhandshakedone")                                 \
   V(onhandshakestart_string, "onhandshakestart")                               \
   V(onkeylog_string, "onkeylog")                                               \
+  V(online_string, "onLine")                                                   \
   V(onmessage_string, "onmessage")                                             \
+  V(onmessages_string, "onmessages")                                           \
   V(onnewsession_string, "onnewsession")                                       \
   V(onocspresponse_string, "onocspresponse")                                   \
   V(onreadstart_string, "onreadstart")                                         \
   V(onreadstop_string, "onreadstop")                                           \
   V(onshutdown_string, "onshutdown")                                           \
   V(onsignal_string, "onsignal")                                               \
+  V(onstall_string, "onstall")                                                 \
+  V(ontimeout_string, "ontimeout")                                             \
   V(onunpipe_string, "onunpipe")                                               \
+  V(onwork_string, "onwork")                                                   \
   V(onwrite_string, "onwrite")                                                 \
   V(openssl_error_stack, "opensslErrorStack")                                  \
   V(options_string, "options")                                                 \
@@ -483,6 +493,7 @@ constexpr size_t kFsStatsBufferLength =
   V(tty_constructor_template, v8::FunctionTemplate)                            \
   V(write_wrap_template, v8::ObjectTemplate)                                   \
   V(worker_heap_snapshot_taker_template, v8::ObjectTemplate)                   \
+  V(worker_pool_constructor_template, v8::FunctionTemplate)                    \
   V(x509_constructor_template, v8::FunctionTemplate)
 
 #define ENVIRONMENT_STRONG_PERSISTENT_VALUES(V)                                \
@@ -534,6 +545,8 @@ constexpr size_t kFsStatsBufferLength =
   V(promise_hook_handler, v8::Function)                                        \
   V(promise_reject_callback, v8::Function)                                     \
   V(script_data_constructor_function, v8::Function)                            \
+  V(snapshot_deserialize_main, v8::Function)                                   \
+  V(snapshot_serialize_callback, v8::Function)                                 \
   V(source_map_cache_getter, v8::Function)                                     \
   V(tick_callback_function, v8::Function)                                      \
   V(timers_callback_function, v8::Function)                                    \
@@ -851,6 +864,66 @@ class TickInfo : public MemoryRetainer {
   AliasedUint8Array fields_;
 };
 
+// Counts the callbacks into JavaScript made by the event loop, and the time
+// spent in them, grouped by the loop phase that they were made in and by the
+// type of the resource that made them. The phase is tracked all the time,
+// since that is just a store, but callbacks are only timed while enabled.
+class LoopMetrics {
+ public:
+  enum Phase : uint8_t {
+    kTimers,
+    kPending,
+    kPoll,
+    kCheck,
+    kClose,
+    kPhaseCount
+  };
+
+  // The number of values written by Snapshot(): the number of loop
+  // iterations, then the number of callbacks and the time spent in them for
+  // each phase and for each provider type.
+  static constexpr size_t kFieldCount =
+      1 + 2 * kPhaseCount + 2 * AsyncWrap::PROVIDERS_LENGTH;
+
+  // Attributes the callbacks made during its lifetime to `phase`.
+  class PhaseScope {
+   public:
+    inline PhaseScope(LoopMetrics* metrics, Phase phase);
+    inline ~PhaseScope();
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+   private:
+    LoopMetrics* metrics_;
+    Phase previous_;
+  };
+
+  inline bool enabled() const;
+  inline void set_enabled(bool enabled);
+  // Called right before and right after the loop polls for I/O.
+  inline void EnterPoll();
+  inline void LeavePoll();
+  inline void RecordCallback(AsyncWrap::ProviderType provider,
+                             uint64_t duration);
+
+  void Reset();
+  // Writes kFieldCount values to `out`. Times are in milliseconds.
+  void Snapshot(double* out) const;
+
+ private:
+  struct Counter {
+    uint64_t count = 0;
+    uint64_t time = 0;
+  };
+
+  bool enabled_ = false;
+  Phase phase_ = kPending;
+  uint64_t iterations_ = 0;
+  std::array<Counter, kPhaseCount> phases_;
+  std::array<Counter, AsyncWrap::PROVIDERS_LENGTH> providers_;
+};
+
 class TrackingTraceStateObserver :
     public v8::TracingController::TraceStateObserver {
  public:
@@ -957,9 +1030,17 @@ struct EnvSerializeInfo {
 
 struct SnapshotData {
   SnapshotData() { blob.data = nullptr; }
+  ~SnapshotData() { delete[] blob.data; }
+  SnapshotData(const SnapshotData&) = delete;
+  SnapshotData& operator=(const SnapshotData&) = delete;
   v8::StartupData blob;
   std::vector<size_t> isolate_data_indices;
   EnvSerializeInfo env_info;
+
+  // Write the snapshot into a file written by --build-snapshot, or read it
+  // back. A blob can only be read by the same Node.js binary that wrote it.
+  bool ToBlob(FILE* out) const;
+  static bool FromBlob(SnapshotData* out, FILE* in);
 };
 
 class Environment : public MemoryRetainer {
@@ -1108,6 +1189,7 @@ class Environment : public MemoryRetainer {
   inline AsyncHooks* async_hooks();
   inline ImmediateInfo* immediate_info();
   inline TickInfo* tick_info();
+  inline LoopMetrics* loop_metrics();
   inline uint64_t timer_base() const;
   inline std::shared_ptr<KVStore> env_vars();
   inline void set_env_vars(std::shared_ptr<KVStore> env_vars);
@@ -1399,6 +1481,10 @@ class Environment : public MemoryRetainer {
       std::unique_ptr<profiler::V8CpuProfilerConnection> connection);
   profiler::V8CpuProfilerConnection* cpu_profiler_connection();
 
+  void set_continuous_cpu_profiler(
+      std::unique_ptr<profiler::V8ContinuousCpuProfiler> profiler);
+  profiler::V8ContinuousCpuProfiler* continuous_cpu_profiler();
+
   inline void set_cpu_prof_name(const std::string& name);
   inline const std::string& cpu_prof_name() const;
 
@@ -1433,6 +1519,11 @@ class Environment : public MemoryRetainer {
   inline std::unordered_map<char*, std::unique_ptr<v8::BackingStore>>*
       released_allocated_buffers();
 
+  // Created on first use, see stream_base.cc.
+  StreamReadPool* stream_read_pool();
+  // Created on first use, see timer_wheel.cc.
+  TimerWheel* timer_wheel();
+
   void AddUnmanagedFd(int fd);
   void RemoveUnmanagedFd(int fd);
 
@@ -1457,6 +1548,7 @@ class Environment : public MemoryRetainer {
   AsyncHooks async_hooks_;
   ImmediateInfo immediate_info_;
   TickInfo tick_info_;
+  LoopMetrics loop_metrics_;
   const uint64_t timer_base_;
   std::shared_ptr<KVStore> env_vars_;
   bool printed_error_ = false;
@@ -1472,6 +1564,7 @@ class Environment : public MemoryRetainer {
 #if HAVE_INSPECTOR
   std::unique_ptr<profiler::V8CoverageConnection> coverage_connection_;
   std::unique_ptr<profiler::V8CpuProfilerConnection> cpu_profiler_connection_;
+  std::unique_ptr<profiler::V8ContinuousCpuProfiler> continuous_cpu_profiler_;
   std::string coverage_directory_;
   std::string cpu_prof_dir_;
   std::string cpu_prof_name_;
@@ -1609,6 +1702,9 @@ class Environment : public MemoryRetainer {
   // a given pointer.
   std::unordered_map<char*, std::unique_ptr<v8::BackingStore>>
       released_allocated_buffers_;
+
+  std::unique_ptr<StreamReadPool> stream_read_pool_;
+  std::unique_ptr<TimerWheel> timer_wheel_;
 };
 
 }  // namespace node
@@ -130,6 +130,8 @@ void HandleWrap::OnClose(uv_handle_t* handle) {
   Environment* env = wrap->env();
   HandleScope scope(env->isolate());
   Context::Scope context_scope(env->context());
+  LoopMetrics::PhaseScope phase_scope(env->loop_metrics(),
+                                      LoopMetrics::kClose);
 
   CHECK_EQ(wrap->state_, kClosing);
 
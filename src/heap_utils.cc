@@ -2,26 +2,40 @@
 #include "env-inl.h"
 #include "memory_tracker-inl.h"
 #include "node_external_reference.h"
+#include "node_internals.h"
+#include "node_pprof.h"
 #include "stream_base-inl.h"
+#include "threadpoolwork-inl.h"
 #include "util-inl.h"
+#include "zlib.h"
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <deque>
+
+using v8::AllocationProfile;
 using v8::Array;
 using v8::Boolean;
 using v8::Context;
 using v8::EmbedderGraph;
 using v8::EscapableHandleScope;
+using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::Global;
 using v8::HandleScope;
+using v8::HeapProfiler;
 using v8::HeapSnapshot;
 using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
+using v8::Null;
 using v8::Number;
 using v8::Object;
 using v8::ObjectTemplate;
 using v8::String;
+using v8::Uint32;
 using v8::Value;
 
 namespace node {
@@ -228,6 +242,224 @@ class FileOutputStream : public v8::OutputStream {
   FILE* stream_;
 };
 
+// Compresses the snapshot with gzip while it is being written, using a fixed
+// size output buffer.
+class GzipFileOutputStream : public v8::OutputStream {
+ public:
+  explicit GzipFileOutputStream(FILE* stream) : stream_(stream) {
+    memset(&zstream_, 0, sizeof(zstream_));
+    // A window size of 15 plus 16 makes zlib write a gzip header and trailer.
+    ok_ = deflateInit2(&zstream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                       15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+  }
+
+  ~GzipFileOutputStream() override {
+    deflateEnd(&zstream_);
+  }
+
+  int GetChunkSize() override {
+    return kChunkSize;
+  }
+
+  void EndOfStream() override {
+    Deflate(nullptr, 0, Z_FINISH);
+  }
+
+  WriteResult WriteAsciiChunk(char* data, int size) override {
+    Deflate(data, size, Z_NO_FLUSH);
+    return ok_ ? kContinue : kAbort;
+  }
+
+  bool ok() const { return ok_; }
+
+ private:
+  static const int kChunkSize = 65536;
+
+  void Deflate(char* data, int size, int flush) {
+    if (!ok_) return;
+    zstream_.next_in = reinterpret_cast<Bytef*>(data);
+    zstream_.avail_in = size;
+    int err;
+    do {
+      zstream_.next_out = reinterpret_cast<Bytef*>(out_);
+      zstream_.avail_out = sizeof(out_);
+      err = deflate(&zstream_, flush);
+      size_t len = sizeof(out_) - zstream_.avail_out;
+      if ((err != Z_OK && err != Z_STREAM_END && err != Z_BUF_ERROR) ||
+          fwrite(out_, 1, len, stream_) != len) {
+        ok_ = false;
+        return;
+      }
+    } while (zstream_.avail_out == 0 ||
+             (flush == Z_FINISH && err != Z_STREAM_END));
+  }
+
+  FILE* stream_;
+  z_stream zstream_;
+  bool ok_;
+  char out_[kChunkSize];
+};
+
+// Calls `write` with an OutputStream that writes to `filename`, gzipped if
+// `compress` is true, and returns 0 or a libuv error code along with the
+// failed `syscall`.
+template <typename WriteFn>
+int WriteToFile(const char* filename,
+                bool compress,
+                const char** syscall,
+                WriteFn&& write) {
+  *syscall = "open";
+  FILE* fp = fopen(filename, "wb");
+  if (fp == nullptr)
+    return uv_translate_sys_error(errno);
+  *syscall = "write";
+  bool ok;
+  if (compress) {
+    GzipFileOutputStream stream(fp);
+    write(&stream);
+    ok = stream.ok();
+  } else {
+    FileOutputStream stream(fp);
+    write(&stream);
+    ok = !ferror(fp);
+  }
+  if (fclose(fp) != 0 && ok)
+    return uv_translate_sys_error(errno);
+  return ok ? 0 : UV_EIO;
+}
+
+// Writes a heap snapshot to a file on the libuv threadpool. V8 only allows
+// a snapshot to be serialized on the thread that owns the isolate, so the
+// main thread still serializes it, but the chunks are handed over to the
+// threadpool, which compresses them and writes them to the file while the
+// rest of the snapshot is being serialized.
+class HeapSnapshotWriteWrap : public AsyncWrap,
+                              public ThreadPoolWork,
+                              public v8::OutputStream {
+ public:
+  HeapSnapshotWriteWrap(Environment* env, Local<Object> obj)
+      : AsyncWrap(env, obj, AsyncWrap::PROVIDER_HEAPSNAPSHOT),
+        ThreadPoolWork(env) {
+    MakeWeak();
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args.IsConstructCall());
+    Environment* env = Environment::GetCurrent(args);
+    new HeapSnapshotWriteWrap(env, args.This());
+  }
+
+  void Start(HeapSnapshotPointer&& snapshot,
+             std::string&& filename,
+             bool compress) {
+    filename_ = std::move(filename);
+    compress_ = compress;
+    ClearWeak();
+    ScheduleWork();
+    // V8 does not call EndOfStream() if the serialization is aborted, so the
+    // end of the snapshot is signaled here instead.
+    snapshot->Serialize(this, HeapSnapshot::kJSON);
+    Mutex::ScopedLock lock(mutex_);
+    serialized_ = true;
+    chunks_cond_.Signal(lock);
+  }
+
+  int GetChunkSize() override {
+    return 65536;  // big chunks == faster
+  }
+
+  void EndOfStream() override {}
+
+  WriteResult WriteAsciiChunk(char* data, int size) override {
+    Mutex::ScopedLock lock(mutex_);
+    // Wait for the threadpool to catch up rather than holding on to the whole
+    // snapshot, e.g. when the threadpool is busy with other work.
+    while (chunks_.size() >= kMaxQueuedChunks && !write_failed_)
+      space_cond_.Wait(lock);
+    if (write_failed_)
+      return kAbort;
+    chunks_.emplace_back(data, size);
+    chunks_cond_.Signal(lock);
+    return kContinue;
+  }
+
+  void DoThreadPoolWork() override {
+    err_ = WriteToFile(
+        filename_.c_str(), compress_, &syscall_, [&](v8::OutputStream* out) {
+          std::string chunk;
+          for (;;) {
+            {
+              Mutex::ScopedLock lock(mutex_);
+              while (chunks_.empty() && !serialized_)
+                chunks_cond_.Wait(lock);
+              if (chunks_.empty())
+                break;
+              chunk = std::move(chunks_.front());
+              chunks_.pop_front();
+              space_cond_.Signal(lock);
+            }
+            if (out->WriteAsciiChunk(&chunk[0], chunk.size()) == kAbort)
+              return;
+          }
+          out->EndOfStream();
+        });
+    if (err_ != 0) {
+      // Make the serializer stop early, there is no point in going on.
+      Mutex::ScopedLock lock(mutex_);
+      write_failed_ = true;
+      chunks_.clear();
+      space_cond_.Signal(lock);
+    }
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    MakeWeak();
+    if (status == UV_ECANCELED)
+      return;
+    CHECK_EQ(status, 0);
+
+    Environment* env = AsyncWrap::env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+    Local<Value> arg;
+    if (err_ == 0) {
+      arg = Null(env->isolate());
+    } else {
+      arg = UVException(env->isolate(),
+                        err_,
+                        syscall_,
+                        nullptr,
+                        filename_.c_str());
+    }
+    MakeCallback(env->oncomplete_string(), 1, &arg);
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("filename", filename_);
+  }
+
+  SET_MEMORY_INFO_NAME(HeapSnapshotWriteWrap)
+  SET_SELF_SIZE(HeapSnapshotWriteWrap)
+
+ private:
+  std::string filename_;
+  bool compress_ = false;
+  int err_ = 0;
+  const char* syscall_ = nullptr;
+
+  // Limits the memory used for chunks that are waiting to be written to
+  // 4 MiB.
+  static const size_t kMaxQueuedChunks = 64;
+
+  Mutex mutex_;
+  ConditionVariable chunks_cond_;
+  ConditionVariable space_cond_;
+  // Serialized chunks that have not been written yet.
+  std::deque<std::string> chunks_;
+  bool serialized_ = false;
+  bool write_failed_ = false;
+};
+
 class HeapSnapshotStream : public AsyncWrap,
                            public StreamBase,
                            public v8::OutputStream {
@@ -308,22 +540,72 @@ class HeapSnapshotStream : public AsyncWrap,
   HeapSnapshotPointer snapshot_;
 };
 
-inline void TakeSnapshot(Isolate* isolate, v8::OutputStream* out) {
+}  // namespace
+
+bool WriteSnapshot(Isolate* isolate, const char* filename, bool compress) {
   HeapSnapshotPointer snapshot {
       isolate->GetHeapProfiler()->TakeHeapSnapshot() };
-  snapshot->Serialize(out, HeapSnapshot::kJSON);
+  const char* syscall;
+  return WriteToFile(filename, compress, &syscall, [&](v8::OutputStream* out) {
+    snapshot->Serialize(out, HeapSnapshot::kJSON);
+  }) == 0;
 }
 
-}  // namespace
+namespace {
+// V8 truncates strings to this length in heap snapshots by default.
+std::atomic<int> heap_snapshot_string_limit { 1024 };
 
-bool WriteSnapshot(Isolate* isolate, const char* filename) {
-  FILE* fp = fopen(filename, "w");
-  if (fp == nullptr)
-    return false;
-  FileOutputStream stream(fp);
-  TakeSnapshot(isolate, &stream);
-  fclose(fp);
-  return true;
+// Lowers --heap-snapshot-string-limit while a snapshot is being captured,
+// which is when V8 truncates the strings.
+class ScopedHeapSnapshotStringLimit {
+ public:
+  explicit ScopedHeapSnapshotStringLimit(int limit) : active_(limit >= 0) {
+    if (active_)
+      SetLimit(limit);
+  }
+
+  ~ScopedHeapSnapshotStringLimit() {
+    if (active_)
+      SetLimit(heap_snapshot_string_limit);
+  }
+
+ private:
+  static void SetLimit(int limit) {
+    std::string flag =
+        "--heap-snapshot-string-limit=" + std::to_string(limit);
+    v8::V8::SetFlagsFromString(flag.c_str(), flag.size());
+  }
+
+  bool active_;
+};
+}  // anonymous namespace
+
+void RecordV8Flags(const std::vector<std::string>& args) {
+  for (size_t i = 0; i < args.size(); i++) {
+    const std::string& arg = args[i];
+    size_t start = arg.find_first_not_of('-');
+    if (start == 0 || start == std::string::npos)
+      continue;
+    size_t eq = arg.find('=', start);
+    std::string name = arg.substr(
+        start, eq == std::string::npos ? std::string::npos : eq - start);
+    std::replace(name.begin(), name.end(), '_', '-');
+    if (name != "heap-snapshot-string-limit")
+      continue;
+    // V8 also accepts the value as the next argument.
+    std::string value;
+    if (eq != std::string::npos)
+      value = arg.substr(eq + 1);
+    else if (i + 1 < args.size())
+      value = args[++i];
+    char* end;
+    errno = 0;
+    long limit = strtol(value.c_str(), &end, 10);  // NOLINT(runtime/int)
+    if (!value.empty() && *end == '\0' && errno == 0 &&
+        limit >= 0 && limit <= INT_MAX) {
+      heap_snapshot_string_limit = static_cast<int>(limit);
+    }
+  }
 }
 
 void DeleteHeapSnapshot(const HeapSnapshot* snapshot) {
@@ -371,22 +653,200 @@ void TriggerHeapSnapshot(const FunctionCallbackInfo<Value>& args) {
   Isolate* isolate = args.GetIsolate();
 
   Local<Value> filename_v = args[0];
+  bool compress = args[1]->IsTrue();
+  std::string filename;
+  ScopedHeapSnapshotStringLimit string_limit(
+      args[3]->IsInt32() ? args[3].As<v8::Int32>()->Value() : -1);
 
   if (filename_v->IsUndefined()) {
-    DiagnosticFilename name(env, "Heap", "heapsnapshot");
-    if (!WriteSnapshot(isolate, *name))
+    DiagnosticFilename name(
+        env, "Heap", compress ? "heapsnapshot.gz" : "heapsnapshot");
+    filename = *name;
+    if (!String::NewFromUtf8(isolate, *name).ToLocal(&filename_v))
       return;
-    if (String::NewFromUtf8(isolate, *name).ToLocal(&filename_v)) {
-      args.GetReturnValue().Set(filename_v);
-    }
+  } else {
+    BufferValue path(isolate, filename_v);
+    CHECK_NOT_NULL(*path);
+    filename = *path;
+  }
+
+  if (args[2]->IsObject()) {
+    // Only capture the snapshot here and serialize it in the background.
+    HeapSnapshotWriteWrap* req_wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&req_wrap, args[2]);
+    HeapSnapshotPointer snapshot {
+        isolate->GetHeapProfiler()->TakeHeapSnapshot() };
+    CHECK(snapshot);
+    req_wrap->Start(std::move(snapshot), std::move(filename), compress);
+  } else if (!WriteSnapshot(isolate, filename.c_str(), compress)) {
     return;
   }
+  args.GetReturnValue().Set(filename_v);
+}
+
+// Collects the native nodes reported by MemoryTracker, together with the
+// first native node that retains each of them, so that their sizes can be
+// attributed to a retainer path in heap profiles. JS nodes are not needed
+// for that, so they are all represented by the same placeholder.
+class NativeRetainerGraph : public EmbedderGraph {
+ public:
+  class JSNode : public EmbedderGraph::Node {
+   public:
+    const char* Name() override { return "<JS Node>"; }
+    size_t SizeInBytes() override { return 0; }
+    bool IsEmbedderNode() override { return false; }
+  };
+
+  Node* V8Node(const Local<Value>& value) override { return &js_node_; }
+
+  Node* AddNode(std::unique_ptr<Node> node) override {
+    Node* n = node.get();
+    nodes_.emplace_back(std::move(node));
+    return n;
+  }
+
+  void AddEdge(Node* from, Node* to, const char* name = nullptr) override {
+    if (from->IsEmbedderNode() && to->IsEmbedderNode())
+      retainers_.emplace(to, from);
+  }
 
-  BufferValue path(isolate, filename_v);
-  CHECK_NOT_NULL(*path);
-  if (!WriteSnapshot(isolate, *path))
+  // Adds a sample for each native node with a non-zero size to `builder`.
+  // Its stack goes from the node itself up to the outermost native node
+  // that retains it, below a "(native)" frame.
+  void AddSamples(pprof::ProfileBuilder* builder) const {
+    static const size_t kMaxDepth = 64;
+    uint64_t native_location = builder->GetLocation("(native)", "", 0, 0);
+    std::vector<uint64_t> locations;
+    for (const std::unique_ptr<Node>& node : nodes_) {
+      size_t size = node->SizeInBytes();
+      if (size == 0) continue;
+      locations.clear();
+      Node* current = node.get();
+      while (current != nullptr && locations.size() < kMaxDepth) {
+        locations.push_back(
+            builder->GetLocation(current->Name(), "(native)", 0, 0));
+        auto it = retainers_.find(current);
+        current = it == retainers_.end() ? nullptr : it->second;
+      }
+      locations.push_back(native_location);
+      builder->AddSample(locations, { 1, static_cast<int64_t>(size) });
+    }
+  }
+
+ private:
+  JSNode js_node_;
+  std::vector<std::unique_ptr<Node>> nodes_;
+  // Maps each node to the first node that was reported to retain it.
+  std::unordered_map<Node*, Node*> retainers_;
+};
+
+void StartSamplingHeapProfiler(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsNumber());
+  CHECK(args[1]->IsUint32());
+  uint64_t interval = static_cast<uint64_t>(args[0].As<Number>()->Value());
+  int depth = static_cast<int>(args[1].As<Uint32>()->Value());
+  bool started = env->isolate()->GetHeapProfiler()->StartSamplingHeapProfiler(
+      interval, depth);
+  args.GetReturnValue().Set(started);
+}
+
+void StopSamplingHeapProfiler(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  env->isolate()->GetHeapProfiler()->StopSamplingHeapProfiler();
+}
+
+bool WriteAllocationProfile(Environment* env,
+                            const char* filename,
+                            uint64_t interval) {
+  Isolate* isolate = env->isolate();
+  HeapProfiler* heap_profiler = isolate->GetHeapProfiler();
+  std::unique_ptr<AllocationProfile> profile {
+      heap_profiler->GetAllocationProfile() };
+  if (!profile) return false;
+
+  pprof::ProfileBuilder builder;
+  builder.AddSampleType("objects", "count");
+  builder.AddSampleType("space", "bytes");
+  builder.SetPeriod("space", "bytes", interval);
+  builder.SetTime(
+      static_cast<int64_t>(GetCurrentTimeInMicroseconds()) * 1000, 0);
+
+  // Walk the allocation tree without recursion. `stack` holds the locations
+  // from the root to the current node.
+  HandleScope handle_scope(isolate);
+  std::vector<std::pair<AllocationProfile::Node*, size_t>> pending;
+  std::vector<uint64_t> stack;
+  std::vector<uint64_t> locations;
+  AllocationProfile::Node* root = profile->GetRootNode();
+  for (auto it = root->children.rbegin(); it != root->children.rend(); ++it)
+    pending.emplace_back(*it, 0);
+  while (!pending.empty()) {
+    AllocationProfile::Node* node = pending.back().first;
+    size_t depth = pending.back().second;
+    pending.pop_back();
+
+    Utf8Value name(isolate, node->name);
+    Utf8Value script_name(isolate, node->script_name);
+    stack.resize(depth);
+    stack.push_back(builder.GetLocation(
+        name.length() > 0 ? *name : "(anonymous)",
+        *script_name,
+        node->line_number,
+        node->line_number));
+
+    int64_t count = 0;
+    int64_t size = 0;
+    for (const AllocationProfile::Allocation& allocation : node->allocations) {
+      count += allocation.count;
+      size += static_cast<int64_t>(allocation.size) * allocation.count;
+    }
+    if (count > 0) {
+      locations.assign(stack.rbegin(), stack.rend());
+      builder.AddSample(locations, { count, size });
+    }
+    for (auto it = node->children.rbegin(); it != node->children.rend(); ++it)
+      pending.emplace_back(*it, depth + 1);
+  }
+
+  NativeRetainerGraph graph;
+  Environment::BuildEmbedderGraph(isolate, &graph, env);
+  graph.AddSamples(&builder);
+
+  std::string data;
+  if (!builder.SerializeGzip(&data)) return false;
+  return WriteFileSync(filename, uv_buf_init(&data[0], data.size())) == 0;
+}
+
+void WriteHeapProfile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = args.GetIsolate();
+  CHECK(args[2]->IsNumber());
+  uint64_t interval = static_cast<uint64_t>(args[2].As<Number>()->Value());
+
+  Local<Value> filename_v = args[0];
+  std::string filename;
+  if (filename_v->IsUndefined()) {
+    DiagnosticFilename name(env, "Heap", "pb.gz");
+    if (args[1]->IsUndefined()) {
+      filename = *name;
+    } else {
+      BufferValue directory(isolate, args[1]);
+      CHECK_NOT_NULL(*directory);
+      filename = std::string(*directory) + kPathSeparator;
+      filename += *name;
+    }
+    if (!String::NewFromUtf8(isolate, filename.c_str()).ToLocal(&filename_v))
+      return;
+  } else {
+    BufferValue path(isolate, filename_v);
+    CHECK_NOT_NULL(*path);
+    filename = *path;
+  }
+
+  if (!WriteAllocationProfile(env, filename.c_str(), interval))
     return;
-  return args.GetReturnValue().Set(filename_v);
+  args.GetReturnValue().Set(filename_v);
 }
 
 void Initialize(Local<Object> target,
@@ -398,12 +858,28 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "buildEmbedderGraph", BuildEmbedderGraph);
   env->SetMethod(target, "triggerHeapSnapshot", TriggerHeapSnapshot);
   env->SetMethod(target, "createHeapSnapshotStream", CreateHeapSnapshotStream);
+
+  Local<FunctionTemplate> write_wrap =
+      env->NewFunctionTemplate(HeapSnapshotWriteWrap::New);
+  write_wrap->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  write_wrap->InstanceTemplate()->SetInternalFieldCount(
+      HeapSnapshotWriteWrap::kInternalFieldCount);
+  env->SetConstructorFunction(target, "HeapSnapshotWriteWrap", write_wrap);
+  env->SetMethod(target,
+                 "startSamplingHeapProfiler",
+                 StartSamplingHeapProfiler);
+  env->SetMethod(target, "stopSamplingHeapProfiler", StopSamplingHeapProfiler);
+  env->SetMethod(target, "writeHeapProfile", WriteHeapProfile);
 }
 
 void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(BuildEmbedderGraph);
   registry->Register(TriggerHeapSnapshot);
   registry->Register(CreateHeapSnapshotStream);
+  registry->Register(HeapSnapshotWriteWrap::New);
+  registry->Register(StartSamplingHeapProfiler);
+  registry->Register(StopSamplingHeapProfiler);
+  registry->Register(WriteHeapProfile);
 }
 
 }  // namespace heap
@@ -5,13 +5,24 @@
 
 #include "histogram.h"
 #include "base_object-inl.h"
+#include "hdr_atomic.h"
 #include "node_internals.h"
 
 namespace node {
 
 void Histogram::Reset() {
   Mutex::ScopedLock lock(mutex_);
-  hdr_reset(histogram_.get());
+  if (atomic_) {
+    // Other threads may be recording values without holding the mutex.
+    hdr_histogram* h = histogram_.get();
+    for (int32_t i = 0; i < h->counts_len; i++)
+      hdr_atomic_store_64(&h->counts[i], 0);
+    hdr_atomic_store_64(&h->total_count, 0);
+    hdr_atomic_store_64(&h->min_value, std::numeric_limits<int64_t>::max());
+    hdr_atomic_store_64(&h->max_value, 0);
+  } else {
+    hdr_reset(histogram_.get());
+  }
   exceeds_ = 0;
   prev_ = 0;
 }
@@ -44,6 +55,11 @@ double Histogram::Percentile(double percentile) {
       hdr_value_at_percentile(histogram_.get(), percentile));
 }
 
+int64_t Histogram::Count() {
+  Mutex::ScopedLock lock(mutex_);
+  return histogram_->total_count;
+}
+
 template <typename Iterator>
 void Histogram::Percentiles(Iterator&& fn) {
   Mutex::ScopedLock lock(mutex_);
@@ -56,7 +72,15 @@ void Histogram::Percentiles(Iterator&& fn) {
   }
 }
 
+bool Histogram::RecordValues(int64_t value, int64_t count) {
+  return atomic_ ?
+      hdr_record_values_atomic(histogram_.get(), value, count) :
+      hdr_record_values(histogram_.get(), value, count);
+}
+
 bool Histogram::Record(int64_t value) {
+  if (atomic_)
+    return hdr_record_value_atomic(histogram_.get(), value);
   Mutex::ScopedLock lock(mutex_);
   return hdr_record_value(histogram_.get(), value);
 }
@@ -68,7 +92,7 @@ uint64_t Histogram::RecordDelta() {
   if (prev_ > 0) {
     delta = time - prev_;
     if (delta > 0) {
-      if (!hdr_record_value(histogram_.get(), delta) && exceeds_ < 0xFFFFFFFF)
+      if (!RecordValues(delta, 1) && exceeds_ < 0xFFFFFFFF)
         exceeds_++;
     }
   }
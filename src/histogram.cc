@@ -2,7 +2,14 @@
 #include "histogram-inl.h"
 #include "base_object-inl.h"
 #include "memory_tracker-inl.h"
+#include "node_buffer.h"
 #include "node_errors.h"
+#include "util-inl.h"
+#include "zlib.h"
+
+#include <cstring>
+#include <utility>
+
 namespace node {
 
 using v8::BigInt;
@@ -13,20 +20,262 @@ using v8::Map;
 using v8::Number;
 using v8::Object;
 using v8::String;
+using v8::Uint32;
 using v8::Value;
 
-Histogram::Histogram(int64_t lowest, int64_t highest, int figures) {
+namespace {
+
+// The HdrHistogram V2 encoding is a header followed by the counts of the
+// histogram, compressed with zlib and prefixed by another header. All the
+// integers in the headers are big-endian.
+constexpr uint32_t kV2EncodingCookie = 0x1c849303 | 0x10;
+constexpr uint32_t kV2CompressionCookie = 0x1c849304 | 0x10;
+// Cookie, payload length, normalizing index offset, significant figures,
+// lowest and highest trackable value, and integer to double conversion ratio.
+constexpr size_t kEncodingHeaderSize = 40;
+// Cookie and compressed length.
+constexpr size_t kCompressionHeaderSize = 8;
+constexpr size_t kMaxVarIntSize = 9;
+
+void WriteBigEndian(uint8_t* out, uint64_t value, size_t size) {
+  for (size_t i = 0; i < size; i++)
+    out[i] = static_cast<uint8_t>(value >> (8 * (size - 1 - i)));
+}
+
+uint64_t ReadBigEndian(const uint8_t* in, size_t size) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; i++)
+    value = (value << 8) | in[i];
+  return value;
+}
+
+// Counts are written as ZigZag encoded LEB128 varints of at most 9 bytes, the
+// last of which holds 8 bits instead of 7.
+size_t WriteVarInt(uint8_t* out, int64_t signed_value) {
+  uint64_t value = (static_cast<uint64_t>(signed_value) << 1) ^
+                   static_cast<uint64_t>(signed_value >> 63);
+  size_t i = 0;
+  while (i < kMaxVarIntSize - 1 && value >= 0x80) {
+    out[i++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  out[i++] = static_cast<uint8_t>(value);
+  return i;
+}
+
+bool ReadVarInt(const std::vector<uint8_t>& in, size_t* pos, int64_t* result) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < kMaxVarIntSize; i++) {
+    if (*pos >= in.size()) return false;
+    uint8_t byte = in[(*pos)++];
+    if (i == kMaxVarIntSize - 1) {
+      value |= static_cast<uint64_t>(byte) << 56;
+      break;
+    }
+    value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+    if ((byte & 0x80) == 0) break;
+  }
+  *result = static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+  return true;
+}
+
+int64_t GetInt64(Local<Value> value) {
+  CHECK_IMPLIES(!value->IsNumber(), value->IsBigInt());
+  return value->IsBigInt()
+      ? value.As<BigInt>()->Int64Value()
+      : static_cast<int64_t>(value.As<Number>()->Value());
+}
+
+void EncodeHistogram(Environment* env,
+                     Histogram* histogram,
+                     const FunctionCallbackInfo<Value>& args) {
+  std::vector<uint8_t> data;
+  if (!histogram->Encode(&data))
+    return THROW_ERR_MEMORY_ALLOCATION_FAILED(env);
+  Local<Object> buffer;
+  if (Buffer::Copy(env, reinterpret_cast<char*>(data.data()), data.size())
+          .ToLocal(&buffer)) {
+    args.GetReturnValue().Set(buffer);
+  }
+}
+
+}  // anonymous namespace
+
+Histogram::Histogram(int64_t lowest, int64_t highest, int figures, bool atomic)
+    : atomic_(atomic) {
   hdr_histogram* histogram;
   CHECK_EQ(0, hdr_init(lowest, highest, figures, &histogram));
   histogram_.reset(histogram);
 }
 
+int64_t Histogram::Add(const Histogram& other) {
+  // Copy the recorded values of `other` first, so that the mutexes of both
+  // histograms are never held at the same time. This also makes adding a
+  // histogram to itself work.
+  std::vector<std::pair<int64_t, int64_t>> values;
+  int64_t exceeds;
+  {
+    Mutex::ScopedLock lock(other.mutex_);
+    hdr_iter iter;
+    hdr_iter_recorded_init(&iter, other.histogram_.get());
+    while (hdr_iter_next(&iter))
+      values.emplace_back(iter.value, iter.count);
+    exceeds = other.exceeds_;
+  }
+
+  Mutex::ScopedLock lock(mutex_);
+  int64_t dropped = 0;
+  for (const auto& value : values) {
+    if (!RecordValues(value.first, value.second))
+      dropped += value.second;
+  }
+  exceeds_ += exceeds + dropped;
+  return dropped;
+}
+
+bool Histogram::Encode(std::vector<uint8_t>* out) {
+  std::vector<uint8_t> encoded;
+  {
+    Mutex::ScopedLock lock(mutex_);
+    const hdr_histogram* h = histogram_.get();
+    int32_t limit = h->counts_len;
+    while (limit > 0 && h->counts[limit - 1] == 0)
+      limit--;
+
+    encoded.resize(kEncodingHeaderSize + limit * kMaxVarIntSize);
+    size_t length = kEncodingHeaderSize;
+    for (int32_t i = 0; i < limit;) {
+      int64_t count = h->counts[i++];
+      if (count == 0) {
+        // Runs of empty buckets are written as their negated length.
+        int64_t zeros = 1;
+        for (; i < limit && h->counts[i] == 0; i++)
+          zeros++;
+        count = -zeros;
+      }
+      length += WriteVarInt(&encoded[length], count);
+    }
+    encoded.resize(length);
+
+    uint64_t conversion_ratio;
+    memcpy(&conversion_ratio, &h->conversion_ratio, sizeof(conversion_ratio));
+    uint8_t* header = encoded.data();
+    WriteBigEndian(header, kV2EncodingCookie, 4);
+    WriteBigEndian(header + 4, length - kEncodingHeaderSize, 4);
+    WriteBigEndian(header + 8, h->normalizing_index_offset, 4);
+    WriteBigEndian(header + 12, h->significant_figures, 4);
+    WriteBigEndian(header + 16, h->lowest_trackable_value, 8);
+    WriteBigEndian(header + 24, h->highest_trackable_value, 8);
+    WriteBigEndian(header + 32, conversion_ratio, 8);
+  }
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+    return false;
+  out->resize(kCompressionHeaderSize + deflateBound(&stream, encoded.size()));
+  stream.next_in = encoded.data();
+  stream.avail_in = encoded.size();
+  stream.next_out = out->data() + kCompressionHeaderSize;
+  stream.avail_out = out->size() - kCompressionHeaderSize;
+  int err = deflate(&stream, Z_FINISH);
+  deflateEnd(&stream);
+  if (err != Z_STREAM_END)
+    return false;
+
+  WriteBigEndian(out->data(), kV2CompressionCookie, 4);
+  WriteBigEndian(out->data() + 4, stream.total_out, 4);
+  out->resize(kCompressionHeaderSize + stream.total_out);
+  return true;
+}
+
+std::shared_ptr<Histogram> Histogram::Decode(
+    const uint8_t* data, size_t length, bool atomic) {
+  if (length < kCompressionHeaderSize ||
+      ReadBigEndian(data, 4) != kV2CompressionCookie) {
+    return nullptr;
+  }
+  size_t compressed_length = ReadBigEndian(data + 4, 4);
+  if (compressed_length > length - kCompressionHeaderSize)
+    return nullptr;
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit(&stream) != Z_OK)
+    return nullptr;
+  auto cleanup = OnScopeLeave([&]() { inflateEnd(&stream); });
+
+  // Inflate the header first, so that the length of the payload can be
+  // checked against the size of the histogram before inflating the rest.
+  std::vector<uint8_t> encoded(kEncodingHeaderSize);
+  stream.next_in = const_cast<uint8_t*>(data + kCompressionHeaderSize);
+  stream.avail_in = compressed_length;
+  stream.next_out = encoded.data();
+  stream.avail_out = kEncodingHeaderSize;
+  int err = inflate(&stream, Z_SYNC_FLUSH);
+  if ((err != Z_OK && err != Z_STREAM_END) || stream.avail_out != 0)
+    return nullptr;
+
+  const uint8_t* header = encoded.data();
+  if (ReadBigEndian(header, 4) != kV2EncodingCookie)
+    return nullptr;
+  size_t payload_length = ReadBigEndian(header + 4, 4);
+  uint64_t figures = ReadBigEndian(header + 12, 4);
+  int64_t lowest = static_cast<int64_t>(ReadBigEndian(header + 16, 8));
+  int64_t highest = static_cast<int64_t>(ReadBigEndian(header + 24, 8));
+  // These are the conditions under which hdr_init() succeeds.
+  if (figures < 1 || figures > 5 || lowest < 1 || lowest > highest / 2)
+    return nullptr;
+
+  std::shared_ptr<Histogram> histogram =
+      std::make_shared<Histogram>(lowest, highest, figures, atomic);
+  hdr_histogram* h = histogram->histogram_.get();
+  if (payload_length > h->counts_len * kMaxVarIntSize)
+    return nullptr;
+
+  if (payload_length > 0) {
+    encoded.resize(kEncodingHeaderSize + payload_length);
+    stream.next_out = encoded.data() + kEncodingHeaderSize;
+    stream.avail_out = payload_length;
+    err = inflate(&stream, Z_SYNC_FLUSH);
+    if ((err != Z_OK && err != Z_STREAM_END) || stream.avail_out != 0)
+      return nullptr;
+  }
+
+  // The histogram has not been shared with other threads yet, so there is
+  // no need to lock it.
+  size_t pos = kEncodingHeaderSize;
+  int32_t index = 0;
+  while (pos < encoded.size()) {
+    int64_t count;
+    if (!ReadVarInt(encoded, &pos, &count))
+      return nullptr;
+    if (count < 0) {
+      if (count < static_cast<int64_t>(index) - h->counts_len)
+        return nullptr;
+      index += static_cast<int32_t>(-count);
+      continue;
+    }
+    if (index >= h->counts_len ||
+        count > std::numeric_limits<int64_t>::max() - h->total_count) {
+      return nullptr;
+    }
+    if (count > 0 &&
+        !hdr_record_values(h, hdr_value_at_index(h, index), count)) {
+      return nullptr;
+    }
+    index++;
+  }
+  return histogram;
+}
+
 void Histogram::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackFieldWithSize("histogram", GetMemorySize());
 }
 
-HistogramImpl::HistogramImpl(int64_t lowest, int64_t highest, int figures)
-    : histogram_(new Histogram(lowest, highest, figures)) {}
+HistogramImpl::HistogramImpl(
+    int64_t lowest, int64_t highest, int figures, bool atomic)
+    : histogram_(new Histogram(lowest, highest, figures, atomic)) {}
 
 HistogramImpl::HistogramImpl(std::shared_ptr<Histogram> histogram)
     : histogram_(std::move(histogram)) {}
@@ -36,9 +285,10 @@ HistogramBase::HistogramBase(
     Local<Object> wrap,
     int64_t lowest,
     int64_t highest,
-    int figures)
+    int figures,
+    bool atomic)
     : BaseObject(env, wrap),
-      HistogramImpl(lowest, highest, figures) {
+      HistogramImpl(lowest, highest, figures, atomic) {
   MakeWeak();
 }
 
@@ -88,6 +338,13 @@ void HistogramBase::GetStddev(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set((*histogram)->Stddev());
 }
 
+void HistogramBase::GetCount(const FunctionCallbackInfo<Value>& args) {
+  HistogramBase* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  double value = static_cast<double>((*histogram)->Count());
+  args.GetReturnValue().Set(value);
+}
+
 void HistogramBase::GetPercentile(const FunctionCallbackInfo<Value>& args) {
   HistogramBase* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
@@ -136,11 +393,54 @@ void HistogramBase::Record(const FunctionCallbackInfo<Value>& args) {
   (*histogram)->Record(value);
 }
 
+void HistogramBase::Add(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  HistogramBase* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  CHECK(args[0]->IsObject());
+  Local<Object> obj = args[0].As<Object>();
+  std::shared_ptr<Histogram> other;
+  if (GetConstructorTemplate(env)->HasInstance(obj)) {
+    HistogramBase* base;
+    ASSIGN_OR_RETURN_UNWRAP(&base, obj);
+    other = base->histogram();
+  } else {
+    CHECK(IntervalHistogram::GetConstructorTemplate(env)->HasInstance(obj));
+    IntervalHistogram* interval;
+    ASSIGN_OR_RETURN_UNWRAP(&interval, obj);
+    other = interval->histogram();
+  }
+  double dropped = static_cast<double>((*histogram)->Add(*other));
+  args.GetReturnValue().Set(dropped);
+}
+
+void HistogramBase::Encode(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  HistogramBase* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  EncodeHistogram(env, histogram->histogram().get(), args);
+}
+
+void HistogramBase::Decode(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsArrayBufferView());
+  ArrayBufferViewContents<uint8_t> data(args[0]);
+  std::shared_ptr<Histogram> histogram =
+      Histogram::Decode(data.data(), data.length(), args[1]->IsTrue());
+  // Returns undefined if the data is not a valid encoded histogram.
+  if (!histogram)
+    return;
+  BaseObjectPtr<HistogramBase> wrap = Create(env, std::move(histogram));
+  if (wrap)
+    args.GetReturnValue().Set(wrap->object());
+}
+
 BaseObjectPtr<HistogramBase> HistogramBase::Create(
     Environment* env,
     int64_t lowest,
     int64_t highest,
-    int figures) {
+    int figures,
+    bool atomic) {
   Local<Object> obj;
   if (!GetConstructorTemplate(env)
           ->InstanceTemplate()
@@ -149,7 +449,7 @@ BaseObjectPtr<HistogramBase> HistogramBase::Create(
   }
 
   return MakeBaseObject<HistogramBase>(
-      env, obj, lowest, highest, figures);
+      env, obj, lowest, highest, figures, atomic);
 }
 
 BaseObjectPtr<HistogramBase> HistogramBase::Create(
@@ -167,7 +467,17 @@ BaseObjectPtr<HistogramBase> HistogramBase::Create(
 void HistogramBase::New(const FunctionCallbackInfo<Value>& args) {
   CHECK(args.IsConstructCall());
   Environment* env = Environment::GetCurrent(args);
-  new HistogramBase(env, args.This());
+  if (args.Length() == 0) {
+    new HistogramBase(env, args.This());
+    return;
+  }
+  CHECK(args[2]->IsUint32());
+  new HistogramBase(env,
+                    args.This(),
+                    GetInt64(args[0]),
+                    GetInt64(args[1]),
+                    args[2].As<Uint32>()->Value(),
+                    args[3]->IsTrue());
 }
 
 Local<FunctionTemplate> HistogramBase::GetConstructorTemplate(
@@ -187,11 +497,14 @@ Local<FunctionTemplate> HistogramBase::GetConstructorTemplate(
     env->SetProtoMethodNoSideEffect(tmpl, "max", GetMax);
     env->SetProtoMethodNoSideEffect(tmpl, "mean", GetMean);
     env->SetProtoMethodNoSideEffect(tmpl, "stddev", GetStddev);
+    env->SetProtoMethodNoSideEffect(tmpl, "count", GetCount);
     env->SetProtoMethodNoSideEffect(tmpl, "percentile", GetPercentile);
     env->SetProtoMethodNoSideEffect(tmpl, "percentiles", GetPercentiles);
+    env->SetProtoMethodNoSideEffect(tmpl, "encode", Encode);
     env->SetProtoMethod(tmpl, "reset", DoReset);
     env->SetProtoMethod(tmpl, "record", Record);
     env->SetProtoMethod(tmpl, "recordDelta", RecordDelta);
+    env->SetProtoMethod(tmpl, "add", Add);
     env->set_histogram_ctor_template(tmpl);
   }
   return tmpl;
@@ -199,6 +512,7 @@ Local<FunctionTemplate> HistogramBase::GetConstructorTemplate(
 
 void HistogramBase::Initialize(Environment* env, Local<Object> target) {
   env->SetConstructorFunction(target, "Histogram", GetConstructorTemplate(env));
+  env->SetMethod(target, "decodeHistogram", Decode);
 }
 
 BaseObjectPtr<BaseObject> HistogramBase::HistogramTransferData::Deserialize(
@@ -230,8 +544,10 @@ Local<FunctionTemplate> IntervalHistogram::GetConstructorTemplate(
     env->SetProtoMethodNoSideEffect(tmpl, "max", GetMax);
     env->SetProtoMethodNoSideEffect(tmpl, "mean", GetMean);
     env->SetProtoMethodNoSideEffect(tmpl, "stddev", GetStddev);
+    env->SetProtoMethodNoSideEffect(tmpl, "count", GetCount);
     env->SetProtoMethodNoSideEffect(tmpl, "percentile", GetPercentile);
     env->SetProtoMethodNoSideEffect(tmpl, "percentiles", GetPercentiles);
+    env->SetProtoMethodNoSideEffect(tmpl, "encode", Encode);
     env->SetProtoMethod(tmpl, "reset", DoReset);
     env->SetProtoMethod(tmpl, "start", Start);
     env->SetProtoMethod(tmpl, "stop", Stop);
@@ -329,6 +645,13 @@ void IntervalHistogram::GetStddev(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set((*histogram)->Stddev());
 }
 
+void IntervalHistogram::GetCount(const FunctionCallbackInfo<Value>& args) {
+  IntervalHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  double value = static_cast<double>((*histogram)->Count());
+  args.GetReturnValue().Set(value);
+}
+
 void IntervalHistogram::GetPercentile(const FunctionCallbackInfo<Value>& args) {
   IntervalHistogram* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
@@ -358,6 +681,13 @@ void IntervalHistogram::DoReset(const FunctionCallbackInfo<Value>& args) {
   (*histogram)->Reset();
 }
 
+void IntervalHistogram::Encode(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  IntervalHistogram* histogram;
+  ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
+  EncodeHistogram(env, histogram->histogram().get(), args);
+}
+
 std::unique_ptr<worker::TransferData>
 IntervalHistogram::CloneForMessaging() const {
   return std::make_unique<HistogramBase::HistogramTransferData>(histogram());
@@ -14,20 +14,33 @@
 #include <functional>
 #include <limits>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace node {
 
 constexpr int kDefaultHistogramFigures = 3;
 
+// A histogram is shared by all the JS objects that refer to it, including
+// clones of them sent to other threads. By default, a mutex serializes all
+// accesses to it. An atomic histogram instead records values without taking
+// the mutex, so that several threads can record into it at the same time at
+// the cost of reads possibly observing a recording that is in progress.
 class Histogram : public MemoryRetainer {
  public:
   Histogram(
       int64_t lowest = 1,
       int64_t highest = std::numeric_limits<int64_t>::max(),
-      int figures = kDefaultHistogramFigures);
+      int figures = kDefaultHistogramFigures,
+      bool atomic = false);
   virtual ~Histogram() = default;
 
+  // Parses a histogram in the HdrHistogram V2 compressed encoding, as
+  // written by Encode(). Returns nullptr if `data` is not a valid encoding.
+  static std::shared_ptr<Histogram> Decode(
+      const uint8_t* data, size_t length, bool atomic = false);
+
   inline bool Record(int64_t value);
   inline void Reset();
   inline int64_t Min();
@@ -35,10 +48,21 @@ class Histogram : public MemoryRetainer {
   inline double Mean();
   inline double Stddev();
   inline double Percentile(double percentile);
+  inline int64_t Count();
   inline int64_t Exceeds() const { return exceeds_; }
+  inline bool IsAtomic() const { return atomic_; }
 
   inline uint64_t RecordDelta();
 
+  // Records all the values of `other` into this histogram, and returns the
+  // number of values that were out of its range.
+  int64_t Add(const Histogram& other);
+
+  // Appends the contents of the histogram in the HdrHistogram V2 compressed
+  // encoding, which the HdrHistogram libraries for other languages and their
+  // log tools understand, to `out`.
+  bool Encode(std::vector<uint8_t>* out);
+
   // Iterator is a function type that takes two doubles as argument, one for
   // percentile and one for the value at that percentile.
   template <typename Iterator>
@@ -51,8 +75,13 @@ class Histogram : public MemoryRetainer {
   SET_SELF_SIZE(Histogram)
 
  private:
+  // Records `count` times `value`. Unless the histogram is atomic, the mutex
+  // has to be held by the caller.
+  inline bool RecordValues(int64_t value, int64_t count);
+
   using HistogramPointer = DeleteFnPtr<hdr_histogram, hdr_close>;
   HistogramPointer histogram_;
+  const bool atomic_;
   int64_t exceeds_ = 0;
   uint64_t prev_ = 0;
 
@@ -61,12 +90,12 @@ class Histogram : public MemoryRetainer {
 
 class HistogramImpl {
  public:
-  HistogramImpl(int64_t lowest, int64_t highest, int figures);
+  HistogramImpl(int64_t lowest, int64_t highest, int figures,
+                bool atomic = false);
   explicit HistogramImpl(std::shared_ptr<Histogram> histogram);
 
   Histogram* operator->() { return histogram_.get(); }
 
- protected:
   const std::shared_ptr<Histogram>& histogram() const { return histogram_; }
 
  private:
@@ -83,7 +112,8 @@ class HistogramBase : public BaseObject, public HistogramImpl {
       Environment* env,
       int64_t lowest = 1,
       int64_t highest = std::numeric_limits<int64_t>::max(),
-      int figures = kDefaultHistogramFigures);
+      int figures = kDefaultHistogramFigures,
+      bool atomic = false);
 
   static BaseObjectPtr<HistogramBase> Create(
       Environment* env,
@@ -100,6 +130,7 @@ class HistogramBase : public BaseObject, public HistogramImpl {
   static void GetMean(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetExceeds(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetStddev(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetCount(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetPercentile(
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetPercentiles(
@@ -107,13 +138,17 @@ class HistogramBase : public BaseObject, public HistogramImpl {
   static void DoReset(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Record(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void RecordDelta(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Add(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Encode(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Decode(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   HistogramBase(
       Environment* env,
       v8::Local<v8::Object> wrap,
       int64_t lowest = 1,
       int64_t highest = std::numeric_limits<int64_t>::max(),
-      int figures = kDefaultHistogramFigures);
+      int figures = kDefaultHistogramFigures,
+      bool atomic = false);
 
   HistogramBase(
       Environment* env,
@@ -181,11 +216,13 @@ class IntervalHistogram : public HandleWrap, public HistogramImpl {
   static void GetMean(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetExceeds(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetStddev(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetCount(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetPercentile(
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetPercentiles(
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void DoReset(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Encode(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Start(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Stop(const v8::FunctionCallbackInfo<v8::Value>& args);
 
@@ -7,6 +7,7 @@
 #include "node_external_reference.h"
 #include "node_file.h"
 #include "node_internals.h"
+#include "node_pprof.h"
 #include "util-inl.h"
 #include "v8-inspector.h"
 
@@ -18,6 +19,10 @@ namespace profiler {
 
 using errors::TryCatchScope;
 using v8::Context;
+using v8::CpuProfile;
+using v8::CpuProfileNode;
+using v8::CpuProfiler;
+using v8::CpuProfilingOptions;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::HandleScope;
@@ -398,6 +403,165 @@ void V8HeapProfilerConnection::End() {
   DispatchMessage("HeapProfiler.stopSampling", nullptr, true);
 }
 
+V8ContinuousCpuProfiler::V8ContinuousCpuProfiler(Environment* env)
+    : env_(env) {
+  CHECK_EQ(uv_timer_init(env->event_loop(), &timer_), 0);
+  uv_unref(reinterpret_cast<uv_handle_t*>(&timer_));
+  env->AddCleanupHook(CloseTimer, this);
+}
+
+V8ContinuousCpuProfiler::~V8ContinuousCpuProfiler() {
+  CHECK(timer_closed_);
+  if (profiler_ != nullptr) {
+    profiler_->Dispose();
+  }
+}
+
+void V8ContinuousCpuProfiler::CloseTimer(void* data) {
+  V8ContinuousCpuProfiler* profiler =
+      static_cast<V8ContinuousCpuProfiler*>(data);
+  profiler->env_->CloseHandle(&profiler->timer_, [](uv_timer_t* timer) {
+    V8ContinuousCpuProfiler* profiler =
+        ContainerOf(&V8ContinuousCpuProfiler::timer_, timer);
+    profiler->timer_closed_ = true;
+  });
+}
+
+Local<String> V8ContinuousCpuProfiler::GetTitle(uint32_t index) const {
+  std::string title = "node:continuous:" + std::to_string(index);
+  return OneByteString(env_->isolate(), title.c_str(), title.size());
+}
+
+void V8ContinuousCpuProfiler::StartProfile() {
+  // With a sample limit of 0, V8 only updates the hit counts in the call
+  // tree instead of recording every sample with its timestamp.
+  profiler_->StartProfiling(GetTitle(profile_index_),
+                            CpuProfilingOptions(v8::kLeafNodeLineNumbers, 0));
+  profile_start_time_ = GetCurrentTimeInMicroseconds();
+}
+
+void V8ContinuousCpuProfiler::Start() {
+  HandleScope handle_scope(env_->isolate());
+  profiler_ = CpuProfiler::New(env_->isolate());
+  profiler_->SetSamplingInterval(static_cast<int>(env_->cpu_prof_interval()));
+  StartProfile();
+  uint64_t interval = env_->options()->cpu_prof_rotate_interval * 1000;
+  uv_timer_start(&timer_, OnTimer, interval, interval);
+}
+
+void V8ContinuousCpuProfiler::OnTimer(uv_timer_t* timer) {
+  V8ContinuousCpuProfiler* profiler =
+      ContainerOf(&V8ContinuousCpuProfiler::timer_, timer);
+  profiler->Rotate();
+}
+
+void V8ContinuousCpuProfiler::Rotate() {
+  Debug(env_,
+        DebugCategory::INSPECTOR_PROFILER,
+        "V8ContinuousCpuProfiler::Rotate(), profile = %d\n",
+        profile_index_);
+  HandleScope handle_scope(env_->isolate());
+  Local<String> title = GetTitle(profile_index_);
+  double start_time = profile_start_time_;
+  // Start the next profile before stopping the current one, so that no
+  // samples are lost in between.
+  profile_index_++;
+  StartProfile();
+  CpuProfile* profile = profiler_->StopProfiling(title);
+  if (profile == nullptr) return;
+  WriteProfile(profile, start_time);
+  profile->Delete();
+}
+
+void V8ContinuousCpuProfiler::End() {
+  Debug(env_,
+        DebugCategory::INSPECTOR_PROFILER,
+        "V8ContinuousCpuProfiler::End(), ending = %d\n", ending_);
+  if (ending_ || profiler_ == nullptr) {
+    return;
+  }
+  ending_ = true;
+  if (!timer_closed_) {
+    uv_timer_stop(&timer_);
+  }
+  HandleScope handle_scope(env_->isolate());
+  CpuProfile* profile = profiler_->StopProfiling(GetTitle(profile_index_));
+  if (profile == nullptr) return;
+  WriteProfile(profile, profile_start_time_);
+  profile->Delete();
+}
+
+void V8ContinuousCpuProfiler::WriteProfile(const CpuProfile* profile,
+                                           double start_time) {
+  pprof::ProfileBuilder builder;
+  int64_t period = static_cast<int64_t>(env_->cpu_prof_interval()) * 1000;
+  builder.AddSampleType("samples", "count");
+  builder.AddSampleType("cpu", "nanoseconds");
+  builder.SetPeriod("cpu", "nanoseconds", period);
+  builder.SetTime(static_cast<int64_t>(start_time) * 1000,
+                  (profile->GetEndTime() - profile->GetStartTime()) * 1000);
+
+  // Walk the call tree without recursion, since it can be as deep as the
+  // deepest JavaScript stack that was sampled. `stack` holds the locations
+  // from the root to the current node.
+  std::vector<std::pair<const CpuProfileNode*, size_t>> pending;
+  std::vector<uint64_t> stack;
+  std::vector<uint64_t> locations;
+  const CpuProfileNode* root = profile->GetTopDownRoot();
+  for (int i = root->GetChildrenCount() - 1; i >= 0; i--) {
+    pending.emplace_back(root->GetChild(i), 0);
+  }
+  while (!pending.empty()) {
+    const CpuProfileNode* node = pending.back().first;
+    size_t depth = pending.back().second;
+    pending.pop_back();
+
+    const char* name = node->GetFunctionNameStr();
+    if (*name == '\0') name = "(anonymous)";
+    int line = node->GetLineNumber();
+    stack.resize(depth);
+    stack.push_back(builder.GetLocation(
+        name, node->GetScriptResourceNameStr(), line, line));
+
+    int64_t hits = node->GetHitCount();
+    if (hits > 0) {
+      locations.assign(stack.rbegin(), stack.rend());
+      builder.AddSample(locations, { hits, hits * period });
+    }
+    for (int i = node->GetChildrenCount() - 1; i >= 0; i--) {
+      pending.emplace_back(node->GetChild(i), depth + 1);
+    }
+  }
+
+  std::string data;
+  if (!builder.SerializeGzip(&data)) {
+    fprintf(stderr, "Failed to compress CPU profile\n");
+    return;
+  }
+
+  const std::string& directory = env_->cpu_prof_dir();
+  DCHECK(!directory.empty());
+  if (!EnsureDirectory(directory, "CPU")) {
+    return;
+  }
+  DiagnosticFilename filename(env_, "CPU", "pb.gz");
+  std::string path = directory + kPathSeparator;
+  path += *filename;
+  int ret = WriteFileSync(path.c_str(), uv_buf_init(&data[0], data.size()));
+  if (ret != 0) {
+    char err_buf[128];
+    uv_err_name_r(ret, err_buf, sizeof(err_buf));
+    fprintf(stderr, "%s: Failed to write file %s\n", err_buf, path.c_str());
+    return;
+  }
+  Debug(env_,
+        DebugCategory::INSPECTOR_PROFILER,
+        "Written %zu samples of %zu functions to %s\n",
+        builder.sample_count(),
+        builder.function_count(),
+        path);
+}
+
 // For now, we only support coverage profiling, but we may add more
 // in the future.
 static void EndStartedProfilers(Environment* env) {
@@ -413,6 +577,12 @@ static void EndStartedProfilers(Environment* env) {
     connection->End();
   }
 
+  V8ContinuousCpuProfiler* continuous_profiler =
+      env->continuous_cpu_profiler();
+  if (continuous_profiler != nullptr) {
+    continuous_profiler->End();
+  }
+
   connection = env->coverage_connection();
   if (connection != nullptr) {
     connection->End();
@@ -433,10 +603,12 @@ void StartProfilers(Environment* env) {
     env->set_coverage_connection(std::make_unique<V8CoverageConnection>(env));
     env->coverage_connection()->Start();
   }
-  if (env->options()->cpu_prof) {
+  if (env->options()->cpu_prof || env->options()->cpu_prof_continuous) {
     const std::string& dir = env->options()->cpu_prof_dir;
     env->set_cpu_prof_interval(env->options()->cpu_prof_interval);
     env->set_cpu_prof_dir(dir.empty() ? env->GetCwd() : dir);
+  }
+  if (env->options()->cpu_prof) {
     if (env->options()->cpu_prof_name.empty()) {
       DiagnosticFilename filename(env, "CPU", "cpuprofile");
       env->set_cpu_prof_name(*filename);
@@ -448,6 +620,11 @@ void StartProfilers(Environment* env) {
         std::make_unique<V8CpuProfilerConnection>(env));
     env->cpu_profiler_connection()->Start();
   }
+  if (env->options()->cpu_prof_continuous) {
+    env->set_continuous_cpu_profiler(
+        std::make_unique<V8ContinuousCpuProfiler>(env));
+    env->continuous_cpu_profiler()->Start();
+  }
   if (env->options()->heap_prof) {
     const std::string& dir = env->options()->heap_prof_dir;
     env->set_heap_prof_interval(env->options()->heap_prof_interval);
@@ -9,6 +9,8 @@
 
 #include <unordered_set>
 #include "inspector_agent.h"
+#include "uv.h"
+#include "v8-profiler.h"
 
 namespace node {
 // Forward declaration to break recursive dependency chain with src/env.h.
@@ -142,6 +144,40 @@ class V8HeapProfilerConnection : public V8ProfilerConnection {
   bool ending_ = false;
 };
 
+// Samples the CPU with v8::CpuProfiler directly instead of going through the
+// inspector protocol, and writes out the profile collected so far as a
+// gzipped pprof file every --cpu-prof-rotate-interval seconds. Only the
+// aggregated call tree is kept between rotations, which keeps the overhead
+// low enough to leave it running in production.
+class V8ContinuousCpuProfiler {
+ public:
+  explicit V8ContinuousCpuProfiler(Environment* env);
+  ~V8ContinuousCpuProfiler();
+
+  void Start();
+  void End();
+  // Writes out the profile collected since the last rotation and starts a
+  // new one.
+  void Rotate();
+
+ private:
+  v8::Local<v8::String> GetTitle(uint32_t index) const;
+  void StartProfile();
+  void WriteProfile(const v8::CpuProfile* profile, double start_time);
+  static void OnTimer(uv_timer_t* timer);
+  static void CloseTimer(void* data);
+
+  Environment* env_;
+  v8::CpuProfiler* profiler_ = nullptr;
+  uv_timer_t timer_;
+  bool timer_closed_ = false;
+  // The index of the profile that is currently being collected.
+  uint32_t profile_index_ = 0;
+  // The wall clock time at which that profile was started, in microseconds.
+  double profile_start_time_ = 0;
+  bool ending_ = false;
+};
+
 }  // namespace profiler
 }  // namespace node
 
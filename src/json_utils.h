@@ -18,6 +18,11 @@ class JSONWriter {
  public:
   JSONWriter(std::ostream& out, bool compact)
     : out_(out), compact_(compact) {}
+  // Creates a writer for the members of an object or the elements of an array
+  // that is written by another JSONWriter, in which it is nested `indent`
+  // spaces deep. The output can be added to that writer with json_fragment().
+  JSONWriter(std::ostream& out, bool compact, int indent)
+    : out_(out), compact_(compact), indent_(indent) {}
 
  private:
   inline void indent() { indent_ += 2; }
@@ -117,6 +122,15 @@ class JSONWriter {
     state_ = kAfterValue;
   }
 
+  // Writes members or elements that were written by a JSONWriter created
+  // with the current indentation of this one.
+  inline void json_fragment(const std::string& fragment) {
+    if (fragment.empty()) return;
+    if (state_ == kAfterValue) out_ << ',';
+    out_ << fragment;
+    state_ = kAfterValue;
+  }
+
   struct Null {};  // Usable as a JSON value.
 
   struct ForeignJSON {
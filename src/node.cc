@@ -452,6 +452,16 @@ MaybeLocal<Value> StartExecution(Environment* env, const char* main_script_id) {
       ExecuteBootstrapper(env, main_script_id, &parameters, &arguments));
 }
 
+static MaybeLocal<Value> RunSnapshotDeserializeMain(Environment* env) {
+  EscapableHandleScope scope(env->isolate());
+  Local<Value> arguments[] = {
+      env->NewFunctionTemplate(MarkBootstrapComplete)
+          ->GetFunction(env->context())
+          .ToLocalChecked()};
+  return scope.EscapeMaybe(env->snapshot_deserialize_main()->Call(
+      env->context(), env->process_object(), arraysize(arguments), arguments));
+}
+
 MaybeLocal<Value> StartExecution(Environment* env, StartExecutionCallback cb) {
   InternalCallbackScope callback_scope(
       env,
@@ -477,6 +487,16 @@ MaybeLocal<Value> StartExecution(Environment* env, StartExecutionCallback cb) {
     return StartExecution(env, "internal/main/worker_thread");
   }
 
+  if (per_process::cli_options->build_snapshot) {
+    return StartExecution(env, "internal/main/mksnapshot");
+  }
+
+  // The application was started from a user-land snapshot that configured
+  // its own main function, see v8.startupSnapshot.setDeserializeMainFunction().
+  if (!env->snapshot_deserialize_main().IsEmpty()) {
+    return RunSnapshotDeserializeMain(env);
+  }
+
   std::string first_argv;
   if (env->argv().size() > 1) {
     first_argv = env->argv()[1];
@@ -834,6 +854,7 @@ int ProcessGlobalArgs(std::vector<std::string>* args,
     int argc = v8_args.size();
     V8::SetFlagsFromCommandLine(&argc, &v8_args_as_char_ptr[0], true);
     v8_args_as_char_ptr.resize(argc);
+    heap::RecordV8Flags(v8_args);
   }
 
   // Anything that's still in v8_argv is not a V8 or a node option.
@@ -1122,19 +1143,81 @@ void TearDownOncePerProcess() {
   per_process::v8_platform.Dispose();
 }
 
+// Run the entry point script given to --build-snapshot and write the
+// resulting snapshot blob to the path given to --snapshot-blob.
+static int GenerateAndWriteSnapshotData(const InitializationResult& result) {
+  if (result.args.size() < 2) {
+    fprintf(stderr,
+            "%s: --build-snapshot must be used with an entry point script\n",
+            result.args.at(0).c_str());
+    return 9;
+  }
+
+  std::string blob_path = per_process::cli_options->snapshot_blob;
+  if (blob_path.empty()) {
+    blob_path = "snapshot.blob";
+  }
+
+  SnapshotData snapshot_data;
+  int exit_code =
+      SnapshotBuilder::Generate(&snapshot_data, result.args, result.exec_args);
+  if (exit_code == 0) {
+    FILE* fp = fopen(blob_path.c_str(), "wb");
+    if (fp == nullptr) {
+      fprintf(stderr, "Cannot open %s for writing\n", blob_path.c_str());
+      exit_code = 1;
+    } else {
+      if (!snapshot_data.ToBlob(fp)) {
+        fprintf(stderr, "Cannot write snapshot blob to %s\n",
+                blob_path.c_str());
+        exit_code = 1;
+      }
+      fclose(fp);
+    }
+  }
+  return exit_code;
+}
+
 int Start(int argc, char** argv) {
   InitializationResult result = InitializeOncePerProcess(argc, argv);
   if (result.early_return) {
     return result.exit_code;
   }
 
+  if (per_process::cli_options->build_snapshot) {
+    result.exit_code = GenerateAndWriteSnapshotData(result);
+    TearDownOncePerProcess();
+    return result.exit_code;
+  }
+
   {
     Isolate::CreateParams params;
     const std::vector<size_t>* indices = nullptr;
     const EnvSerializeInfo* env_info = nullptr;
     bool force_no_snapshot =
         per_process::cli_options->per_isolate->no_node_snapshot;
-    if (!force_no_snapshot) {
+    const std::string& snapshot_blob_path =
+        per_process::cli_options->snapshot_blob;
+    SnapshotData snapshot_data;
+    if (!snapshot_blob_path.empty()) {
+      FILE* fp = fopen(snapshot_blob_path.c_str(), "rb");
+      bool loaded = fp != nullptr &&
+                    SnapshotData::FromBlob(&snapshot_data, fp);
+      if (fp != nullptr) {
+        fclose(fp);
+      }
+      if (!loaded) {
+        fprintf(stderr,
+                "Cannot load snapshot blob from %s, it must be built by "
+                "this Node.js binary with --build-snapshot\n",
+                snapshot_blob_path.c_str());
+        TearDownOncePerProcess();
+        return 1;
+      }
+      params.snapshot_blob = &snapshot_data.blob;
+      indices = &snapshot_data.isolate_data_indices;
+      env_info = &snapshot_data.env_info;
+    } else if (!force_no_snapshot) {
       v8::StartupData* blob = NodeMainInstance::GetEmbeddedSnapshotBlob();
       if (blob != nullptr) {
         params.snapshot_blob = blob;
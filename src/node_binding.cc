@@ -57,6 +57,7 @@
   V(js_stream)                                                                 \
   V(js_udp_wrap)                                                               \
   V(messaging)                                                                 \
+  V(mksnapshot)                                                                \
   V(module_wrap)                                                               \
   V(native_module)                                                             \
   V(options)                                                                   \
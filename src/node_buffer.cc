@@ -49,6 +49,7 @@
 namespace node {
 namespace Buffer {
 
+using v8::Array;
 using v8::ArrayBuffer;
 using v8::ArrayBufferView;
 using v8::BackingStore;
@@ -1038,6 +1039,146 @@ void IndexOfNumber(const FunctionCallbackInfo<Value>& args) {
                                 : -1);
 }
 
+// Finds the first offset >= args[2] at which any of the buffers in the
+// args[1] array occurs in args[0], or -1.
+void IndexOfAny(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[1]->IsArray());
+  CHECK(args[2]->IsNumber());
+
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+  ArrayBufferViewContents<char> haystack_contents(args[0]);
+  Local<Array> needles = args[1].As<Array>();
+  int64_t offset_i64 = args[2].As<Integer>()->Value();
+
+  const uint8_t* haystack =
+      reinterpret_cast<const uint8_t*>(haystack_contents.data());
+  const size_t haystack_length = haystack_contents.length();
+
+  int64_t best = -1;
+  for (uint32_t i = 0; i < needles->Length(); i++) {
+    Local<Value> needle_value;
+    if (!needles->Get(env->context(), i).ToLocal(&needle_value)) return;
+    THROW_AND_RETURN_UNLESS_BUFFER(env, needle_value);
+    ArrayBufferViewContents<uint8_t> needle(needle_value);
+
+    int64_t opt_offset =
+        IndexOfOffset(haystack_length, offset_i64, needle.length(), true);
+    if (opt_offset <= -1) continue;
+    if (needle.length() == 0) {
+      if (best == -1 || opt_offset < best)
+        best = opt_offset;
+      continue;
+    }
+    // Only look for matches that start before the best one found so far.
+    size_t search_length = haystack_length;
+    if (best != -1) {
+      if (opt_offset >= best) continue;
+      search_length = std::min(
+          haystack_length, static_cast<size_t>(best) - 1 + needle.length());
+    }
+    size_t offset = static_cast<size_t>(opt_offset);
+    if (needle.length() + offset > search_length) continue;
+
+    size_t result = SearchString(haystack,
+                                 search_length,
+                                 needle.data(),
+                                 needle.length(),
+                                 offset,
+                                 true);
+    if (result != search_length)
+      best = static_cast<int64_t>(result);
+  }
+
+  args.GetReturnValue().Set(static_cast<double>(best));
+}
+
+// Finds the first occurrence of the args[1] buffer in the byte sequence
+// formed by the list of buffers in args[0], at an offset >= args[2] into
+// that sequence. Matches that span several buffers are found without
+// concatenating the list.
+void IndexOfList(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsArray());
+  CHECK(args[2]->IsNumber());
+
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[1]);
+  Local<Array> list = args[0].As<Array>();
+  ArrayBufferViewContents<uint8_t> needle_contents(args[1]);
+  const uint8_t* needle = needle_contents.data();
+  const size_t needle_length = needle_contents.length();
+  const size_t offset = static_cast<size_t>(args[2].As<Number>()->Value());
+  CHECK_GT(needle_length, 0);
+
+  // The last `needle_length - 1` bytes of the sequence preceding the current
+  // buffer, followed by the first bytes of the current buffer. Matches that
+  // start inside of it and end inside of the current buffer span buffers.
+  MaybeStackBuffer<uint8_t> window(2 * (needle_length - 1));
+  size_t tail_length = 0;
+  size_t start = 0;  // Offset of the current buffer in the sequence.
+
+  for (uint32_t i = 0; i < list->Length(); i++) {
+    Local<Value> value;
+    if (!list->Get(env->context(), i).ToLocal(&value)) return;
+    THROW_AND_RETURN_UNLESS_BUFFER(env, value);
+    ArrayBufferViewContents<uint8_t> contents(value);
+    const uint8_t* data = contents.data();
+    const size_t length = contents.length();
+    if (length == 0) continue;
+
+    if (tail_length > 0) {
+      const size_t tail_start = start - tail_length;
+      const size_t head_length = std::min(length, needle_length - 1);
+      memcpy(window.out() + tail_length, data, head_length);
+      const size_t window_length = tail_length + head_length;
+      const size_t window_offset =
+          offset > tail_start ? offset - tail_start : 0;
+      if (window_offset < tail_length && window_length >= needle_length) {
+        size_t result = SearchString(window.out(),
+                                     window_length,
+                                     needle,
+                                     needle_length,
+                                     window_offset,
+                                     true);
+        if (result < tail_length)
+          return args.GetReturnValue().Set(
+              static_cast<double>(tail_start + result));
+      }
+    }
+
+    const size_t local_offset = offset > start ? offset - start : 0;
+    if (local_offset < length && needle_length <= length - local_offset) {
+      size_t result = SearchString(data,
+                                   length,
+                                   needle,
+                                   needle_length,
+                                   local_offset,
+                                   true);
+      if (result != length)
+        return args.GetReturnValue().Set(static_cast<double>(start + result));
+    }
+
+    // Keep the last `needle_length - 1` bytes of the sequence for the next
+    // buffer.
+    if (needle_length > 1) {
+      const size_t keep = needle_length - 1;
+      if (length >= keep) {
+        memcpy(window.out(), data + length - keep, keep);
+        tail_length = keep;
+      } else {
+        const size_t drop =
+            tail_length + length > keep ? tail_length + length - keep : 0;
+        memmove(window.out(), window.out() + drop, tail_length - drop);
+        memcpy(window.out() + tail_length - drop, data, length);
+        tail_length = tail_length - drop + length;
+      }
+    }
+    start += length;
+  }
+
+  args.GetReturnValue().Set(-1);
+}
+
 
 void Swap16(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -1175,6 +1316,8 @@ void Initialize(Local<Object> target,
   env->SetMethodNoSideEffect(target, "indexOfBuffer", IndexOfBuffer);
   env->SetMethodNoSideEffect(target, "indexOfNumber", IndexOfNumber);
   env->SetMethodNoSideEffect(target, "indexOfString", IndexOfString);
+  env->SetMethodNoSideEffect(target, "indexOfAny", IndexOfAny);
+  env->SetMethodNoSideEffect(target, "indexOfList", IndexOfList);
 
   env->SetMethod(target, "swap16", Swap16);
   env->SetMethod(target, "swap32", Swap32);
@@ -1226,6 +1369,8 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(IndexOfBuffer);
   registry->Register(IndexOfNumber);
   registry->Register(IndexOfString);
+  registry->Register(IndexOfAny);
+  registry->Register(IndexOfList);
 
   registry->Register(Swap16);
   registry->Register(Swap32);
@@ -25,6 +25,7 @@
 
 #include "async_wrap-inl.h"
 #include "env-inl.h"
+#include "histogram-inl.h"
 #include "memory_tracker-inl.h"
 #include "stream_base-inl.h"
 #include "v8.h"
@@ -32,6 +33,9 @@
 
 #include <cstdlib>  // free()
 #include <cstring>  // strdup(), strchr()
+#include <deque>
+#include <string>
+#include <unordered_map>
 
 
 // This is a binding to llhttp (https://github.com/nodejs/llhttp)
@@ -100,8 +104,24 @@ class BindingData : public BaseObject {
   std::vector<char> parser_buffer;
   bool parser_buffer_in_use = false;
 
+  // The histograms into which server parsers record the timings of each
+  // request, indexed by the route id that JS passes for the request once its
+  // response has finished. See lib/internal/perf/http_routes.js.
+  struct RouteHistograms {
+    std::shared_ptr<Histogram> parse;
+    std::shared_ptr<Histogram> response;
+    std::shared_ptr<Histogram> bytes;
+  };
+  std::vector<RouteHistograms> routes;
+  bool monitor_routes = false;
+  // Incremented every time monitoring is enabled, so that parsers can tell
+  // apart requests that were received before it was last disabled.
+  uint32_t monitor_generation = 0;
+
   void MemoryInfo(MemoryTracker* tracker) const override {
     tracker->TrackField("parser_buffer", parser_buffer);
+    tracker->TrackFieldWithSize("routes",
+                                routes.size() * sizeof(RouteHistograms));
   }
   SET_SELF_SIZE(BindingData)
   SET_MEMORY_INFO_NAME(BindingData)
@@ -190,6 +210,105 @@ struct StringPtr {
   size_t size_;
 };
 
+// A table of prebuilt responses that server parsers write to the socket
+// themselves, without calling into JS, for requests whose method and path
+// match an entry. Shared by all of the parsers of a server, see
+// `server.setStaticResponse()` in lib/_http_server.js.
+class StaticResponses : public BaseObject {
+ public:
+  struct Entry {
+    // Not modified once created, so that writes that are still pending can
+    // keep a reference to it after the entry has been replaced.
+    std::shared_ptr<const std::string> response;
+    // The length of the status line and headers, which is all that is sent
+    // for HEAD requests.
+    size_t head_length = 0;
+    uint64_t hits = 0;
+  };
+
+  StaticResponses(Environment* env, Local<Object> wrap)
+      : BaseObject(env, wrap) {
+    MakeWeak();
+  }
+
+  // Looks up the entry for `method` and `path`, falling back to the ones
+  // registered for any path ("*") and then for any method.
+  Entry* Find(const char* method, const char* path, size_t path_length) {
+    if (entries_.empty()) return nullptr;
+    static const char* const kAny = "*";
+    const char* methods[] = { method, method, kAny, kAny };
+    for (size_t i = 0; i < arraysize(methods); i++) {
+      bool any_path = i % 2 == 1;
+      key_.assign(methods[i]);
+      key_ += ' ';
+      if (any_path)
+        key_ += '*';
+      else
+        key_.append(path, path_length);
+      auto it = entries_.find(key_);
+      if (it != entries_.end()) return &it->second;
+    }
+    return nullptr;
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args.IsConstructCall());
+    Environment* env = Environment::GetCurrent(args);
+    new StaticResponses(env, args.This());
+  }
+
+  // set(key, response, headLength)
+  static void Set(const FunctionCallbackInfo<Value>& args) {
+    StaticResponses* responses;
+    ASSIGN_OR_RETURN_UNWRAP(&responses, args.Holder());
+    CHECK(args[0]->IsString());
+    CHECK(args[1]->IsArrayBufferView());
+    CHECK(args[2]->IsUint32());
+    Utf8Value key(args.GetIsolate(), args[0]);
+    ArrayBufferViewContents<char> response(args[1]);
+    Entry& entry = responses->entries_[*key];
+    entry.response = std::make_shared<const std::string>(response.data(),
+                                                         response.length());
+    entry.head_length = args[2].As<Uint32>()->Value();
+    CHECK_LE(entry.head_length, entry.response->size());
+  }
+
+  // delete(key)
+  static void Delete(const FunctionCallbackInfo<Value>& args) {
+    StaticResponses* responses;
+    ASSIGN_OR_RETURN_UNWRAP(&responses, args.Holder());
+    CHECK(args[0]->IsString());
+    Utf8Value key(args.GetIsolate(), args[0]);
+    responses->entries_.erase(*key);
+  }
+
+  // hits(key)
+  static void Hits(const FunctionCallbackInfo<Value>& args) {
+    StaticResponses* responses;
+    ASSIGN_OR_RETURN_UNWRAP(&responses, args.Holder());
+    CHECK(args[0]->IsString());
+    Utf8Value key(args.GetIsolate(), args[0]);
+    auto it = responses->entries_.find(*key);
+    uint64_t hits = it != responses->entries_.end() ? it->second.hits : 0;
+    args.GetReturnValue().Set(static_cast<double>(hits));
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    size_t size = 0;
+    for (const auto& it : entries_)
+      size += it.first.size() + it.second.response->size() + sizeof(Entry);
+    tracker->TrackFieldWithSize("entries", size);
+  }
+  SET_MEMORY_INFO_NAME(StaticResponses)
+  SET_SELF_SIZE(StaticResponses)
+
+ private:
+  // Keyed by method and path, separated by a space.
+  std::unordered_map<std::string, Entry> entries_;
+  // Scratch space for the lookup key, to avoid an allocation per request.
+  std::string key_;
+};
+
 class Parser : public AsyncWrap, public StreamListener {
  public:
   Parser(BindingData* binding_data, Local<Object> wrap)
@@ -212,6 +331,8 @@ class Parser : public AsyncWrap, public StreamListener {
     url_.Reset();
     status_message_.Reset();
     header_parsing_start_time_ = uv_hrtime();
+    message_bytes_ = 0;
+    timing_body_ = false;
 
     Local<Value> cb = object()->Get(env()->context(), kOnMessageBegin)
                               .ToLocalChecked();
@@ -230,6 +351,7 @@ class Parser : public AsyncWrap, public StreamListener {
 
 
   int on_url(const char* at, size_t length) {
+    message_bytes_ += length;
     int rv = TrackHeader(length);
     if (rv != 0) {
       return rv;
@@ -252,6 +374,7 @@ class Parser : public AsyncWrap, public StreamListener {
 
 
   int on_header_field(const char* at, size_t length) {
+    message_bytes_ += length;
     int rv = TrackHeader(length);
     if (rv != 0) {
       return rv;
@@ -279,6 +402,7 @@ class Parser : public AsyncWrap, public StreamListener {
 
 
   int on_header_value(const char* at, size_t length) {
+    message_bytes_ += length;
     int rv = TrackHeader(length);
     if (rv != 0) {
       return rv;
@@ -300,6 +424,28 @@ class Parser : public AsyncWrap, public StreamListener {
 
 
   int on_headers_complete() {
+    if (static_responses_ && RespondStatically()) {
+      header_nread_ = 0;
+      header_parsing_start_time_ = 0;
+      num_fields_ = 0;
+      num_values_ = 0;
+      static_message_ = true;
+      return 0;
+    }
+    if (type_ == HTTP_REQUEST)
+      js_requests_++;
+
+    if (binding_data_->monitor_routes && type_ == HTTP_REQUEST) {
+      // Drop the oldest request if JS has stopped reporting responses for
+      // some reason, rather than letting the queue grow without bound.
+      if (pending_messages_.size() >= kMaxPendingMessages)
+        pending_messages_.pop_front();
+      pending_messages_.push_back({ header_parsing_start_time_,
+                                    uv_hrtime(),
+                                    message_bytes_,
+                                    binding_data_->monitor_generation });
+      timing_body_ = true;
+    }
     header_nread_ = 0;
     header_parsing_start_time_ = 0;
 
@@ -392,6 +538,11 @@ class Parser : public AsyncWrap, public StreamListener {
 
 
   int on_body(const char* at, size_t length) {
+    // The response may have finished before the whole body was received, in
+    // which case the request is not pending anymore.
+    if (timing_body_ && !pending_messages_.empty())
+      pending_messages_.back().bytes += length;
+
     EscapableHandleScope scope(env()->isolate());
 
     Local<Object> obj = object();
@@ -430,7 +581,13 @@ class Parser : public AsyncWrap, public StreamListener {
 
 
   int on_message_complete() {
+    if (static_message_) {
+      static_message_ = false;
+      return 0;
+    }
+
     HandleScope scope(env()->isolate());
+    timing_body_ = false;
 
     if (num_fields_)
       Flush();  // Flush trailing HTTP headers.
@@ -496,6 +653,97 @@ class Parser : public AsyncWrap, public StreamListener {
   }
 
 
+  // parser.recordResponse(routeId)
+  static void RecordResponse(const FunctionCallbackInfo<Value>& args) {
+    Parser* parser;
+    ASSIGN_OR_RETURN_UNWRAP(&parser, args.Holder());
+    CHECK(args[0]->IsUint32());
+    parser->RecordResponse(args[0].As<Uint32>()->Value());
+  }
+
+
+  // Records the timings of the oldest request whose response had not
+  // finished yet. HTTP/1 responses are sent in the order of the requests, so
+  // that is the request whose response has just finished.
+  void RecordResponse(uint32_t route) {
+    BindingData* binding_data = binding_data_.get();
+    while (!pending_messages_.empty() &&
+           pending_messages_.front().generation !=
+               binding_data->monitor_generation) {
+      pending_messages_.pop_front();
+    }
+    if (pending_messages_.empty())
+      return;
+    PendingMessage message = pending_messages_.front();
+    pending_messages_.pop_front();
+
+    if (!binding_data->monitor_routes || route >= binding_data->routes.size())
+      return;
+    const BindingData::RouteHistograms& histograms =
+        binding_data->routes[route];
+    if (histograms.parse)
+      histograms.parse->Record(message.headers_complete_time -
+                               message.begin_time);
+    if (histograms.response)
+      histograms.response->Record(uv_hrtime() -
+                                  message.headers_complete_time);
+    if (histograms.bytes)
+      histograms.bytes->Record(message.bytes);
+  }
+
+
+  // parser.setStaticResponses(responses)
+  static void SetStaticResponses(const FunctionCallbackInfo<Value>& args) {
+    Parser* parser;
+    ASSIGN_OR_RETURN_UNWRAP(&parser, args.Holder());
+    if (args[0]->IsUndefined()) {
+      parser->static_responses_.reset();
+      return;
+    }
+    CHECK(args[0]->IsObject());
+    StaticResponses* responses;
+    ASSIGN_OR_RETURN_UNWRAP(&responses, args[0].As<Object>());
+    parser->static_responses_.reset(responses);
+  }
+
+
+  // Writes the static response for the request whose headers have just been
+  // parsed, if there is one and it can be sent right away. That is not the
+  // case if a response from JS might still be pending on this connection,
+  // since it would have to be sent first, or if the request has a body or
+  // is not a plain keep-alive request, which are all left to JS.
+  bool RespondStatically() {
+    if (stream_ == nullptr ||
+        type_ != HTTP_REQUEST ||
+        js_requests_ != 0 ||
+        have_flushed_ ||
+        parser_.upgrade ||
+        (parser_.flags & F_CHUNKED) ||
+        parser_.content_length != 0 ||
+        !llhttp_should_keep_alive(&parser_)) {
+      return false;
+    }
+
+    llhttp_method_t method = static_cast<llhttp_method_t>(parser_.method);
+    StaticResponses::Entry* entry = static_responses_->Find(
+        llhttp_method_name(method), url_.str_, url_.size_);
+    if (entry == nullptr)
+      return false;
+
+    const std::shared_ptr<const std::string>& response = entry->response;
+    size_t length = method == HTTP_HEAD ? entry->head_length
+                                        : response->size();
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(response->data()), length);
+    StreamWriteResult res = static_cast<StreamBase*>(stream_)->Write(&buf, 1);
+    if (res.wrap != nullptr)
+      pending_writes_.emplace_back(res.wrap, response);
+
+    entry->hits++;
+    static_responses_in_read_++;
+    return true;
+  }
+
+
   void Save() {
     url_.Save();
     status_message_.Save();
@@ -650,6 +898,13 @@ class Parser : public AsyncWrap, public StreamListener {
  protected:
   static const size_t kAllocBufferSize = 64 * 1024;
 
+  void OnStreamAfterWrite(WriteWrap* w, int status) override {
+    // Writes complete in the order in which they were started.
+    if (!pending_writes_.empty() && pending_writes_.front().first == w)
+      pending_writes_.pop_front();
+    StreamListener::OnStreamAfterWrite(w, status);
+  }
+
   uv_buf_t OnStreamAlloc(size_t suggested_size) override {
     // For most types of streams, OnStreamRead will be immediately after
     // OnStreamAlloc, and will consume all data, so using a static buffer for
@@ -687,6 +942,7 @@ class Parser : public AsyncWrap, public StreamListener {
       return;
 
     current_buffer_.Clear();
+    static_responses_in_read_ = 0;
     Local<Value> ret = Execute(buf.base, nread);
 
     // Exception
@@ -721,7 +977,14 @@ class Parser : public AsyncWrap, public StreamListener {
     current_buffer_len_ = nread;
     current_buffer_data_ = buf.base;
 
-    MakeCallback(cb.As<Function>(), 1, &ret);
+    // JS still has to know about reads that were only answered with static
+    // responses, to manage the timeouts of the connection.
+    Local<Value> argv[] = {
+      ret,
+      Integer::NewFromUnsigned(
+          env()->isolate(), static_cast<uint32_t>(static_responses_in_read_))
+    };
+    MakeCallback(cb.As<Function>(), arraysize(argv), argv);
 
     current_buffer_len_ = 0;
     current_buffer_data_ = nullptr;
@@ -879,6 +1142,14 @@ class Parser : public AsyncWrap, public StreamListener {
     max_http_header_size_ = max_http_header_size;
     header_parsing_start_time_ = 0;
     headers_timeout_ = headers_timeout;
+    type_ = type;
+    message_bytes_ = 0;
+    timing_body_ = false;
+    pending_messages_.clear();
+    static_responses_.reset();
+    js_requests_ = 0;
+    static_message_ = false;
+    pending_writes_.clear();
   }
 
 
@@ -932,6 +1203,35 @@ class Parser : public AsyncWrap, public StreamListener {
   uint64_t headers_timeout_;
   uint64_t header_parsing_start_time_ = 0;
 
+  // Requests whose timings will be recorded once their response finishes.
+  struct PendingMessage {
+    uint64_t begin_time;
+    uint64_t headers_complete_time;
+    uint64_t bytes;
+    uint32_t generation;
+  };
+  static const size_t kMaxPendingMessages = 64;
+  std::deque<PendingMessage> pending_messages_;
+  llhttp_type_t type_ = HTTP_BOTH;
+  // The number of bytes of the URL, the headers and the body of the current
+  // message.
+  uint64_t message_bytes_ = 0;
+  // Whether the body of the current message is counted towards the last
+  // entry of `pending_messages_`.
+  bool timing_body_ = false;
+
+  BaseObjectPtr<StaticResponses> static_responses_;
+  // The number of requests on this connection that have been passed to JS.
+  // Static responses are only sent natively as long as this is zero.
+  uint64_t js_requests_ = 0;
+  // Whether the current message was answered with a static response.
+  bool static_message_ = false;
+  // The number of static responses sent for the current read.
+  size_t static_responses_in_read_ = 0;
+  // Static responses that are still being written.
+  std::deque<std::pair<WriteWrap*, std::shared_ptr<const std::string>>>
+      pending_writes_;
+
   BaseObjectPtr<BindingData> binding_data_;
 
   // These are helper functions for filling `http_parser_settings`, which turn
@@ -978,6 +1278,39 @@ const llhttp_settings_t Parser::settings = {
 };
 
 
+// setRouteMonitoring(enabled)
+void SetRouteMonitoring(const FunctionCallbackInfo<Value>& args) {
+  BindingData* binding_data = Environment::GetBindingData<BindingData>(args);
+  bool enabled = args[0]->IsTrue();
+  if (enabled && !binding_data->monitor_routes)
+    binding_data->monitor_generation++;
+  binding_data->monitor_routes = enabled;
+}
+
+// setRouteHistograms(routeId, parse, response, bytes), where each histogram
+// is either a native Histogram or undefined.
+void SetRouteHistograms(const FunctionCallbackInfo<Value>& args) {
+  BindingData* binding_data = Environment::GetBindingData<BindingData>(args);
+  CHECK(args[0]->IsUint32());
+  uint32_t route = args[0].As<Uint32>()->Value();
+
+  auto get_histogram = [](Local<Value> value) {
+    if (value->IsUndefined())
+      return std::shared_ptr<Histogram>();
+    HistogramBase* histogram = Unwrap<HistogramBase>(value.As<Object>());
+    CHECK_NOT_NULL(histogram);
+    return histogram->histogram();
+  };
+
+  if (route >= binding_data->routes.size())
+    binding_data->routes.resize(route + 1);
+  BindingData::RouteHistograms& histograms = binding_data->routes[route];
+  histograms.parse = get_histogram(args[1]);
+  histograms.response = get_histogram(args[2]);
+  histograms.bytes = get_histogram(args[3]);
+}
+
+
 void InitializeHttpParser(Local<Object> target,
                           Local<Value> unused,
                           Local<Context> context,
@@ -1041,8 +1374,22 @@ void InitializeHttpParser(Local<Object> target,
   env->SetProtoMethod(t, "consume", Parser::Consume);
   env->SetProtoMethod(t, "unconsume", Parser::Unconsume);
   env->SetProtoMethod(t, "getCurrentBuffer", Parser::GetCurrentBuffer);
+  env->SetProtoMethod(t, "recordResponse", Parser::RecordResponse);
+  env->SetProtoMethod(t, "setStaticResponses", Parser::SetStaticResponses);
 
   env->SetConstructorFunction(target, "HTTPParser", t);
+
+  Local<FunctionTemplate> srt = env->NewFunctionTemplate(StaticResponses::New);
+  srt->Inherit(BaseObject::GetConstructorTemplate(env));
+  srt->InstanceTemplate()->SetInternalFieldCount(
+      StaticResponses::kInternalFieldCount);
+  env->SetProtoMethod(srt, "set", StaticResponses::Set);
+  env->SetProtoMethod(srt, "delete", StaticResponses::Delete);
+  env->SetProtoMethod(srt, "hits", StaticResponses::Hits);
+  env->SetConstructorFunction(target, "StaticResponses", srt);
+
+  env->SetMethod(target, "setRouteMonitoring", SetRouteMonitoring);
+  env->SetMethod(target, "setRouteHistograms", SetRouteHistograms);
 }
 
 }  // anonymous namespace
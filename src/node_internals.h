@@ -198,7 +198,8 @@ v8::MaybeLocal<v8::Value> InternalMakeCallback(
     const v8::Local<v8::Function> callback,
     int argc,
     v8::Local<v8::Value> argv[],
-    async_context asyncContext);
+    async_context asyncContext,
+    AsyncWrap::ProviderType provider = AsyncWrap::PROVIDER_NONE);
 
 v8::MaybeLocal<v8::Value> MakeSyncCallback(v8::Isolate* isolate,
                                            v8::Local<v8::Object> recv,
@@ -221,7 +222,9 @@ class InternalCallbackScope {
   InternalCallbackScope(Environment* env,
                         v8::Local<v8::Object> object,
                         const async_context& asyncContext,
-                        int flags = kNoFlags);
+                        int flags = kNoFlags,
+                        AsyncWrap::ProviderType provider =
+                            AsyncWrap::PROVIDER_NONE);
   // Utility that can be used by AsyncWrap classes.
   explicit InternalCallbackScope(AsyncWrap* async_wrap, int flags = 0);
   ~InternalCallbackScope();
@@ -239,6 +242,8 @@ class InternalCallbackScope {
   bool failed_ = false;
   bool pushed_ids_ = false;
   bool closed_ = false;
+  AsyncWrap::ProviderType provider_;
+  uint64_t start_time_ = 0;
 };
 
 class DebugSealHandleScope {
@@ -383,7 +388,12 @@ class DiagnosticFilename {
 };
 
 namespace heap {
-bool WriteSnapshot(v8::Isolate* isolate, const char* filename);
+bool WriteSnapshot(v8::Isolate* isolate,
+                   const char* filename,
+                   bool compress = false);
+// V8 has no API to read back the value of a flag, so the ones that heap
+// snapshots depend on are recorded as flags are passed to V8.
+void RecordV8Flags(const std::vector<std::string>& args);
 }
 
 class TraceEventScope {
@@ -71,8 +71,15 @@ class NodeMainInstance {
   static v8::StartupData* GetEmbeddedSnapshotBlob();
   static const EnvSerializeInfo* GetEnvSerializeInfo();
   static const std::vector<intptr_t>& CollectExternalReferences();
+  // Returns nullptr if the external references have not been collected,
+  // i.e. the main instance is not deserialized from a snapshot.
+  static const std::vector<intptr_t>* GetCollectedExternalReferences();
 
   static const size_t kNodeContextIndex = 0;
+  // A context that has only been through the per-context scripts, with no
+  // Environment attached. Workers deserialize it from the embedded snapshot
+  // and bootstrap their own Environment on top of it.
+  static const size_t kNodeBaseContextIndex = kNodeContextIndex + 1;
   NodeMainInstance(const NodeMainInstance&) = delete;
   NodeMainInstance& operator=(const NodeMainInstance&) = delete;
   NodeMainInstance(NodeMainInstance&&) = delete;
@@ -86,6 +93,7 @@ class NodeMainInstance {
                    const std::vector<std::string>& exec_args);
 
   static std::unique_ptr<ExternalReferenceRegistry> registry_;
+  static const std::vector<intptr_t>* external_references_;
   std::vector<std::string> args_;
   std::vector<std::string> exec_args_;
   std::unique_ptr<ArrayBufferAllocator> array_buffer_allocator_;
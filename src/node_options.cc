@@ -81,6 +81,9 @@ void PerProcessOptions::CheckOptions(std::vector<std::string>* errors) {
       errors->push_back("--secure-heap-min must be a power of 2");
   }
 #endif
+  if (trace_event_format != "json" && trace_event_format != "proto") {
+    errors->push_back("invalid value for --trace-event-format");
+  }
   if (use_largepages != "off" &&
       use_largepages != "on" &&
       use_largepages != "silent") {
@@ -139,10 +142,11 @@ void EnvironmentOptions::CheckOptions(std::vector<std::string>* errors) {
   }
 
 #if HAVE_INSPECTOR
-  if (!cpu_prof) {
-    if (!cpu_prof_name.empty()) {
-      errors->push_back("--cpu-prof-name must be used with --cpu-prof");
-    }
+  if (!cpu_prof && !cpu_prof_name.empty()) {
+    errors->push_back("--cpu-prof-name must be used with --cpu-prof");
+  }
+
+  if (!cpu_prof && !cpu_prof_continuous) {
     if (!cpu_prof_dir.empty()) {
       errors->push_back("--cpu-prof-dir must be used with --cpu-prof");
     }
@@ -153,9 +157,20 @@ void EnvironmentOptions::CheckOptions(std::vector<std::string>* errors) {
     }
   }
 
-  if (cpu_prof && cpu_prof_dir.empty() && !diagnostic_dir.empty()) {
-      cpu_prof_dir = diagnostic_dir;
-    }
+  if (!cpu_prof_continuous &&
+      cpu_prof_rotate_interval != kDefaultCpuProfRotateInterval) {
+    errors->push_back("--cpu-prof-rotate-interval must be used with "
+                      "--cpu-prof-continuous");
+  }
+
+  if (cpu_prof_rotate_interval == 0) {
+    errors->push_back("--cpu-prof-rotate-interval must be greater than 0");
+  }
+
+  if ((cpu_prof || cpu_prof_continuous) &&
+      cpu_prof_dir.empty() && !diagnostic_dir.empty()) {
+    cpu_prof_dir = diagnostic_dir;
+  }
 
   if (!heap_prof) {
     if (!heap_prof_name.empty()) {
@@ -311,6 +326,11 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             kAllowedInEnvironment);
   AddOption("--experimental-abortcontroller", "",
             NoOp{}, kAllowedInEnvironment);
+  AddOption("--experimental-async-context-frame",
+            "experimental AsyncLocalStorage support based on continuation "
+            "preserved embedder data instead of async_hooks",
+            &EnvironmentOptions::experimental_async_context_frame,
+            kAllowedInEnvironment);
   AddOption("--experimental-json-modules",
             "experimental JSON interop support for the ES Module loader",
             &EnvironmentOptions::experimental_json_modules,
@@ -369,6 +389,11 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "Generate heap snapshot on specified signal",
             &EnvironmentOptions::heap_snapshot_signal,
             kAllowedInEnvironment);
+  AddOption("--heapprofile-signal",
+            "Start the sampling heap profiler on specified signal, and "
+            "write a heap profile on each following one",
+            &EnvironmentOptions::heap_profile_signal,
+            kAllowedInEnvironment);
   AddOption("--heapsnapshot-near-heap-limit",
             "Generate heap snapshots whenever V8 is approaching "
             "the heap limit. No more than the specified number of "
@@ -433,6 +458,15 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "to disk before exit. If --cpu-prof-dir is not specified, write "
             "the profile to the current working directory.",
             &EnvironmentOptions::cpu_prof);
+  AddOption("--cpu-prof-continuous",
+            "Start the V8 CPU profiler on start up, and write a gzipped "
+            "pprof profile to disk every --cpu-prof-rotate-interval seconds "
+            "and before exit.",
+            &EnvironmentOptions::cpu_prof_continuous);
+  AddOption("--cpu-prof-rotate-interval",
+            "specified interval in seconds at which the CPU profiles "
+            "generated with --cpu-prof-continuous are written. (default: 60)",
+            &EnvironmentOptions::cpu_prof_rotate_interval);
   AddOption("--cpu-prof-name",
             "specified file name of the V8 CPU profile generated with "
             "--cpu-prof",
@@ -675,6 +709,12 @@ PerProcessOptionsParser::PerProcessOptionsParser(
             "data, it supports ${rotation} and ${pid}.",
             &PerProcessOptions::trace_event_file_pattern,
             kAllowedInEnvironment);
+  AddOption("--trace-event-format",
+            "format of the trace-events data: 'json' (default) for the "
+            "Chrome JSON trace format, or 'proto' for the Perfetto "
+            "protobuf trace format",
+            &PerProcessOptions::trace_event_format,
+            kAllowedInEnvironment);
   AddAlias("--trace-events-enabled", {
     "--trace-event-categories", "v8,node,node.async_hooks" });
   AddOption("--v8-pool-size",
@@ -732,6 +772,14 @@ PerProcessOptionsParser::PerProcessOptionsParser(
               "generate diagnostic report on fatal (internal) errors",
               &PerProcessOptions::report_on_fatalerror,
               kAllowedInEnvironment);
+  AddOption("--build-snapshot",
+            "run the entry point script and write the resulting heap "
+            "into a startup snapshot blob",
+            &PerProcessOptions::build_snapshot);
+  AddOption("--snapshot-blob",
+            "path to the snapshot blob that is used to start the "
+            "application, or that is written by --build-snapshot",
+            &PerProcessOptions::snapshot_blob);
 
 #ifdef NODE_HAVE_I18N_SUPPORT
   AddOption("--icu-data-dir",
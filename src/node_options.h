@@ -103,6 +103,7 @@ class EnvironmentOptions : public Options {
   std::vector<std::string> conditions;
   std::string dns_result_order;
   bool enable_source_maps = false;
+  bool experimental_async_context_frame = false;
   bool experimental_json_modules = false;
   bool experimental_modules = false;
   std::string experimental_specifier_resolution;
@@ -118,6 +119,7 @@ class EnvironmentOptions : public Options {
   bool frozen_intrinsics = false;
   int64_t heap_snapshot_near_heap_limit = 0;
   std::string heap_snapshot_signal;
+  std::string heap_profile_signal;
   uint64_t max_http_header_size = 16 * 1024;
   bool no_deprecation = false;
   bool no_force_async_hooks_checks = false;
@@ -133,6 +135,9 @@ class EnvironmentOptions : public Options {
   uint64_t cpu_prof_interval = kDefaultCpuProfInterval;
   std::string cpu_prof_name;
   bool cpu_prof = false;
+  bool cpu_prof_continuous = false;
+  static const uint64_t kDefaultCpuProfRotateInterval = 60;
+  uint64_t cpu_prof_rotate_interval = kDefaultCpuProfRotateInterval;
   std::string heap_prof_dir;
   std::string heap_prof_name;
   static const uint64_t kDefaultHeapProfInterval = 512 * 1024;
@@ -217,6 +222,7 @@ class PerProcessOptions : public Options {
   std::string title;
   std::string trace_event_categories;
   std::string trace_event_file_pattern = "node_trace.${rotation}.log";
+  std::string trace_event_format = "json";
   int64_t v8_thread_pool_size = 4;
   bool zero_fill_all_buffers = false;
   bool debug_arraybuffer_allocations = false;
@@ -228,6 +234,10 @@ class PerProcessOptions : public Options {
   bool print_v8_help = false;
   bool print_version = false;
 
+  // Used when building or starting from a user-land startup snapshot.
+  bool build_snapshot = false;
+  std::string snapshot_blob;
+
 #ifdef NODE_HAVE_I18N_SUPPORT
   std::string icu_data_dir;
 #endif
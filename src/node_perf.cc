@@ -13,8 +13,10 @@
 namespace node {
 namespace performance {
 
+using v8::ArrayBuffer;
 using v8::Context;
 using v8::DontDelete;
+using v8::Float64Array;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
@@ -233,6 +235,28 @@ void LoopIdleTime(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(1.0 * idle_time / 1e6);
 }
 
+void SetLoopMetricsEnabled(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsBoolean());
+  env->loop_metrics()->set_enabled(args[0]->IsTrue());
+}
+
+void ResetLoopMetrics(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  env->loop_metrics()->Reset();
+}
+
+// Returns a Float64Array with a copy of the current loop metrics.
+void GetLoopMetrics(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Local<ArrayBuffer> buffer = ArrayBuffer::New(
+      env->isolate(), LoopMetrics::kFieldCount * sizeof(double));
+  env->loop_metrics()->Snapshot(
+      static_cast<double*>(buffer->GetBackingStore()->Data()));
+  args.GetReturnValue().Set(
+      Float64Array::New(buffer, 0, LoopMetrics::kFieldCount));
+}
+
 // Event Loop Timing Histogram
 void ELDHistogram::New(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -308,6 +332,9 @@ void Initialize(Local<Object> target,
                  RemoveGarbageCollectionTracking);
   env->SetMethod(target, "notify", Notify);
   env->SetMethod(target, "loopIdleTime", LoopIdleTime);
+  env->SetMethod(target, "setLoopMetricsEnabled", SetLoopMetricsEnabled);
+  env->SetMethod(target, "resetLoopMetrics", ResetLoopMetrics);
+  env->SetMethodNoSideEffect(target, "getLoopMetrics", GetLoopMetrics);
 
   Local<Object> constants = Object::New(isolate);
 
@@ -0,0 +1,217 @@
+#include "node_pprof.h"
+
+#include "zlib.h"
+
+#include <cstring>
+
+namespace node {
+namespace pprof {
+
+namespace {
+
+// Field numbers from profile.proto.
+enum ProfileField : uint32_t {
+  kProfileSampleType = 1,
+  kProfileSample = 2,
+  kProfileLocation = 4,
+  kProfileFunction = 5,
+  kProfileStringTable = 6,
+  kProfileTimeNanos = 9,
+  kProfileDurationNanos = 10,
+  kProfilePeriodType = 11,
+  kProfilePeriod = 12,
+  kProfileComment = 13,
+};
+
+enum ValueTypeField : uint32_t {
+  kValueTypeType = 1,
+  kValueTypeUnit = 2,
+};
+
+enum SampleField : uint32_t {
+  kSampleLocationId = 1,
+  kSampleValue = 2,
+  kSampleLabel = 3,
+};
+
+enum LabelField : uint32_t {
+  kLabelKey = 1,
+  kLabelStr = 2,
+  kLabelNum = 3,
+};
+
+enum LocationField : uint32_t {
+  kLocationId = 1,
+  kLocationLine = 4,
+};
+
+enum LineField : uint32_t {
+  kLineFunctionId = 1,
+  kLineLine = 2,
+};
+
+enum FunctionField : uint32_t {
+  kFunctionId = 1,
+  kFunctionName = 2,
+  kFunctionSystemName = 3,
+  kFunctionFilename = 4,
+  kFunctionStartLine = 5,
+};
+
+}  // anonymous namespace
+
+ProfileBuilder::ProfileBuilder(size_t max_functions)
+    : max_functions_(max_functions) {
+  // The first entry of the string table has to be the empty string.
+  InternString("");
+}
+
+uint64_t ProfileBuilder::InternString(const std::string& str) {
+  auto it = strings_.find(str);
+  if (it != strings_.end()) return it->second;
+  uint64_t index = strings_.size();
+  strings_.emplace(str, index);
+  string_table_.AppendString(kProfileStringTable, str);
+  return index;
+}
+
+void ProfileBuilder::AddSampleType(const char* type, const char* unit) {
+  message_.clear();
+  message_.AppendVarInt(kValueTypeType, InternString(type));
+  message_.AppendVarInt(kValueTypeUnit, InternString(unit));
+  sample_types_.AppendMessage(kProfileSampleType, message_);
+}
+
+void ProfileBuilder::SetPeriod(const char* type,
+                               const char* unit,
+                               int64_t period) {
+  message_.clear();
+  message_.AppendVarInt(kValueTypeType, InternString(type));
+  message_.AppendVarInt(kValueTypeUnit, InternString(unit));
+  fields_.AppendMessage(kProfilePeriodType, message_);
+  fields_.AppendVarInt(kProfilePeriod, period);
+}
+
+void ProfileBuilder::SetTime(int64_t time_nanos, int64_t duration_nanos) {
+  fields_.AppendVarInt(kProfileTimeNanos, time_nanos);
+  fields_.AppendVarInt(kProfileDurationNanos, duration_nanos);
+}
+
+void ProfileBuilder::AddComment(const std::string& comment) {
+  fields_.AppendVarInt(kProfileComment, InternString(comment));
+}
+
+uint64_t ProfileBuilder::AddFunction(std::string&& key,
+                                     const char* name,
+                                     const char* filename,
+                                     int64_t start_line) {
+  // Ids have to be non-zero.
+  uint64_t id = functions_.size() + 1;
+  functions_.emplace(std::move(key), id);
+  uint64_t name_index = InternString(name);
+  message_.clear();
+  message_.AppendVarInt(kFunctionId, id);
+  message_.AppendVarInt(kFunctionName, name_index);
+  message_.AppendVarInt(kFunctionSystemName, name_index);
+  message_.AppendVarInt(kFunctionFilename, InternString(filename));
+  message_.AppendVarInt(kFunctionStartLine, start_line);
+  function_table_.AppendMessage(kProfileFunction, message_);
+  return id;
+}
+
+uint64_t ProfileBuilder::GetFunction(const char* name,
+                                     const char* filename,
+                                     int64_t start_line) {
+  std::string key = std::string(name) + '\n' + filename + '\n' +
+                    std::to_string(start_line);
+  auto it = functions_.find(key);
+  if (it != functions_.end()) return it->second;
+
+  if (functions_.size() < max_functions_)
+    return AddFunction(std::move(key), name, filename, start_line);
+
+  if (truncated_function_ == 0)
+    truncated_function_ = AddFunction("", "(truncated)", "", 0);
+  return truncated_function_;
+}
+
+uint64_t ProfileBuilder::GetLocation(const char* name,
+                                     const char* filename,
+                                     int64_t start_line,
+                                     int64_t line) {
+  uint64_t function_id = GetFunction(name, filename, start_line);
+  if (function_id == truncated_function_) line = 0;
+  std::string key = std::to_string(function_id) + ':' + std::to_string(line);
+  auto it = locations_.find(key);
+  if (it != locations_.end()) return it->second;
+
+  uint64_t id = locations_.size() + 1;
+  locations_.emplace(std::move(key), id);
+  line_.clear();
+  line_.AppendVarInt(kLineFunctionId, function_id);
+  line_.AppendVarInt(kLineLine, line);
+  message_.clear();
+  message_.AppendVarInt(kLocationId, id);
+  message_.AppendMessage(kLocationLine, line_);
+  location_table_.AppendMessage(kProfileLocation, message_);
+  return id;
+}
+
+void ProfileBuilder::AddSample(const std::vector<uint64_t>& locations,
+                               const std::vector<int64_t>& values,
+                               const std::vector<Label>& labels) {
+  message_.clear();
+  message_.AppendPackedVarInts(
+      kSampleLocationId, locations.data(), locations.size());
+  // int64 values are encoded as their two's complement.
+  scratch_.assign(values.begin(), values.end());
+  message_.AppendPackedVarInts(kSampleValue, scratch_.data(), scratch_.size());
+  for (const Label& label : labels) {
+    line_.clear();
+    line_.AppendVarInt(kLabelKey, InternString(label.key));
+    if (!label.str.empty())
+      line_.AppendVarInt(kLabelStr, InternString(label.str));
+    else
+      line_.AppendVarInt(kLabelNum, label.num);
+    message_.AppendMessage(kSampleLabel, line_);
+  }
+  samples_.AppendMessage(kProfileSample, message_);
+  sample_count_++;
+}
+
+std::string ProfileBuilder::Serialize() const {
+  std::string out;
+  out.reserve(sample_types_.data().size() + samples_.data().size() +
+              location_table_.data().size() + function_table_.data().size() +
+              string_table_.data().size() + fields_.data().size());
+  out += sample_types_.data();
+  out += samples_.data();
+  out += location_table_.data();
+  out += function_table_.data();
+  out += string_table_.data();
+  out += fields_.data();
+  return out;
+}
+
+bool ProfileBuilder::SerializeGzip(std::string* out) const {
+  std::string data = Serialize();
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // A window size of 15 plus 16 makes zlib write a gzip header and trailer.
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                   15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    return false;
+  }
+  out->resize(deflateBound(&stream, data.size()));
+  stream.next_in = reinterpret_cast<Bytef*>(&data[0]);
+  stream.avail_in = data.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&(*out)[0]);
+  stream.avail_out = out->size();
+  int err = deflate(&stream, Z_FINISH);
+  out->resize(stream.total_out);
+  deflateEnd(&stream);
+  return err == Z_STREAM_END;
+}
+
+}  // namespace pprof
+}  // namespace node
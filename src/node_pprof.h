@@ -0,0 +1,101 @@
+#ifndef SRC_NODE_PPROF_H_
+#define SRC_NODE_PPROF_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "tracing/proto_trace_writer.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace node {
+namespace pprof {
+
+// Builds a profile in the pprof format (see
+// https://github.com/google/pprof/blob/master/proto/profile.proto).
+//
+// Functions and locations are interned as they are added, and samples are
+// encoded right away, so the memory used is proportional to the number of
+// distinct functions rather than to the size of the profile that is being
+// converted. Once `max_functions` distinct functions have been added, any
+// further ones are folded into a single "(truncated)" function so that a
+// profile with unbounded stack diversity cannot grow the tables forever.
+class ProfileBuilder {
+ public:
+  static const size_t kDefaultMaxFunctions = 64 * 1024;
+
+  explicit ProfileBuilder(size_t max_functions = kDefaultMaxFunctions);
+
+  // Describes the next value of each sample, e.g. ("samples", "count").
+  void AddSampleType(const char* type, const char* unit);
+  void SetPeriod(const char* type, const char* unit, int64_t period);
+  // The wall clock time at which the profile was started, and its duration.
+  void SetTime(int64_t time_nanos, int64_t duration_nanos);
+  void AddComment(const std::string& comment);
+
+  // Returns the id of the location for line `line` of the function `name`
+  // defined in `filename` at `start_line`, adding it first if necessary.
+  uint64_t GetLocation(const char* name,
+                       const char* filename,
+                       int64_t start_line,
+                       int64_t line);
+
+  struct Label {
+    const char* key;
+    std::string str;
+    int64_t num;
+  };
+
+  // `locations` goes from the leaf to the root, and `values` has one value
+  // for each sample type. A label either has a string or a numeric value.
+  void AddSample(const std::vector<uint64_t>& locations,
+                 const std::vector<int64_t>& values,
+                 const std::vector<Label>& labels = {});
+
+  size_t function_count() const { return functions_.size(); }
+  size_t sample_count() const { return sample_count_; }
+
+  // Returns the encoded `Profile` message.
+  std::string Serialize() const;
+  // Returns the encoded `Profile` message compressed with gzip, which is how
+  // pprof files are usually stored.
+  bool SerializeGzip(std::string* out) const;
+
+ private:
+  uint64_t InternString(const std::string& str);
+  uint64_t AddFunction(std::string&& key,
+                       const char* name,
+                       const char* filename,
+                       int64_t start_line);
+  uint64_t GetFunction(const char* name,
+                       const char* filename,
+                       int64_t start_line);
+
+  const size_t max_functions_;
+  uint64_t truncated_function_ = 0;
+  size_t sample_count_ = 0;
+  std::unordered_map<std::string, uint64_t> strings_;
+  std::unordered_map<std::string, uint64_t> functions_;
+  std::unordered_map<std::string, uint64_t> locations_;
+  // The encoded repeated fields of the `Profile` message, in the order in
+  // which they will be written out.
+  tracing::ProtoEncoder sample_types_;
+  tracing::ProtoEncoder samples_;
+  tracing::ProtoEncoder location_table_;
+  tracing::ProtoEncoder function_table_;
+  tracing::ProtoEncoder string_table_;
+  tracing::ProtoEncoder fields_;
+  // Scratch encoders, kept around to avoid allocations for each sample.
+  tracing::ProtoEncoder message_;
+  tracing::ProtoEncoder line_;
+  std::vector<uint64_t> scratch_;
+};
+
+}  // namespace pprof
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_PPROF_H_
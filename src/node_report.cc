@@ -19,6 +19,7 @@
 
 #include <iostream>
 #include <cstring>
+#include <sstream>
 #include <ctime>
 #include <cwctype>
 #include <fstream>
@@ -57,13 +58,15 @@ using v8::Value;
 namespace per_process = node::per_process;
 
 // Internal/static function declarations
-static void WriteNodeReport(Isolate* isolate,
-                            Environment* env,
-                            const char* message,
-                            const char* trigger,
-                            const std::string& filename,
+static void CollectThreadReport(ThreadReport* report,
+                                Isolate* isolate,
+                                Environment* env,
+                                const char* message,
+                                const char* trigger,
+                                Local<Value> error,
+                                bool compact);
+static void WriteNodeReport(const ThreadReport& report,
                             std::ostream& out,
-                            Local<Value> error,
                             bool compact);
 static void PrintVersionInformation(JSONWriter* writer);
 static void PrintJavaScriptErrorStack(JSONWriter* writer,
@@ -73,8 +76,8 @@ static void PrintJavaScriptErrorStack(JSONWriter* writer,
 static void PrintJavaScriptErrorProperties(JSONWriter* writer,
                                            Isolate* isolate,
                                            Local<Value> error);
-static void PrintNativeStack(JSONWriter* writer);
-static void PrintResourceUsage(JSONWriter* writer);
+static void PrintNativeStack(JSONWriter* writer, const ThreadReport& report);
+static void PrintResourceUsage(JSONWriter* writer, const ThreadReport& report);
 static void PrintGCStatistics(JSONWriter* writer, Isolate* isolate);
 static void PrintSystemInformation(JSONWriter* writer);
 static void PrintLoadedLibraries(JSONWriter* writer);
@@ -90,13 +93,26 @@ std::string TriggerNodeReport(Isolate* isolate,
                               const char* trigger,
                               const std::string& name,
                               Local<Value> error) {
-  std::string filename;
+  ThreadReport report;
+  std::string filename =
+      PrepareNodeReport(&report, isolate, env, message, trigger, name, error);
+  if (WriteReportFile(report) != 0)
+    return "";
+  return filename;
+}
 
+std::string PrepareNodeReport(ThreadReport* report,
+                              Isolate* isolate,
+                              Environment* env,
+                              const char* message,
+                              const char* trigger,
+                              const std::string& name,
+                              Local<Value> error) {
   // Determine the required report filename. In order of priority:
   //   1) supplied on API 2) configured on startup 3) default generated
   if (!name.empty()) {
     // Filename was specified as API parameter.
-    filename = name;
+    report->filename = name;
   } else {
     std::string report_filename;
     {
@@ -105,13 +121,27 @@ std::string TriggerNodeReport(Isolate* isolate,
     }
     if (report_filename.length() > 0) {
       // File name was supplied via start-up option.
-      filename = report_filename;
+      report->filename = report_filename;
     } else {
-      filename = *DiagnosticFilename(env != nullptr ? env->thread_id() : 0,
-          "report", "json");
+      report->filename = *DiagnosticFilename(
+          env != nullptr ? env->thread_id() : 0, "report", "json");
     }
   }
 
+  {
+    Mutex::ScopedLock lock(per_process::cli_options_mutex);
+    report->directory = per_process::cli_options->report_directory;
+    report->compact = per_process::cli_options->report_compact;
+  }
+
+  CollectThreadReport(
+      report, isolate, env, message, trigger, error, report->compact);
+  return report->filename;
+}
+
+int WriteReportFile(const ThreadReport& report) {
+  const std::string& filename = report.filename;
+
   // Open the report file stream for writing. Supports stdout/err,
   // user-specified or (default) generated name
   std::ofstream outfile;
@@ -121,11 +151,7 @@ std::string TriggerNodeReport(Isolate* isolate,
   } else if (filename == "stderr") {
     outstream = &std::cerr;
   } else {
-    std::string report_directory;
-    {
-      Mutex::ScopedLock lock(per_process::cli_options_mutex);
-      report_directory = per_process::cli_options->report_directory;
-    }
+    const std::string& report_directory = report.directory;
     // Regular file. Append filename to directory path if one was specified
     if (report_directory.length() > 0) {
       std::string pathname = report_directory;
@@ -137,25 +163,20 @@ std::string TriggerNodeReport(Isolate* isolate,
     }
     // Check for errors on the file open
     if (!outfile.is_open()) {
+      int err = errno;
       std::cerr << "\nFailed to open Node.js report file: " << filename;
 
       if (report_directory.length() > 0)
         std::cerr << " directory: " << report_directory;
 
-      std::cerr << " (errno: " << errno << ")" << std::endl;
-      return "";
+      std::cerr << " (errno: " << err << ")" << std::endl;
+      return err != 0 ? err : EIO;
     }
     outstream = &outfile;
     std::cerr << "\nWriting Node.js report to file: " << filename;
   }
 
-  bool compact;
-  {
-    Mutex::ScopedLock lock(per_process::cli_options_mutex);
-    compact = per_process::cli_options->report_compact;
-  }
-  WriteNodeReport(isolate, env, message, trigger, filename, *outstream,
-                  error, compact);
+  WriteNodeReport(report, *outstream, report.compact);
 
   // Do not close stdout/stderr, only close files we opened.
   if (outfile.is_open()) {
@@ -166,7 +187,7 @@ std::string TriggerNodeReport(Isolate* isolate,
   if (filename != "stderr") {
     std::cerr << "\nNode.js report completed" << std::endl;
   }
-  return filename;
+  return 0;
 }
 
 // External function to trigger a report, writing to a supplied stream.
@@ -176,22 +197,114 @@ void GetNodeReport(Isolate* isolate,
                    const char* trigger,
                    Local<Value> error,
                    std::ostream& out) {
-  WriteNodeReport(isolate, env, message, trigger, "", out, error, false);
+  ThreadReport report;
+  CollectThreadReport(&report, isolate, env, message, trigger, error, false);
+  WriteNodeReport(report, out, false);
+}
+
+// Internal function to collect the parts of the report that have to be
+// collected on the thread that the report is about.
+static void CollectThreadReport(ThreadReport* report,
+                                Isolate* isolate,
+                                Environment* env,
+                                const char* message,
+                                const char* trigger,
+                                Local<Value> error,
+                                bool compact) {
+  report->message = message;
+  report->trigger = trigger;
+
+  // Obtain the current time.
+  DiagnosticFilename::LocalTime(&report->time);
+  report->has_timestamp = uv_gettimeofday(&report->timestamp) == 0;
+
+  if (env != nullptr) {
+    report->has_env = true;
+    report->thread_id = env->thread_id();
+  }
+
+  if (isolate != nullptr) {
+    // The members are nested in the top-level object.
+    std::ostringstream out;
+    JSONWriter writer(out, compact, 2);
+    writer.json_objectstart("javascriptStack");
+    // Report summary JavaScript error stack backtrace
+    PrintJavaScriptErrorStack(&writer, isolate, error, trigger);
+
+    // Report summary JavaScript error properties backtrace
+    PrintJavaScriptErrorProperties(&writer, isolate, error);
+    writer.json_objectend();  // the end of 'javascriptStack'
+
+    // Report V8 Heap and Garbage Collector information
+    PrintGCStatistics(&writer, isolate);
+    report->javascript = out.str();
+  }
+
+  // Capture the native stack, which is only symbolized when it is written.
+  report->native_frame_count = NativeSymbolDebuggingContext::New()->
+      GetStackTrace(report->native_frames, arraysize(report->native_frames));
+
+#ifdef RUSAGE_THREAD
+  report->has_thread_usage =
+      getrusage(RUSAGE_THREAD, &report->thread_usage) == 0;
+#endif
+
+  if (env != nullptr) {
+    // The elements are nested in the "libuv" array of the top-level object.
+    std::ostringstream out;
+    JSONWriter writer(out, compact, 4);
+    uv_walk(env->event_loop(), WalkHandle, static_cast<void*>(&writer));
+
+    writer.json_start();
+    writer.json_keyvalue("type", "loop");
+    writer.json_keyvalue("is_active",
+        static_cast<bool>(uv_loop_alive(env->event_loop())));
+    writer.json_keyvalue("address",
+        ValueToHexString(reinterpret_cast<int64_t>(env->event_loop())));
+
+    // Report Event loop idle time
+    uint64_t idle_time = uv_metrics_idle_time(env->event_loop());
+    writer.json_keyvalue("loopIdleTimeSeconds", 1.0 * idle_time / 1e9);
+    writer.json_end();
+    report->libuv = out.str();
+
+    // Ask the workers for their subreports, which are waited for when the
+    // report is written.
+    std::shared_ptr<WorkerReports> workers =
+        std::make_shared<WorkerReports>();
+    size_t expected_results = 0;
+    env->ForEachWorker([&](Worker* w) {
+      expected_results += w->RequestInterrupt(
+          [workers, trigger = report->trigger](Environment* env) {
+            std::ostringstream os;
+
+            GetNodeReport(env->isolate(),
+                          env,
+                          "Worker thread subreport",
+                          trigger.c_str(),
+                          Local<Object>(),
+                          os);
+
+            Mutex::ScopedLock lock(workers->mutex);
+            workers->reports.emplace_back(os.str());
+            workers->notify.Signal(lock);
+          });
+    });
+    {
+      Mutex::ScopedLock lock(workers->mutex);
+      workers->expected = expected_results;
+    }
+    report->workers = std::move(workers);
+  }
 }
 
 // Internal function to coordinate and write the various
 // sections of the report to the supplied stream
-static void WriteNodeReport(Isolate* isolate,
-                            Environment* env,
-                            const char* message,
-                            const char* trigger,
-                            const std::string& filename,
+static void WriteNodeReport(const ThreadReport& report,
                             std::ostream& out,
-                            Local<Value> error,
                             bool compact) {
-  // Obtain the current time and the pid.
-  TIME_TYPE tm_struct;
-  DiagnosticFilename::LocalTime(&tm_struct);
+  const TIME_TYPE& tm_struct = report.time;
+  // Obtain the pid.
   uv_pid_t pid = uv_os_getpid();
 
   // Save formatting for output stream.
@@ -205,10 +318,10 @@ static void WriteNodeReport(Isolate* isolate,
   writer.json_start();
   writer.json_objectstart("header");
   writer.json_keyvalue("reportVersion", NODE_REPORT_VERSION);
-  writer.json_keyvalue("event", message);
-  writer.json_keyvalue("trigger", trigger);
-  if (!filename.empty())
-    writer.json_keyvalue("filename", filename);
+  writer.json_keyvalue("event", report.message);
+  writer.json_keyvalue("trigger", report.trigger);
+  if (!report.filename.empty())
+    writer.json_keyvalue("filename", report.filename);
   else
     writer.json_keyvalue("filename", JSONWriter::Null{});
 
@@ -238,16 +351,16 @@ static void WriteNodeReport(Isolate* isolate,
   writer.json_keyvalue("dumpEventTime", timebuf);
 #endif
 
-  uv_timeval64_t ts;
-  if (uv_gettimeofday(&ts) == 0) {
+  if (report.has_timestamp) {
+    const uv_timeval64_t& ts = report.timestamp;
     writer.json_keyvalue("dumpEventTimeStamp",
                          std::to_string(ts.tv_sec * 1000 + ts.tv_usec / 1000));
   }
 
   // Report native process ID
   writer.json_keyvalue("processId", pid);
-  if (env != nullptr)
-    writer.json_keyvalue("threadId", env->thread_id());
+  if (report.has_env)
+    writer.json_keyvalue("threadId", report.thread_id);
   else
     writer.json_keyvalue("threadId", JSONWriter::Null{});
 
@@ -272,73 +385,26 @@ static void WriteNodeReport(Isolate* isolate,
   PrintVersionInformation(&writer);
   writer.json_objectend();
 
-  if (isolate != nullptr) {
-    writer.json_objectstart("javascriptStack");
-    // Report summary JavaScript error stack backtrace
-    PrintJavaScriptErrorStack(&writer, isolate, error, trigger);
-
-    // Report summary JavaScript error properties backtrace
-    PrintJavaScriptErrorProperties(&writer, isolate, error);
-    writer.json_objectend();  // the end of 'javascriptStack'
-
-    // Report V8 Heap and Garbage Collector information
-    PrintGCStatistics(&writer, isolate);
-  }
+  // Report the JavaScript stack and V8 heap information
+  writer.json_fragment(report.javascript);
 
   // Report native stack backtrace
-  PrintNativeStack(&writer);
+  PrintNativeStack(&writer, report);
 
   // Report OS and current thread resource usage
-  PrintResourceUsage(&writer);
+  PrintResourceUsage(&writer, report);
 
   writer.json_arraystart("libuv");
-  if (env != nullptr) {
-    uv_walk(env->event_loop(), WalkHandle, static_cast<void*>(&writer));
-
-    writer.json_start();
-    writer.json_keyvalue("type", "loop");
-    writer.json_keyvalue("is_active",
-        static_cast<bool>(uv_loop_alive(env->event_loop())));
-    writer.json_keyvalue("address",
-        ValueToHexString(reinterpret_cast<int64_t>(env->event_loop())));
-
-    // Report Event loop idle time
-    uint64_t idle_time = uv_metrics_idle_time(env->event_loop());
-    writer.json_keyvalue("loopIdleTimeSeconds", 1.0 * idle_time / 1e9);
-    writer.json_end();
-  }
-
+  writer.json_fragment(report.libuv);
   writer.json_arrayend();
 
   writer.json_arraystart("workers");
-  if (env != nullptr) {
-    Mutex workers_mutex;
-    ConditionVariable notify;
-    std::vector<std::string> worker_infos;
-    size_t expected_results = 0;
-
-    env->ForEachWorker([&](Worker* w) {
-      expected_results += w->RequestInterrupt([&](Environment* env) {
-        std::ostringstream os;
-
-        GetNodeReport(env->isolate(),
-                      env,
-                      "Worker thread subreport",
-                      trigger,
-                      Local<Object>(),
-                      os);
-
-        Mutex::ScopedLock lock(workers_mutex);
-        worker_infos.emplace_back(os.str());
-        notify.Signal(lock);
-      });
-    });
-
-    Mutex::ScopedLock lock(workers_mutex);
-    worker_infos.reserve(expected_results);
-    while (worker_infos.size() < expected_results)
-      notify.Wait(lock);
-    for (const std::string& worker_info : worker_infos)
+  if (report.workers) {
+    WorkerReports* workers = report.workers.get();
+    Mutex::ScopedLock lock(workers->mutex);
+    while (workers->reports.size() < workers->expected)
+      workers->notify.Wait(lock);
+    for (const std::string& worker_info : workers->reports)
       writer.json_element(JSONWriter::ForeignJSON { worker_info });
   }
   writer.json_arrayend();
@@ -580,14 +646,12 @@ static void PrintJavaScriptErrorStack(JSONWriter* writer,
 }
 
 // Report a native stack backtrace
-static void PrintNativeStack(JSONWriter* writer) {
+static void PrintNativeStack(JSONWriter* writer, const ThreadReport& report) {
   auto sym_ctx = NativeSymbolDebuggingContext::New();
-  void* frames[256];
-  const int size = sym_ctx->GetStackTrace(frames, arraysize(frames));
   writer->json_arraystart("nativeStack");
   int i;
-  for (i = 1; i < size; i++) {
-    void* frame = frames[i];
+  for (i = 1; i < report.native_frame_count; i++) {
+    void* frame = report.native_frames[i];
     writer->json_start();
     writer->json_keyvalue("pc",
                           ValueToHexString(reinterpret_cast<uintptr_t>(frame)));
@@ -638,7 +702,8 @@ static void PrintGCStatistics(JSONWriter* writer, Isolate* isolate) {
   writer->json_objectend();
 }
 
-static void PrintResourceUsage(JSONWriter* writer) {
+static void PrintResourceUsage(JSONWriter* writer,
+                               const ThreadReport& report) {
   // Get process uptime in seconds
   uint64_t uptime =
       (uv_hrtime() - node::per_process::node_start_time) / (NANOS_PER_SEC);
@@ -669,8 +734,8 @@ static void PrintResourceUsage(JSONWriter* writer) {
   }
   writer->json_objectend();
 #ifdef RUSAGE_THREAD
-  struct rusage stats;
-  if (getrusage(RUSAGE_THREAD, &stats) == 0) {
+  if (report.has_thread_usage) {
+    const struct rusage& stats = report.thread_usage;
     writer->json_objectstart("uvthreadResourceUsage");
     double user_cpu =
         stats.ru_utime.tv_sec + SEC_PER_MICROS * stats.ru_utime.tv_usec;
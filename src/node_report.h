@@ -2,18 +2,63 @@
 
 #include "node.h"
 #include "node_buffer.h"
+#include "node_internals.h"
+#include "node_mutex.h"
 #include "uv.h"
 #include "util.h"
 
 #ifndef _WIN32
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
 
 #include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace report {
 
+// The subreports of worker threads, which are written on the worker threads
+// and may be waited for on a thread other than the one that requested them.
+struct WorkerReports {
+  node::Mutex mutex;
+  node::ConditionVariable notify;
+  std::vector<std::string> reports;
+  size_t expected = 0;
+};
+
+// The parts of a report that can only be collected on the thread that the
+// report is about. The rest of a report only contains process-wide
+// information, so it can be collected on any thread.
+struct ThreadReport {
+  std::string message;
+  std::string trigger;
+  // The file that the report is written to, empty if it is not written to a
+  // file by TriggerNodeReport().
+  std::string filename;
+  std::string directory;
+  bool compact = false;
+
+  node::TIME_TYPE time;
+  uv_timeval64_t timestamp;
+  bool has_timestamp = false;
+  bool has_env = false;
+  uint64_t thread_id = 0;
+  // The "javascriptStack" and "javascriptHeap" members of the report.
+  std::string javascript;
+  void* native_frames[256];
+  int native_frame_count = 0;
+#ifdef RUSAGE_THREAD
+  struct rusage thread_usage;
+  bool has_thread_usage = false;
+#endif
+  // The elements of the "libuv" array of the report.
+  std::string libuv;
+  std::shared_ptr<WorkerReports> workers;
+};
+
 // Function declarations - functions in src/node_report.cc
 std::string TriggerNodeReport(v8::Isolate* isolate,
                               node::Environment* env,
@@ -27,6 +72,18 @@ void GetNodeReport(v8::Isolate* isolate,
                    const char* trigger,
                    v8::Local<v8::Value> error,
                    std::ostream& out);
+// Collects the parts of a report that have to be collected on the current
+// thread and determines the file that it is written to, which is returned.
+// The report can then be written with WriteReportFile() on any thread.
+std::string PrepareNodeReport(ThreadReport* report,
+                              v8::Isolate* isolate,
+                              node::Environment* env,
+                              const char* message,
+                              const char* trigger,
+                              const std::string& name,
+                              v8::Local<v8::Value> error);
+// Returns 0 on success and an errno value if the file could not be opened.
+int WriteReportFile(const ThreadReport& report);
 
 // Function declarations - utility functions in src/node_report_utils.cc
 void WalkHandle(uv_handle_t* h, void* arg);
@@ -1,8 +1,11 @@
+#include "async_wrap-inl.h"
 #include "env.h"
+#include "memory_tracker-inl.h"
 #include "node_errors.h"
 #include "node_internals.h"
 #include "node_options.h"
 #include "node_report.h"
+#include "threadpoolwork-inl.h"
 #include "util-inl.h"
 
 #include "handle_wrap.h"
@@ -15,18 +18,90 @@
 #include <sstream>
 
 namespace report {
+using node::AsyncWrap;
+using node::BaseObject;
 using node::Environment;
+using node::MemoryTracker;
 using node::Mutex;
+using node::ThreadPoolWork;
 using node::Utf8Value;
 using v8::Context;
 using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
 using v8::HandleScope;
 using v8::Isolate;
 using v8::Local;
+using v8::Null;
 using v8::Object;
 using v8::String;
 using v8::Value;
 
+// Writes a report that was prepared on the main thread to a file on the
+// thread pool, so that symbolizing the native stack, collecting the system
+// information and waiting for the subreports of workers does not block the
+// event loop.
+class ReportWriteWrap : public AsyncWrap, public ThreadPoolWork {
+ public:
+  ReportWriteWrap(Environment* env, Local<Object> obj)
+      : AsyncWrap(env, obj, AsyncWrap::PROVIDER_REPORTWRITEWRAP),
+        ThreadPoolWork(env) {
+    MakeWeak();
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args.IsConstructCall());
+    Environment* env = Environment::GetCurrent(args);
+    new ReportWriteWrap(env, args.This());
+  }
+
+  ThreadReport* report() { return &report_; }
+
+  void Start() {
+    ClearWeak();
+    ScheduleWork();
+  }
+
+  void DoThreadPoolWork() override {
+    err_ = WriteReportFile(report_);
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    MakeWeak();
+    report_.workers.reset();
+    if (status == UV_ECANCELED)
+      return;
+    CHECK_EQ(status, 0);
+
+    Environment* env = AsyncWrap::env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+    Local<Value> arg;
+    if (err_ == 0) {
+      arg = Null(env->isolate());
+    } else {
+      arg = node::ErrnoException(env->isolate(),
+                                 err_,
+                                 "open",
+                                 nullptr,
+                                 report_.filename.c_str());
+    }
+    MakeCallback(env->oncomplete_string(), 1, &arg);
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("filename", report_.filename);
+    tracker->TrackField("javascript", report_.javascript);
+    tracker->TrackField("libuv", report_.libuv);
+  }
+
+  SET_MEMORY_INFO_NAME(ReportWriteWrap)
+  SET_SELF_SIZE(ReportWriteWrap)
+
+ private:
+  ThreadReport report_;
+  int err_ = 0;
+};
+
 void WriteReport(const FunctionCallbackInfo<Value>& info) {
   Environment* env = Environment::GetCurrent(info);
   Isolate* isolate = env->isolate();
@@ -34,7 +109,7 @@ void WriteReport(const FunctionCallbackInfo<Value>& info) {
   std::string filename;
   Local<Value> error;
 
-  CHECK_EQ(info.Length(), 4);
+  CHECK_GE(info.Length(), 4);
   String::Utf8Value message(isolate, info[0].As<String>());
   String::Utf8Value trigger(isolate, info[1].As<String>());
 
@@ -45,8 +120,23 @@ void WriteReport(const FunctionCallbackInfo<Value>& info) {
   else
     error = Local<Value>();
 
-  filename = TriggerNodeReport(
-      isolate, env, *message, *trigger, filename, error);
+  if (info.Length() > 4 && info[4]->IsObject()) {
+    // Only the parts of the report that are specific to this thread are
+    // collected synchronously, the file is written on the thread pool.
+    ReportWriteWrap* req_wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&req_wrap, info[4]);
+    filename = PrepareNodeReport(req_wrap->report(),
+                                 isolate,
+                                 env,
+                                 *message,
+                                 *trigger,
+                                 filename,
+                                 error);
+    req_wrap->Start();
+  } else {
+    filename = TriggerNodeReport(
+        isolate, env, *message, *trigger, filename, error);
+  }
   // Return value is the report filename
   info.GetReturnValue().Set(
       String::NewFromUtf8(isolate, filename.c_str()).ToLocalChecked());
@@ -176,6 +266,13 @@ static void Initialize(Local<Object> exports,
                        void* priv) {
   Environment* env = Environment::GetCurrent(context);
 
+  Local<FunctionTemplate> write_wrap =
+      env->NewFunctionTemplate(ReportWriteWrap::New);
+  write_wrap->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  write_wrap->InstanceTemplate()->SetInternalFieldCount(
+      ReportWriteWrap::kInternalFieldCount);
+  env->SetConstructorFunction(exports, "ReportWriteWrap", write_wrap);
+
   env->SetMethod(exports, "writeReport", WriteReport);
   env->SetMethod(exports, "getReport", GetReport);
   env->SetMethod(exports, "getCompact", GetCompact);
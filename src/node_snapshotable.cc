@@ -12,19 +12,228 @@
 #include "node_main_instance.h"
 #include "node_v8.h"
 #include "node_v8_platform-inl.h"
+#include "node_version.h"
 
 namespace node {
 
 using v8::Context;
+using v8::Function;
+using v8::FunctionCallbackInfo;
 using v8::HandleScope;
 using v8::Isolate;
 using v8::Local;
 using v8::Object;
+using v8::ScriptCompiler;
+using v8::ScriptOrigin;
 using v8::SnapshotCreator;
 using v8::StartupData;
+using v8::String;
 using v8::TryCatch;
 using v8::Value;
 
+// Layout of the snapshot blob written by --build-snapshot. Integers are
+// written in the native byte order, since a blob can only be loaded by the
+// binary that built it anyway.
+//
+// [    magic     ] - kSnapshotBlobMagic (a uint32_t)
+// [   version    ] - NODE_VERSION, as a length-prefixed string
+// [   v8 blob    ] - the v8::StartupData, as length-prefixed bytes
+// [ isolate data ] - the isolate data indices, as a length-prefixed vector
+// [   env info   ] - the EnvSerializeInfo, written field by field
+static constexpr uint32_t kSnapshotBlobMagic = 0x143da20;
+
+class SnapshotBlobWriter {
+ public:
+  explicit SnapshotBlobWriter(FILE* out) : out_(out) {}
+
+  bool ok() const { return ok_; }
+
+  void WriteRaw(const void* data, size_t size) {
+    if (ok_ && size > 0 && fwrite(data, 1, size, out_) != size) ok_ = false;
+  }
+
+  void Write(size_t value) { WriteRaw(&value, sizeof(value)); }
+
+  void Write(const std::string& value) {
+    Write(value.size());
+    WriteRaw(value.data(), value.size());
+  }
+
+  template <typename T>
+  void Write(const std::vector<T>& values) {
+    Write(values.size());
+    for (const T& value : values) Write(value);
+  }
+
+  void Write(const PropInfo& info) {
+    Write(info.name);
+    Write(info.id);
+    Write(info.index);
+  }
+
+  void Write(const AsyncHooks::SerializeInfo& info) {
+    Write(info.async_ids_stack);
+    Write(info.fields);
+    Write(info.async_id_fields);
+    Write(info.js_execution_async_resources);
+    Write(info.native_execution_async_resources);
+  }
+
+  void Write(const performance::PerformanceState::SerializeInfo& info) {
+    Write(info.root);
+    Write(info.milestones);
+    Write(info.observers);
+  }
+
+  void Write(const EnvSerializeInfo& info) {
+    Write(info.bindings);
+    Write(info.native_modules);
+    Write(info.async_hooks);
+    Write(info.tick_info.fields);
+    Write(info.immediate_info.fields);
+    Write(info.performance_state);
+    Write(info.stream_base_state);
+    Write(info.should_abort_on_uncaught_toggle);
+    Write(info.persistent_templates);
+    Write(info.persistent_values);
+    Write(info.context);
+  }
+
+ private:
+  FILE* out_;
+  bool ok_ = true;
+};
+
+class SnapshotBlobReader {
+ public:
+  explicit SnapshotBlobReader(FILE* in) : in_(in) {
+    // Record the size of the file so that corrupted lengths are detected
+    // before anything is allocated for them.
+    if (fseek(in_, 0, SEEK_END) != 0) {
+      ok_ = false;
+      return;
+    }
+    long size = ftell(in_);  // NOLINT(runtime/int)
+    if (size < 0 || fseek(in_, 0, SEEK_SET) != 0) {
+      ok_ = false;
+      return;
+    }
+    remaining_ = static_cast<size_t>(size);
+  }
+
+  bool ok() const { return ok_; }
+
+  void ReadRaw(void* data, size_t size) {
+    if (!ok_ || size == 0) return;
+    if (size > remaining_ || fread(data, 1, size, in_) != size) {
+      ok_ = false;
+      return;
+    }
+    remaining_ -= size;
+  }
+
+  void Read(size_t* value) { ReadRaw(value, sizeof(*value)); }
+
+  void Read(std::string* value) {
+    size_t size = 0;
+    Read(&size);
+    if (!ok_ || size > remaining_) {
+      ok_ = false;
+      return;
+    }
+    value->resize(size);
+    ReadRaw(&(*value)[0], size);
+  }
+
+  template <typename T>
+  void Read(std::vector<T>* values) {
+    size_t size = 0;
+    Read(&size);
+    values->clear();
+    for (size_t i = 0; ok_ && i < size; i++) {
+      T value;
+      Read(&value);
+      values->push_back(std::move(value));
+    }
+  }
+
+  void Read(PropInfo* info) {
+    Read(&info->name);
+    Read(&info->id);
+    Read(&info->index);
+  }
+
+  void Read(AsyncHooks::SerializeInfo* info) {
+    Read(&info->async_ids_stack);
+    Read(&info->fields);
+    Read(&info->async_id_fields);
+    Read(&info->js_execution_async_resources);
+    Read(&info->native_execution_async_resources);
+  }
+
+  void Read(performance::PerformanceState::SerializeInfo* info) {
+    Read(&info->root);
+    Read(&info->milestones);
+    Read(&info->observers);
+  }
+
+  void Read(EnvSerializeInfo* info) {
+    Read(&info->bindings);
+    Read(&info->native_modules);
+    Read(&info->async_hooks);
+    Read(&info->tick_info.fields);
+    Read(&info->immediate_info.fields);
+    Read(&info->performance_state);
+    Read(&info->stream_base_state);
+    Read(&info->should_abort_on_uncaught_toggle);
+    Read(&info->persistent_templates);
+    Read(&info->persistent_values);
+    Read(&info->context);
+  }
+
+ private:
+  FILE* in_;
+  size_t remaining_ = 0;
+  bool ok_ = true;
+};
+
+bool SnapshotData::ToBlob(FILE* out) const {
+  SnapshotBlobWriter writer(out);
+  writer.WriteRaw(&kSnapshotBlobMagic, sizeof(kSnapshotBlobMagic));
+  writer.Write(std::string(NODE_VERSION));
+  writer.Write(static_cast<size_t>(blob.raw_size));
+  writer.WriteRaw(blob.data, blob.raw_size);
+  writer.Write(isolate_data_indices);
+  writer.Write(env_info);
+  return writer.ok();
+}
+
+bool SnapshotData::FromBlob(SnapshotData* out, FILE* in) {
+  SnapshotBlobReader reader(in);
+  uint32_t magic = 0;
+  reader.ReadRaw(&magic, sizeof(magic));
+  if (!reader.ok() || magic != kSnapshotBlobMagic) return false;
+
+  std::string version;
+  reader.Read(&version);
+  if (!reader.ok() || version != NODE_VERSION) return false;
+
+  size_t blob_size = 0;
+  reader.Read(&blob_size);
+  if (!reader.ok() || blob_size == 0 ||
+      blob_size > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return false;
+  }
+  char* blob_data = new char[blob_size];
+  reader.ReadRaw(blob_data, blob_size);
+  out->blob.data = blob_data;
+  out->blob.raw_size = static_cast<int>(blob_size);
+
+  reader.Read(&out->isolate_data_indices);
+  reader.Read(&out->env_info);
+  return reader.ok();
+}
+
 template <typename T>
 void WriteVector(std::ostringstream* ss, const T* vec, size_t size) {
   for (size_t i = 0; i < size; i++) {
@@ -82,16 +291,53 @@ const EnvSerializeInfo* NodeMainInstance::GetEnvSerializeInfo() {
   return ss.str();
 }
 
-void SnapshotBuilder::Generate(SnapshotData* out,
-                               const std::vector<std::string> args,
-                               const std::vector<std::string> exec_args) {
+// Run the entry point script of a user-land snapshot (see
+// lib/internal/main/mksnapshot.js) and spin the event loop until there is
+// nothing left to do. The handles that are still open afterwards cannot be
+// serialized, so they are closed once the serialize callbacks have been run.
+static int RunSnapshotEntryPoint(Environment* env) {
+  Isolate* isolate = env->isolate();
+  if (LoadEnvironment(env, StartExecutionCallback{}).IsEmpty()) {
+    return 1;
+  }
+
+  bool more;
+  do {
+    uv_run(env->event_loop(), UV_RUN_DEFAULT);
+    per_process::v8_platform.DrainVMTasks(isolate);
+    more = uv_loop_alive(env->event_loop());
+  } while (more && !env->is_stopping());
+
+  if (env->is_stopping()) {
+    return 1;
+  }
+
+  Local<Function> serialize_callback = env->snapshot_serialize_callback();
+  if (!serialize_callback.IsEmpty()) {
+    TryCatch try_catch(isolate);
+    if (serialize_callback
+            ->Call(env->context(), env->process_object(), 0, nullptr)
+            .IsEmpty()) {
+      PrintCaughtException(isolate, env->context(), try_catch);
+      return 1;
+    }
+  }
+
+  env->set_can_call_into_js(false);
+  env->CleanupHandles();
+  return 0;
+}
+
+int SnapshotBuilder::Generate(SnapshotData* out,
+                              const std::vector<std::string> args,
+                              const std::vector<std::string> exec_args) {
   Isolate* isolate = Isolate::Allocate();
   isolate->SetCaptureStackTraceForUncaughtExceptions(
       true, 10, v8::StackTrace::StackTraceOptions::kDetailed);
   per_process::v8_platform.Platform()->RegisterIsolate(isolate,
                                                        uv_default_loop());
   std::unique_ptr<NodeMainInstance> main_instance;
-  std::string result;
+  int exit_code = 0;
 
   {
     const std::vector<intptr_t>& external_references =
@@ -112,9 +358,15 @@ void SnapshotBuilder::Generate(SnapshotData* out,
           main_instance->isolate_data()->Serialize(&creator);
 
       // Run the per-context scripts
+      Local<Context> base_context;
       Local<Context> context;
       {
         TryCatch bootstrapCatch(isolate);
+        base_context = NewContext(isolate);
+        if (bootstrapCatch.HasCaught()) {
+          PrintCaughtException(isolate, base_context, bootstrapCatch);
+          abort();
+        }
         context = NewContext(isolate);
         if (bootstrapCatch.HasCaught()) {
           PrintCaughtException(isolate, context, bootstrapCatch);
@@ -141,23 +393,36 @@ void SnapshotBuilder::Generate(SnapshotData* out,
         result.ToLocalChecked();
       }
 
+      // Run the application code when building a user-land snapshot.
+      if (per_process::cli_options->build_snapshot) {
+        exit_code = RunSnapshotEntryPoint(env);
+      }
+
       if (per_process::enabled_debug_list.enabled(DebugCategory::MKSNAPSHOT)) {
         env->PrintAllBaseObjects();
         printf("Environment = %p\n", env);
       }
 
-      // Serialize the native states
-      out->env_info = env->Serialize(&creator);
-      // Serialize the context
-      size_t index = creator.AddContext(
-          context, {SerializeNodeContextInternalFields, env});
-      CHECK_EQ(index, NodeMainInstance::kNodeContextIndex);
+      if (exit_code == 0) {
+        // Serialize the native states
+        out->env_info = env->Serialize(&creator);
+        // Serialize the context
+        size_t index = creator.AddContext(
+            context, {SerializeNodeContextInternalFields, env});
+        CHECK_EQ(index, NodeMainInstance::kNodeContextIndex);
+        // Serialize the base context used by workers. It has no Environment
+        // attached, so there are no internal fields to serialize.
+        index = creator.AddContext(base_context);
+        CHECK_EQ(index, NodeMainInstance::kNodeBaseContextIndex);
+      }
     }
 
-    // Must be out of HandleScope
-    out->blob =
-        creator.CreateBlob(SnapshotCreator::FunctionCodeHandling::kClear);
-    CHECK(out->blob.CanBeRehashed());
+    if (exit_code == 0) {
+      // Must be out of HandleScope
+      out->blob =
+          creator.CreateBlob(SnapshotCreator::FunctionCodeHandling::kClear);
+      CHECK(out->blob.CanBeRehashed());
+    }
     // Must be done while the snapshot creator isolate is entered i.e. the
     // creator is still alive.
     FreeEnvironment(env);
@@ -165,16 +430,15 @@ void SnapshotBuilder::Generate(SnapshotData* out,
   }
 
   per_process::v8_platform.Platform()->UnregisterIsolate(isolate);
+  return exit_code;
 }
 
 std::string SnapshotBuilder::Generate(
     const std::vector<std::string> args,
     const std::vector<std::string> exec_args) {
   SnapshotData data;
-  Generate(&data, args, exec_args);
-  std::string result = FormatBlob(&data);
-  delete[] data.blob.data;
-  return result;
+  CHECK_EQ(Generate(&data, args, exec_args), 0);
+  return FormatBlob(&data);
 }
 
 SnapshotableObject::SnapshotableObject(Environment* env,
@@ -253,7 +517,15 @@ StartupData SerializeNodeContextInternalFields(Local<Object> holder,
     return StartupData{nullptr, 0};
   }
 
-  DCHECK(static_cast<BaseObject*>(ptr)->is_snapshotable());
+  BaseObject* base = static_cast<BaseObject*>(ptr);
+  if (!base->is_snapshotable()) {
+    // This can only be hit with a user-land snapshot, when the application
+    // keeps a native object alive that does not implement SnapshotableObject.
+    FPrintF(stderr,
+            "Cannot serialize %s into the startup snapshot\n",
+            base->MemoryInfoName());
+    ABORT();
+  }
   SnapshotableObject* obj = static_cast<SnapshotableObject*>(ptr);
   per_process::Debug(DebugCategory::MKSNAPSHOT,
                      "Object %p is %s, ",
@@ -288,11 +560,95 @@ void SerializeBindingData(Environment* env,
       SnapshotableObject* ptr = static_cast<SnapshotableObject*>(binding.get());
       ptr->PrepareForSerialization(env->context(), creator);
     } else {
-      UNREACHABLE();
+      // Only reachable when the application of a user-land snapshot loads
+      // a binding whose data cannot be serialized yet.
+      FPrintF(stderr,
+              "Cannot serialize binding data %s into the startup snapshot\n",
+              key.c_str());
+      ABORT();
     }
 
     i++;
   });
 }
 
+namespace mksnapshot {
+
+// Compile the entry point script of a user-land snapshot as a function
+// that takes the arguments (require, __filename, __dirname).
+static void CompileSnapshotMain(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsString());
+  Local<String> filename = args[0].As<String>();
+  Local<String> source = args[1].As<String>();
+  Isolate* isolate = args.GetIsolate();
+  Local<Context> context = isolate->GetCurrentContext();
+  ScriptOrigin origin(isolate, filename, 0, 0, true);
+  std::vector<Local<String>> parameters = {
+      FIXED_ONE_BYTE_STRING(isolate, "require"),
+      FIXED_ONE_BYTE_STRING(isolate, "__filename"),
+      FIXED_ONE_BYTE_STRING(isolate, "__dirname"),
+  };
+  ScriptCompiler::Source script_source(source, origin);
+  Local<Function> fn;
+  if (ScriptCompiler::CompileFunctionInContext(context,
+                                               &script_source,
+                                               parameters.size(),
+                                               parameters.data(),
+                                               0,
+                                               nullptr,
+                                               ScriptCompiler::kEagerCompile)
+          .ToLocal(&fn)) {
+    args.GetReturnValue().Set(fn);
+  }
+}
+
+static void GetEntryPoint(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  if (env->argv().size() < 2) return;
+  Local<Value> entry;
+  if (ToV8Value(env->context(), env->argv()[1]).ToLocal(&entry)) {
+    args.GetReturnValue().Set(entry);
+  }
+}
+
+static void SetSerializeCallback(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(env->snapshot_serialize_callback().IsEmpty());
+  CHECK(args[0]->IsFunction());
+  env->set_snapshot_serialize_callback(args[0].As<Function>());
+}
+
+static void SetDeserializeMainFunction(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(env->snapshot_deserialize_main().IsEmpty());
+  CHECK(args[0]->IsFunction());
+  env->set_snapshot_deserialize_main(args[0].As<Function>());
+}
+
+void Initialize(Local<Object> target,
+                Local<Value> unused,
+                Local<Context> context,
+                void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+  env->SetMethod(target, "compileSnapshotMain", CompileSnapshotMain);
+  env->SetMethodNoSideEffect(target, "getEntryPoint", GetEntryPoint);
+  env->SetMethod(target, "setSerializeCallback", SetSerializeCallback);
+  env->SetMethod(
+      target, "setDeserializeMainFunction", SetDeserializeMainFunction);
+}
+
+void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+  registry->Register(CompileSnapshotMain);
+  registry->Register(GetEntryPoint);
+  registry->Register(SetSerializeCallback);
+  registry->Register(SetDeserializeMainFunction);
+}
+}  // namespace mksnapshot
+
 }  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_INTERNAL(mksnapshot, node::mksnapshot::Initialize)
+NODE_MODULE_EXTERNAL_REFERENCE(mksnapshot,
+                               node::mksnapshot::RegisterExternalReferences)
@@ -125,9 +125,11 @@ class SnapshotBuilder {
  public:
   static std::string Generate(const std::vector<std::string> args,
                               const std::vector<std::string> exec_args);
-  static void Generate(SnapshotData* out,
-                       const std::vector<std::string> args,
-                       const std::vector<std::string> exec_args);
+  // Returns the exit code. When --build-snapshot is used, the entry point
+  // script in args[1] is run before the heap is serialized.
+  static int Generate(SnapshotData* out,
+                      const std::vector<std::string> args,
+                      const std::vector<std::string> exec_args);
 };
 }  // namespace node
 
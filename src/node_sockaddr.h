@@ -363,6 +363,10 @@ class SocketAddressBlockListWrap : public BaseObject {
       std::shared_ptr<SocketAddressBlockList> blocklist =
           std::make_shared<SocketAddressBlockList>());
 
+  const std::shared_ptr<SocketAddressBlockList>& blocklist() const {
+    return blocklist_;
+  }
+
   void MemoryInfo(node::MemoryTracker* tracker) const override;
   SET_MEMORY_INFO_NAME(SocketAddressBlockListWrap)
   SET_SELF_SIZE(SocketAddressBlockListWrap)
@@ -7,6 +7,7 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,7 @@ using v8::NewStringType;
 using v8::Null;
 using v8::Object;
 using v8::String;
+using v8::Uint32Array;
 using v8::Undefined;
 using v8::Value;
 
@@ -931,6 +933,34 @@ void URLHost::ParseOpaqueHost(const char* input, size_t length) {
   SetOpaque(std::move(output));
 }
 
+// Returns true if the input is a domain made of ASCII letters, digits,
+// hyphens and non-empty dot-separated labels, none of which is a Punycode
+// label. For such a domain, percent-decoding is a no-op and domain to ASCII
+// only lowercases the input, so it can be validated without ICU.
+bool IsSimpleASCIIDomain(const char* input, size_t length) {
+  if (length == 0)
+    return false;
+  size_t label_start = 0;
+  for (size_t n = 0; n <= length; n++) {
+    const char ch = n < length ? input[n] : '.';
+    if (ch == '.') {
+      if (n == label_start)
+        return false;
+      if (n - label_start >= 4 &&
+          ASCIILowercase(input[label_start]) == 'x' &&
+          ASCIILowercase(input[label_start + 1]) == 'n' &&
+          input[label_start + 2] == '-' &&
+          input[label_start + 3] == '-') {
+        return false;
+      }
+      label_start = n + 1;
+    } else if (!IsASCIIAlphanumeric(ch) && ch != '-') {
+      return false;
+    }
+  }
+  return true;
+}
+
 void URLHost::ParseHost(const char* input,
                         size_t length,
                         bool is_special,
@@ -950,12 +980,20 @@ void URLHost::ParseHost(const char* input,
   if (!is_special)
     return ParseOpaqueHost(input, length);
 
-  // First, we have to percent decode
-  std::string decoded = PercentDecode(input, length);
+  std::string decoded;
+  const bool simple = IsSimpleASCIIDomain(input, length);
+  if (simple) {
+    decoded.reserve(length);
+    for (size_t n = 0; n < length; n++)
+      decoded += ASCIILowercase(input[n]);
+  } else {
+    // First, we have to percent decode
+    decoded = PercentDecode(input, length);
 
-  // Then we have to punycode toASCII
-  if (!ToASCII(decoded, &decoded))
-    return;
+    // Then we have to punycode toASCII
+    if (!ToASCII(decoded, &decoded))
+      return;
+  }
 
   // If any of the following characters are still present, we have to fail
   for (size_t n = 0; n < decoded.size(); n++) {
@@ -972,7 +1010,7 @@ void URLHost::ParseHost(const char* input,
     return;
 
   // If the unicode flag is set, run the result through punycode ToUnicode
-  if (unicode && !ToUnicode(decoded, &decoded))
+  if (unicode && !simple && !ToUnicode(decoded, &decoded))
     return;
 
   // It's not an IPv4 or IPv6 address, it must be a domain
@@ -1264,6 +1302,164 @@ void ShortenUrlPath(struct url_data* url) {
   url->path.pop_back();
 }
 
+// Returns true if [p, end) only contains printable ASCII characters, i.e.
+// no C0 controls, spaces, DEL or non-ASCII bytes. Checks eight bytes at a
+// time: a byte is below 0x21 if subtracting 0x21 from it borrows into its
+// high bit, and above 0x7e if adding 1 to it carries into its high bit.
+bool IsPrintableASCII(const char* p, const char* end) {
+  constexpr uint64_t kOnes = ~static_cast<uint64_t>(0) / 0xff;
+  constexpr uint64_t kHighBits = kOnes * 0x80;
+  for (; end - p >= 8; p += 8) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    if ((((word - kOnes * 0x21) & ~word) | (word + kOnes) | word) & kHighBits)
+      return false;
+  }
+  for (; p < end; p++) {
+    if (*p < 0x21 || *p > 0x7e)
+      return false;
+  }
+  return true;
+}
+
+// Returns true if none of the characters in [p, end) is in the encode set,
+// i.e. the range can be copied verbatim.
+bool NeedsNoEscape(const char* p, const char* end, const uint8_t encode_set[]) {
+  for (; p < end; p++) {
+    if (BitAt(encode_set, static_cast<uint8_t>(*p)))
+      return false;
+  }
+  return true;
+}
+
+// Fast path for the common case of an absolute URL with a special,
+// non-file scheme whose components need no escaping or normalization, e.g.
+// "https://example.org:8080/a/b?c=d#e". The delimiters are located with
+// memchr(), which is vectorized by the C library, and each component is
+// copied out of the input once instead of being appended character by
+// character. Returns false without modifying |url| for anything unusual
+// (credentials, IP addresses, Punycode, percent-encoded hosts, backslashes,
+// dot segments, characters that need escaping, ...), in which case the
+// caller must run the full state machine.
+bool ParseSimpleURL(const char* input, size_t len, struct url_data* url) {
+  const char* p = input;
+  const char* end = input + len;
+  if (!IsPrintableASCII(p, end))
+    return false;
+
+  // Scheme
+  if (p == end || !IsASCIIAlpha(*p))
+    return false;
+  const char* scheme_end = p + 1;
+  while (scheme_end < end && IsASCIIAlphanumeric(*scheme_end))
+    scheme_end++;
+  if (scheme_end == end || *scheme_end != ':')
+    return false;
+  std::string scheme;
+  scheme.reserve(scheme_end - p + 1);
+  for (; p < scheme_end; p++)
+    scheme += ASCIILowercase(*p);
+  scheme += ':';
+  if (!IsSpecial(scheme) || scheme == "file:")
+    return false;
+  p = scheme_end + 1;
+
+  // Exactly two slashes must follow, anything else is normalized by the
+  // state machine.
+  if (end - p < 3 || p[0] != '/' || p[1] != '/' || p[2] == '/')
+    return false;
+  p += 2;
+
+  const char* fragment_start =
+      static_cast<const char*>(memchr(p, '#', end - p));
+  const char* body_end = fragment_start != nullptr ? fragment_start : end;
+  const char* query_start =
+      static_cast<const char*>(memchr(p, '?', body_end - p));
+  const char* path_end = query_start != nullptr ? query_start : body_end;
+  if (memchr(p, '\\', path_end - p) != nullptr)
+    return false;
+  const char* host_end = static_cast<const char*>(memchr(p, '/', path_end - p));
+  if (host_end == nullptr)
+    host_end = path_end;
+  if (memchr(p, '@', host_end - p) != nullptr)
+    return false;
+
+  // Host and port
+  const char* port_start =
+      static_cast<const char*>(memchr(p, ':', host_end - p));
+  const char* hostname_end = port_start != nullptr ? port_start : host_end;
+  if (!IsSimpleASCIIDomain(p, hostname_end - p))
+    return false;
+  // A host whose last label starts with a digit may be an IPv4 address.
+  const char* last_label = hostname_end;
+  while (last_label > p && last_label[-1] != '.')
+    last_label--;
+  if (IsASCIIDigit(*last_label))
+    return false;
+  int port = -1;
+  if (port_start != nullptr) {
+    if (host_end - port_start < 2 || host_end - port_start > 6)
+      return false;
+    port = 0;
+    for (const char* ptr = port_start + 1; ptr < host_end; ptr++) {
+      if (!IsASCIIDigit(*ptr))
+        return false;
+      port = port * 10 + (ptr[0] - '0');
+    }
+    if (port > 0xffff)
+      return false;
+  }
+
+  // Path
+  std::vector<std::string> path;
+  if (!NeedsNoEscape(host_end, path_end, PATH_ENCODE_SET))
+    return false;
+  const char* segment = host_end < path_end ? host_end + 1 : path_end;
+  for (;;) {
+    const char* segment_end =
+        static_cast<const char*>(memchr(segment, '/', path_end - segment));
+    if (segment_end == nullptr)
+      segment_end = path_end;
+    path.emplace_back(segment, segment_end - segment);
+    if (IsSingleDotSegment(path.back()) || IsDoubleDotSegment(path.back()))
+      return false;
+    if (segment_end == path_end)
+      break;
+    segment = segment_end + 1;
+  }
+
+  // Query and fragment
+  if (query_start != nullptr &&
+      !NeedsNoEscape(query_start + 1, body_end, QUERY_ENCODE_SET_SPECIAL)) {
+    return false;
+  }
+  if (fragment_start != nullptr &&
+      !NeedsNoEscape(fragment_start + 1, end, FRAGMENT_ENCODE_SET)) {
+    return false;
+  }
+
+  url->flags |= URL_FLAGS_SPECIAL | URL_FLAGS_HAS_HOST | URL_FLAGS_HAS_PATH;
+  url->host.reserve(hostname_end - p);
+  for (; p < hostname_end; p++)
+    url->host += ASCIILowercase(*p);
+  if (port != -1) {
+    url->port = NormalizePort(scheme, port);
+    if (url->port == -1)
+      url->flags |= URL_FLAGS_IS_DEFAULT_SCHEME_PORT;
+  }
+  url->scheme = std::move(scheme);
+  url->path = std::move(path);
+  if (query_start != nullptr) {
+    url->flags |= URL_FLAGS_HAS_QUERY;
+    url->query.assign(query_start + 1, body_end - query_start - 1);
+  }
+  if (fragment_start != nullptr) {
+    url->flags |= URL_FLAGS_HAS_FRAGMENT;
+    url->fragment.assign(fragment_start + 1, end - fragment_start - 1);
+  }
+  return true;
+}
+
 }  // anonymous namespace
 
 void URL::Parse(const char* input,
@@ -1335,6 +1531,9 @@ void URL::Parse(const char* input,
     return;
   }
 
+  if (!has_url && !has_state_override && ParseSimpleURL(p, end - p, url))
+    return;
+
   while (p <= end) {
     const char ch = p < end ? p[0] : kEOL;
     bool special = (url->flags & URL_FLAGS_SPECIAL);
@@ -2037,6 +2236,83 @@ std::string URL::SerializeURL(const struct url_data* url,
   return output;
 }
 
+std::string URL::SerializeURL(const struct url_data* url,
+                              uint32_t* components) {
+  const bool has_host = url->flags & URL_FLAGS_HAS_HOST;
+  const bool has_username =
+      (url->flags & URL_FLAGS_HAS_USERNAME) && !url->username.empty();
+  const bool has_password =
+      (url->flags & URL_FLAGS_HAS_PASSWORD) && !url->password.empty();
+  const bool has_path = (url->flags & URL_FLAGS_HAS_PATH) && !url->path.empty();
+
+  std::string output = url->scheme;
+  components[kURLComponentFlags] = url->flags;
+  components[kURLComponentSchemeEnd] = output.size();
+  components[kURLComponentHostStart] = kURLComponentOmitted;
+  components[kURLComponentHostEnd] = kURLComponentOmitted;
+  if (has_host)
+    output += "//";
+  components[kURLComponentUsernameStart] = output.size();
+  if (has_host && (has_username || has_password)) {
+    if (has_username)
+      output += url->username;
+    components[kURLComponentUsernameEnd] = output.size();
+    if (has_password)
+      output += ":";
+    components[kURLComponentPasswordStart] = output.size();
+    if (has_password)
+      output += url->password;
+    components[kURLComponentPasswordEnd] = output.size();
+    output += "@";
+  } else {
+    components[kURLComponentUsernameEnd] = output.size();
+    components[kURLComponentPasswordStart] = output.size();
+    components[kURLComponentPasswordEnd] = output.size();
+  }
+  if (has_host) {
+    components[kURLComponentHostStart] = output.size();
+    output += url->host;
+    components[kURLComponentHostEnd] = output.size();
+    if (url->port > -1)
+      output += ":" + std::to_string(url->port);
+  }
+  components[kURLComponentPort] =
+      url->port > -1 ? url->port : kURLComponentOmitted;
+
+  if (url->flags & URL_FLAGS_CANNOT_BE_BASE) {
+    components[kURLComponentPathStart] = output.size();
+    if (has_path)
+      output += url->path[0];
+  } else {
+    if (!has_host && has_path && url->path.size() > 1 &&
+        url->path[0].empty()) {
+      output += "/.";
+    }
+    components[kURLComponentPathStart] = output.size();
+    if (has_path) {
+      for (const std::string& segment : url->path) {
+        output += '/';
+        output += segment;
+      }
+    }
+  }
+  components[kURLComponentPathEnd] = output.size();
+
+  components[kURLComponentQueryStart] = kURLComponentOmitted;
+  if (url->flags & URL_FLAGS_HAS_QUERY) {
+    output += '?';
+    components[kURLComponentQueryStart] = output.size();
+    output += url->query;
+  }
+  components[kURLComponentFragmentStart] = kURLComponentOmitted;
+  if (url->flags & URL_FLAGS_HAS_FRAGMENT) {
+    output += '#';
+    components[kURLComponentFragmentStart] = output.size();
+    output += url->fragment;
+  }
+  return output;
+}
+
 namespace {
 void SetArgs(Environment* env,
              Local<Value> argv[ARG_COUNT],
@@ -2149,6 +2425,75 @@ void Parse(const FunctionCallbackInfo<Value>& args) {
         args[5]);
 }
 
+bool IsASCII(const std::string& str) {
+  for (const char ch : str) {
+    if (static_cast<uint8_t>(ch) >= 0x80)
+      return false;
+  }
+  return true;
+}
+
+// Converts a byte offset into |str|, which is valid UTF-8, into the offset
+// of the same position in UTF-16 code units.
+uint32_t Utf16Offset(const std::string& str, uint32_t offset) {
+  uint32_t result = 0;
+  for (uint32_t i = 0; i < offset; i++) {
+    const uint8_t ch = static_cast<uint8_t>(str[i]);
+    if ((ch & 0xc0) != 0x80)  // Not a continuation byte
+      result += ch >= 0xf0 ? 2 : 1;  // 4-byte sequences are surrogate pairs
+  }
+  return result;
+}
+
+// Parses the input, relative to the base if it is a string, and returns the
+// serialized URL, or undefined on failure. The flags and the offsets of the
+// components of the result are written to the Uint32Array, see
+// URL_COMPONENTS in node_url.h.
+void ParseHref(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK_GE(args.Length(), 3);
+  CHECK(args[0]->IsString());  // input
+  CHECK(args[1]->IsUndefined() || args[1]->IsString());  // base
+  CHECK(args[2]->IsUint32Array());  // components
+  Local<Uint32Array> components_arr = args[2].As<Uint32Array>();
+  CHECK_GE(components_arr->Length(), kURLComponentsCount);
+
+  url_data base;
+  const bool has_base = args[1]->IsString();
+  if (has_base) {
+    Utf8Value base_input(env->isolate(), args[1]);
+    URL::Parse(*base_input, base_input.length(), kUnknownState,
+               &base, false, nullptr, false);
+    if (base.flags & URL_FLAGS_FAILED)
+      return;
+  }
+
+  Utf8Value input(env->isolate(), args[0]);
+  url_data url;
+  URL::Parse(*input, input.length(), kUnknownState,
+             &url, false, &base, has_base);
+  if (url.flags & URL_FLAGS_FAILED)
+    return;
+
+  uint32_t* components = reinterpret_cast<uint32_t*>(
+      static_cast<char*>(components_arr->Buffer()->GetBackingStore()->Data()) +
+      components_arr->ByteOffset());
+  const std::string href = URL::SerializeURL(&url, components);
+
+  // The serialized URL is ASCII unless the host could not be converted
+  // with ICU, i.e. when Node.js is built without Intl support.
+  if (!IsASCII(href)) {
+    for (size_t n = kURLComponentSchemeEnd; n < kURLComponentsCount; n++) {
+      if (n != kURLComponentPort && components[n] != kURLComponentOmitted)
+        components[n] = Utf16Offset(href, components[n]);
+    }
+    args.GetReturnValue().Set(Utf8String(env->isolate(), href));
+    return;
+  }
+  args.GetReturnValue().Set(
+      OneByteString(env->isolate(), href.data(), href.size()));
+}
+
 void EncodeAuthSet(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK_GE(args.Length(), 1);
@@ -2248,6 +2593,7 @@ void Initialize(Local<Object> target,
                 void* priv) {
   Environment* env = Environment::GetCurrent(context);
   env->SetMethod(target, "parse", Parse);
+  env->SetMethod(target, "parseHref", ParseHref);
   env->SetMethodNoSideEffect(target, "encodeAuth", EncodeAuthSet);
   env->SetMethodNoSideEffect(target, "toUSVString", ToUSVString);
   env->SetMethodNoSideEffect(target, "domainToASCII", DomainToASCII);
@@ -2260,12 +2606,15 @@ void Initialize(Local<Object> target,
 
 #define XX(name) NODE_DEFINE_CONSTANT(target, name);
   PARSESTATES(XX)
+  URL_COMPONENTS(XX)
+  XX(kURLComponentOmitted)
 #undef XX
 }
 }  // namespace
 
 void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(Parse);
+  registry->Register(ParseHref);
   registry->Register(EncodeAuthSet);
   registry->Register(ToUSVString);
   registry->Register(DomainToASCII);
@@ -48,6 +48,28 @@ namespace url {
   XX(URL_FLAGS_HAS_FRAGMENT, 0x400)                                           \
   XX(URL_FLAGS_IS_DEFAULT_SCHEME_PORT, 0x800)                                 \
 
+// Indices into the Uint32Array filled by the parseHref() binding, which
+// holds the flags and the offsets of the components of the serialized URL.
+// The end of a component is exclusive. Offsets of null components (host,
+// query and fragment) and a null port are kURLComponentOmitted.
+#define URL_COMPONENTS(XX)                                                    \
+  XX(kURLComponentFlags)                                                      \
+  XX(kURLComponentSchemeEnd)                                                  \
+  XX(kURLComponentUsernameStart)                                              \
+  XX(kURLComponentUsernameEnd)                                                \
+  XX(kURLComponentPasswordStart)                                              \
+  XX(kURLComponentPasswordEnd)                                                \
+  XX(kURLComponentHostStart)                                                  \
+  XX(kURLComponentHostEnd)                                                    \
+  XX(kURLComponentPort)                                                       \
+  XX(kURLComponentPathStart)                                                  \
+  XX(kURLComponentPathEnd)                                                    \
+  XX(kURLComponentQueryStart)                                                 \
+  XX(kURLComponentFragmentStart)                                              \
+  XX(kURLComponentsCount)  // This one has to be last.
+
+constexpr uint32_t kURLComponentOmitted = 0xffffffff;
+
 enum url_parse_state {
   kUnknownState = -1,
 #define XX(name) name,
@@ -61,6 +83,12 @@ enum url_flags {
 #undef XX
 };
 
+enum url_component {
+#define XX(name) name,
+  URL_COMPONENTS(XX)
+#undef XX
+};
+
 struct url_data {
   int32_t flags = URL_FLAGS_NONE;
   int port = -1;
@@ -85,6 +113,11 @@ class URL {
                     bool has_base);
 
   static std::string SerializeURL(const struct url_data* url, bool exclude);
+  // Serializes the URL like the URL Standard does and stores the flags and
+  // the byte offsets of the components of the result in |components|,
+  // which must have room for kURLComponentsCount elements.
+  static std::string SerializeURL(const struct url_data* url,
+                                  uint32_t* components);
 
   URL(const char* input, const size_t len) {
     Parse(input, len, kUnknownState, &context_, false, nullptr, false);
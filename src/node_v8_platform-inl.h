@@ -129,13 +129,18 @@ struct V8Platform {
     if (tracing_file_writer_.IsDefaultHandle()) {
       std::vector<std::string> categories =
           SplitString(per_process::cli_options->trace_event_categories, ',');
+      tracing::NodeTraceWriter::Format format =
+          per_process::cli_options->trace_event_format == "proto" ?
+              tracing::NodeTraceWriter::Format::kProto :
+              tracing::NodeTraceWriter::Format::kJSON;
 
       tracing_file_writer_ = tracing_agent_->AddClient(
           std::set<std::string>(std::make_move_iterator(categories.begin()),
                                 std::make_move_iterator(categories.end())),
           std::unique_ptr<tracing::AsyncTraceWriter>(
               new tracing::NodeTraceWriter(
-                  per_process::cli_options->trace_event_file_pattern)),
+                  per_process::cli_options->trace_event_file_pattern,
+                  format)),
           tracing::Agent::kUseDefaultCategories);
     }
   }
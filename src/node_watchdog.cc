@@ -26,6 +26,7 @@
 #include "env-inl.h"
 #include "node_errors.h"
 #include "node_internals.h"
+#include "node_report.h"
 #include "node_watchdog.h"
 #include "util-inl.h"
 
@@ -34,8 +35,16 @@ namespace node {
 using v8::Context;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Isolate;
 using v8::Local;
+using v8::NewStringType;
+using v8::Number;
 using v8::Object;
+using v8::StackFrame;
+using v8::StackTrace;
+using v8::String;
+using v8::Uint32;
 using v8::Value;
 
 Watchdog::Watchdog(v8::Isolate* isolate, uint64_t ms, bool* timed_out)
@@ -220,6 +229,201 @@ void TraceSigintWatchdog::HandleInterrupt() {
   raise(SIGINT);
 }
 
+void LoopStallWatchdog::Init(Environment* env, Local<Object> target) {
+  Local<FunctionTemplate> constructor = env->NewFunctionTemplate(New);
+  constructor->InstanceTemplate()->SetInternalFieldCount(
+      LoopStallWatchdog::kInternalFieldCount);
+  constructor->Inherit(HandleWrap::GetConstructorTemplate(env));
+
+  env->SetProtoMethod(constructor, "start", Start);
+  env->SetProtoMethod(constructor, "stop", Stop);
+
+  env->SetConstructorFunction(target, "LoopStallWatchdog", constructor);
+}
+
+void LoopStallWatchdog::New(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsUint32());
+  CHECK(args[1]->IsBoolean());
+  Environment* env = Environment::GetCurrent(args);
+  uint32_t threshold_ms = args[0].As<Uint32>()->Value();
+  CHECK_GT(threshold_ms, 0);
+  new LoopStallWatchdog(
+      env, args.This(), threshold_ms, args[1]->IsTrue());
+}
+
+void LoopStallWatchdog::Start(const FunctionCallbackInfo<Value>& args) {
+  LoopStallWatchdog* watchdog;
+  ASSIGN_OR_RETURN_UNWRAP(&watchdog, args.Holder());
+  if (watchdog->running_ || watchdog->IsHandleClosing()) return;
+  watchdog->StartThread();
+}
+
+void LoopStallWatchdog::Stop(const FunctionCallbackInfo<Value>& args) {
+  LoopStallWatchdog* watchdog;
+  ASSIGN_OR_RETURN_UNWRAP(&watchdog, args.Holder());
+  watchdog->StopThread();
+}
+
+LoopStallWatchdog::LoopStallWatchdog(Environment* env,
+                                     Local<Object> object,
+                                     uint64_t threshold_ms,
+                                     bool write_report)
+    : HandleWrap(env,
+                 object,
+                 reinterpret_cast<uv_handle_t*>(&handle_),
+                 AsyncWrap::PROVIDER_LOOPSTALLWATCHDOG),
+      threshold_ms_(threshold_ms),
+      write_report_(write_report),
+      state_(std::make_shared<SharedState>()) {
+  state_->watchdog = this;
+  CHECK_EQ(0, uv_timer_init(env->event_loop(), &handle_));
+  uv_unref(reinterpret_cast<uv_handle_t*>(&handle_));
+}
+
+LoopStallWatchdog::~LoopStallWatchdog() {
+  CHECK(!running_);
+  state_->watchdog = nullptr;
+}
+
+void LoopStallWatchdog::OnClose() {
+  StopThread();
+}
+
+void LoopStallWatchdog::StartThread() {
+  // Check twice per threshold, so that a stall is detected after at most one
+  // and a half times the threshold.
+  uint64_t interval = std::max<uint64_t>(threshold_ms_ / 2, 1);
+
+  state_->heartbeat = uv_hrtime();
+  reported_heartbeat_ = 0;
+  CHECK_EQ(0, uv_timer_start(&handle_, Heartbeat, interval, interval));
+
+  CHECK_EQ(0, uv_loop_init(&loop_));
+  CHECK_EQ(0, uv_async_init(&loop_, &async_, [](uv_async_t* signal) {
+    LoopStallWatchdog* w = ContainerOf(&LoopStallWatchdog::async_, signal);
+    uv_stop(&w->loop_);
+  }));
+  CHECK_EQ(0, uv_timer_init(&loop_, &check_timer_));
+  CHECK_EQ(0, uv_timer_start(&check_timer_, Check, interval, interval));
+  CHECK_EQ(0, uv_thread_create(&thread_, Run, this));
+  running_ = true;
+}
+
+void LoopStallWatchdog::StopThread() {
+  if (!running_) return;
+  running_ = false;
+  uv_timer_stop(&handle_);
+
+  uv_async_send(&async_);
+  uv_thread_join(&thread_);
+
+  uv_close(reinterpret_cast<uv_handle_t*>(&async_), nullptr);
+
+  // UV_RUN_DEFAULT so that libuv has a chance to clean up.
+  uv_run(&loop_, UV_RUN_DEFAULT);
+
+  CheckedUvLoopClose(&loop_);
+}
+
+void LoopStallWatchdog::Run(void* arg) {
+  LoopStallWatchdog* w = static_cast<LoopStallWatchdog*>(arg);
+
+  // The loop runs until it is stopped by the async handle.
+  uv_run(&w->loop_, UV_RUN_DEFAULT);
+
+  // Close the timer handle on this side and let StopThread() close async_.
+  uv_close(reinterpret_cast<uv_handle_t*>(&w->check_timer_), nullptr);
+}
+
+// Runs on the helper thread.
+void LoopStallWatchdog::Check(uv_timer_t* timer) {
+  LoopStallWatchdog* w = ContainerOf(&LoopStallWatchdog::check_timer_, timer);
+  uint64_t heartbeat = w->state_->heartbeat.load();
+  // Only interrupt the isolate once for each stall.
+  if (heartbeat == w->reported_heartbeat_ ||
+      uv_hrtime() - heartbeat <= w->threshold_ms_ * 1000000) {
+    return;
+  }
+  w->reported_heartbeat_ = heartbeat;
+  w->env()->RequestInterrupt(
+      [state = w->state_, heartbeat](Environment* env) {
+        if (state->watchdog != nullptr)
+          state->watchdog->OnStall(heartbeat);
+      });
+}
+
+// Runs on the thread that owns the event loop, usually while the code that
+// blocks the loop is still on the stack.
+void LoopStallWatchdog::OnStall(uint64_t stalled_heartbeat) {
+  Isolate* isolate = env()->isolate();
+  HandleScope handle_scope(isolate);
+
+  stall_stack_.clear();
+  Local<StackTrace> stack = StackTrace::CurrentStackTrace(
+      isolate, kStackFrames, StackTrace::kDetailed);
+  for (int i = 0; i < stack->GetFrameCount(); i++) {
+    Local<StackFrame> frame = stack->GetFrame(isolate, i);
+    Utf8Value function_name(isolate, frame->GetFunctionName());
+    Utf8Value script_name(isolate, frame->GetScriptName());
+    if (function_name.length() == 0) {
+      stall_stack_ += SPrintF("    at %s:%i:%i\n",
+                              script_name,
+                              frame->GetLineNumber(),
+                              frame->GetColumn());
+    } else {
+      stall_stack_ += SPrintF("    at %s (%s:%i:%i)\n",
+                              function_name,
+                              script_name,
+                              frame->GetLineNumber(),
+                              frame->GetColumn());
+    }
+  }
+
+  TRACE_EVENT_INSTANT1(TRACING_CATEGORY_NODE2(perf, event_loop),
+                       "stall", TRACE_EVENT_SCOPE_THREAD,
+                       "stack", TRACE_STR_COPY(stall_stack_.c_str()));
+
+  if (write_report_) {
+    report::TriggerNodeReport(isolate,
+                              env(),
+                              "Event loop stall",
+                              "EventLoopStall",
+                              "",
+                              Local<Value>());
+  }
+
+  // If the interrupt only ran once the loop turned again, the heartbeat has
+  // already moved on and marks the end of the stall.
+  uint64_t heartbeat = state_->heartbeat.load();
+  stall_pending_ = true;
+  stall_start_ = stalled_heartbeat;
+  stall_end_ = heartbeat != stalled_heartbeat ? heartbeat : 0;
+}
+
+void LoopStallWatchdog::Heartbeat(uv_timer_t* timer) {
+  LoopStallWatchdog* w = ContainerOf(&LoopStallWatchdog::handle_, timer);
+  uint64_t now = uv_hrtime();
+  w->state_->heartbeat = now;
+
+  if (!w->stall_pending_) return;
+  w->stall_pending_ = false;
+  uint64_t end = w->stall_end_ != 0 ? w->stall_end_ : now;
+
+  Environment* env = w->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  Local<Value> argv[] = {
+    Number::New(env->isolate(), (end - w->stall_start_) / 1e6),
+    String::NewFromUtf8(env->isolate(),
+                        w->stall_stack_.data(),
+                        NewStringType::kNormal,
+                        w->stall_stack_.size()).ToLocalChecked()
+  };
+  w->stall_stack_.clear();
+  w->MakeCallback(env->onstall_string(), arraysize(argv), argv);
+}
+
 #ifdef __POSIX__
 void* SigintWatchdogHelper::RunSigintWatchdog(void* arg) {
   // Inside the helper thread.
@@ -421,6 +625,7 @@ static void Initialize(Local<Object> target,
                        void* priv) {
   Environment* env = Environment::GetCurrent(context);
   TraceSigintWatchdog::Init(env, target);
+  LoopStallWatchdog::Init(env, target);
 }
 }  // namespace watchdog
 
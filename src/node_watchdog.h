@@ -24,6 +24,9 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include <atomic>
+#include <memory>
+#include <string>
 #include <vector>
 #include "handle_wrap.h"
 #include "memory_tracker-inl.h"
@@ -107,6 +110,77 @@ class TraceSigintWatchdog : public HandleWrap, public SigintWatchdogBase {
   SignalFlags signal_flag_ = SignalFlags::None;
 };
 
+// Detects when the event loop has not turned for longer than a threshold.
+// A timer on the event loop records when it last ran, and a helper thread
+// periodically checks that timestamp. When the loop is found to be stalled,
+// the helper thread interrupts the isolate so that the JavaScript stack is
+// captured while the code that blocks the loop is still running. The stack
+// is written to a trace event and, optionally, to a diagnostic report, and is
+// passed to JavaScript once the loop turns again.
+class LoopStallWatchdog : public HandleWrap {
+ public:
+  static void Init(Environment* env, v8::Local<v8::Object> target);
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Start(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Stop(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  ~LoopStallWatchdog() override;
+
+  inline void MemoryInfo(node::MemoryTracker* tracker) const override {
+    tracker->TrackField("stall_stack", stall_stack_);
+  }
+  SET_MEMORY_INFO_NAME(LoopStallWatchdog)
+  SET_SELF_SIZE(LoopStallWatchdog)
+
+ protected:
+  void OnClose() override;
+
+ private:
+  // The number of JavaScript frames captured for a stall.
+  static const int kStackFrames = 20;
+
+  // State shared with the helper thread and with pending interrupts, which
+  // may only run after the watchdog has been destroyed.
+  struct SharedState {
+    // The uv_hrtime() at which the heartbeat timer last ran.
+    std::atomic<uint64_t> heartbeat { 0 };
+    // Only accessed on the thread that owns the event loop.
+    LoopStallWatchdog* watchdog = nullptr;
+  };
+
+  LoopStallWatchdog(Environment* env,
+                    v8::Local<v8::Object> object,
+                    uint64_t threshold_ms,
+                    bool write_report);
+
+  void StartThread();
+  void StopThread();
+  void OnStall(uint64_t stalled_heartbeat);
+
+  static void Run(void* arg);
+  static void Heartbeat(uv_timer_t* timer);
+  static void Check(uv_timer_t* timer);
+
+  uv_timer_t handle_;
+  const uint64_t threshold_ms_;
+  const bool write_report_;
+  std::shared_ptr<SharedState> state_;
+  bool running_ = false;
+
+  // Owned by the helper thread while it is running.
+  uv_thread_t thread_;
+  uv_loop_t loop_;
+  uv_async_t async_;
+  uv_timer_t check_timer_;
+  uint64_t reported_heartbeat_ = 0;
+
+  // The stall that has been detected but not yet passed to JavaScript.
+  bool stall_pending_ = false;
+  uint64_t stall_start_ = 0;
+  uint64_t stall_end_ = 0;
+  std::string stall_stack_;
+};
+
 class SigintWatchdogHelper {
  public:
   static SigintWatchdogHelper* GetInstance() { return &instance; }
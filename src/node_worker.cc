@@ -1,10 +1,13 @@
 #include "node_worker.h"
+#include "node_worker_pool.h"
 #include "debug_utils-inl.h"
 #include "histogram-inl.h"
 #include "memory_tracker-inl.h"
 #include "node_errors.h"
 #include "node_external_reference.h"
 #include "node_buffer.h"
+#include "node_internals.h"
+#include "node_main_instance.h"
 #include "node_options-inl.h"
 #include "node_perf.h"
 #include "util-inl.h"
@@ -148,6 +151,24 @@ class WorkerThreadData {
 
     w->UpdateResourceConstraints(&params.constraints);
 
+    // Deserialize the isolate from the embedded snapshot when the main
+    // instance was deserialized too, so that the external references have
+    // already been collected.
+    const std::vector<size_t>* indices = nullptr;
+    const std::vector<intptr_t>* external_references =
+        NodeMainInstance::GetCollectedExternalReferences();
+    v8::StartupData* blob = NodeMainInstance::GetEmbeddedSnapshotBlob();
+    bool no_node_snapshot =
+        w->per_isolate_opts_ ? w->per_isolate_opts_->no_node_snapshot
+            : per_process::cli_options->per_isolate->no_node_snapshot;
+    if (blob != nullptr && external_references != nullptr &&
+        !no_node_snapshot) {
+      params.snapshot_blob = blob;
+      params.external_references = external_references->data();
+      indices = NodeMainInstance::GetIsolateDataIndices();
+      deserialize_mode_ = true;
+    }
+
     Isolate* isolate = Isolate::Allocate();
     if (isolate == nullptr) {
       w->Exit(1, "ERR_WORKER_INIT_FAILED", "Failed to create new Isolate");
@@ -156,7 +177,13 @@ class WorkerThreadData {
 
     w->platform_->RegisterIsolate(isolate, &loop_);
     Isolate::Initialize(isolate, params);
-    SetIsolateUpForNode(isolate);
+    if (deserialize_mode_) {
+      // The error handlers are set up in Worker::Run() once the context
+      // has been deserialized, like what NodeMainInstance does.
+      SetIsolateMiscHandlers(isolate, {});
+    } else {
+      SetIsolateUpForNode(isolate);
+    }
 
     // Be sure it's called before Environment::InitializeDiagnostics()
     // so that this callback stays when the callback of
@@ -171,10 +198,11 @@ class WorkerThreadData {
       isolate->SetStackLimit(w->stack_base_);
 
       HandleScope handle_scope(isolate);
-      isolate_data_.reset(CreateIsolateData(isolate,
-                                            &loop_,
-                                            w_->platform_,
-                                            allocator.get()));
+      isolate_data_.reset(new IsolateData(isolate,
+                                          &loop_,
+                                          w_->platform_,
+                                          allocator.get(),
+                                          indices));
       CHECK(isolate_data_);
       if (w_->per_isolate_opts_)
         isolate_data_->set_options(std::move(w_->per_isolate_opts_));
@@ -230,6 +258,7 @@ class WorkerThreadData {
   Worker* const w_;
   uv_loop_t loop_;
   bool loop_init_failed_ = true;
+  bool deserialize_mode_ = false;
   DeleteFnPtr<IsolateData, FreeIsolateData> isolate_data_;
 
   friend class Worker;
@@ -294,7 +323,17 @@ void Worker::Run() {
         // resource constraints, we need something in place to handle it,
         // though.
         TryCatch try_catch(isolate_);
-        context = NewContext(isolate_);
+        if (data.deserialize_mode_) {
+          if (Context::FromSnapshot(isolate_,
+                                    NodeMainInstance::kNodeBaseContextIndex)
+                  .ToLocal(&context)) {
+            Context::Scope context_scope(context);
+            InitializeContextRuntime(context);
+          }
+          SetIsolateErrorHandlers(isolate_, {});
+        } else {
+          context = NewContext(isolate_);
+        }
         if (context.IsEmpty()) {
           Exit(1, "ERR_WORKER_INIT_FAILED", "Failed to create new Context");
           return;
@@ -830,6 +869,8 @@ void InitWorker(Local<Object> target,
     env->set_worker_heap_snapshot_taker_template(wst->InstanceTemplate());
   }
 
+  WorkerPoolHandle::Initialize(env, target);
+
   env->SetMethod(target, "getEnvMessagePort", GetEnvMessagePort);
 
   target
@@ -876,6 +917,7 @@ void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
   registry->Register(Worker::TakeHeapSnapshot);
   registry->Register(Worker::LoopIdleTime);
   registry->Register(Worker::LoopStartTime);
+  WorkerPoolHandle::RegisterExternalReferences(registry);
 }
 
 }  // anonymous namespace
@@ -0,0 +1,356 @@
+#include "node_worker_pool.h"
+#include "async_wrap-inl.h"
+#include "env-inl.h"
+#include "memory_tracker-inl.h"
+#include "node_errors.h"
+#include "node_external_reference.h"
+#include "util-inl.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace node {
+namespace worker {
+
+using v8::Array;
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Isolate;
+using v8::Local;
+using v8::Number;
+using v8::Object;
+using v8::TryCatch;
+using v8::Undefined;
+using v8::Value;
+
+WorkerPoolQueue::WorkerPoolQueue(WorkerPoolHandle* owner) : owner_(owner) {}
+
+void WorkerPoolQueue::Post(Task&& task) {
+  Mutex::ScopedLock lock(mutex_);
+  tasks_.emplace_back(std::move(task));
+  // Waking up one worker per task is enough. A worker takes tasks until the
+  // queue is empty before it becomes idle again.
+  if (!idle_.empty()) {
+    WorkerPoolHandle* worker = idle_.back();
+    idle_.pop_back();
+    worker->Signal();
+  }
+}
+
+bool WorkerPoolQueue::Take(WorkerPoolHandle* worker, Task* task) {
+  Mutex::ScopedLock lock(mutex_);
+  if (tasks_.empty()) {
+    if (std::find(idle_.begin(), idle_.end(), worker) == idle_.end())
+      idle_.push_back(worker);
+    return false;
+  }
+  *task = std::move(tasks_.front());
+  tasks_.pop_front();
+  return true;
+}
+
+void WorkerPoolQueue::Complete(Result&& result) {
+  Mutex::ScopedLock lock(mutex_);
+  if (owner_ == nullptr)
+    return;
+  results_.emplace_back(std::move(result));
+  // The owner takes all results at once, so only the first result after
+  // that needs to wake it up.
+  if (results_.size() == 1)
+    owner_->Signal();
+}
+
+std::deque<WorkerPoolQueue::Result> WorkerPoolQueue::TakeResults() {
+  std::deque<Result> results;
+  Mutex::ScopedLock lock(mutex_);
+  results.swap(results_);
+  return results;
+}
+
+void WorkerPoolQueue::RemoveHandle(WorkerPoolHandle* handle) {
+  Mutex::ScopedLock lock(mutex_);
+  if (handle == owner_) {
+    owner_ = nullptr;
+    tasks_.clear();
+    results_.clear();
+  }
+  idle_.erase(std::remove(idle_.begin(), idle_.end(), handle), idle_.end());
+}
+
+void WorkerPoolQueue::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackFieldWithSize("tasks", tasks_.size() * sizeof(Task));
+  tracker->TrackFieldWithSize("results", results_.size() * sizeof(Result));
+}
+
+WorkerPoolHandle::WorkerPoolHandle(Environment* env,
+                                   Local<Object> object,
+                                   std::shared_ptr<WorkerPoolQueue> queue)
+    : HandleWrap(env,
+                 object,
+                 reinterpret_cast<uv_handle_t*>(&async_),
+                 AsyncWrap::PROVIDER_WORKERPOOL),
+      queue_(std::move(queue)),
+      is_owner_(!queue_) {
+  CHECK_EQ(uv_async_init(env->event_loop(), &async_, [](uv_async_t* handle) {
+    WorkerPoolHandle* wrap = ContainerOf(&WorkerPoolHandle::async_, handle);
+    wrap->OnSignal();
+  }), 0);
+  if (is_owner_) {
+    queue_ = std::make_shared<WorkerPoolQueue>(this);
+    // The pool refs the handle while it is waiting for results.
+    uv_unref(GetHandle());
+  }
+}
+
+BaseObjectPtr<WorkerPoolHandle> WorkerPoolHandle::Create(
+    Environment* env,
+    std::shared_ptr<WorkerPoolQueue> queue) {
+  Local<Object> obj;
+  if (!GetConstructorTemplate(env)
+          ->InstanceTemplate()
+          ->NewInstance(env->context()).ToLocal(&obj)) {
+    return BaseObjectPtr<WorkerPoolHandle>();
+  }
+  return MakeBaseObject<WorkerPoolHandle>(env, obj, std::move(queue));
+}
+
+void WorkerPoolHandle::New(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args.IsConstructCall());
+  Environment* env = Environment::GetCurrent(args);
+  new WorkerPoolHandle(env, args.This(), nullptr);
+}
+
+void WorkerPoolHandle::Signal() {
+  CHECK_EQ(uv_async_send(&async_), 0);
+}
+
+void WorkerPoolHandle::Close(Local<Value> close_callback) {
+  if (!IsHandleClosing()) {
+    // Tasks that this worker will not complete anymore are reported as
+    // aborted, so that the pool can settle them.
+    for (uint64_t id : running_)
+      queue_->Complete({ id, kTaskAborted, nullptr });
+    running_.clear();
+    // After this, the queue does not signal this handle anymore.
+    queue_->RemoveHandle(this);
+  }
+  HandleWrap::Close(close_callback);
+}
+
+void WorkerPoolHandle::OnSignal() {
+  if (is_owner_)
+    OnResults();
+  else
+    OnWork();
+}
+
+void WorkerPoolHandle::OnResults() {
+  std::deque<WorkerPoolQueue::Result> results = queue_->TakeResults();
+  if (results.empty() || !env()->can_call_into_js())
+    return;
+
+  Isolate* isolate = env()->isolate();
+  HandleScope handle_scope(isolate);
+  Local<Context> context = env()->context();
+  Context::Scope context_scope(context);
+
+  // All results are passed to JS at once, as [id, status, value, ...].
+  std::vector<Local<Value>> list;
+  list.reserve(results.size() * 3);
+  for (WorkerPoolQueue::Result& result : results) {
+    WorkerPoolTaskStatus status = result.status;
+    Local<Value> value = Undefined(isolate);
+    if (result.message) {
+      TryCatch try_catch(isolate);
+      if (!result.message->Deserialize(env(), context).ToLocal(&value)) {
+        if (try_catch.HasTerminated())
+          return;
+        status = kTaskRejected;
+        value = try_catch.Exception();
+      }
+    }
+    list.push_back(Number::New(isolate, static_cast<double>(result.id)));
+    list.push_back(Integer::New(isolate, status));
+    list.push_back(value);
+  }
+
+  Local<Value> argv[] = { Array::New(isolate, list.data(), list.size()) };
+  MakeCallback(env()->oncomplete_string(), arraysize(argv), argv);
+}
+
+void WorkerPoolHandle::OnWork() {
+  if (!env()->can_call_into_js())
+    return;
+  HandleScope handle_scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+  MakeCallback(env()->onwork_string(), 0, nullptr);
+}
+
+static bool ReadTransferList(Local<Context> context,
+                             Local<Value> value,
+                             TransferList* transfer_list) {
+  if (!value->IsArray())
+    return true;
+  Local<Array> array = value.As<Array>();
+  uint32_t length = array->Length();
+  transfer_list->AllocateSufficientStorage(length);
+  for (uint32_t i = 0; i < length; i++) {
+    if (!array->Get(context, i).ToLocal(&(*transfer_list)[i]))
+      return false;
+  }
+  return true;
+}
+
+void WorkerPoolHandle::Post(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  WorkerPoolHandle* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  CHECK(wrap->is_owner_);
+  if (wrap->IsHandleClosing())
+    return;
+
+  Local<Context> context = env->context();
+  TransferList transfer_list;
+  if (!ReadTransferList(context, args[1], &transfer_list))
+    return;
+
+  auto message = std::make_unique<Message>();
+  if (message->Serialize(env, context, args[0], transfer_list).IsNothing())
+    return;
+
+  uint64_t id = wrap->next_task_id_++;
+  wrap->queue_->Post({ id, std::move(message) });
+  args.GetReturnValue().Set(static_cast<double>(id));
+}
+
+void WorkerPoolHandle::Receive(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  WorkerPoolHandle* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  CHECK(!wrap->is_owner_);
+  if (wrap->IsHandleClosing())
+    return;
+
+  Local<Context> context = env->context();
+  WorkerPoolQueue::Task task;
+  Local<Value> value;
+  for (;;) {
+    if (!wrap->queue_->Take(wrap, &task))
+      return;
+    TryCatch try_catch(env->isolate());
+    if (task.message->Deserialize(env, context).ToLocal(&value))
+      break;
+    if (try_catch.HasTerminated()) {
+      try_catch.ReThrow();
+      return;
+    }
+    // A task that cannot be deserialized here is rejected with the exception
+    // and the worker moves on to the next one.
+    TransferList transfer_list;
+    auto message = std::make_unique<Message>();
+    if (message->Serialize(env, context, try_catch.Exception(), transfer_list)
+            .IsNothing()) {
+      message.reset();
+    }
+    WorkerPoolTaskStatus status = message ? kTaskRejected : kTaskAborted;
+    wrap->queue_->Complete({ task.id, status, std::move(message) });
+  }
+  wrap->running_.insert(task.id);
+
+  Local<Value> entry[] = {
+    Number::New(env->isolate(), static_cast<double>(task.id)),
+    value
+  };
+  args.GetReturnValue().Set(
+      Array::New(env->isolate(), entry, arraysize(entry)));
+}
+
+void WorkerPoolHandle::Complete(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  WorkerPoolHandle* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  CHECK(!wrap->is_owner_);
+  CHECK(args[0]->IsNumber());
+  CHECK(args[1]->IsBoolean());
+
+  uint64_t id = static_cast<uint64_t>(args[0].As<Number>()->Value());
+  if (wrap->running_.count(id) == 0)
+    return;
+
+  Local<Context> context = env->context();
+  TransferList transfer_list;
+  if (!ReadTransferList(context, args[3], &transfer_list))
+    return;
+
+  // If the value cannot be serialized, the exception is thrown to JS and the
+  // task stays running, so that it can be completed with that exception.
+  auto message = std::make_unique<Message>();
+  if (message->Serialize(env, context, args[2], transfer_list).IsNothing())
+    return;
+
+  wrap->running_.erase(id);
+  WorkerPoolTaskStatus status = args[1]->IsTrue() ?
+      kTaskFulfilled : kTaskRejected;
+  wrap->queue_->Complete({ id, status, std::move(message) });
+}
+
+std::unique_ptr<worker::TransferData>
+WorkerPoolHandle::CloneForMessaging() const {
+  return std::make_unique<TransferData>(queue_);
+}
+
+BaseObjectPtr<BaseObject> WorkerPoolHandle::TransferData::Deserialize(
+    Environment* env,
+    Local<Context> context,
+    std::unique_ptr<worker::TransferData> self) {
+  return Create(env, std::move(queue_));
+}
+
+void WorkerPoolHandle::TransferData::MemoryInfo(
+    MemoryTracker* tracker) const {
+  tracker->TrackField("queue", queue_);
+}
+
+void WorkerPoolHandle::MemoryInfo(MemoryTracker* tracker) const {
+  tracker->TrackField("queue", queue_);
+}
+
+Local<FunctionTemplate> WorkerPoolHandle::GetConstructorTemplate(
+    Environment* env) {
+  Local<FunctionTemplate> tmpl = env->worker_pool_constructor_template();
+  if (tmpl.IsEmpty()) {
+    tmpl = env->NewFunctionTemplate(New);
+    tmpl->SetClassName(
+        FIXED_ONE_BYTE_STRING(env->isolate(), "WorkerPoolHandle"));
+    tmpl->Inherit(HandleWrap::GetConstructorTemplate(env));
+    tmpl->InstanceTemplate()->SetInternalFieldCount(kInternalFieldCount);
+    env->SetProtoMethod(tmpl, "post", Post);
+    env->SetProtoMethod(tmpl, "receive", Receive);
+    env->SetProtoMethod(tmpl, "complete", Complete);
+    env->set_worker_pool_constructor_template(tmpl);
+  }
+  return tmpl;
+}
+
+void WorkerPoolHandle::Initialize(Environment* env, Local<Object> target) {
+  env->SetConstructorFunction(
+      target, "WorkerPoolHandle", GetConstructorTemplate(env));
+
+  NODE_DEFINE_CONSTANT(target, kTaskFulfilled);
+  NODE_DEFINE_CONSTANT(target, kTaskRejected);
+  NODE_DEFINE_CONSTANT(target, kTaskAborted);
+}
+
+void WorkerPoolHandle::RegisterExternalReferences(
+    ExternalReferenceRegistry* registry) {
+  registry->Register(New);
+  registry->Register(Post);
+  registry->Register(Receive);
+  registry->Register(Complete);
+}
+
+}  // namespace worker
+}  // namespace node
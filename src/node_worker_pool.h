@@ -0,0 +1,160 @@
+#ifndef SRC_NODE_WORKER_POOL_H_
+#define SRC_NODE_WORKER_POOL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "handle_wrap.h"
+#include "node_messaging.h"
+#include "node_mutex.h"
+#include "uv.h"
+
+#include <deque>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace node {
+
+class ExternalReferenceRegistry;
+
+namespace worker {
+
+class WorkerPoolHandle;
+
+// How a task of a WorkerPool has been settled.
+enum WorkerPoolTaskStatus {
+  kTaskFulfilled,
+  kTaskRejected,
+  // The worker that was running the task exited before completing it.
+  kTaskAborted
+};
+
+// The task queue of a WorkerPool. It is shared between the handle that the
+// pool owns on the thread that created it and the handles of its workers,
+// which all take their tasks from it. Tasks and results are serialized
+// Messages, so that they can be posted from any thread.
+class WorkerPoolQueue final : public MemoryRetainer {
+ public:
+  struct Task {
+    uint64_t id;
+    std::unique_ptr<Message> message;
+  };
+
+  struct Result {
+    uint64_t id;
+    WorkerPoolTaskStatus status;
+    std::unique_ptr<Message> message;
+  };
+
+  explicit WorkerPoolQueue(WorkerPoolHandle* owner);
+
+  // Called on the owner's thread. Wakes up one idle worker, if there is one.
+  void Post(Task&& task);
+  // Called on a worker's thread. If there is no task, returns false and
+  // `worker` is woken up again once one is posted.
+  bool Take(WorkerPoolHandle* worker, Task* task);
+  // Called on a worker's thread. Results are handed to the owner in batches,
+  // with one wakeup for all results that arrive before it gets to run.
+  void Complete(Result&& result);
+  // Called on the owner's thread.
+  std::deque<Result> TakeResults();
+
+  // Called by a handle that is being closed. Once the owner is gone, posted
+  // tasks are dropped and results are discarded.
+  void RemoveHandle(WorkerPoolHandle* handle);
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(WorkerPoolQueue)
+  SET_SELF_SIZE(WorkerPoolQueue)
+
+ private:
+  Mutex mutex_;
+  std::deque<Task> tasks_;
+  std::deque<Result> results_;
+  // Workers that found the queue empty, in the order in which they did.
+  std::vector<WorkerPoolHandle*> idle_;
+  WorkerPoolHandle* owner_;
+};
+
+// A handle on a WorkerPoolQueue. The handle that is created from JS owns a
+// new queue and is notified of results through `oncomplete`. Clones of it
+// that are passed to workers are notified of new tasks through `onwork`.
+class WorkerPoolHandle final : public HandleWrap {
+ public:
+  static void Initialize(Environment* env, v8::Local<v8::Object> target);
+  static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
+
+  static v8::Local<v8::FunctionTemplate> GetConstructorTemplate(
+      Environment* env);
+
+  // Creates a handle on an existing queue, for a worker.
+  static BaseObjectPtr<WorkerPoolHandle> Create(
+      Environment* env,
+      std::shared_ptr<WorkerPoolQueue> queue);
+
+  // If `queue` is empty, the handle creates a new queue and becomes its
+  // owner.
+  WorkerPoolHandle(Environment* env,
+                   v8::Local<v8::Object> object,
+                   std::shared_ptr<WorkerPoolQueue> queue);
+
+  // Wake up the thread of this handle. Called with the queue's mutex held.
+  void Signal();
+
+  void Close(v8::Local<v8::Value> close_callback =
+                 v8::Local<v8::Value>()) override;
+
+  TransferMode GetTransferMode() const override {
+    return TransferMode::kCloneable;
+  }
+  std::unique_ptr<worker::TransferData> CloneForMessaging() const override;
+
+  class TransferData : public worker::TransferData {
+   public:
+    explicit TransferData(std::shared_ptr<WorkerPoolQueue> queue)
+        : queue_(std::move(queue)) {}
+
+    BaseObjectPtr<BaseObject> Deserialize(
+        Environment* env,
+        v8::Local<v8::Context> context,
+        std::unique_ptr<worker::TransferData> self) override;
+
+    void MemoryInfo(MemoryTracker* tracker) const override;
+    SET_MEMORY_INFO_NAME(WorkerPoolHandle::TransferData)
+    SET_SELF_SIZE(TransferData)
+
+   private:
+    std::shared_ptr<WorkerPoolQueue> queue_;
+  };
+
+  void MemoryInfo(MemoryTracker* tracker) const override;
+  SET_MEMORY_INFO_NAME(WorkerPoolHandle)
+  SET_SELF_SIZE(WorkerPoolHandle)
+
+ private:
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // post(value, transferList): Queue a task, returns its id.
+  static void Post(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // receive(): Returns [id, value] for the next task, or undefined.
+  static void Receive(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // complete(id, fulfilled, value, transferList): Report a task's result.
+  static void Complete(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  void OnSignal();
+  void OnResults();
+  void OnWork();
+
+  uv_async_t async_;
+  std::shared_ptr<WorkerPoolQueue> queue_;
+  const bool is_owner_;
+  uint64_t next_task_id_ = 0;
+  // Tasks that a worker has received but not completed yet.
+  std::unordered_set<uint64_t> running_;
+};
+
+}  // namespace worker
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_WORKER_POOL_H_
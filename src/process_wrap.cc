@@ -255,6 +255,14 @@ class ProcessWrap : public HandleWrap {
       options.flags |= UV_PROCESS_DETACHED;
     }
 
+    // options.fastSpawn
+    Local<Value> fast_spawn_v =
+        js_options->Get(context, env->fast_spawn_string()).ToLocalChecked();
+
+    if (fast_spawn_v->IsTrue()) {
+      options.flags |= UV_PROCESS_VFORK;
+    }
+
     int err = uv_spawn(env->event_loop(), &wrap->process_, &options);
     wrap->MarkAsInitialized();
 
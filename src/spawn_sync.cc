@@ -26,6 +26,9 @@
 #include "string_bytes.h"
 #include "util-inl.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
 #include <cstring>
 
 
@@ -34,6 +37,7 @@ namespace node {
 using v8::Array;
 using v8::Context;
 using v8::EscapableHandleScope;
+using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::HandleScope;
 using v8::Int32;
@@ -48,62 +52,93 @@ using v8::Null;
 using v8::Number;
 using v8::Object;
 using v8::String;
+using v8::Undefined;
 using v8::Value;
 
-void SyncProcessOutputBuffer::OnAlloc(size_t suggested_size,
-                                      uv_buf_t* buf) const {
-  if (used() == kBufferSize)
-    *buf = uv_buf_init(nullptr, 0);
-  else
-    *buf = uv_buf_init(data_ + used(), available());
+SyncProcessOutputBuffer::~SyncProcessOutputBuffer() {
+  free(data_);
 }
 
 
-void SyncProcessOutputBuffer::OnRead(const uv_buf_t* buf, size_t nread) {
-  // If we hand out the same chunk twice, this should catch it.
-  CHECK_EQ(buf->base, data_ + used());
-  used_ += static_cast<unsigned int>(nread);
+void SyncProcessOutputBuffer::OnAlloc(size_t limit, uv_buf_t* buf) {
+  if (used_ == size_) {
+    size_t size = size_ == 0 ? kInitialSize : 2 * size_;
+    // The first chunk is always allocated in full, so that a read returns
+    // as much output past a small maxBuffer as it did with fixed-size chunks.
+    if (limit > 0 && size > kInitialSize)
+      size = std::max(std::min(size, limit + 1), used_ + 1);
+    // For large buffers, realloc() can usually remap the pages instead of
+    // copying the data.
+    char* data = static_cast<char*>(realloc(data_, size));
+    if (data == nullptr) {
+      // libuv reports UV_ENOBUFS to the read callback.
+      *buf = uv_buf_init(nullptr, 0);
+      return;
+    }
+    data_ = data;
+    size_ = size;
+  }
+
+  // Use unsigned int because that's what `uv_buf_init` takes.
+  size_t available = std::min<size_t>(size_ - used_, UINT_MAX);
+  *buf = uv_buf_init(data_ + used_, static_cast<unsigned int>(available));
 }
 
 
-size_t SyncProcessOutputBuffer::Copy(char* dest) const {
-  memcpy(dest, data_, used());
-  return used();
+void SyncProcessOutputBuffer::OnRead(const uv_buf_t* buf, size_t nread) {
+  // If we hand out the same chunk twice, this should catch it.
+  CHECK_EQ(buf->base, data_ + used_);
+  used_ += nread;
 }
 
 
-unsigned int SyncProcessOutputBuffer::available() const {
-  return sizeof data_ - used();
-}
+MaybeLocal<Object> SyncProcessOutputBuffer::Release(Environment* env) {
+  if (used_ == 0)
+    return Buffer::New(env->isolate(), 0);
 
+  // Give back the unused part of the allocation, the Buffer keeps all of it
+  // alive for as long as it is reachable.
+  if (used_ < size_) {
+    char* data = static_cast<char*>(realloc(data_, used_));
+    if (data != nullptr)
+      data_ = data;
+  }
 
-unsigned int SyncProcessOutputBuffer::used() const {
-  return used_;
+  MaybeLocal<Object> buffer = Buffer::New(
+      env->isolate(),
+      data_,
+      used_,
+      [](char* data, void* hint) { free(data); },
+      nullptr);
+  if (!buffer.IsEmpty()) {
+    data_ = nullptr;
+    size_ = used_ = 0;
+  }
+  return buffer;
 }
 
 
-SyncProcessOutputBuffer* SyncProcessOutputBuffer::next() const {
-  return next_;
+const char* SyncProcessOutputBuffer::data() const {
+  return data_;
 }
 
 
-void SyncProcessOutputBuffer::set_next(SyncProcessOutputBuffer* next) {
-  next_ = next;
+size_t SyncProcessOutputBuffer::used() const {
+  return used_;
 }
 
 
 SyncProcessStdioPipe::SyncProcessStdioPipe(SyncProcessRunner* process_handler,
+                                           uint32_t child_fd,
                                            bool readable,
                                            bool writable,
                                            uv_buf_t input_buffer)
     : process_handler_(process_handler),
+      child_fd_(child_fd),
       readable_(readable),
       writable_(writable),
       input_buffer_(input_buffer),
 
-      first_output_buffer_(nullptr),
-      last_output_buffer_(nullptr),
-
       uv_pipe_(),
       write_req_(),
       shutdown_req_(),
@@ -115,14 +150,6 @@ SyncProcessStdioPipe::SyncProcessStdioPipe(SyncProcessRunner* process_handler,
 
 SyncProcessStdioPipe::~SyncProcessStdioPipe() {
   CHECK(lifecycle_ == kUninitialized || lifecycle_ == kClosed);
-
-  SyncProcessOutputBuffer* buf;
-  SyncProcessOutputBuffer* next;
-
-  for (buf = first_output_buffer_; buf != nullptr; buf = next) {
-    next = buf->next();
-    delete buf;
-  }
 }
 
 
@@ -184,11 +211,8 @@ void SyncProcessStdioPipe::Close() {
 }
 
 
-Local<Object> SyncProcessStdioPipe::GetOutputAsBuffer(Environment* env) const {
-  size_t length = OutputLength();
-  Local<Object> js_buffer = Buffer::New(env, length).ToLocalChecked();
-  CopyOutput(Buffer::Data(js_buffer));
-  return js_buffer;
+Local<Object> SyncProcessStdioPipe::GetOutputAsBuffer(Environment* env) {
+  return output_.Release(env).ToLocalChecked();
 }
 
 
@@ -231,23 +255,30 @@ uv_handle_t* SyncProcessStdioPipe::uv_handle() const {
 }
 
 
-size_t SyncProcessStdioPipe::OutputLength() const {
-  SyncProcessOutputBuffer* buf;
-  size_t size = 0;
-
-  for (buf = first_output_buffer_; buf != nullptr; buf = buf->next())
-    size += buf->used();
-
-  return size;
-}
-
-
-void SyncProcessStdioPipe::CopyOutput(char* dest) const {
-  SyncProcessOutputBuffer* buf;
-  size_t offset = 0;
+void SyncProcessStdioPipe::EmitLines(bool eof) {
+  const char* data = output_.data();
+  size_t used = output_.used();
+
+  while (line_start_ < used && !process_handler_->killed_) {
+    const void* newline =
+        memchr(data + line_scan_, '\n', used - line_scan_);
+    if (newline == nullptr) {
+      line_scan_ = used;
+      if (!eof)
+        break;
+      process_handler_->EmitLine(
+          child_fd_, data + line_start_, used - line_start_);
+      line_start_ = used;
+      break;
+    }
 
-  for (buf = first_output_buffer_; buf != nullptr; buf = buf->next())
-    offset += buf->Copy(dest + offset);
+    size_t end = static_cast<const char*>(newline) - data;
+    size_t length = end - line_start_;
+    if (length > 0 && data[end - 1] == '\r')
+      length--;
+    process_handler_->EmitLine(child_fd_, data + line_start_, length);
+    line_start_ = line_scan_ = end + 1;
+  }
 }
 
 
@@ -256,26 +287,19 @@ void SyncProcessStdioPipe::OnAlloc(size_t suggested_size, uv_buf_t* buf) {
   // same stream at the same time. There's an assert in
   // SyncProcessOutputBuffer::OnRead that would fail if this assumption was
   // ever violated.
-
-  if (last_output_buffer_ == nullptr) {
-    // Allocate the first capture buffer.
-    first_output_buffer_ = new SyncProcessOutputBuffer();
-    last_output_buffer_ = first_output_buffer_;
-
-  } else if (last_output_buffer_->available() == 0) {
-    // The current capture buffer is full so get us a new one.
-    SyncProcessOutputBuffer* buf = new SyncProcessOutputBuffer();
-    last_output_buffer_->set_next(buf);
-    last_output_buffer_ = buf;
-  }
-
-  last_output_buffer_->OnAlloc(suggested_size, buf);
+  double max_buffer = process_handler_->max_buffer_;
+  size_t limit = 0;
+  if (max_buffer > 0 && max_buffer < static_cast<double>(SIZE_MAX))
+    limit = static_cast<size_t>(max_buffer);
+  output_.OnAlloc(limit, buf);
 }
 
 
 void SyncProcessStdioPipe::OnRead(const uv_buf_t* buf, ssize_t nread) {
   if (nread == UV_EOF) {
     // Libuv implicitly stops reading on EOF.
+    if (process_handler_->has_line_callback())
+      EmitLines(true);
 
   } else if (nread < 0) {
     SetError(static_cast<int>(nread));
@@ -283,8 +307,10 @@ void SyncProcessStdioPipe::OnRead(const uv_buf_t* buf, ssize_t nread) {
     uv_read_stop(uv_stream());
 
   } else {
-    last_output_buffer_->OnRead(buf, nread);
+    output_.OnRead(buf, nread);
     process_handler_->IncrementBufferSizeAndCheckOverflow(nread);
+    if (process_handler_->has_line_callback())
+      EmitLines(false);
   }
 }
 
@@ -381,6 +407,7 @@ void SyncProcessRunner::Spawn(const FunctionCallbackInfo<Value>& args) {
 SyncProcessRunner::SyncProcessRunner(Environment* env)
     : max_buffer_(0),
       timeout_(0),
+      line_callback_threw_(false),
       kill_signal_(SIGTERM),
 
       uv_loop_(nullptr),
@@ -437,7 +464,7 @@ MaybeLocal<Object> SyncProcessRunner::Run(Local<Value> options) {
 
   Maybe<bool> r = TryInitializeAndRunLoop(options);
   CloseHandlesAndDeleteLoop();
-  if (r.IsNothing()) return MaybeLocal<Object>();
+  if (r.IsNothing() || line_callback_threw_) return MaybeLocal<Object>();
 
   Local<Object> result = BuildResultObject();
 
@@ -639,6 +666,32 @@ void SyncProcessRunner::IncrementBufferSizeAndCheckOverflow(ssize_t length) {
 }
 
 
+bool SyncProcessRunner::has_line_callback() const {
+  return !line_callback_.IsEmpty();
+}
+
+
+void SyncProcessRunner::EmitLine(uint32_t child_fd,
+                                 const char* data,
+                                 size_t length) {
+  if (line_callback_threw_)
+    return;
+
+  Isolate* isolate = env()->isolate();
+  HandleScope scope(isolate);
+  Local<Value> argv[2];
+  argv[1] = Integer::NewFromUnsigned(isolate, child_fd);
+  if (!Buffer::Copy(isolate, data, length).ToLocal(&argv[0]) ||
+      line_callback_.Get(isolate)->Call(env()->context(),
+                                        Undefined(isolate),
+                                        arraysize(argv),
+                                        argv).IsEmpty()) {
+    line_callback_threw_ = true;
+    Kill();
+  }
+}
+
+
 void SyncProcessRunner::OnExit(int64_t exit_status, int term_signal) {
   if (exit_status < 0)
     return SetError(static_cast<int>(exit_status));
@@ -805,6 +858,11 @@ Maybe<int> SyncProcessRunner::ParseOptions(Local<Value> js_value) {
   if (js_detached->BooleanValue(isolate))
     uv_process_options_.flags |= UV_PROCESS_DETACHED;
 
+  Local<Value> js_fast_spawn =
+      js_options->Get(context, env()->fast_spawn_string()).ToLocalChecked();
+  if (js_fast_spawn->BooleanValue(isolate))
+    uv_process_options_.flags |= UV_PROCESS_VFORK;
+
   Local<Value> js_win_hide =
       js_options->Get(context, env()->windows_hide_string()).ToLocalChecked();
   if (js_win_hide->BooleanValue(isolate))
@@ -832,6 +890,13 @@ Maybe<int> SyncProcessRunner::ParseOptions(Local<Value> js_value) {
     max_buffer_ = js_max_buffer->NumberValue(context).FromJust();
   }
 
+  Local<Value> js_on_line =
+      js_options->Get(context, env()->online_string()).ToLocalChecked();
+  if (IsSet(js_on_line)) {
+    CHECK(js_on_line->IsFunction());
+    line_callback_.Reset(isolate, js_on_line.As<Function>());
+  }
+
   Local<Value> js_kill_signal =
       js_options->Get(context, env()->kill_signal_string()).ToLocalChecked();
   if (IsSet(js_kill_signal)) {
@@ -953,7 +1018,8 @@ int SyncProcessRunner::AddStdioPipe(uint32_t child_fd,
   CHECK(!stdio_pipes_[child_fd]);
 
   std::unique_ptr<SyncProcessStdioPipe> h(
-      new SyncProcessStdioPipe(this, readable, writable, input_buffer));
+      new SyncProcessStdioPipe(this, child_fd, readable, writable,
+                               input_buffer));
 
   int r = h->Initialize(uv_loop_);
   if (r < 0) {
@@ -37,29 +37,35 @@ class SyncProcessStdioPipe;
 class SyncProcessRunner;
 
 
+// Collects the output of a pipe in a single growable allocation. Once the
+// child process is done, the memory is handed over to JS as the backing store
+// of the output Buffer, so that the output does not have to be copied again.
 class SyncProcessOutputBuffer {
-  static const unsigned int kBufferSize = 65536;
+  static const size_t kInitialSize = 65536;
 
  public:
   inline SyncProcessOutputBuffer() = default;
+  inline ~SyncProcessOutputBuffer();
 
-  inline void OnAlloc(size_t suggested_size, uv_buf_t* buf) const;
-  inline void OnRead(const uv_buf_t* buf, size_t nread);
+  SyncProcessOutputBuffer(const SyncProcessOutputBuffer&) = delete;
+  SyncProcessOutputBuffer& operator=(const SyncProcessOutputBuffer&) = delete;
 
-  inline size_t Copy(char* dest) const;
+  // `limit` is the most data that will ever be kept, or 0 if there is no
+  // limit. The buffer grows by doubling its size, up to `limit` plus one byte
+  // so that an overflow can still be detected.
+  inline void OnAlloc(size_t limit, uv_buf_t* buf);
+  inline void OnRead(const uv_buf_t* buf, size_t nread);
 
-  inline unsigned int available() const;
-  inline unsigned int used() const;
+  // Transfers ownership of the data to a new Buffer.
+  v8::MaybeLocal<v8::Object> Release(Environment* env);
 
-  inline SyncProcessOutputBuffer* next() const;
-  inline void set_next(SyncProcessOutputBuffer* next);
+  inline const char* data() const;
+  inline size_t used() const;
 
  private:
-  // Use unsigned int because that's what `uv_buf_init` takes.
-  mutable char data_[kBufferSize];
-  unsigned int used_ = 0;
-
-  SyncProcessOutputBuffer* next_ = nullptr;
+  char* data_ = nullptr;
+  size_t size_ = 0;
+  size_t used_ = 0;
 };
 
 
@@ -74,6 +80,7 @@ class SyncProcessStdioPipe {
 
  public:
   SyncProcessStdioPipe(SyncProcessRunner* process_handler,
+                       uint32_t child_fd,
                        bool readable,
                        bool writable,
                        uv_buf_t input_buffer);
@@ -83,7 +90,7 @@ class SyncProcessStdioPipe {
   int Start();
   void Close();
 
-  v8::Local<v8::Object> GetOutputAsBuffer(Environment* env) const;
+  v8::Local<v8::Object> GetOutputAsBuffer(Environment* env);
 
   inline bool readable() const;
   inline bool writable() const;
@@ -94,8 +101,9 @@ class SyncProcessStdioPipe {
   inline uv_handle_t* uv_handle() const;
 
  private:
-  inline size_t OutputLength() const;
-  inline void CopyOutput(char* dest) const;
+  // Passes the complete lines read since the last call to the `onLine`
+  // callback. At EOF, a last line without a terminator is passed as well.
+  inline void EmitLines(bool eof);
 
   inline void OnAlloc(size_t suggested_size, uv_buf_t* buf);
   inline void OnRead(const uv_buf_t* buf, ssize_t nread);
@@ -117,12 +125,16 @@ class SyncProcessStdioPipe {
 
   SyncProcessRunner* process_handler_;
 
+  uint32_t child_fd_;
   bool readable_;
   bool writable_;
   uv_buf_t input_buffer_;
 
-  SyncProcessOutputBuffer* first_output_buffer_;
-  SyncProcessOutputBuffer* last_output_buffer_;
+  SyncProcessOutputBuffer output_;
+  // The start of the next line to be passed to `onLine`, and the offset at
+  // which the search for its end continues.
+  size_t line_start_ = 0;
+  size_t line_scan_ = 0;
 
   mutable uv_pipe_t uv_pipe_;
   uv_write_t write_req_;
@@ -163,6 +175,8 @@ class SyncProcessRunner {
 
   void Kill();
   void IncrementBufferSizeAndCheckOverflow(ssize_t length);
+  void EmitLine(uint32_t child_fd, const char* data, size_t length);
+  inline bool has_line_callback() const;
 
   void OnExit(int64_t exit_status, int term_signal);
   void OnKillTimerTimeout();
@@ -199,6 +213,10 @@ class SyncProcessRunner {
 
   double max_buffer_;
   uint64_t timeout_;
+  v8::Global<v8::Function> line_callback_;
+  // Set once the `onLine` callback has thrown. The exception is left pending
+  // and no result is returned.
+  bool line_callback_threw_;
   int kill_signal_;
 
   uv_loop_t* uv_loop_;
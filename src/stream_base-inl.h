@@ -128,6 +128,12 @@ int StreamBase::Shutdown(v8::Local<v8::Object> req_wrap_obj) {
 
   v8::HandleScope handle_scope(env->isolate());
 
+  // A write error for coalesced data fails the shutdown, since the writes
+  // that the data belongs to have already completed.
+  int err = FlushCoalescedWrites();
+  if (err != 0)
+    return err;
+
   if (req_wrap_obj.IsEmpty()) {
     if (!env->shutdown_wrap_template()
              ->NewInstance(env->context())
@@ -142,7 +148,7 @@ int StreamBase::Shutdown(v8::Local<v8::Object> req_wrap_obj) {
   ShutdownWrap* req_wrap = CreateShutdownWrap(req_wrap_obj);
   if (req_wrap != nullptr)
     req_wrap_ptr.reset(req_wrap->GetAsyncWrap());
-  int err = DoShutdown(req_wrap);
+  err = DoShutdown(req_wrap);
 
   if (err != 0 && req_wrap != nullptr) {
     req_wrap->Dispose();
@@ -170,6 +176,17 @@ StreamWriteResult StreamBase::Write(
   size_t total_bytes = 0;
   for (size_t i = 0; i < count; ++i)
     total_bytes += bufs[i].len;
+
+  if (coalesce_writes_ && send_handle == nullptr) {
+    err = CoalesceWrite(bufs, count, total_bytes);
+    if (err != UV_EAGAIN) {
+      if (err == 0)
+        bytes_written_ += total_bytes;
+      return StreamWriteResult {
+          false, err, nullptr, err == 0 ? total_bytes : 0, {} };
+    }
+  }
+
   bytes_written_ += total_bytes;
 
   if (send_handle == nullptr) {
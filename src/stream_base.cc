@@ -9,16 +9,19 @@
 #include "node_buffer.h"
 #include "node_errors.h"
 #include "node_external_reference.h"
+#include "node_mutex.h"
 #include "string_bytes.h"
 #include "util-inl.h"
 #include "v8.h"
 
+#include <algorithm>
 #include <climits>  // INT_MAX
 
 namespace node {
 
 using v8::Array;
 using v8::ArrayBuffer;
+using v8::BackingStore;
 using v8::ConstructorBehavior;
 using v8::Context;
 using v8::DontDelete;
@@ -37,6 +40,7 @@ using v8::ReadOnly;
 using v8::SideEffectType;
 using v8::Signature;
 using v8::String;
+using v8::True;
 using v8::Value;
 
 template int StreamBase::WriteString<ASCII>(
@@ -66,6 +70,116 @@ int StreamBase::UseUserBuffer(const FunctionCallbackInfo<Value>& args) {
   return 0;
 }
 
+int StreamBase::SetWriteCoalescing(const FunctionCallbackInfo<Value>& args) {
+  bool enable = args[0]->IsTrue();
+  int err = 0;
+  if (!enable)
+    err = FlushCoalescedWrites();
+  coalesce_writes_ = enable;
+  return err;
+}
+
+int StreamBase::CoalesceWrite(const uv_buf_t* bufs,
+                              size_t count,
+                              size_t total_bytes) {
+  if (coalesced_writes_in_flight_ > 0 ||
+      total_bytes > kMaxCoalescedWriteSize ||
+      coalesced_data_.size() + total_bytes > kMaxCoalescedBytes) {
+    // Write out what has been queued so far to keep the data in order.
+    int err = FlushCoalescedWrites();
+    return err != 0 ? err : UV_EAGAIN;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    coalesced_data_.insert(coalesced_data_.end(),
+                           bufs[i].base,
+                           bufs[i].base + bufs[i].len);
+  }
+
+  if (!coalesced_flush_scheduled_) {
+    coalesced_flush_scheduled_ = true;
+    BaseObjectPtr<AsyncWrap> strong_ref{GetAsyncWrap()};
+    stream_env()->SetImmediate([this, strong_ref](Environment* env) {
+      coalesced_flush_scheduled_ = false;
+      int err = FlushCoalescedWrites();
+      if (err != 0)
+        ReportCoalescedWriteError(err);
+    });
+  }
+
+  return 0;
+}
+
+int StreamBase::FlushCoalescedWrites() {
+  if (coalesced_data_.empty())
+    return 0;
+
+  if (!IsAlive() || IsClosing()) {
+    // Only happens when the handle has been closed without going through
+    // Close(), e.g. while the Environment is being torn down.
+    coalesced_data_.clear();
+    return 0;
+  }
+
+  uv_buf_t buf = uv_buf_init(coalesced_data_.data(), coalesced_data_.size());
+  uv_buf_t* bufs = &buf;
+  size_t count = 1;
+  int err = DoTryWrite(&bufs, &count);
+
+  if (err == 0 && count > 0) {
+    // Partial write, the rest is written asynchronously from a copy so that
+    // `coalesced_data_` can be reused right away.
+    Environment* env = stream_env();
+    HandleScope handle_scope(env->isolate());
+    Local<Object> req_wrap_obj;
+    if (!env->write_wrap_template()
+             ->NewInstance(env->context())
+             .ToLocal(&req_wrap_obj)) {
+      err = UV_EBUSY;
+    } else {
+      StreamReq::ResetObject(req_wrap_obj);
+      AllocatedBuffer data = AllocatedBuffer::AllocateManaged(env, bufs[0].len);
+      memcpy(data.data(), bufs[0].base, bufs[0].len);
+      uv_buf_t rest = uv_buf_init(data.data(), data.size());
+
+      AsyncHooks::DefaultTriggerAsyncIdScope trigger_scope(GetAsyncWrap());
+      WriteWrap* req_wrap = CreateWriteWrap(req_wrap_obj);
+      BaseObjectPtr<AsyncWrap> req_wrap_ptr(req_wrap->GetAsyncWrap());
+      req_wrap->coalesced_ = true;
+      req_wrap->SetAllocatedStorage(std::move(data));
+
+      err = DoWrite(req_wrap, &rest, 1, nullptr);
+      if (err == 0)
+        coalesced_writes_in_flight_++;
+      else
+        req_wrap->Dispose();
+      ClearError();
+    }
+  }
+
+  coalesced_data_.clear();
+  return err;
+}
+
+void StreamBase::AfterCoalescedWrite(int status) {
+  CHECK_GT(coalesced_writes_in_flight_, 0);
+  coalesced_writes_in_flight_--;
+  if (status != 0 && status != UV_ECANCELED)
+    ReportCoalescedWriteError(status);
+}
+
+void StreamBase::ReportCoalescedWriteError(int status) {
+  // The writes that the data belongs to have already completed, so the error
+  // is reported on the stream itself.
+  Environment* env = stream_env();
+  if (!env->can_call_into_js())
+    return;
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  Local<Value> arg = Integer::New(env->isolate(), status);
+  GetAsyncWrap()->MakeCallback(env->onerror_string(), 1, &arg);
+}
+
 int StreamBase::Shutdown(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsObject());
   Local<Object> req_wrap_obj = args[0].As<Object>();
@@ -255,6 +369,17 @@ int StreamBase::WriteString(const FunctionCallbackInfo<Value>& args) {
                                    enc);
     buf = uv_buf_init(stack_storage, data_size);
 
+    if (coalesce_writes_ && send_handle_obj.IsEmpty()) {
+      const int err = CoalesceWrite(&buf, 1, data_size);
+      if (err != UV_EAGAIN) {
+        if (err == 0)
+          bytes_written_ += data_size;
+        SetWriteResult(
+            StreamWriteResult { false, err, nullptr, data_size, {} });
+        return err;
+      }
+    }
+
     uv_buf_t* bufs = &buf;
     size_t count = 1;
     const int err = DoTryWrite(&bufs, &count);
@@ -402,6 +527,9 @@ void StreamBase::AddMethods(Environment* env, Local<FunctionTemplate> t) {
   env->SetProtoMethod(t,
                       "useUserBuffer",
                       JSMethod<&StreamBase::UseUserBuffer>);
+  env->SetProtoMethod(t,
+                      "setWriteCoalescing",
+                      JSMethod<&StreamBase::SetWriteCoalescing>);
   env->SetProtoMethod(t, "writev", JSMethod<&StreamBase::Writev>);
   env->SetProtoMethod(t, "writeBuffer", JSMethod<&StreamBase::WriteBuffer>);
   env->SetProtoMethod(
@@ -434,6 +562,7 @@ void StreamBase::RegisterExternalReferences(
   registry->Register(JSMethod<&StreamBase::ReadStopJS>);
   registry->Register(JSMethod<&StreamBase::Shutdown>);
   registry->Register(JSMethod<&StreamBase::UseUserBuffer>);
+  registry->Register(JSMethod<&StreamBase::SetWriteCoalescing>);
   registry->Register(JSMethod<&StreamBase::Writev>);
   registry->Register(JSMethod<&StreamBase::WriteBuffer>);
   registry->Register(JSMethod<&StreamBase::WriteString<ASCII>>);
@@ -508,9 +637,140 @@ void StreamResource::ClearError() {
 }
 
 
+struct StreamReadPool::FreeList {
+  ~FreeList() {
+    for (char* slab : slabs)
+      free(slab);
+  }
+
+  // Slabs are given back from the BackingStore deleter, which V8 may call on
+  // a background thread.
+  Mutex mutex;
+  std::vector<char*> slabs;
+};
+
+StreamReadPool::StreamReadPool(Environment* env)
+    : env_(env), free_list_(std::make_shared<FreeList>()) {}
+
+StreamReadPool::~StreamReadPool() {
+  slab_array_buffer_.Reset();
+}
+
+void StreamReadPool::FreeSlab(void* data, size_t length, void* deleter_data) {
+  std::shared_ptr<FreeList>* free_list =
+      static_cast<std::shared_ptr<FreeList>*>(deleter_data);
+  {
+    Mutex::ScopedLock lock((*free_list)->mutex);
+    if ((*free_list)->slabs.size() < kMaxFreeSlabs) {
+      (*free_list)->slabs.push_back(static_cast<char*>(data));
+      data = nullptr;
+    }
+  }
+  free(data);
+  delete free_list;
+}
+
+MaybeLocal<ArrayBuffer> StreamReadPool::CreateArrayBuffer(
+    std::shared_ptr<BackingStore> slab) {
+  Local<ArrayBuffer> ab = ArrayBuffer::New(env_->isolate(), std::move(slab));
+  if (ab->SetPrivate(env_->context(),
+                     env_->untransferable_object_private_symbol(),
+                     True(env_->isolate())).IsNothing()) {
+    return MaybeLocal<ArrayBuffer>();
+  }
+  return ab;
+}
+
+bool StreamReadPool::NewSlab() {
+  char* data = nullptr;
+  {
+    Mutex::ScopedLock lock(free_list_->mutex);
+    if (!free_list_->slabs.empty()) {
+      data = free_list_->slabs.back();
+      free_list_->slabs.pop_back();
+    }
+  }
+  if (data == nullptr)
+    data = UncheckedMalloc(kSlabSize);
+  if (data == nullptr)
+    return false;
+
+  std::shared_ptr<BackingStore> slab = ArrayBuffer::NewBackingStore(
+      data, kSlabSize, FreeSlab, new std::shared_ptr<FreeList>(free_list_));
+  HandleScope handle_scope(env_->isolate());
+  Local<ArrayBuffer> ab;
+  if (!CreateArrayBuffer(slab).ToLocal(&ab))
+    return false;
+
+  slab_ = std::move(slab);
+  slab_array_buffer_.Reset(env_->isolate(), ab);
+  slab_used_ = 0;
+  return true;
+}
+
+uv_buf_t StreamReadPool::Allocate(size_t size,
+                                  std::shared_ptr<BackingStore>* slab) {
+  CHECK_LE(size, kSlabSize);
+  if ((!slab_ || slab_used_ + size > kSlabSize) && !NewSlab())
+    return uv_buf_init(nullptr, 0);
+
+  char* base = static_cast<char*>(slab_->Data()) + slab_used_;
+  slab_used_ += size;
+  *slab = slab_;
+  return uv_buf_init(base, size);
+}
+
+MaybeLocal<ArrayBuffer> StreamReadPool::Commit(
+    const uv_buf_t& buf,
+    size_t nread,
+    std::shared_ptr<BackingStore>&& slab,
+    size_t* offset) {
+  CHECK_LE(nread, buf.len);
+  *offset = buf.base - static_cast<char*>(slab->Data());
+
+  if (slab != slab_) {
+    // The read was pending while another stream started a new slab.
+    return CreateArrayBuffer(std::move(slab));
+  }
+
+  // Keep the next read aligned, so that views of any type can be created on
+  // top of the data.
+  if (*offset + buf.len == slab_used_)
+    slab_used_ = std::min(*offset + RoundUp<size_t>(nread, 8), kSlabSize);
+  return PersistentToLocal::Default(env_->isolate(), slab_array_buffer_);
+}
+
+StreamReadPool* Environment::stream_read_pool() {
+  if (!stream_read_pool_)
+    stream_read_pool_ = std::make_unique<StreamReadPool>(this);
+  return stream_read_pool_.get();
+}
+
+
+void EmitToJSStreamListener::UpdateReadSizeHint(size_t nread,
+                                                size_t allocated) {
+  if (nread >= allocated) {
+    read_size_hint_ = std::min(2 * allocated, StreamReadPool::kSlabSize);
+    return;
+  }
+  size_t hint = kMinReadSize;
+  while (hint < nread)
+    hint *= 2;
+  read_size_hint_ = hint;
+}
+
 uv_buf_t EmitToJSStreamListener::OnStreamAlloc(size_t suggested_size) {
   CHECK_NOT_NULL(stream_);
   Environment* env = static_cast<StreamBase*>(stream_)->stream_env();
+  if (read_size_hint_ <= StreamReadPool::kMaxPooledReadSize &&
+      read_size_hint_ <= suggested_size) {
+    uv_buf_t buf =
+        env->stream_read_pool()->Allocate(read_size_hint_, &pooled_slab_);
+    if (buf.base != nullptr) {
+      pooled_read_ = buf.base;
+      return buf;
+    }
+  }
   return AllocatedBuffer::AllocateManaged(env, suggested_size).release();
 }
 
@@ -520,6 +780,26 @@ void EmitToJSStreamListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf_) {
   Environment* env = stream->stream_env();
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
+
+  if (buf_.base != nullptr && buf_.base == pooled_read_) {
+    pooled_read_ = nullptr;
+    size_t offset;
+    Local<ArrayBuffer> ab;
+    bool ok = env->stream_read_pool()->Commit(
+        buf_, nread > 0 ? nread : 0, std::move(pooled_slab_), &offset)
+            .ToLocal(&ab);
+    if (nread <= 0) {
+      if (nread < 0)
+        stream->CallJSOnreadMethod(nread, Local<ArrayBuffer>());
+      return;
+    }
+    if (!ok)
+      return;
+    UpdateReadSizeHint(nread, buf_.len);
+    stream->CallJSOnreadMethod(nread, ab, offset);
+    return;
+  }
+
   AllocatedBuffer buf(env, buf_);
 
   if (nread <= 0)  {
@@ -529,6 +809,7 @@ void EmitToJSStreamListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf_) {
   }
 
   CHECK_LE(static_cast<size_t>(nread), buf.size());
+  UpdateReadSizeHint(nread, buf.size());
   buf.Resize(nread);
 
   stream->CallJSOnreadMethod(nread, buf.ToArrayBuffer());
@@ -611,7 +892,10 @@ void ShutdownWrap::OnDone(int status) {
 }
 
 void WriteWrap::OnDone(int status) {
-  stream()->EmitAfterWrite(this, status);
+  if (coalesced_)
+    stream()->AfterCoalescedWrite(status);
+  else
+    stream()->EmitAfterWrite(this, status);
   Dispose();
 }
 
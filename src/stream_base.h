@@ -11,6 +11,9 @@
 
 #include "v8.h"
 
+#include <memory>
+#include <vector>
+
 namespace node {
 
 // Forward declarations
@@ -106,6 +109,10 @@ class WriteWrap : public StreamReq {
 
  private:
   AllocatedBuffer storage_;
+  // Set for writes of coalesced data, which no JS request is waiting for.
+  bool coalesced_ = false;
+
+  friend class StreamBase;
 };
 
 
@@ -191,12 +198,65 @@ class ReportWritesToJSStreamListener : public StreamListener {
 };
 
 
+// Hands out the memory for reads of EmitToJSStreamListener from 64 KiB slabs
+// that are shared by all streams of an Environment, so that small reads do
+// not need an allocation and a reallocation each. The data is passed to JS as
+// a view into the slab's ArrayBuffer, which is marked as untransferable like
+// the pool that is used by Buffer.allocUnsafe(). Once all views into a slab
+// have been garbage collected, its memory is put on a free list for reuse.
+class StreamReadPool {
+ public:
+  explicit StreamReadPool(Environment* env);
+  ~StreamReadPool();
+
+  static constexpr size_t kSlabSize = 64 * 1024;
+  // Reads that are expected to be larger than this get a buffer of their own.
+  static constexpr size_t kMaxPooledReadSize = 16 * 1024;
+  static constexpr size_t kMaxFreeSlabs = 16;
+
+  // Reserves `size` bytes in the current slab. `slab` keeps the memory alive
+  // until the read has completed. Returns a buffer with a nullptr base if no
+  // memory could be allocated.
+  uv_buf_t Allocate(size_t size, std::shared_ptr<v8::BackingStore>* slab);
+  // Gives back the part of a reservation that was not filled by the read and
+  // returns the ArrayBuffer that contains the data along with its offset.
+  v8::MaybeLocal<v8::ArrayBuffer> Commit(
+      const uv_buf_t& buf,
+      size_t nread,
+      std::shared_ptr<v8::BackingStore>&& slab,
+      size_t* offset);
+
+ private:
+  struct FreeList;
+  static void FreeSlab(void* data, size_t length, void* deleter_data);
+  v8::MaybeLocal<v8::ArrayBuffer> CreateArrayBuffer(
+      std::shared_ptr<v8::BackingStore> slab);
+  bool NewSlab();
+
+  Environment* env_;
+  std::shared_ptr<FreeList> free_list_;
+  std::shared_ptr<v8::BackingStore> slab_;
+  v8::Global<v8::ArrayBuffer> slab_array_buffer_;
+  size_t slab_used_ = 0;
+};
+
+
 // A default emitter that just pushes data chunks as Buffer instances to
 // JS land via the handle’s .ondata method.
 class EmitToJSStreamListener : public ReportWritesToJSStreamListener {
  public:
   uv_buf_t OnStreamAlloc(size_t suggested_size) override;
   void OnStreamRead(ssize_t nread, const uv_buf_t& buf) override;
+
+ private:
+  // Adapts the size of the next read to the sizes of the recent ones, so that
+  // mostly idle streams only take up a small part of a StreamReadPool slab.
+  void UpdateReadSizeHint(size_t nread, size_t allocated);
+
+  static constexpr size_t kMinReadSize = 1024;
+  size_t read_size_hint_ = 4 * kMinReadSize;
+  char* pooled_read_ = nullptr;
+  std::shared_ptr<v8::BackingStore> pooled_slab_;
 };
 
 
@@ -353,6 +413,12 @@ class StreamBase : public StreamResource {
   virtual ShutdownWrap* CreateShutdownWrap(v8::Local<v8::Object> object);
   virtual WriteWrap* CreateWriteWrap(v8::Local<v8::Object> object);
 
+  // Write out the data that has been queued up while write coalescing is
+  // enabled. Returns 0, or the error if the write failed synchronously.
+  int FlushCoalescedWrites();
+  // Drop the data that has been queued up and not been written out yet.
+  inline void DiscardCoalescedWrites() { coalesced_data_.clear(); }
+
   // One of these must be implemented
   virtual AsyncWrap* GetAsyncWrap() = 0;
   virtual v8::Local<v8::Object> GetObject();
@@ -371,6 +437,7 @@ class StreamBase : public StreamResource {
   template <enum encoding enc>
   int WriteString(const v8::FunctionCallbackInfo<v8::Value>& args);
   int UseUserBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
+  int SetWriteCoalescing(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   static void GetFD(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetExternal(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -396,6 +463,27 @@ class StreamBase : public StreamResource {
   EmitToJSStreamListener default_listener_;
 
   void SetWriteResult(const StreamWriteResult& res);
+
+  // Copies the data to the coalesced write buffer. Returns 0 if it was
+  // queued, in which case the write is complete as far as the caller is
+  // concerned, UV_EAGAIN if the data has to be written the regular way, or
+  // the error from writing out the data queued before it.
+  int CoalesceWrite(const uv_buf_t* bufs, size_t count, size_t total_bytes);
+  void AfterCoalescedWrite(int status);
+  // Calls the `onerror` callback of the stream for a write error that could
+  // not be returned from a write or shutdown call.
+  void ReportCoalescedWriteError(int status);
+
+  // While write coalescing is enabled, small writes are collected in
+  // `coalesced_data_` and written out together once per event loop
+  // iteration. Once such a write does not complete synchronously, writes go
+  // the regular way again until it is done, so that backpressure works.
+  static constexpr size_t kMaxCoalescedWriteSize = 16 * 1024;
+  static constexpr size_t kMaxCoalescedBytes = 64 * 1024;
+  bool coalesce_writes_ = false;
+  bool coalesced_flush_scheduled_ = false;
+  size_t coalesced_writes_in_flight_ = 0;
+  std::vector<char> coalesced_data_;
   static void AddMethod(Environment* env,
                         v8::Local<v8::Signature> sig,
                         enum v8::PropertyAttribute attributes,
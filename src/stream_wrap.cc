@@ -32,6 +32,7 @@
 #include "udp_wrap.h"
 #include "util-inl.h"
 
+#include <cmath>  // std::ceil()
 #include <cstring>  // memcpy()
 #include <climits>  // INT_MAX
 
@@ -41,11 +42,13 @@ namespace node {
 using v8::Context;
 using v8::DontDelete;
 using v8::EscapableHandleScope;
+using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
 using v8::Local;
 using v8::MaybeLocal;
+using v8::Number;
 using v8::Object;
 using v8::PropertyAttribute;
 using v8::ReadOnly;
@@ -106,6 +109,8 @@ void LibuvStreamWrap::Initialize(Local<Object> target,
 void LibuvStreamWrap::RegisterExternalReferences(
     ExternalReferenceRegistry* registry) {
   registry->Register(IsConstructCallCallback);
+  registry->Register(SetTimeout);
+  registry->Register(RefreshTimeout);
 }
 
 LibuvStreamWrap::LibuvStreamWrap(Environment* env,
@@ -143,6 +148,8 @@ Local<FunctionTemplate> LibuvStreamWrap::GetConstructorTemplate(
         Local<FunctionTemplate>(),
         static_cast<PropertyAttribute>(ReadOnly | DontDelete));
     env->SetProtoMethod(tmpl, "setBlocking", SetBlocking);
+    env->SetProtoMethod(tmpl, "setTimeout", SetTimeout);
+    env->SetProtoMethod(tmpl, "refreshTimeout", RefreshTimeout);
     StreamBase::AddMethods(env, tmpl);
     env->set_libuv_stream_wrap_ctor_template(tmpl);
   }
@@ -179,6 +186,17 @@ bool LibuvStreamWrap::IsClosing() {
 }
 
 
+void LibuvStreamWrap::Close(Local<Value> close_callback) {
+  if (timeout_.is_armed())
+    env()->timer_wheel()->Arm(&timeout_, 0);
+  // Like other pending writes, coalesced data that has not been written out
+  // yet is dropped, and the write of a remainder is cancelled. A graceful
+  // shutdown writes the data out first.
+  DiscardCoalescedWrites();
+  HandleWrap::Close(close_callback);
+}
+
+
 AsyncWrap* LibuvStreamWrap::GetAsyncWrap() {
   return static_cast<AsyncWrap*>(this);
 }
@@ -273,6 +291,7 @@ void LibuvStreamWrap::OnUvRead(ssize_t nread, const uv_buf_t* buf) {
     }
   }
 
+  RefreshTimeout();
   EmitRead(nread, *buf);
 }
 
@@ -304,6 +323,44 @@ void LibuvStreamWrap::SetBlocking(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(uv_stream_set_blocking(wrap->stream(), enable));
 }
 
+
+void LibuvStreamWrap::SetTimeout(const FunctionCallbackInfo<Value>& args) {
+  LibuvStreamWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+  CHECK(args[0]->IsNumber());
+  double msecs = args[0].As<Number>()->Value();
+  CHECK_GE(msecs, 0);
+  if (!wrap->IsAlive())
+    return;
+
+  // Round fractional timeouts up, only zero disables the timeout.
+  uint64_t timeout = static_cast<uint64_t>(std::ceil(msecs));
+  wrap->env()->timer_wheel()->Arm(&wrap->timeout_, timeout);
+}
+
+
+void LibuvStreamWrap::RefreshTimeout(const FunctionCallbackInfo<Value>& args) {
+  LibuvStreamWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  wrap->RefreshTimeout();
+}
+
+
+void LibuvStreamWrap::Timeout::OnTimeout() {
+  LibuvStreamWrap* wrap = wrap_;
+  Environment* env = wrap->env();
+  if (!wrap->IsAlive())
+    return;
+
+  Local<Value> ontimeout;
+  if (!wrap->object()->Get(env->context(), env->ontimeout_string())
+          .ToLocal(&ontimeout) || !ontimeout->IsFunction()) {
+    return;
+  }
+  wrap->MakeCallback(ontimeout.As<Function>(), 0, nullptr);
+}
+
 typedef SimpleShutdownWrap<ReqWrap<uv_shutdown_t>> LibuvShutdownWrap;
 typedef SimpleWriteWrap<ReqWrap<uv_write_t>> LibuvWriteWrap;
 
@@ -342,6 +399,7 @@ int LibuvStreamWrap::DoTryWrite(uv_buf_t** bufs, size_t* count) {
   uv_buf_t* vbufs = *bufs;
   size_t vcount = *count;
 
+  RefreshTimeout();
   err = uv_try_write(stream(), vbufs, vcount);
   if (err == UV_ENOSYS || err == UV_EAGAIN)
     return 0;
@@ -393,6 +451,7 @@ void LibuvStreamWrap::AfterUvWrite(uv_write_t* req, int status) {
   CHECK_NOT_NULL(req_wrap);
   HandleScope scope(req_wrap->env()->isolate());
   Context::Scope context_scope(req_wrap->env()->context());
+  static_cast<LibuvStreamWrap*>(req_wrap->stream())->RefreshTimeout();
   req_wrap->Done(status);
 }
 
@@ -26,6 +26,7 @@
 
 #include "stream_base.h"
 #include "handle_wrap.h"
+#include "timer_wheel.h"
 #include "v8.h"
 
 namespace node {
@@ -45,6 +46,9 @@ class LibuvStreamWrap : public HandleWrap, public StreamBase {
   bool IsClosing() override;
   bool IsIPCPipe() override;
 
+  void Close(
+      v8::Local<v8::Value> close_callback = v8::Local<v8::Value>()) override;
+
   // JavaScript functions
   int ReadStart() override;
   int ReadStop() override;
@@ -102,6 +106,26 @@ class LibuvStreamWrap : public HandleWrap, public StreamBase {
   static void GetWriteQueueSize(
       const v8::FunctionCallbackInfo<v8::Value>& info);
   static void SetBlocking(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetTimeout(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void RefreshTimeout(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  // Restarts the idle timeout, if one is set, after reading or writing.
+  inline void RefreshTimeout() {
+    if (timeout_.is_armed())
+      env()->timer_wheel()->Refresh(&timeout_);
+  }
+
+  // The idle timeout set through socket.setTimeout(). It is kept in the
+  // Environment's TimerWheel and refreshed here without calling into JS, the
+  // handle's `ontimeout` callback is only called once it actually expires.
+  class Timeout final : public TimerWheel::Entry {
+   public:
+    explicit Timeout(LibuvStreamWrap* wrap) : wrap_(wrap) {}
+    void OnTimeout() override;
+
+   private:
+    LibuvStreamWrap* wrap_;
+  };
 
   // Callbacks for libuv
   void OnUvAlloc(size_t suggested_size, uv_buf_t* buf);
@@ -111,6 +135,7 @@ class LibuvStreamWrap : public HandleWrap, public StreamBase {
   static void AfterUvShutdown(uv_shutdown_t* req, int status);
 
   uv_stream_t* const stream_;
+  Timeout timeout_{this};
 
 #ifdef _WIN32
   // We don't always have an FD that we could look up on the stream_
@@ -585,6 +585,110 @@ size_t SearchString(Vector<const Char> subject,
   StringSearch<Char> search(pattern);
   return search.Search(subject, start_index);
 }
+
+//---------------------------------------------------------------------
+// First/Last Byte Filter Search Strategy
+//---------------------------------------------------------------------
+
+// Longest pattern for which FirstLastByteSearch() is used. Past this length,
+// the skips done by Boyer-Moore-Horspool outweigh the cheaper candidate
+// filtering.
+static const size_t kFirstLastByteMaxPatternLength = 32;
+
+// Finds the first occurrence of `pattern` in `subject` at an index >= `index`,
+// or returns `subject_length` if there is none.
+//
+// memchr() is used to skip to the next occurrence of the first byte of the
+// pattern. From there, the first and the last byte of the pattern are compared
+// against eight candidate positions at a time using word-sized loads, and
+// memcmp() only runs on positions where both of them match. This avoids most
+// of the false candidates that slow the linear search down when the first
+// byte of the pattern is frequent in the subject (e.g. '-' or '\r' in
+// multipart bodies), without giving up memchr() speed when it is rare.
+// Only forward searches are supported.
+inline size_t FirstLastByteSearch(const uint8_t* subject,
+                                  size_t subject_length,
+                                  const uint8_t* pattern,
+                                  size_t pattern_length,
+                                  size_t index) {
+  static const uint64_t kLowBits = 0x0101010101010101ull;
+  static const uint64_t kHighBits = 0x8080808080808080ull;
+
+  CHECK_GE(pattern_length, 2);
+  CHECK_LE(pattern_length, subject_length);
+  const size_t last = pattern_length - 1;
+  const uint8_t first_char = pattern[0];
+  const uint8_t last_char = pattern[last];
+  const uint64_t first_word = kLowBits * first_char;
+  const uint64_t last_word = kLowBits * last_char;
+  // Number of positions at which the pattern can start.
+  const size_t max_n = subject_length - last;
+
+  size_t i = index;
+  while (i + sizeof(uint64_t) <= max_n) {
+    uint64_t first_bytes;
+    uint64_t last_bytes;
+    memcpy(&first_bytes, subject + i, sizeof(first_bytes));
+    memcpy(&last_bytes, subject + i + last, sizeof(last_bytes));
+    first_bytes ^= first_word;
+    if (((first_bytes - kLowBits) & ~first_bytes & kHighBits) == 0) {
+      // The first byte does not occur in this block at all. memchr() skips
+      // over runs without candidates much faster than eight bytes at a time.
+      const void* pos = memchr(subject + i + sizeof(uint64_t),
+                               first_char,
+                               max_n - i - sizeof(uint64_t));
+      if (pos == nullptr)
+        return subject_length;
+      i = static_cast<const uint8_t*>(pos) - subject;
+      continue;
+    }
+    // A zero byte in `x` marks a position where both the first and the last
+    // byte match.
+    const uint64_t x = first_bytes | (last_bytes ^ last_word);
+    if (((x - kLowBits) & ~x & kHighBits) != 0) {
+      for (size_t j = i; j < i + sizeof(uint64_t); j++) {
+        if (subject[j] == first_char && subject[j + last] == last_char &&
+            memcmp(subject + j + 1, pattern + 1, last - 1) == 0) {
+          return j;
+        }
+      }
+    }
+    i += sizeof(uint64_t);
+  }
+  for (; i < max_n; i++) {
+    if (subject[i] == first_char && subject[i + last] == last_char &&
+        memcmp(subject + i + 1, pattern + 1, last - 1) == 0) {
+      return i;
+    }
+  }
+  return subject_length;
+}
+
+// Dispatches forward searches for short one-byte patterns to
+// FirstLastByteSearch(). Returns false if `StringSearch` should be used
+// instead.
+template <typename Char>
+inline bool FastForwardSearch(const Char* haystack,
+                              size_t haystack_length,
+                              const Char* needle,
+                              size_t needle_length,
+                              size_t start_index,
+                              size_t* result) {
+  return false;
+}
+
+inline bool FastForwardSearch(const uint8_t* haystack,
+                              size_t haystack_length,
+                              const uint8_t* needle,
+                              size_t needle_length,
+                              size_t start_index,
+                              size_t* result) {
+  if (needle_length < 2 || needle_length > kFirstLastByteMaxPatternLength)
+    return false;
+  *result = FirstLastByteSearch(
+      haystack, haystack_length, needle, needle_length, start_index);
+  return true;
+}
 }  // namespace stringsearch
 }  // namespace node
 
@@ -598,6 +702,13 @@ size_t SearchString(const Char* haystack,
                     size_t start_index,
                     bool is_forward) {
   if (haystack_length < needle_length) return haystack_length;
+  size_t fast_result;
+  if (is_forward &&
+      stringsearch::FastForwardSearch(haystack, haystack_length,
+                                      needle, needle_length,
+                                      start_index, &fast_result)) {
+    return fast_result;
+  }
   // To do a reverse search (lastIndexOf instead of indexOf) without redundant
   // code, create two vectors that are reversed views into the input strings.
   // For example, v_needle[0] would return the *last* character of the needle.
@@ -26,6 +26,7 @@
 #include "handle_wrap.h"
 #include "node_buffer.h"
 #include "node_internals.h"
+#include "node_sockaddr-inl.h"
 #include "connect_wrap.h"
 #include "stream_base-inl.h"
 #include "stream_wrap.h"
@@ -33,17 +34,25 @@
 
 #include <cstdlib>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 
 namespace node {
 
 using v8::Boolean;
 using v8::Context;
 using v8::EscapableHandleScope;
+using v8::Array;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::Int32;
 using v8::Integer;
+using v8::HandleScope;
 using v8::Local;
 using v8::MaybeLocal;
 using v8::Object;
@@ -87,6 +96,8 @@ void TCPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "open", Open);
   env->SetProtoMethod(t, "bind", Bind);
   env->SetProtoMethod(t, "listen", Listen);
+  env->SetProtoMethod(t, "setBlockList", SetBlockList);
+  env->SetProtoMethod(t, "setAcceptBatch", SetAcceptBatch);
   env->SetProtoMethod(t, "connect", Connect);
   env->SetProtoMethod(t, "bind6", Bind6);
   env->SetProtoMethod(t, "connect6", Connect6);
@@ -115,6 +126,7 @@ void TCPWrap::Initialize(Local<Object> target,
   NODE_DEFINE_CONSTANT(constants, SOCKET);
   NODE_DEFINE_CONSTANT(constants, SERVER);
   NODE_DEFINE_CONSTANT(constants, UV_TCP_IPV6ONLY);
+  NODE_DEFINE_CONSTANT(constants, TCP_REUSEPORT);
   target->Set(context,
               env->constants_string(),
               constants).Check();
@@ -225,14 +237,22 @@ void TCPWrap::Bind(
   int port;
   unsigned int flags = 0;
   if (!args[1]->Int32Value(env->context()).To(&port)) return;
-  if (family == AF_INET6 &&
+  if (!args[2]->IsUndefined() &&
       !args[2]->Uint32Value(env->context()).To(&flags)) {
     return;
   }
+  bool reuse_port = (flags & TCP_REUSEPORT) != 0;
+  flags &= ~TCP_REUSEPORT;
+  // Only meaningful for IPv6, libuv rejects it for IPv4 addresses.
+  if (family == AF_INET)
+    flags &= ~UV_TCP_IPV6ONLY;
 
   T addr;
   int err = uv_ip_addr(*ip_address, port, &addr);
 
+  if (err == 0 && reuse_port)
+    err = wrap->EnableReusePort(family);
+
   if (err == 0) {
     err = uv_tcp_bind(&wrap->handle_,
                       reinterpret_cast<const sockaddr*>(&addr),
@@ -266,6 +286,194 @@ void TCPWrap::Listen(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+int TCPWrap::EnableReusePort(int family) {
+#if defined(SO_REUSEPORT) && !defined(_WIN32)
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&handle_), &fd);
+  if (err == UV_EBADF) {
+    // libuv only creates the socket in uv_tcp_bind(), which is too late.
+#ifdef SOCK_CLOEXEC
+    fd = socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+#else
+    fd = socket(family, SOCK_STREAM, 0);
+    if (fd != -1) fcntl(fd, F_SETFD, FD_CLOEXEC);
+#endif
+    if (fd == -1)
+      return uv_translate_sys_error(errno);
+    err = uv_tcp_open(&handle_, fd);
+    if (err != 0) {
+      close(fd);
+      return err;
+    }
+  } else if (err != 0) {
+    return err;
+  }
+
+  int on = 1;
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) != 0)
+    return uv_translate_sys_error(errno);
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
+void TCPWrap::SetBlockList(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  if (args[0]->IsUndefined()) {
+    wrap->blocklist_.reset();
+    return;
+  }
+  CHECK(SocketAddressBlockListWrap::HasInstance(env, args[0]));
+  SocketAddressBlockListWrap* blocklist;
+  ASSIGN_OR_RETURN_UNWRAP(&blocklist, args[0]);
+  wrap->blocklist_ = blocklist->blocklist();
+}
+
+
+void TCPWrap::SetAcceptBatch(const FunctionCallbackInfo<Value>& args) {
+  TCPWrap* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  wrap->accept_batch_ = args[0]->IsTrue();
+}
+
+
+MaybeLocal<Object> TCPWrap::AcceptAllowedConnection() {
+  Environment* env = this->env();
+  EscapableHandleScope handle_scope(env->isolate());
+  Local<Object> client_obj;
+#ifndef _WIN32
+  // The connection is accepted into a temporary handle first, so that the
+  // peer can be checked without creating a client object for it.
+  uv_tcp_t* pending = new uv_tcp_t;
+  CHECK_EQ(uv_tcp_init(env->event_loop(), pending), 0);
+  uv_handle_t* pending_handle = reinterpret_cast<uv_handle_t*>(pending);
+  auto delete_handle = [](uv_handle_t* handle) {
+    delete reinterpret_cast<uv_tcp_t*>(handle);
+  };
+  if (uv_accept(reinterpret_cast<uv_stream_t*>(&handle_),
+                reinterpret_cast<uv_stream_t*>(pending)) != 0) {
+    uv_close(pending_handle, delete_handle);
+    return MaybeLocal<Object>();
+  }
+
+  auto peer = std::make_shared<SocketAddress>(
+      SocketAddress::FromPeerName(*pending));
+  if (blocklist_->Apply(peer)) {
+    // Reset the connection rather than closing it gracefully, so that denied
+    // peers do not leave sockets behind in TIME_WAIT.
+    uv_tcp_close_reset(pending, delete_handle);
+    return MaybeLocal<Object>();
+  }
+
+  // Move the socket over to a client handle.
+  uv_os_fd_t fd;
+  CHECK_EQ(uv_fileno(pending_handle, &fd), 0);
+  int client_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+  uv_close(pending_handle, delete_handle);
+  if (client_fd == -1)
+    return MaybeLocal<Object>();
+  if (!Instantiate(env, this, SOCKET).ToLocal(&client_obj)) {
+    close(client_fd);
+    return MaybeLocal<Object>();
+  }
+  TCPWrap* client = Unwrap<TCPWrap>(client_obj);
+  if (client == nullptr || uv_tcp_open(&client->handle_, client_fd) != 0) {
+    close(client_fd);
+    return MaybeLocal<Object>();
+  }
+#else
+  // On Windows the socket cannot be moved to another handle, so the peer is
+  // checked on the client handle instead.
+  if (!AcceptConnection().ToLocal(&client_obj))
+    return MaybeLocal<Object>();
+  TCPWrap* client = Unwrap<TCPWrap>(client_obj);
+  CHECK_NOT_NULL(client);
+  auto peer = std::make_shared<SocketAddress>(
+      SocketAddress::FromPeerName(client->handle_));
+  if (blocklist_->Apply(peer)) {
+    client->Close();
+    return MaybeLocal<Object>();
+  }
+#endif
+  return handle_scope.Escape(client_obj);
+}
+
+
+void TCPWrap::OnConnection(uv_stream_t* handle, int status) {
+  TCPWrap* wrap = static_cast<TCPWrap*>(handle->data);
+  CHECK_NOT_NULL(wrap);
+
+  if (status != 0 || (!wrap->accept_batch_ && !wrap->blocklist_)) {
+    ConnectionWrap::OnConnection(handle, status);
+    return;
+  }
+
+  Environment* env = wrap->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  CHECK_EQ(wrap->persistent().IsEmpty(), false);
+
+  Local<Object> client_obj;
+  if (wrap->blocklist_) {
+    if (!wrap->AcceptAllowedConnection().ToLocal(&client_obj))
+      return;
+  } else if (!wrap->AcceptConnection().ToLocal(&client_obj)) {
+    return;
+  }
+  TCPWrap* client = Unwrap<TCPWrap>(client_obj);
+  CHECK_NOT_NULL(client);
+
+  if (!wrap->accept_batch_) {
+    Local<Value> argv[] = { Integer::New(env->isolate(), 0), client_obj };
+    wrap->MakeCallback(env->onconnection_string(), arraysize(argv), argv);
+    return;
+  }
+
+  // libuv keeps on accepting until the listen queue is drained, so all of
+  // the connections that arrive in this iteration of the event loop are
+  // collected and passed to JS with a single callback.
+  if (wrap->pending_connections_.empty()) {
+    BaseObjectPtr<TCPWrap> strong_ref{wrap};
+    env->SetImmediate([strong_ref](Environment* env) {
+      strong_ref->EmitPendingConnections();
+    });
+  }
+  wrap->pending_connections_.emplace_back(client);
+}
+
+
+void TCPWrap::EmitPendingConnections() {
+  std::vector<BaseObjectPtr<TCPWrap>> clients;
+  clients.swap(pending_connections_);
+
+  // The server may have been closed after the connections were accepted.
+  if (IsHandleClosing()) {
+    for (const BaseObjectPtr<TCPWrap>& client : clients)
+      client->Close();
+    return;
+  }
+
+  Environment* env = this->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  std::vector<Local<Value>> handles;
+  handles.reserve(clients.size());
+  for (const BaseObjectPtr<TCPWrap>& client : clients)
+    handles.push_back(client->object());
+
+  Local<Value> argv[] = {
+    Integer::New(env->isolate(), 0),
+    Array::New(env->isolate(), handles.data(), handles.size())
+  };
+  MakeCallback(env->onconnection_string(), arraysize(argv), argv);
+}
+
+
 void TCPWrap::Connect(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[2]->IsUint32());
   // explicit cast to fit to libuv's type expectation
@@ -27,9 +27,13 @@
 #include "async_wrap.h"
 #include "connection_wrap.h"
 
+#include <memory>
+#include <vector>
+
 namespace node {
 
 class Environment;
+class SocketAddressBlockList;
 
 class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
  public:
@@ -38,6 +42,12 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
     SERVER
   };
 
+  // Bind flags that are handled by Node.js rather than by libuv. The value
+  // is chosen so that it does not overlap with any of the uv_tcp_flags.
+  enum BindFlags {
+    TCP_REUSEPORT = 1 << 8
+  };
+
   static v8::MaybeLocal<v8::Object> Instantiate(Environment* env,
                                                 AsyncWrap* parent,
                                                 SocketType type);
@@ -75,6 +85,8 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
   static void Bind(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Bind6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Listen(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetBlockList(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetAcceptBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Connect(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Connect6(const v8::FunctionCallbackInfo<v8::Value>& args);
   template <typename T>
@@ -91,6 +103,22 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
   static void SetSimultaneousAccepts(
       const v8::FunctionCallbackInfo<v8::Value>& args);
 #endif
+
+  static void OnConnection(uv_stream_t* handle, int status);
+  // Creates the socket ahead of uv_tcp_bind() so that SO_REUSEPORT can be
+  // set on it before it is bound.
+  int EnableReusePort(int family);
+  // Accepts a connection and returns its client object, unless its peer is
+  // denied by the block list, in which case the connection is reset and an
+  // empty handle is returned.
+  v8::MaybeLocal<v8::Object> AcceptAllowedConnection();
+  void EmitPendingConnections();
+
+  std::shared_ptr<SocketAddressBlockList> blocklist_;
+  bool accept_batch_ = false;
+  // Connections that have been accepted during the current event loop
+  // iteration and that are handed to JS all at once.
+  std::vector<BaseObjectPtr<TCPWrap>> pending_connections_;
 };
 
 
@@ -0,0 +1,195 @@
+#include "timer_wheel.h"
+#include "env-inl.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <algorithm>
+
+namespace node {
+
+using v8::Context;
+using v8::HandleScope;
+
+TimerWheel::Entry::~Entry() {
+  if (wheel_ != nullptr)
+    wheel_->Remove(this);
+}
+
+TimerWheel::TimerWheel(Environment* env)
+    : env_(env),
+      timer_(env, [this]() { OnTimer(); }) {
+  // Like JS timers created by socket.setTimeout(), the wheel does not keep
+  // the event loop alive on its own.
+  timer_.Unref();
+}
+
+TimerWheel::~TimerWheel() {
+  // The entries are owned by their streams, which may outlive the wheel
+  // during Environment teardown.
+  for (int level = 0; level < kLevels; level++) {
+    for (int slot = 0; slot < kSlots; slot++) {
+      while (Entry* entry = slots_[level][slot].PopFront())
+        entry->wheel_ = nullptr;
+    }
+  }
+}
+
+uint64_t TimerWheel::Now() const {
+  return uv_now(env_->event_loop());
+}
+
+void TimerWheel::Arm(Entry* entry, uint64_t timeout) {
+  // Always take the entry out of its slot, the new deadline may be earlier
+  // than the time at which that slot is going to be processed.
+  Remove(entry);
+  entry->timeout_ = timeout;
+  if (timeout == 0)
+    return;
+  entry->deadline_ = Now() + timeout;
+  Insert(entry);
+}
+
+void TimerWheel::Refresh(Entry* entry) {
+  if (!entry->is_armed())
+    return;
+  entry->deadline_ = Now() + entry->timeout_;
+  // An entry that has already timed out is not in the wheel anymore.
+  if (entry->wheel_ == nullptr)
+    Insert(entry);
+}
+
+void TimerWheel::Insert(Entry* entry) {
+  // An empty wheel can skip ahead, there is nothing left to process. Bits
+  // that are still set in `occupied_` belong to entries that were removed.
+  if (count_ == 0 && !running_) {
+    now_ = std::max(now_, Now());
+    std::fill(std::begin(occupied_), std::end(occupied_), 0);
+  }
+
+  uint64_t deadline = std::max(entry->deadline_, now_ + 1);
+  int level = 0;
+  int shift = 0;
+  uint64_t granule = deadline;
+  for (; level < kLevels; level++, shift += kSlotBits) {
+    granule = deadline >> shift;
+    if (granule - (now_ >> shift) < kSlots)
+      break;
+  }
+  if (level == kLevels) {
+    // Too far out for the wheel, park the entry in the last slot of the top
+    // level. It is re-inserted from there until its deadline is in reach.
+    level = kLevels - 1;
+    shift -= kSlotBits;
+    granule = (now_ >> shift) + kSlots - 1;
+  }
+
+  int index = granule & (kSlots - 1);
+  entry->node_.Remove();
+  slots_[level][index].PushBack(entry);
+  occupied_[level] |= uint64_t{1} << index;
+  entry->wheel_ = this;
+  count_++;
+
+  uint64_t time = granule << shift;
+  if (!running_ && (timer_time_ == 0 || time < timer_time_))
+    ScheduleTimer(time);
+}
+
+void TimerWheel::Remove(Entry* entry) {
+  // The slot's bit in `occupied_` is cleared lazily when the slot is
+  // processed.
+  if (entry->wheel_ == this)
+    count_--;
+  entry->wheel_ = nullptr;
+  entry->node_.Remove();
+}
+
+uint64_t TimerWheel::NextSlotTime() const {
+  uint64_t next = UINT64_MAX;
+  for (int level = 0, shift = 0; level < kLevels;
+       level++, shift += kSlotBits) {
+    if (occupied_[level] == 0)
+      continue;
+    // Rotate the bitmap so that bit 0 is the slot after the current one.
+    uint64_t current = now_ >> shift;
+    int start = (current + 1) & (kSlots - 1);
+    uint64_t bits = occupied_[level] >> start;
+    if (start != 0)
+      bits |= occupied_[level] << (kSlots - start);
+    uint64_t distance = 1;
+    while ((bits & 1) == 0) {
+      bits >>= 1;
+      distance++;
+    }
+    next = std::min(next, (current + distance) << shift);
+  }
+  return next;
+}
+
+void TimerWheel::ScheduleTimer(uint64_t time) {
+  if (count_ == 0) {
+    timer_.Stop();
+    timer_time_ = 0;
+    return;
+  }
+  uint64_t now = Now();
+  timer_.Update(time > now ? time - now : 0);
+  timer_time_ = time;
+}
+
+void TimerWheel::OnTimer() {
+  timer_time_ = 0;
+  uint64_t now = Now();
+  Slot expired;
+
+  running_ = true;
+  while (count_ > 0) {
+    uint64_t time = NextSlotTime();
+    if (time > now)
+      break;
+    now_ = time;
+    // Process the slots of all levels that start at `time`, from the top
+    // down, so that entries cascading from a higher level end up in a slot
+    // that has not been processed yet.
+    for (int level = kLevels - 1; level >= 0; level--) {
+      int shift = level * kSlotBits;
+      if ((time & ((uint64_t{1} << shift) - 1)) != 0)
+        continue;
+      int index = (time >> shift) & (kSlots - 1);
+      uint64_t bit = uint64_t{1} << index;
+      if ((occupied_[level] & bit) == 0)
+        continue;
+      occupied_[level] &= ~bit;
+      Slot& slot = slots_[level][index];
+      while (Entry* entry = slot.PopFront()) {
+        entry->wheel_ = nullptr;
+        count_--;
+        if (entry->deadline_ <= now)
+          expired.PushBack(entry);
+        else
+          Insert(entry);
+      }
+    }
+  }
+  now_ = std::max(now_, now);
+  running_ = false;
+  ScheduleTimer(NextSlotTime());
+
+  if (expired.IsEmpty() || !env_->can_call_into_js())
+    return;
+
+  HandleScope handle_scope(env_->isolate());
+  Context::Scope context_scope(env_->context());
+  // An entry that is disarmed or destroyed by an earlier callback is removed
+  // from `expired` and does not time out.
+  while (Entry* entry = expired.PopFront())
+    entry->OnTimeout();
+}
+
+TimerWheel* Environment::timer_wheel() {
+  if (!timer_wheel_)
+    timer_wheel_ = std::make_unique<TimerWheel>(this);
+  return timer_wheel_.get();
+}
+
+}  // namespace node
@@ -0,0 +1,101 @@
+#ifndef SRC_TIMER_WHEEL_H_
+#define SRC_TIMER_WHEEL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "timer_wrap.h"
+#include "util.h"
+
+#include <cstdint>
+
+namespace node {
+
+class Environment;
+
+// A hierarchical timing wheel for timeouts that are armed once and then pushed
+// back over and over again, like the idle timeout of a socket that is
+// refreshed every time data is read or written.
+//
+// Level `l` of the wheel has 64 slots that each cover 64^l milliseconds, so
+// that six levels cover a bit more than two years. An entry is put in the
+// lowest level in which its deadline is less than 64 slots away. A bitmap of
+// occupied slots for each level is used to find the next slot that needs
+// processing, and a single unref'd libuv timer is started for that slot.
+//
+// Refreshing an entry only moves its deadline, it stays in its slot. When the
+// slot is processed, entries whose deadline is still in the future are put
+// into the wheel again, and only the others actually time out. This makes a
+// refresh O(1) without touching any lists, at the cost of occasionally
+// re-inserting an entry that has been refreshed since it was scheduled.
+class TimerWheel final {
+ public:
+  class Entry {
+   public:
+    Entry() = default;
+    virtual ~Entry();
+    Entry(const Entry&) = delete;
+    Entry& operator=(const Entry&) = delete;
+
+    // Called once the timeout has expired. The entry stays armed, so that the
+    // next Refresh() schedules it again.
+    virtual void OnTimeout() = 0;
+
+    inline bool is_armed() const { return timeout_ != 0; }
+
+   private:
+    friend class TimerWheel;
+
+    // Links the entry into a slot, or into the list of expired entries while
+    // their OnTimeout() callbacks are being called.
+    ListNode<Entry> node_;
+    // The wheel this entry has been scheduled on, if it is in one of its
+    // slots.
+    TimerWheel* wheel_ = nullptr;
+    uint64_t deadline_ = 0;
+    uint64_t timeout_ = 0;
+  };
+
+  explicit TimerWheel(Environment* env);
+  ~TimerWheel();
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Makes `entry` time out `timeout` milliseconds from now, or disarms it if
+  // `timeout` is zero.
+  void Arm(Entry* entry, uint64_t timeout);
+  // Restarts the timeout of an armed entry. Does nothing for entries that are
+  // not armed.
+  void Refresh(Entry* entry);
+
+  static const int kSlotBits = 6;
+  static const int kSlots = 1 << kSlotBits;
+  static const int kLevels = 6;
+
+ private:
+  using Slot = ListHead<Entry, &Entry::node_>;
+
+  uint64_t Now() const;
+  void Insert(Entry* entry);
+  void Remove(Entry* entry);
+  // Returns the time at which the next occupied slot has to be processed.
+  uint64_t NextSlotTime() const;
+  void ScheduleTimer(uint64_t time);
+  void OnTimer();
+
+  Environment* env_;
+  TimerWrapHandle timer_;
+  // The time up to which the slots have been processed.
+  uint64_t now_ = 0;
+  // The time at which `timer_` fires, or zero if it is not running.
+  uint64_t timer_time_ = 0;
+  size_t count_ = 0;
+  bool running_ = false;
+  uint64_t occupied_[kLevels] = {};
+  Slot slots_[kLevels][kSlots];
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_TIMER_WHEEL_H_
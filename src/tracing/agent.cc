@@ -50,7 +50,7 @@ using v8::platform::tracing::TraceWriter;
 using std::string;
 
 Agent::Agent() : tracing_controller_(new TracingController()) {
-  tracing_controller_->Initialize(nullptr);
+  tracing_controller_->SetTraceBuffer(nullptr);
 
   CHECK_EQ(uv_loop_init(&tracing_loop_), 0);
   CHECK_EQ(uv_async_init(&tracing_loop_,
@@ -89,7 +89,7 @@ void Agent::Start() {
 
   NodeTraceBuffer* trace_buffer_ = new NodeTraceBuffer(
       NodeTraceBuffer::kBufferChunks, this, &tracing_loop_);
-  tracing_controller_->Initialize(trace_buffer_);
+  tracing_controller_->SetTraceBuffer(trace_buffer_);
 
   // This thread should be created *after* async handles are created
   // (within NodeTraceWriter and NodeTraceBuffer constructors).
@@ -144,7 +144,7 @@ void Agent::StopTracing() {
   // Perform final Flush on TraceBuffer. We don't want the tracing controller
   // to flush the buffer again on destruction of the V8::Platform.
   tracing_controller_->StopTracing();
-  tracing_controller_->Initialize(nullptr);
+  tracing_controller_->SetTraceBuffer(nullptr);
   started_ = false;
 
   // Thread should finish when the tracing loop is stopped.
@@ -223,6 +223,74 @@ void Agent::Flush(bool blocking) {
     id_writer.second->Flush(blocking);
 }
 
+void TracingController::SetTraceBuffer(NodeTraceBuffer* trace_buffer) {
+  trace_buffer_ = trace_buffer;
+  // Threads that have already loaded the previous buffer may still be using
+  // it. This only waits for a single event to be added or updated.
+  while (active_writers_ != 0)
+    uv_sleep(0);
+  Initialize(trace_buffer);
+}
+
+NodeTraceBuffer* TracingController::PinTraceBuffer() {
+  // Both this and SetTraceBuffer() use sequentially consistent accesses, so
+  // either SetTraceBuffer() sees this thread as active, or this thread sees
+  // the new buffer.
+  ++active_writers_;
+  return trace_buffer_;
+}
+
+void TracingController::UnpinTraceBuffer() {
+  --active_writers_;
+}
+
+uint64_t TracingController::AddTraceEventWithTimestamp(
+    char phase,
+    const uint8_t* category_enabled_flag,
+    const char* name,
+    const char* scope,
+    uint64_t id,
+    uint64_t bind_id,
+    int32_t num_args,
+    const char** arg_names,
+    const uint8_t* arg_types,
+    const uint64_t* arg_values,
+    std::unique_ptr<v8::ConvertableToTraceFormat>* arg_convertables,
+    unsigned int flags,
+    int64_t timestamp) {
+  // The category flags are cleared when tracing stops, so there is no need to
+  // check whether the base class is still recording.
+  if (!(*category_enabled_flag & ENABLED_FOR_RECORDING))
+    return 0;
+  int64_t cpu_now_us = CurrentCpuTimestampMicroseconds();
+  uint64_t handle = 0;
+  NodeTraceBuffer* trace_buffer = PinTraceBuffer();
+  if (trace_buffer != nullptr) {
+    TraceObject* trace_object = trace_buffer->AddTraceEvent(&handle);
+    if (trace_object != nullptr) {
+      trace_object->Initialize(phase, category_enabled_flag, name, scope, id,
+                               bind_id, num_args, arg_names, arg_types,
+                               arg_values, arg_convertables, flags, timestamp,
+                               cpu_now_us);
+      trace_buffer->CommitTraceEvents();
+    }
+  }
+  UnpinTraceBuffer();
+  return handle;
+}
+
+void TracingController::UpdateTraceEventDuration(
+    const uint8_t* category_enabled_flag,
+    const char* name,
+    uint64_t handle) {
+  int64_t now_us = CurrentTimestampMicroseconds();
+  int64_t cpu_now_us = CurrentCpuTimestampMicroseconds();
+  NodeTraceBuffer* trace_buffer = PinTraceBuffer();
+  if (trace_buffer != nullptr)
+    trace_buffer->UpdateEventDuration(handle, now_us, cpu_now_us);
+  UnpinTraceBuffer();
+}
+
 void TracingController::AddMetadataEvent(
     const unsigned char* category_group_enabled,
     const char* name,
@@ -6,6 +6,7 @@
 #include "util.h"
 #include "node_mutex.h"
 
+#include <atomic>
 #include <list>
 #include <set>
 #include <string>
@@ -23,6 +24,7 @@ using v8::platform::tracing::TraceConfig;
 using v8::platform::tracing::TraceObject;
 
 class Agent;
+class NodeTraceBuffer;
 
 class AsyncTraceWriter {
  public:
@@ -39,6 +41,31 @@ class TracingController : public v8::platform::tracing::TracingController {
   int64_t CurrentTimestampMicroseconds() override {
     return uv_hrtime() / 1000;
   }
+
+  // Passes ownership of `trace_buffer` to the base class. The previous buffer
+  // is deleted once no thread is adding or updating events in it anymore.
+  void SetTraceBuffer(NodeTraceBuffer* trace_buffer);
+
+  // Unlike the base class, these do not take a lock for every event. The
+  // event is initialized in the chunk that the current thread owns in the
+  // NodeTraceBuffer, and then committed to it.
+  uint64_t AddTraceEventWithTimestamp(
+      char phase,
+      const uint8_t* category_enabled_flag,
+      const char* name,
+      const char* scope,
+      uint64_t id,
+      uint64_t bind_id,
+      int32_t num_args,
+      const char** arg_names,
+      const uint8_t* arg_types,
+      const uint64_t* arg_values,
+      std::unique_ptr<v8::ConvertableToTraceFormat>* arg_convertables,
+      unsigned int flags,
+      int64_t timestamp) override;
+  void UpdateTraceEventDuration(const uint8_t* category_enabled_flag,
+                                const char* name,
+                                uint64_t handle) override;
   void AddMetadataEvent(
       const unsigned char* category_group_enabled,
       const char* name,
@@ -48,6 +75,17 @@ class TracingController : public v8::platform::tracing::TracingController {
       const uint64_t* arg_values,
       std::unique_ptr<v8::ConvertableToTraceFormat>* convertable_values,
       unsigned int flags);
+
+ private:
+  // Returns the current buffer, which is not deleted before the matching
+  // UnpinTraceBuffer() call.
+  NodeTraceBuffer* PinTraceBuffer();
+  void UnpinTraceBuffer();
+
+  // Owned by the base class.
+  std::atomic<NodeTraceBuffer*> trace_buffer_ { nullptr };
+  // The number of threads between PinTraceBuffer() and UnpinTraceBuffer().
+  std::atomic<uint32_t> active_writers_ { 0 };
 };
 
 class AgentWriterHandle {
@@ -1,106 +1,59 @@
 #include "tracing/node_trace_buffer.h"
 
 #include <memory>
+#include <unordered_map>
 #include "util-inl.h"
 
 namespace node {
 namespace tracing {
 
-InternalTraceBuffer::InternalTraceBuffer(size_t max_chunks, uint32_t id,
-                                         Agent* agent)
-    : flushing_(false), max_chunks_(max_chunks),
-      agent_(agent), id_(id) {
-  chunks_.resize(max_chunks);
-}
-
-TraceObject* InternalTraceBuffer::AddTraceEvent(uint64_t* handle) {
-  Mutex::ScopedLock scoped_lock(mutex_);
-  // Create new chunk if last chunk is full or there is no chunk.
-  if (total_chunks_ == 0 || chunks_[total_chunks_ - 1]->IsFull()) {
-    auto& chunk = chunks_[total_chunks_++];
-    if (chunk) {
-      chunk->Reset(current_chunk_seq_++);
-    } else {
-      chunk = std::make_unique<TraceBufferChunk>(current_chunk_seq_++);
-    }
-  }
-  auto& chunk = chunks_[total_chunks_ - 1];
-  size_t event_index;
-  TraceObject* trace_object = chunk->AddTraceEvent(&event_index);
-  *handle = MakeHandle(total_chunks_ - 1, chunk->seq(), event_index);
-  return trace_object;
-}
+namespace {
 
-TraceObject* InternalTraceBuffer::GetEventByHandle(uint64_t handle) {
-  Mutex::ScopedLock scoped_lock(mutex_);
-  if (handle == 0) {
-    // A handle value of zero never has a trace event associated with it.
-    return nullptr;
-  }
-  size_t chunk_index, event_index;
-  uint32_t buffer_id, chunk_seq;
-  ExtractHandle(handle, &buffer_id, &chunk_index, &chunk_seq, &event_index);
-  if (buffer_id != id_ || chunk_index >= total_chunks_) {
-    // Either the chunk belongs to the other buffer, or is outside the current
-    // range of chunks loaded in memory (the latter being true suggests that
-    // the chunk has already been flushed and is no longer in memory.)
-    return nullptr;
-  }
-  auto& chunk = chunks_[chunk_index];
-  if (chunk->seq() != chunk_seq) {
-    // Chunk is no longer in memory.
-    return nullptr;
-  }
-  return chunk->GetEventAt(event_index);
-}
+std::atomic<uint64_t> next_buffer_id { 1 };
 
-void InternalTraceBuffer::Flush(bool blocking) {
-  {
-    Mutex::ScopedLock scoped_lock(mutex_);
-    if (total_chunks_ > 0) {
-      flushing_ = true;
-      for (size_t i = 0; i < total_chunks_; ++i) {
-        auto& chunk = chunks_[i];
-        for (size_t j = 0; j < chunk->size(); ++j) {
-          TraceObject* trace_event = chunk->GetEventAt(j);
-          // Another thread may have added a trace that is yet to be
-          // initialized. Skip such traces.
-          // https://github.com/nodejs/node/issues/21038.
-          if (trace_event->name()) {
-            agent_->AppendTraceEvent(trace_event);
-          }
-        }
-      }
-      total_chunks_ = 0;
-      flushing_ = false;
+// Buffers that are still alive, by id, for retiring the chunks of exiting
+// threads.
+Mutex live_buffers_mutex;
+std::unordered_map<uint64_t, NodeTraceBuffer*> live_buffers;
+
+}  // anonymous namespace
+
+struct NodeTraceBuffer::ThreadChunk {
+  // The id of the NodeTraceBuffer that the chunk belongs to, or 0.
+  uint64_t buffer_id = 0;
+  uint32_t slot_index = 0;
+
+  ~ThreadChunk() {
+    if (buffer_id == 0)
+      return;
+    // Otherwise the chunk would never be reused.
+    Mutex::ScopedLock lock(live_buffers_mutex);
+    auto it = live_buffers.find(buffer_id);
+    if (it != live_buffers.end()) {
+      NodeTraceBuffer* buffer = it->second;
+      buffer->RetireChunk(&buffer->slots_[slot_index]);
     }
   }
-  agent_->Flush(blocking);
-}
+};
 
-uint64_t InternalTraceBuffer::MakeHandle(
-    size_t chunk_index, uint32_t chunk_seq, size_t event_index) const {
-  return ((static_cast<uint64_t>(chunk_seq) * Capacity() +
-          chunk_index * TraceBufferChunk::kChunkSize + event_index) << 1) + id_;
-}
-
-void InternalTraceBuffer::ExtractHandle(
-    uint64_t handle, uint32_t* buffer_id, size_t* chunk_index,
-    uint32_t* chunk_seq, size_t* event_index) const {
-  *buffer_id = static_cast<uint32_t>(handle & 0x1);
-  handle >>= 1;
-  *chunk_seq = static_cast<uint32_t>(handle / Capacity());
-  size_t indices = handle % Capacity();
-  *chunk_index = indices / TraceBufferChunk::kChunkSize;
-  *event_index = indices % TraceBufferChunk::kChunkSize;
-}
+thread_local NodeTraceBuffer::ThreadChunk
+    NodeTraceBuffer::current_thread_chunk_;
 
 NodeTraceBuffer::NodeTraceBuffer(size_t max_chunks,
     Agent* agent, uv_loop_t* tracing_loop)
-    : tracing_loop_(tracing_loop),
-      buffer1_(max_chunks, 0, agent),
-      buffer2_(max_chunks, 1, agent) {
-  current_buf_.store(&buffer1_);
+    : max_chunks_(max_chunks),
+      id_(next_buffer_id++),
+      agent_(agent),
+      slots_(new ChunkSlot[max_chunks]),
+      free_list_(kNoSlot),
+      tracing_loop_(tracing_loop) {
+  CHECK_LT(max_chunks, kNoSlot);
+  for (size_t i = max_chunks; i > 0; --i)
+    PushFreeSlot(static_cast<uint32_t>(i - 1));
+  {
+    Mutex::ScopedLock lock(live_buffers_mutex);
+    live_buffers[id_] = this;
+  }
 
   flush_signal_.data = this;
   int err = uv_async_init(tracing_loop_, &flush_signal_,
@@ -113,6 +66,10 @@ NodeTraceBuffer::NodeTraceBuffer(size_t max_chunks,
 }
 
 NodeTraceBuffer::~NodeTraceBuffer() {
+  {
+    Mutex::ScopedLock lock(live_buffers_mutex);
+    live_buffers.erase(id_);
+  }
   uv_async_send(&exit_signal_);
   Mutex::ScopedLock scoped_lock(exit_mutex_);
   while (!exited_) {
@@ -120,55 +77,210 @@ NodeTraceBuffer::~NodeTraceBuffer() {
   }
 }
 
+bool NodeTraceBuffer::PopFreeSlot(uint32_t* index) {
+  uint64_t head = free_list_.load(std::memory_order_acquire);
+  for (;;) {
+    uint32_t top = static_cast<uint32_t>(head);
+    if (top == kNoSlot)
+      return false;
+    uint32_t next = slots_[top].next_free.load(std::memory_order_relaxed);
+    uint64_t new_head = (((head >> 32) + 1) << 32) | next;
+    if (free_list_.compare_exchange_weak(head, new_head,
+                                         std::memory_order_acquire,
+                                         std::memory_order_acquire)) {
+      *index = top;
+      return true;
+    }
+  }
+}
+
+void NodeTraceBuffer::PushFreeSlot(uint32_t index) {
+  uint64_t head = free_list_.load(std::memory_order_relaxed);
+  uint64_t new_head;
+  do {
+    slots_[index].next_free.store(static_cast<uint32_t>(head),
+                                  std::memory_order_relaxed);
+    new_head = (((head >> 32) + 1) << 32) | index;
+  } while (!free_list_.compare_exchange_weak(head, new_head,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+}
+
+// Returns the chunk that the current thread is filling, or nullptr.
+NodeTraceBuffer::ChunkSlot* NodeTraceBuffer::GetThreadChunk() {
+  ThreadChunk* thread_chunk = &current_thread_chunk_;
+  if (thread_chunk->buffer_id != id_)
+    return nullptr;
+  return &slots_[thread_chunk->slot_index];
+}
+
+NodeTraceBuffer::ChunkSlot* NodeTraceBuffer::AcquireChunk() {
+  uint32_t index;
+  if (!PopFreeSlot(&index))
+    return nullptr;
+  ChunkSlot* slot = &slots_[index];
+  uint32_t seq = next_chunk_seq_++;
+  if (seq == 0) seq = next_chunk_seq_++;
+  if (slot->chunk) {
+    slot->chunk->Reset(seq);
+  } else {
+    slot->chunk = std::make_unique<TraceBufferChunk>(seq);
+  }
+  slot->seq.store(seq, std::memory_order_relaxed);
+  slot->committed.store(0, std::memory_order_relaxed);
+  slot->flushed = 0;
+  slot->state.store(kOwned, std::memory_order_release);
+  current_thread_chunk_.buffer_id = id_;
+  current_thread_chunk_.slot_index = index;
+  return slot;
+}
+
+void NodeTraceBuffer::RetireChunk(ChunkSlot* slot) {
+  current_thread_chunk_.buffer_id = 0;
+  slot->committed.store(slot->chunk->size(), std::memory_order_release);
+  slot->state.store(kRetired, std::memory_order_release);
+  // Start writing out chunks once half of them are waiting, so that threads
+  // rarely run out of chunks.
+  if (++retired_chunks_ >= max_chunks_ / 2)
+    uv_async_send(&flush_signal_);  // trigger flush on a separate thread
+}
+
 TraceObject* NodeTraceBuffer::AddTraceEvent(uint64_t* handle) {
-  // If the buffer is full, attempt to perform a flush.
-  if (!TryLoadAvailableBuffer()) {
-    // Assign a value of zero as the trace event handle.
-    // This is equivalent to calling InternalTraceBuffer::MakeHandle(0, 0, 0),
-    // and will cause GetEventByHandle to return NULL if passed as an argument.
-    *handle = 0;
+  ChunkSlot* slot = GetThreadChunk();
+  if (slot != nullptr && slot->chunk->IsFull()) {
+    RetireChunk(slot);
+    slot = nullptr;
+  }
+  if (slot == nullptr) {
+    slot = AcquireChunk();
+    if (slot == nullptr) {
+      // All chunks are in use. Drop the event and make sure that chunks are
+      // being written out.
+      uv_async_send(&flush_signal_);
+      // Assign a value of zero as the trace event handle. This will cause
+      // GetEventByHandle to return NULL if passed as an argument.
+      *handle = 0;
+      return nullptr;
+    }
+  }
+  size_t event_index;
+  TraceObject* trace_object = slot->chunk->AddTraceEvent(&event_index);
+  *handle = MakeHandle(current_thread_chunk_.slot_index,
+                       slot->chunk->seq(),
+                       event_index);
+  return trace_object;
+}
+
+void NodeTraceBuffer::CommitTraceEvents() {
+  ChunkSlot* slot = GetThreadChunk();
+  if (slot != nullptr)
+    slot->committed.store(slot->chunk->size(), std::memory_order_release);
+}
+
+// Returns the chunk that `handle` refers to, or nullptr if that chunk has
+// already been written out and is no longer in memory.
+NodeTraceBuffer::ChunkSlot* NodeTraceBuffer::GetSlotForHandle(
+    uint64_t handle, size_t* event_index) {
+  if (handle == 0) {
+    // A handle value of zero never has a trace event associated with it.
+    return nullptr;
+  }
+  uint32_t slot_index, chunk_seq;
+  ExtractHandle(handle, &slot_index, &chunk_seq, event_index);
+  if (slot_index >= max_chunks_)
+    return nullptr;
+  ChunkSlot* slot = &slots_[slot_index];
+  // AcquireChunk() stores the new sequence number before the new state.
+  if (slot->state.load(std::memory_order_acquire) == kFree ||
+      slot->seq.load(std::memory_order_acquire) != chunk_seq) {
     return nullptr;
   }
-  return current_buf_.load()->AddTraceEvent(handle);
+  return slot;
 }
 
 TraceObject* NodeTraceBuffer::GetEventByHandle(uint64_t handle) {
-  return current_buf_.load()->GetEventByHandle(handle);
+  size_t event_index;
+  ChunkSlot* slot = GetSlotForHandle(handle, &event_index);
+  if (slot == nullptr)
+    return nullptr;
+  return slot->chunk->GetEventAt(event_index);
 }
 
-bool NodeTraceBuffer::Flush() {
-  buffer1_.Flush(true);
-  buffer2_.Flush(true);
-  return true;
+void NodeTraceBuffer::UpdateEventDuration(
+    uint64_t handle, int64_t now_us, int64_t cpu_now_us) {
+  size_t event_index;
+  ChunkSlot* slot = GetSlotForHandle(handle, &event_index);
+  if (slot == nullptr)
+    return;
+  // Pin the chunk, then check the handle again. FlushChunks() sets `flushing`
+  // before it waits for the pins to go away, and these accesses are all
+  // sequentially consistent, so either the flush waits for this update or
+  // the update sees the flush and the chunk is left alone. The chunk cannot
+  // be reset for a new owner without a flush in between.
+  ++slot->pins;
+  if (!slot->flushing && GetSlotForHandle(handle, &event_index) == slot)
+    slot->chunk->GetEventAt(event_index)->UpdateDuration(now_us, cpu_now_us);
+  --slot->pins;
 }
 
-// Attempts to set current_buf_ such that it references a buffer that can
-// write at least one trace event. If both buffers are unavailable this
-// method returns false; otherwise it returns true.
-bool NodeTraceBuffer::TryLoadAvailableBuffer() {
-  InternalTraceBuffer* prev_buf = current_buf_.load();
-  if (prev_buf->IsFull()) {
-    uv_async_send(&flush_signal_);  // trigger flush on a separate thread
-    InternalTraceBuffer* other_buf = prev_buf == &buffer1_ ?
-      &buffer2_ : &buffer1_;
-    if (!other_buf->IsFull()) {
-      current_buf_.store(other_buf);
-    } else {
-      return false;
+void NodeTraceBuffer::FlushChunks(bool blocking) {
+  {
+    Mutex::ScopedLock scoped_lock(flush_mutex_);
+    for (size_t i = 0; i < max_chunks_; ++i) {
+      ChunkSlot* slot = &slots_[i];
+      uint32_t state = slot->state.load(std::memory_order_acquire);
+      if (state == kFree)
+        continue;
+      // Complete events in chunks that are still being filled may be waiting
+      // for their duration. Only write those out when tracing stops.
+      if (state != kRetired && !blocking)
+        continue;
+      slot->flushing = true;
+      while (slot->pins != 0)
+        uv_sleep(0);
+      size_t committed = slot->committed.load(std::memory_order_acquire);
+      for (size_t j = slot->flushed; j < committed; ++j)
+        agent_->AppendTraceEvent(slot->chunk->GetEventAt(j));
+      slot->flushed = committed;
+      if (state == kRetired) {
+        // `committed` is final for retired chunks, so the chunk can be
+        // reused.
+        slot->state.store(kFree, std::memory_order_relaxed);
+        slot->flushing = false;
+        --retired_chunks_;
+        PushFreeSlot(static_cast<uint32_t>(i));
+      } else {
+        slot->flushing = false;
+      }
     }
   }
+  agent_->Flush(blocking);
+}
+
+bool NodeTraceBuffer::Flush() {
+  FlushChunks(true);
   return true;
 }
 
+uint64_t NodeTraceBuffer::MakeHandle(
+    uint32_t slot_index, uint32_t chunk_seq, size_t event_index) const {
+  return (static_cast<uint64_t>(chunk_seq) * max_chunks_ + slot_index) *
+      TraceBufferChunk::kChunkSize + event_index;
+}
+
+void NodeTraceBuffer::ExtractHandle(
+    uint64_t handle, uint32_t* slot_index, uint32_t* chunk_seq,
+    size_t* event_index) const {
+  *event_index = handle % TraceBufferChunk::kChunkSize;
+  handle /= TraceBufferChunk::kChunkSize;
+  *slot_index = static_cast<uint32_t>(handle % max_chunks_);
+  *chunk_seq = static_cast<uint32_t>(handle / max_chunks_);
+}
+
 // static
 void NodeTraceBuffer::NonBlockingFlushSignalCb(uv_async_t* signal) {
   NodeTraceBuffer* buffer = static_cast<NodeTraceBuffer*>(signal->data);
-  if (buffer->buffer1_.IsFull() && !buffer->buffer1_.IsFlushing()) {
-    buffer->buffer1_.Flush(false);
-  }
-  if (buffer->buffer2_.IsFull() && !buffer->buffer2_.IsFlushing()) {
-    buffer->buffer2_.Flush(false);
-  }
+  buffer->FlushChunks(false);
 }
 
 // static
@@ -14,56 +14,102 @@ using v8::platform::tracing::TraceBuffer;
 using v8::platform::tracing::TraceBufferChunk;
 using v8::platform::tracing::TraceObject;
 
-// forward declaration
-class NodeTraceBuffer;
-
-class InternalTraceBuffer {
- public:
-  InternalTraceBuffer(size_t max_chunks, uint32_t id, Agent* agent);
-
-  TraceObject* AddTraceEvent(uint64_t* handle);
-  TraceObject* GetEventByHandle(uint64_t handle);
-  void Flush(bool blocking);
-  bool IsFull() const {
-    return total_chunks_ == max_chunks_ && chunks_[total_chunks_ - 1]->IsFull();
-  }
-  bool IsFlushing() const {
-    return flushing_;
-  }
-
- private:
-  uint64_t MakeHandle(size_t chunk_index, uint32_t chunk_seq,
-                      size_t event_index) const;
-  void ExtractHandle(uint64_t handle, uint32_t* buffer_id, size_t* chunk_index,
-                     uint32_t* chunk_seq, size_t* event_index) const;
-  size_t Capacity() const { return max_chunks_ * TraceBufferChunk::kChunkSize; }
-
-  Mutex mutex_;
-  bool flushing_;
-  size_t max_chunks_;
-  Agent* agent_;
-  std::vector<std::unique_ptr<TraceBufferChunk>> chunks_;
-  size_t total_chunks_ = 0;
-  uint32_t current_chunk_seq_ = 1;
-  uint32_t id_;
-};
-
+// A TraceBuffer in which each thread that adds trace events owns a chunk of
+// events, so that adding an event does not need any locking. Full chunks are
+// handed off to the tracing thread, which writes them out and puts them back
+// on a lock-free free list for reuse by any thread. Chunks that are still
+// being filled are only written out by blocking flushes, up to the last event
+// that the owning thread has committed, so that complete events can still
+// have their duration updated until their chunk is full.
 class NodeTraceBuffer : public TraceBuffer {
  public:
   NodeTraceBuffer(size_t max_chunks, Agent* agent, uv_loop_t* tracing_loop);
   ~NodeTraceBuffer() override;
 
   TraceObject* AddTraceEvent(uint64_t* handle) override;
+  // The returned event may be written out and recycled at any time. Use
+  // UpdateEventDuration() to modify events that were added earlier.
   TraceObject* GetEventByHandle(uint64_t handle) override;
   bool Flush() override;
 
-  static const size_t kBufferChunks = 1024;
+  // Makes the events that the current thread has added and initialized so far
+  // available for writing out.
+  void CommitTraceEvents();
+
+  // Updates the duration of a complete event, unless its chunk has already
+  // been written out or is being written out.
+  void UpdateEventDuration(uint64_t handle, int64_t now_us, int64_t cpu_now_us);
+
+  // The total number of chunks shared by all threads.
+  static const size_t kBufferChunks = 2048;
 
  private:
-  bool TryLoadAvailableBuffer();
+  static const uint32_t kNoSlot = static_cast<uint32_t>(-1);
+
+  enum ChunkState : uint32_t {
+    // On the free list.
+    kFree,
+    // Being filled by the thread that took it from the free list.
+    kOwned,
+    // Full, waiting to be written out by the tracing thread.
+    kRetired
+  };
+
+  struct ChunkSlot {
+    std::unique_ptr<TraceBufferChunk> chunk;
+    std::atomic<uint32_t> state { kFree };
+    // Copy of chunk->seq() that can be read by threads other than the owner.
+    std::atomic<uint32_t> seq { 0 };
+    // The number of events in `chunk` that have been fully initialized and
+    // can be written out. Only advanced by the owning thread, through
+    // CommitTraceEvents().
+    std::atomic<size_t> committed { 0 };
+    // The number of events in `chunk` that have already been written out.
+    // Only accessed with flush_mutex_ held while the chunk is in use.
+    size_t flushed = 0;
+    // Set while the chunk is being written out, which must not overlap with
+    // any UpdateEventDuration() call for this chunk.
+    std::atomic_bool flushing { false };
+    // The number of UpdateEventDuration() calls accessing this chunk.
+    std::atomic<uint32_t> pins { 0 };
+    // The next slot on the free list.
+    std::atomic<uint32_t> next_free { kNoSlot };
+  };
+
+  // Records which chunk, if any, the current thread is filling. Retires the
+  // chunk when the thread exits.
+  struct ThreadChunk;
+  static thread_local ThreadChunk current_thread_chunk_;
+
+  ChunkSlot* GetThreadChunk();
+  ChunkSlot* AcquireChunk();
+  void RetireChunk(ChunkSlot* slot);
+  bool PopFreeSlot(uint32_t* index);
+  void PushFreeSlot(uint32_t index);
+  ChunkSlot* GetSlotForHandle(uint64_t handle, size_t* event_index);
+  void FlushChunks(bool blocking);
+
+  uint64_t MakeHandle(uint32_t slot_index, uint32_t chunk_seq,
+                      size_t event_index) const;
+  void ExtractHandle(uint64_t handle, uint32_t* slot_index,
+                     uint32_t* chunk_seq, size_t* event_index) const;
+
   static void NonBlockingFlushSignalCb(uv_async_t* signal);
   static void ExitSignalCb(uv_async_t* signal);
 
+  const size_t max_chunks_;
+  // Identifies this buffer in current_thread_chunk_.
+  const uint64_t id_;
+  Agent* agent_;
+  std::unique_ptr<ChunkSlot[]> slots_;
+  // The top of the free list in the lower 32 bits, and a counter that is
+  // incremented on every update in the upper 32 bits to avoid ABA problems.
+  std::atomic<uint64_t> free_list_;
+  std::atomic<uint32_t> next_chunk_seq_ { 1 };
+  std::atomic<size_t> retired_chunks_ { 0 };
+  // Serializes writing out chunks between the tracing thread and Flush().
+  Mutex flush_mutex_;
+
   uv_loop_t* tracing_loop_;
   uv_async_t flush_signal_;
   uv_async_t exit_signal_;
@@ -72,9 +118,6 @@ class NodeTraceBuffer : public TraceBuffer {
   Mutex exit_mutex_;
   // Used to wait until async handles have been closed.
   ConditionVariable exit_cond_;
-  std::atomic<InternalTraceBuffer*> current_buf_;
-  InternalTraceBuffer buffer1_;
-  InternalTraceBuffer buffer2_;
 };
 
 }  // namespace tracing
@@ -1,5 +1,6 @@
 #include "tracing/node_trace_writer.h"
 
+#include "tracing/proto_trace_writer.h"
 #include "util-inl.h"
 
 #include <fcntl.h>
@@ -8,8 +9,9 @@
 namespace node {
 namespace tracing {
 
-NodeTraceWriter::NodeTraceWriter(const std::string& log_file_pattern)
-    : log_file_pattern_(log_file_pattern) {}
+NodeTraceWriter::NodeTraceWriter(const std::string& log_file_pattern,
+                                 Format format)
+    : log_file_pattern_(log_file_pattern), format_(format) {}
 
 void NodeTraceWriter::InitializeOnThread(uv_loop_t* loop) {
   CHECK_NULL(tracing_loop_);
@@ -101,16 +103,22 @@ void NodeTraceWriter::AppendTraceEvent(TraceObject* trace_event) {
   // If this is the first trace event, open a new file for streaming.
   if (total_traces_ == 0) {
     OpenNewFileForStreaming();
-    // Constructing a new JSONTraceWriter object appends "{\"traceEvents\":["
-    // to stream_.
-    // In other words, the constructor initializes the serialization stream
-    // to a state where we can start writing trace events to it.
-    // Repeatedly constructing and destroying json_trace_writer_ allows
-    // us to use V8's JSON writer instead of implementing our own.
-    json_trace_writer_.reset(TraceWriter::CreateJSONTraceWriter(stream_));
+    if (format_ == Format::kProto) {
+      // A new ProtoTraceWriter starts with a clean interning state, so that
+      // each file can be loaded on its own.
+      trace_writer_.reset(new ProtoTraceWriter(stream_));
+    } else {
+      // Constructing a new JSONTraceWriter object appends
+      // "{\"traceEvents\":[" to stream_.
+      // In other words, the constructor initializes the serialization stream
+      // to a state where we can start writing trace events to it.
+      // Repeatedly constructing and destroying trace_writer_ allows
+      // us to use V8's JSON writer instead of implementing our own.
+      trace_writer_.reset(TraceWriter::CreateJSONTraceWriter(stream_));
+    }
   }
   ++total_traces_;
-  json_trace_writer_->AppendTraceEvent(trace_event);
+  trace_writer_->AppendTraceEvent(trace_event);
 }
 
 void NodeTraceWriter::FlushPrivate() {
@@ -122,7 +130,7 @@ void NodeTraceWriter::FlushPrivate() {
       total_traces_ = 0;
       // Destroying the member JSONTraceWriter object appends "]}" to
       // stream_ - in other words, ending a JSON file.
-      json_trace_writer_.reset();
+      trace_writer_.reset();
     }
     // str() makes a copy of the contents of the stream.
     str = stream_.str();
@@ -140,10 +148,10 @@ void NodeTraceWriter::Flush(bool blocking) {
   Mutex::ScopedLock scoped_lock(request_mutex_);
   {
     // We need to lock the mutexes here in a nested fashion; stream_mutex_
-    // protects json_trace_writer_, and without request_mutex_ there might be
+    // protects trace_writer_, and without request_mutex_ there might be
     // a time window in which the stream state changes?
     Mutex::ScopedLock stream_mutex_lock(stream_mutex_);
-    if (!json_trace_writer_)
+    if (!trace_writer_)
       return;
   }
   int request_id = ++num_write_requests_;
@@ -0,0 +1,400 @@
+#include "tracing/proto_trace_writer.h"
+
+#include "tracing/trace_event_common.h"
+#include "util.h"
+
+namespace node {
+namespace tracing {
+
+using v8::platform::tracing::TracingController;
+
+namespace {
+
+// Field numbers from the Perfetto protos (perfetto/trace/*.proto).
+enum TraceField : uint32_t {
+  kTracePacket = 1,
+};
+
+enum TracePacketField : uint32_t {
+  kPacketClockSnapshot = 6,
+  kPacketTimestamp = 8,
+  kPacketTrustedPacketSequenceId = 10,
+  kPacketTrackEvent = 11,
+  kPacketInternedData = 12,
+  kPacketSequenceFlags = 13,
+  kPacketTimestampClockId = 58,
+  kPacketTracePacketDefaults = 59,
+  kPacketTrackDescriptor = 60,
+};
+
+enum SequenceFlags : uint32_t {
+  kSeqIncrementalStateCleared = 1,
+  kSeqNeedsIncrementalState = 2,
+};
+
+enum ClockSnapshotField : uint32_t {
+  kClockSnapshotClocks = 1,
+};
+
+enum ClockField : uint32_t {
+  kClockId = 1,
+  kClockTimestamp = 2,
+  kClockIsIncremental = 3,
+  kClockUnitMultiplierNs = 4,
+};
+
+enum TracePacketDefaultsField : uint32_t {
+  kDefaultsTimestampClockId = 58,
+};
+
+enum TrackDescriptorField : uint32_t {
+  kTrackUuid = 1,
+  kTrackProcess = 3,
+  kTrackThread = 4,
+};
+
+enum ProcessDescriptorField : uint32_t {
+  kProcessPid = 1,
+  kProcessName = 6,
+};
+
+enum ThreadDescriptorField : uint32_t {
+  kThreadPid = 1,
+  kThreadTid = 2,
+  kThreadName = 5,
+};
+
+enum InternedDataField : uint32_t {
+  kInternedEventCategories = 1,
+  kInternedEventNames = 2,
+  kInternedDebugAnnotationNames = 3,
+};
+
+// EventCategory, EventName and DebugAnnotationName all share this layout.
+enum InternedStringField : uint32_t {
+  kInternedIid = 1,
+  kInternedName = 2,
+};
+
+enum TrackEventField : uint32_t {
+  kEventCategoryIids = 3,
+  kEventDebugAnnotations = 4,
+  kEventLegacyEvent = 6,
+  kEventNameIid = 10,
+  kEventThreadTimeAbsoluteUs = 17,
+};
+
+enum LegacyEventField : uint32_t {
+  kLegacyPhase = 2,
+  kLegacyDurationUs = 3,
+  kLegacyThreadDurationUs = 4,
+  kLegacyUnscopedId = 6,
+  kLegacyIdScope = 7,
+  kLegacyBindId = 8,
+  kLegacyFlowDirection = 13,
+  kLegacyPidOverride = 18,
+  kLegacyTidOverride = 19,
+};
+
+enum FlowDirection : uint32_t {
+  kFlowIn = 1,
+  kFlowOut = 2,
+  kFlowInOut = 3,
+};
+
+enum DebugAnnotationField : uint32_t {
+  kAnnotationNameIid = 1,
+  kAnnotationBoolValue = 2,
+  kAnnotationUintValue = 3,
+  kAnnotationIntValue = 4,
+  kAnnotationDoubleValue = 5,
+  kAnnotationStringValue = 6,
+  kAnnotationPointerValue = 7,
+  kAnnotationLegacyJsonValue = 9,
+};
+
+enum WireType : uint32_t {
+  kVarInt = 0,
+  kFixed64 = 1,
+  kLengthDelimited = 2,
+};
+
+inline uint64_t MakeTag(uint32_t field, WireType type) {
+  return (static_cast<uint64_t>(field) << 3) | type;
+}
+
+inline uint64_t ThreadTrackUuid(int pid, int tid) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(pid)) << 32) |
+         static_cast<uint32_t>(tid);
+}
+
+inline uint64_t ProcessTrackUuid(int pid) {
+  // Keep process tracks apart from the thread track of tid 0.
+  return ThreadTrackUuid(pid, 0) ^ (uint64_t{1} << 63);
+}
+
+}  // namespace
+
+void ProtoEncoder::AppendRawVarInt(uint64_t value) {
+  while (value >= 0x80) {
+    data_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  data_.push_back(static_cast<char>(value));
+}
+
+void ProtoEncoder::AppendVarInt(uint32_t field, uint64_t value) {
+  AppendRawVarInt(MakeTag(field, kVarInt));
+  AppendRawVarInt(value);
+}
+
+void ProtoEncoder::AppendDouble(uint32_t field, double value) {
+  AppendRawVarInt(MakeTag(field, kFixed64));
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  // The wire format is little-endian.
+  for (int i = 0; i < 8; i++) {
+    data_.push_back(static_cast<char>(bits & 0xff));
+    bits >>= 8;
+  }
+}
+
+void ProtoEncoder::AppendBytes(uint32_t field,
+                               const char* data,
+                               size_t length) {
+  AppendRawVarInt(MakeTag(field, kLengthDelimited));
+  AppendRawVarInt(length);
+  data_.append(data, length);
+}
+
+void ProtoEncoder::AppendPackedVarInts(uint32_t field,
+                                       const uint64_t* values,
+                                       size_t count) {
+  if (count == 0) return;
+  size_t length = 0;
+  for (size_t i = 0; i < count; i++) {
+    uint64_t value = values[i];
+    do {
+      length++;
+      value >>= 7;
+    } while (value != 0);
+  }
+  AppendRawVarInt(MakeTag(field, kLengthDelimited));
+  AppendRawVarInt(length);
+  for (size_t i = 0; i < count; i++)
+    AppendRawVarInt(values[i]);
+}
+
+ProtoTraceWriter::ProtoTraceWriter(std::ostream& stream) : stream_(stream) {}
+
+uint64_t ProtoTraceWriter::Intern(InternTable* table,
+                                  uint32_t field,
+                                  const char* name) {
+  if (name == nullptr) name = "";
+  auto it = table->find(name);
+  if (it != table->end()) return it->second;
+
+  // Interned ids have to be non-zero.
+  uint64_t iid = table->size() + 1;
+  table->emplace(name, iid);
+  entry_.clear();
+  entry_.AppendVarInt(kInternedIid, iid);
+  entry_.AppendString(kInternedName, name);
+  interned_data_.AppendMessage(field, entry_);
+  return iid;
+}
+
+void ProtoTraceWriter::WritePacket() {
+  packet_.AppendVarInt(kPacketTrustedPacketSequenceId, kSequenceId);
+  trace_.clear();
+  trace_.AppendMessage(kTracePacket, packet_);
+  stream_.write(trace_.data().data(), trace_.data().size());
+  packet_.clear();
+}
+
+void ProtoTraceWriter::WriteClockSnapshot(int64_t timestamp) {
+  // Map the incremental clock, which counts microseconds like the timestamps
+  // of trace events, to CLOCK_MONOTONIC which uv_hrtime() is based on.
+  ProtoEncoder snapshot;
+  ProtoEncoder clock;
+  clock.AppendVarInt(kClockId, kMonotonicClockId);
+  clock.AppendVarInt(kClockTimestamp, timestamp * 1000);
+  snapshot.AppendMessage(kClockSnapshotClocks, clock);
+  clock.clear();
+  clock.AppendVarInt(kClockId, kIncrementalClockId);
+  clock.AppendVarInt(kClockTimestamp, timestamp);
+  clock.AppendVarInt(kClockIsIncremental, 1);
+  clock.AppendVarInt(kClockUnitMultiplierNs, 1000);
+  snapshot.AppendMessage(kClockSnapshotClocks, clock);
+
+  ProtoEncoder defaults;
+  defaults.AppendVarInt(kDefaultsTimestampClockId, kIncrementalClockId);
+
+  packet_.AppendVarInt(kPacketTimestamp, timestamp * 1000);
+  packet_.AppendVarInt(kPacketTimestampClockId, kMonotonicClockId);
+  packet_.AppendMessage(kPacketClockSnapshot, snapshot);
+  packet_.AppendMessage(kPacketTracePacketDefaults, defaults);
+  packet_.AppendVarInt(kPacketSequenceFlags, kSeqIncrementalStateCleared);
+  WritePacket();
+
+  last_timestamp_ = timestamp;
+  wrote_clock_snapshot_ = true;
+}
+
+// Turns the thread_name and process_name metadata events into track
+// descriptors, which is how Perfetto names threads and processes.
+void ProtoTraceWriter::WriteMetadataEvent(TraceObject* trace_event) {
+  const char* name = trace_event->name();
+  const bool is_thread = strcmp(name, "thread_name") == 0;
+  const bool is_process = strcmp(name, "process_name") == 0;
+  if ((!is_thread && !is_process) || trace_event->num_args() < 1) return;
+  const uint8_t type = trace_event->arg_types()[0];
+  if (type != TRACE_VALUE_TYPE_STRING && type != TRACE_VALUE_TYPE_COPY_STRING)
+    return;
+  const char* value = trace_event->arg_values()[0].as_string;
+  if (value == nullptr) return;
+
+  ProtoEncoder descriptor;
+  ProtoEncoder details;
+  if (is_thread) {
+    details.AppendVarInt(kThreadPid, trace_event->pid());
+    details.AppendVarInt(kThreadTid, trace_event->tid());
+    details.AppendString(kThreadName, value);
+    descriptor.AppendVarInt(kTrackUuid,
+                            ThreadTrackUuid(trace_event->pid(),
+                                            trace_event->tid()));
+    descriptor.AppendMessage(kTrackThread, details);
+  } else {
+    details.AppendVarInt(kProcessPid, trace_event->pid());
+    details.AppendString(kProcessName, value);
+    descriptor.AppendVarInt(kTrackUuid, ProcessTrackUuid(trace_event->pid()));
+    descriptor.AppendMessage(kTrackProcess, details);
+  }
+  packet_.AppendMessage(kPacketTrackDescriptor, descriptor);
+  WritePacket();
+}
+
+void ProtoTraceWriter::AppendTraceEvent(TraceObject* trace_event) {
+  if (trace_event->phase() == TRACE_EVENT_PHASE_METADATA) {
+    // Metadata events are not timestamped and do not need the clock.
+    WriteMetadataEvent(trace_event);
+    return;
+  }
+
+  const int64_t timestamp = trace_event->ts();
+  if (!wrote_clock_snapshot_)
+    WriteClockSnapshot(timestamp);
+
+  interned_data_.clear();
+  track_event_.clear();
+  legacy_event_.clear();
+
+  track_event_.AppendVarInt(
+      kEventCategoryIids,
+      Intern(&categories_,
+             kInternedEventCategories,
+             TracingController::GetCategoryGroupName(
+                 trace_event->category_enabled_flag())));
+  track_event_.AppendVarInt(
+      kEventNameIid,
+      Intern(&event_names_, kInternedEventNames, trace_event->name()));
+  if (trace_event->tts() != 0)
+    track_event_.AppendVarInt(kEventThreadTimeAbsoluteUs, trace_event->tts());
+
+  const char** arg_names = trace_event->arg_names();
+  const uint8_t* arg_types = trace_event->arg_types();
+  TraceObject::ArgValue* arg_values = trace_event->arg_values();
+  std::unique_ptr<v8::ConvertableToTraceFormat>* arg_convertables =
+      trace_event->arg_convertables();
+  for (int i = 0; i < trace_event->num_args(); ++i) {
+    annotation_.clear();
+    annotation_.AppendVarInt(
+        kAnnotationNameIid,
+        Intern(&annotation_names_,
+               kInternedDebugAnnotationNames,
+               arg_names[i]));
+    const TraceObject::ArgValue& value = arg_values[i];
+    switch (arg_types[i]) {
+      case TRACE_VALUE_TYPE_BOOL:
+        annotation_.AppendVarInt(kAnnotationBoolValue, value.as_uint ? 1 : 0);
+        break;
+      case TRACE_VALUE_TYPE_UINT:
+        annotation_.AppendVarInt(kAnnotationUintValue, value.as_uint);
+        break;
+      case TRACE_VALUE_TYPE_INT:
+        annotation_.AppendVarInt(kAnnotationIntValue,
+                                 static_cast<uint64_t>(value.as_int));
+        break;
+      case TRACE_VALUE_TYPE_DOUBLE:
+        annotation_.AppendDouble(kAnnotationDoubleValue, value.as_double);
+        break;
+      case TRACE_VALUE_TYPE_POINTER:
+        annotation_.AppendVarInt(
+            kAnnotationPointerValue,
+            reinterpret_cast<uintptr_t>(value.as_pointer));
+        break;
+      case TRACE_VALUE_TYPE_STRING:
+      case TRACE_VALUE_TYPE_COPY_STRING:
+        annotation_.AppendString(
+            kAnnotationStringValue,
+            value.as_string != nullptr ? value.as_string : "nullptr");
+        break;
+      case TRACE_VALUE_TYPE_CONVERTABLE: {
+        std::string json;
+        arg_convertables[i]->AppendAsTraceFormat(&json);
+        annotation_.AppendString(kAnnotationLegacyJsonValue, json);
+        break;
+      }
+      default:
+        UNREACHABLE();
+    }
+    track_event_.AppendMessage(kEventDebugAnnotations, annotation_);
+  }
+
+  // The remaining fields keep the semantics of the JSON trace format.
+  const unsigned int flags = trace_event->flags();
+  legacy_event_.AppendVarInt(kLegacyPhase, trace_event->phase());
+  if (trace_event->phase() == TRACE_EVENT_PHASE_COMPLETE) {
+    legacy_event_.AppendVarInt(kLegacyDurationUs, trace_event->duration());
+    if (trace_event->cpu_duration() != 0) {
+      legacy_event_.AppendVarInt(kLegacyThreadDurationUs,
+                                 trace_event->cpu_duration());
+    }
+  }
+  if (flags & TRACE_EVENT_FLAG_HAS_ID) {
+    legacy_event_.AppendVarInt(kLegacyUnscopedId, trace_event->id());
+    if (trace_event->scope() != nullptr)
+      legacy_event_.AppendString(kLegacyIdScope, trace_event->scope());
+  }
+  if (flags & (TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT)) {
+    legacy_event_.AppendVarInt(kLegacyBindId, trace_event->bind_id());
+    uint32_t direction = 0;
+    if (flags & TRACE_EVENT_FLAG_FLOW_IN) direction |= kFlowIn;
+    if (flags & TRACE_EVENT_FLAG_FLOW_OUT) direction |= kFlowOut;
+    legacy_event_.AppendVarInt(kLegacyFlowDirection, direction);
+  }
+  legacy_event_.AppendVarInt(kLegacyPidOverride, trace_event->pid());
+  legacy_event_.AppendVarInt(kLegacyTidOverride, trace_event->tid());
+  track_event_.AppendMessage(kEventLegacyEvent, legacy_event_);
+
+  // Events are mostly, but not strictly, appended in timestamp order. The
+  // incremental clock cannot go backwards, so events that are older than
+  // their predecessor use an absolute timestamp instead.
+  if (timestamp >= last_timestamp_) {
+    packet_.AppendVarInt(kPacketTimestamp, timestamp - last_timestamp_);
+    last_timestamp_ = timestamp;
+  } else {
+    packet_.AppendVarInt(kPacketTimestamp, timestamp * 1000);
+    packet_.AppendVarInt(kPacketTimestampClockId, kMonotonicClockId);
+  }
+  if (!interned_data_.empty())
+    packet_.AppendMessage(kPacketInternedData, interned_data_);
+  packet_.AppendMessage(kPacketTrackEvent, track_event_);
+  packet_.AppendVarInt(kPacketSequenceFlags, kSeqNeedsIncrementalState);
+  WritePacket();
+}
+
+void ProtoTraceWriter::Flush() {}
+
+}  // namespace tracing
+}  // namespace node
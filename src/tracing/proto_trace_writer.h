@@ -0,0 +1,100 @@
+#ifndef SRC_TRACING_PROTO_TRACE_WRITER_H_
+#define SRC_TRACING_PROTO_TRACE_WRITER_H_
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "libplatform/v8-tracing.h"
+
+namespace node {
+namespace tracing {
+
+using v8::platform::tracing::TraceObject;
+using v8::platform::tracing::TraceWriter;
+
+// Minimal encoder for the protobuf wire format, enough to write the subset of
+// the Perfetto trace format used by ProtoTraceWriter.
+class ProtoEncoder {
+ public:
+  void AppendVarInt(uint32_t field, uint64_t value);
+  void AppendDouble(uint32_t field, double value);
+  void AppendBytes(uint32_t field, const char* data, size_t length);
+  // Appends a packed repeated varint field. Nothing is written if `count`
+  // is zero, which is how an empty repeated field is represented.
+  void AppendPackedVarInts(uint32_t field,
+                           const uint64_t* values,
+                           size_t count);
+  inline void AppendString(uint32_t field, const std::string& value) {
+    AppendBytes(field, value.data(), value.size());
+  }
+  inline void AppendString(uint32_t field, const char* value) {
+    AppendBytes(field, value, strlen(value));
+  }
+  inline void AppendMessage(uint32_t field, const ProtoEncoder& message) {
+    AppendBytes(field, message.data().data(), message.data().size());
+  }
+
+  inline const std::string& data() const { return data_; }
+  inline bool empty() const { return data_.empty(); }
+  inline void clear() { data_.clear(); }
+
+ private:
+  void AppendRawVarInt(uint64_t value);
+
+  std::string data_;
+};
+
+// Writes trace events as a Perfetto `Trace` protobuf message, which can be
+// loaded in https://ui.perfetto.dev and by the Perfetto trace processor.
+//
+// Each trace event becomes a `TracePacket` containing a `TrackEvent` that
+// keeps the Chrome JSON semantics through its `legacy_event` field. To keep
+// the output small, category, event and argument names are interned on first
+// use, and timestamps are written as deltas from the previous event using an
+// incremental clock. Like JSONTraceWriter, a new instance has to be created
+// for each file, since both are reset at the start of the stream.
+class ProtoTraceWriter : public TraceWriter {
+ public:
+  explicit ProtoTraceWriter(std::ostream& stream);
+
+  void AppendTraceEvent(TraceObject* trace_event) override;
+  void Flush() override;
+
+  // Identifiers from perfetto/trace/clock_snapshot.proto.
+  static const uint32_t kMonotonicClockId = 3;
+  static const uint32_t kIncrementalClockId = 64;
+  static const uint32_t kSequenceId = 1;
+
+ private:
+  using InternTable = std::unordered_map<std::string, uint64_t>;
+
+  void WriteClockSnapshot(int64_t timestamp);
+  void WriteMetadataEvent(TraceObject* trace_event);
+  void WritePacket();
+  // Returns the interned id for `name` and, the first time it is seen, adds
+  // an entry for it to field `field` of the pending InternedData message.
+  uint64_t Intern(InternTable* table, uint32_t field, const char* name);
+
+  std::ostream& stream_;
+  bool wrote_clock_snapshot_ = false;
+  int64_t last_timestamp_ = 0;
+  InternTable categories_;
+  InternTable event_names_;
+  InternTable annotation_names_;
+  // Scratch encoders, kept around to avoid allocations for each event.
+  ProtoEncoder packet_;
+  ProtoEncoder interned_data_;
+  ProtoEncoder track_event_;
+  ProtoEncoder legacy_event_;
+  ProtoEncoder annotation_;
+  ProtoEncoder entry_;
+  ProtoEncoder trace_;
+};
+
+}  // namespace tracing
+}  // namespace node
+
+#endif  // SRC_TRACING_PROTO_TRACE_WRITER_H_
@@ -28,15 +28,30 @@
 #include "req_wrap-inl.h"
 #include "util-inl.h"
 
+#ifdef __linux__
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#endif
+
+#include <algorithm>
+
 namespace node {
 
 using v8::Array;
+using v8::ArrayBuffer;
 using v8::Context;
 using v8::DontDelete;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
 using v8::Integer;
+using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
 using v8::Object;
@@ -44,6 +59,7 @@ using v8::PropertyAttribute;
 using v8::ReadOnly;
 using v8::Signature;
 using v8::Uint32;
+using v8::Uint32Array;
 using v8::Undefined;
 using v8::Value;
 
@@ -53,6 +69,16 @@ class SendWrap : public ReqWrap<uv_udp_send_t> {
   inline bool have_callback() const;
   size_t msg_size;
 
+  // When a batch of datagrams is sent, this request is used for the last
+  // one and the others are queued with these plain requests. libuv completes
+  // requests in order, so they are all done when this one is.
+  std::unique_ptr<uv_udp_send_t[]> batch_reqs;
+  size_t batch_pending = 0;
+  int batch_status = 0;
+  // Set if this request could not be queued, in which case the batch is
+  // completed by the last of the plain requests instead.
+  int batch_dispatch_error = 0;
+
   SET_NO_MEMORY_INFO()
   SET_MEMORY_INFO_NAME(SendWrap)
   SET_SELF_SIZE(SendWrap)
@@ -109,15 +135,20 @@ void UDPWrapBase::AddMethods(Environment* env, Local<FunctionTemplate> t) {
   env->SetProtoMethod(t, "recvStop", RecvStop);
 }
 
-UDPWrap::UDPWrap(Environment* env, Local<Object> object)
+UDPWrap::UDPWrap(Environment* env, Local<Object> object, bool recv_batch)
     : HandleWrap(env,
                  object,
                  reinterpret_cast<uv_handle_t*>(&handle_),
-                 AsyncWrap::PROVIDER_UDPWRAP) {
+                 AsyncWrap::PROVIDER_UDPWRAP),
+      recv_batch_(recv_batch) {
   object->SetAlignedPointerInInternalField(
       UDPWrapBase::kUDPWrapBaseField, static_cast<UDPWrapBase*>(this));
 
-  int r = uv_udp_init(env->event_loop(), &handle_);
+  // With UV_UDP_RECVMMSG, libuv reads multiple datagrams per system call
+  // where recvmmsg() is available.
+  int r = uv_udp_init_ex(env->event_loop(),
+                         &handle_,
+                         AF_UNSPEC | (recv_batch ? UV_UDP_RECVMMSG : 0));
   CHECK_EQ(r, 0);  // can't fail anyway
 
   set_listener(this);
@@ -158,6 +189,8 @@ void UDPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "bind6", Bind6);
   env->SetProtoMethod(t, "connect6", Connect6);
   env->SetProtoMethod(t, "send6", Send6);
+  env->SetProtoMethod(t, "sendBatch", SendBatch);
+  env->SetProtoMethod(t, "sendBatch6", SendBatch6);
   env->SetProtoMethod(t, "disconnect", Disconnect);
   env->SetProtoMethod(t, "getpeername",
                       GetSockOrPeerName<UDPWrap, uv_udp_getpeername>);
@@ -174,6 +207,7 @@ void UDPWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(t, "setMulticastLoopback", SetMulticastLoopback);
   env->SetProtoMethod(t, "setBroadcast", SetBroadcast);
   env->SetProtoMethod(t, "setTTL", SetTTL);
+  env->SetProtoMethod(t, "setSendSegmentSize", SetSendSegmentSize);
   env->SetProtoMethod(t, "bufferSize", BufferSize);
 
   t->Inherit(HandleWrap::GetConstructorTemplate(env));
@@ -200,7 +234,7 @@ void UDPWrap::Initialize(Local<Object> target,
 void UDPWrap::New(const FunctionCallbackInfo<Value>& args) {
   CHECK(args.IsConstructCall());
   Environment* env = Environment::GetCurrent(args);
-  new UDPWrap(env, args.This());
+  new UDPWrap(env, args.This(), args[0]->IsTrue());
 }
 
 
@@ -364,6 +398,23 @@ void UDPWrap::Disconnect(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(err);
 }
 
+// Makes the kernel split datagrams that are larger than `size` into
+// datagrams of `size` bytes (UDP generic segmentation offload), so that
+// many datagrams can be passed to it in a single send.
+static int SetUDPSegmentSize(uv_udp_t* handle, int size) {
+#ifdef __linux__
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(handle), &fd);
+  if (err != 0)
+    return err;
+  if (setsockopt(fd, SOL_UDP, UDP_SEGMENT, &size, sizeof(size)) != 0)
+    return -errno;
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
 #define X(name, fn)                                                            \
   void UDPWrap::name(const FunctionCallbackInfo<Value>& args) {                \
     UDPWrap* wrap = Unwrap<UDPWrap>(args.Holder());                            \
@@ -381,6 +432,7 @@ X(SetTTL, uv_udp_set_ttl)
 X(SetBroadcast, uv_udp_set_broadcast)
 X(SetMulticastTTL, uv_udp_set_multicast_ttl)
 X(SetMulticastLoopback, uv_udp_set_multicast_loop)
+X(SetSendSegmentSize, SetUDPSegmentSize)
 
 #undef X
 
@@ -474,7 +526,9 @@ void UDPWrap::DropSourceSpecificMembership(
 }
 
 
-void UDPWrap::DoSend(const FunctionCallbackInfo<Value>& args, int family) {
+void UDPWrap::DoSend(const FunctionCallbackInfo<Value>& args,
+                     int family,
+                     bool batch) {
   Environment* env = Environment::GetCurrent(args);
 
   UDPWrap* wrap;
@@ -531,7 +585,10 @@ void UDPWrap::DoSend(const FunctionCallbackInfo<Value>& args, int family) {
     wrap->current_send_has_callback_ =
         sendto ? args[5]->IsTrue() : args[3]->IsTrue();
 
-    err = static_cast<int>(wrap->Send(*bufs, count, addr));
+    if (batch)
+      err = static_cast<int>(wrap->SendBatch(*bufs, count, addr));
+    else
+      err = static_cast<int>(wrap->Send(*bufs, count, addr));
 
     wrap->current_send_req_wrap_.Clear();
     wrap->current_send_has_callback_ = false;
@@ -598,6 +655,134 @@ ssize_t UDPWrap::Send(uv_buf_t* bufs_ptr,
 }
 
 
+ssize_t UDPWrap::TrySendBatch(uv_buf_t* bufs,
+                              size_t count,
+                              const sockaddr* addr) {
+  size_t sent = 0;
+#ifdef __linux__
+  // Do not overtake datagrams that are already queued.
+  if (uv_udp_get_send_queue_count(&handle_) != 0)
+    return 0;
+
+  uv_os_fd_t fd;
+  int err = uv_fileno(reinterpret_cast<uv_handle_t*>(&handle_), &fd);
+  if (err != 0)
+    return err;
+
+  // sendmmsg() sends at most UIO_MAXIOV (1024) datagrams per call.
+  MaybeStackBuffer<mmsghdr, 16> msgs(std::min<size_t>(count, 1024));
+  while (sent < count) {
+    size_t n = std::min(count - sent, msgs.length());
+    for (size_t i = 0; i < n; i++) {
+      msghdr* h = &msgs[i].msg_hdr;
+      memset(&msgs[i], 0, sizeof(msgs[i]));
+      h->msg_name = const_cast<sockaddr*>(addr);
+      h->msg_namelen = addr == nullptr ? 0 : SocketAddress::GetLength(addr);
+      // uv_buf_t has the same layout as struct iovec on Unix.
+      h->msg_iov = reinterpret_cast<iovec*>(&bufs[sent + i]);
+      h->msg_iovlen = 1;
+    }
+
+    int r;
+    do {
+      r = sendmmsg(fd, *msgs, n, 0);
+    } while (r == -1 && errno == EINTR);
+
+    if (r == -1) {
+      // Errors for later datagrams are reported when they are sent again
+      // through libuv.
+      if (sent > 0 ||
+          errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+        break;
+      }
+      return -errno;
+    }
+    sent += r;
+  }
+#else
+  for (; sent < count; sent++) {
+    int err = uv_udp_try_send(&handle_, &bufs[sent], 1, addr);
+    if (err < 0) {
+      if (sent > 0 || err == UV_EAGAIN || err == UV_ENOSYS)
+        break;
+      return err;
+    }
+  }
+#endif
+  return sent;
+}
+
+ssize_t UDPWrap::SendBatch(uv_buf_t* bufs,
+                           size_t count,
+                           const sockaddr* addr) {
+  if (IsHandleClosing()) return UV_EBADF;
+
+  size_t msg_size = 0;
+  for (size_t i = 0; i < count; i++)
+    msg_size += bufs[i].len;
+
+  size_t sent = 0;
+  if (!UNLIKELY(env()->options()->test_udp_no_try_send)) {
+    ssize_t err = TrySendBatch(bufs, count, addr);
+    if (err < 0)
+      return err;
+    sent = err;
+    if (sent == count) {
+      // + 1 so that the JS side can distinguish 0-length async sends from
+      // 0-length sync sends.
+      return msg_size + 1;
+    }
+  }
+
+  AsyncHooks::DefaultTriggerAsyncIdScope trigger_scope(this);
+  SendWrap* req_wrap = static_cast<SendWrap*>(CreateSendWrap(msg_size));
+
+  size_t queued = count - sent - 1;
+  if (queued > 0)
+    req_wrap->batch_reqs.reset(new uv_udp_send_t[queued]);
+  for (size_t i = 0; i < queued; i++) {
+    uv_udp_send_t* req = &req_wrap->batch_reqs[i];
+    req->data = req_wrap;
+    int err = uv_udp_send(
+        req, &handle_, &bufs[sent + i], 1, addr,
+        [](uv_udp_send_t* req, int status) {
+          SendWrap* req_wrap = static_cast<SendWrap*>(req->data);
+          if (status < 0 && req_wrap->batch_status == 0)
+            req_wrap->batch_status = status;
+          if (--req_wrap->batch_pending == 0 &&
+              req_wrap->batch_dispatch_error != 0) {
+            UDPWrap* self = ContainerOf(&UDPWrap::handle_, req->handle);
+            self->OnSendDone(req_wrap, req_wrap->batch_dispatch_error);
+          }
+        });
+    if (err == 0)
+      req_wrap->batch_pending++;
+    else if (req_wrap->batch_status == 0)
+      req_wrap->batch_status = err;
+  }
+
+  int err = req_wrap->Dispatch(
+      uv_udp_send,
+      &handle_,
+      &bufs[count - 1],
+      1,
+      addr,
+      uv_udp_send_cb{[](uv_udp_send_t* req, int status) {
+        UDPWrap* self = ContainerOf(&UDPWrap::handle_, req->handle);
+        self->OnSendDone(ReqWrap<uv_udp_send_t>::from_req(req), status);
+      }});
+  if (err != 0) {
+    if (req_wrap->batch_pending == 0) {
+      delete req_wrap;
+      return err;
+    }
+    req_wrap->batch_dispatch_error = err;
+  }
+
+  return 0;
+}
+
+
 ReqWrap<uv_udp_send_t>* UDPWrap::CreateSendWrap(size_t msg_size) {
   SendWrap* req_wrap = new SendWrap(env(),
                                     current_send_req_wrap_,
@@ -608,12 +793,22 @@ ReqWrap<uv_udp_send_t>* UDPWrap::CreateSendWrap(size_t msg_size) {
 
 
 void UDPWrap::Send(const FunctionCallbackInfo<Value>& args) {
-  DoSend(args, AF_INET);
+  DoSend(args, AF_INET, false);
 }
 
 
 void UDPWrap::Send6(const FunctionCallbackInfo<Value>& args) {
-  DoSend(args, AF_INET6);
+  DoSend(args, AF_INET6, false);
+}
+
+
+void UDPWrap::SendBatch(const FunctionCallbackInfo<Value>& args) {
+  DoSend(args, AF_INET, true);
+}
+
+
+void UDPWrap::SendBatch6(const FunctionCallbackInfo<Value>& args) {
+  DoSend(args, AF_INET6, true);
 }
 
 
@@ -657,6 +852,8 @@ int UDPWrap::RecvStop() {
 
 void UDPWrap::OnSendDone(ReqWrap<uv_udp_send_t>* req, int status) {
   std::unique_ptr<SendWrap> req_wrap{static_cast<SendWrap*>(req)};
+  if (status == 0)
+    status = req_wrap->batch_status;
   if (req_wrap->have_callback()) {
     Environment* env = req_wrap->env();
     HandleScope handle_scope(env->isolate());
@@ -675,6 +872,10 @@ void UDPWrap::OnAlloc(uv_handle_t* handle,
                       uv_buf_t* buf) {
   UDPWrap* wrap = ContainerOf(&UDPWrap::handle_,
                               reinterpret_cast<uv_udp_t*>(handle));
+  if (wrap->recv_batch_ && wrap->listener() == wrap) {
+    *buf = wrap->OnAllocBatch(suggested_size);
+    return;
+  }
   *buf = wrap->listener()->OnAlloc(suggested_size);
 }
 
@@ -682,15 +883,111 @@ uv_buf_t UDPWrap::OnAlloc(size_t suggested_size) {
   return AllocatedBuffer::AllocateManaged(env(), suggested_size).release();
 }
 
+uv_buf_t UDPWrap::OnAllocBatch(size_t suggested_size) {
+  size_t size = suggested_size;
+  if (uv_udp_using_recvmmsg(&handle_))
+    size *= kRecvBatchChunks;
+  if (recv_batch_buffer_size_ < size) {
+    recv_batch_buffer_.reset(new char[size]);
+    recv_batch_buffer_size_ = size;
+  }
+  return uv_buf_init(recv_batch_buffer_.get(), size);
+}
+
 void UDPWrap::OnRecv(uv_udp_t* handle,
                      ssize_t nread,
                      const uv_buf_t* buf,
                      const sockaddr* addr,
                      unsigned int flags) {
   UDPWrap* wrap = ContainerOf(&UDPWrap::handle_, handle);
+  if (wrap->recv_batch_ && wrap->listener() == wrap) {
+    wrap->OnRecvBatch(nread, *buf, addr, flags);
+    return;
+  }
   wrap->listener()->OnRecv(nread, *buf, addr, flags);
 }
 
+void UDPWrap::OnRecvBatch(ssize_t nread,
+                          const uv_buf_t& buf,
+                          const sockaddr* addr,
+                          unsigned int flags) {
+  if (nread < 0) {
+    Environment* env = this->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+    Local<Value> argv[] = {
+        Integer::New(env->isolate(), static_cast<int32_t>(nread)),
+        object(),
+        Undefined(env->isolate()),
+        Undefined(env->isolate())};
+    MakeCallback(env->onmessage_string(), arraysize(argv), argv);
+    return;
+  }
+
+  if (addr != nullptr) {
+    RecvBatchEntry entry;
+    entry.data = buf.base;
+    entry.length = nread;
+    memcpy(&entry.addr, addr, SocketAddress::GetLength(addr));
+    recv_batch_entries_.push_back(entry);
+  }
+
+  // Datagrams read with recvmmsg() are collected until libuv signals the
+  // end of the batch with UV_UDP_MMSG_FREE. Otherwise, each datagram is a
+  // batch of its own.
+  if (!(flags & UV_UDP_MMSG_CHUNK) && !recv_batch_entries_.empty())
+    EmitRecvBatch();
+}
+
+void UDPWrap::EmitRecvBatch() {
+  Environment* env = this->env();
+  Isolate* isolate = env->isolate();
+  HandleScope handle_scope(isolate);
+  Context::Scope context_scope(env->context());
+
+  const size_t count = recv_batch_entries_.size();
+  size_t total = 0;
+  for (const RecvBatchEntry& entry : recv_batch_entries_)
+    total += entry.length;
+
+  // The offsets, lengths and ports of the datagrams, in that order.
+  Local<ArrayBuffer> ab =
+      ArrayBuffer::New(isolate, 3 * count * sizeof(uint32_t));
+  uint32_t* info = static_cast<uint32_t*>(ab->GetBackingStore()->Data());
+  MaybeStackBuffer<Local<Value>, 32> addresses(count);
+  AllocatedBuffer data = AllocatedBuffer::AllocateManaged(env, total);
+
+  // Consecutive datagrams usually come from the same sender, so the address
+  // strings are reused where possible.
+  std::string last_address;
+  Local<Value> last_address_string;
+  size_t offset = 0;
+  for (size_t i = 0; i < count; i++) {
+    const RecvBatchEntry& entry = recv_batch_entries_[i];
+    if (entry.length > 0)
+      memcpy(data.data() + offset, entry.data, entry.length);
+    info[i] = offset;
+    info[count + i] = entry.length;
+    info[2 * count + i] = SocketAddress::GetPort(&entry.addr);
+    std::string address = SocketAddress::GetAddress(&entry.addr);
+    if (last_address_string.IsEmpty() || address != last_address) {
+      last_address_string = OneByteString(isolate, address.c_str());
+      last_address = std::move(address);
+    }
+    addresses[i] = last_address_string;
+    offset += entry.length;
+  }
+  recv_batch_entries_.clear();
+
+  Local<Value> argv[] = {
+      Integer::New(isolate, static_cast<int32_t>(count)),
+      object(),
+      data.ToBuffer().ToLocalChecked(),
+      Uint32Array::New(ab, 0, 3 * count),
+      Array::New(isolate, addresses.out(), count)};
+  MakeCallback(env->onmessages_string(), arraysize(argv), argv);
+}
+
 void UDPWrap::OnRecv(ssize_t nread,
                      const uv_buf_t& buf_,
                      const sockaddr* addr,
@@ -30,6 +30,9 @@
 #include "uv.h"
 #include "v8.h"
 
+#include <memory>
+#include <vector>
+
 namespace node {
 
 class UDPWrapBase;
@@ -135,6 +138,8 @@ class UDPWrap final : public HandleWrap,
   static void Bind6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Connect6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Send6(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SendBatch6(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Disconnect(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void AddMembership(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void DropMembership(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -149,6 +154,8 @@ class UDPWrap final : public HandleWrap,
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetBroadcast(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetTTL(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetSendSegmentSize(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void BufferSize(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   // UDPListener implementation
@@ -186,14 +193,19 @@ class UDPWrap final : public HandleWrap,
             int (*F)(const typename T::HandleType*, sockaddr*, int*)>
   friend void GetSockOrPeerName(const v8::FunctionCallbackInfo<v8::Value>&);
 
-  UDPWrap(Environment* env, v8::Local<v8::Object> object);
+  UDPWrap(Environment* env, v8::Local<v8::Object> object, bool recv_batch);
 
   static void DoBind(const v8::FunctionCallbackInfo<v8::Value>& args,
                      int family);
   static void DoConnect(const v8::FunctionCallbackInfo<v8::Value>& args,
                      int family);
   static void DoSend(const v8::FunctionCallbackInfo<v8::Value>& args,
-                     int family);
+                     int family,
+                     bool batch);
+  // Sends each of `bufs` as a separate datagram. Returns the number of
+  // datagrams that were sent synchronously, or a libuv error code.
+  ssize_t TrySendBatch(uv_buf_t* bufs, size_t count, const sockaddr* addr);
+  ssize_t SendBatch(uv_buf_t* bufs, size_t count, const sockaddr* addr);
   static void SetMembership(const v8::FunctionCallbackInfo<v8::Value>& args,
                             uv_membership membership);
   static void SetSourceMembership(
@@ -209,8 +221,34 @@ class UDPWrap final : public HandleWrap,
                      const struct sockaddr* addr,
                      unsigned int flags);
 
+  // Used instead of the UDPListener methods when datagrams are delivered to
+  // JS in batches.
+  uv_buf_t OnAllocBatch(size_t suggested_size);
+  void OnRecvBatch(ssize_t nread,
+                   const uv_buf_t& buf,
+                   const sockaddr* addr,
+                   unsigned int flags);
+  void EmitRecvBatch();
+
   uv_udp_t handle_;
 
+  struct RecvBatchEntry {
+    const char* data;
+    size_t length;
+    sockaddr_storage addr;
+  };
+
+  // With recvmmsg(), libuv splits the buffer into chunks of the suggested
+  // size and fills up to this many of them at once.
+  static const size_t kRecvBatchChunks = 20;
+
+  const bool recv_batch_;
+  // The datagrams are received into a buffer that is reused, and copied into
+  // a single Buffer of the right size for each batch.
+  std::unique_ptr<char[]> recv_batch_buffer_;
+  size_t recv_batch_buffer_size_ = 0;
+  std::vector<RecvBatchEntry> recv_batch_entries_;
+
   bool current_send_has_callback_;
   v8::Local<v8::Object> current_send_req_wrap_;
 };
@@ -44,6 +44,73 @@ TEST_F(URLTest, Simple2) {
   EXPECT_EQ(simple.fragment(), "fragment");
 }
 
+TEST_F(URLTest, SimpleNormalized) {
+  URL simple("HTTP://Example.ORG:0080/a/b/?#");
+
+  EXPECT_FALSE(simple.flags() & URL_FLAGS_FAILED);
+  EXPECT_EQ(simple.protocol(), "http:");
+  EXPECT_EQ(simple.host(), "example.org");
+  EXPECT_EQ(simple.port(), -1);
+  EXPECT_EQ(simple.path(), "/a/b/");
+  EXPECT_EQ(simple.query(), "");
+  EXPECT_EQ(simple.fragment(), "");
+}
+
+TEST_F(URLTest, SimpleNoPath) {
+  URL simple("wss://example.org:65535?x=1");
+
+  EXPECT_FALSE(simple.flags() & URL_FLAGS_FAILED);
+  EXPECT_EQ(simple.port(), 65535);
+  EXPECT_EQ(simple.path(), "/");
+  EXPECT_EQ(simple.query(), "x=1");
+
+  URL error("wss://example.org:65536/");
+  EXPECT_TRUE(error.flags() & URL_FLAGS_FAILED);
+}
+
+TEST_F(URLTest, NotSimple) {
+  URL ipv4("http://0x7f.1/");
+  EXPECT_FALSE(ipv4.flags() & URL_FLAGS_FAILED);
+  EXPECT_EQ(ipv4.host(), "127.0.0.1");
+
+  URL dots("http://example.org/a/./b/../c");
+  EXPECT_FALSE(dots.flags() & URL_FLAGS_FAILED);
+  EXPECT_EQ(dots.path(), "/a/c");
+
+  URL escaped("http://example.org/a b?'#`");
+  EXPECT_FALSE(escaped.flags() & URL_FLAGS_FAILED);
+  EXPECT_EQ(escaped.path(), "/a%20b");
+  EXPECT_EQ(escaped.query(), "%27");
+  EXPECT_EQ(escaped.fragment(), "%60");
+}
+
+TEST_F(URLTest, SerializeWithComponents) {
+  node::url::url_data data;
+  const std::string input = "https://user@example.org:81/a/b?query#fragment";
+  URL::Parse(input.c_str(), input.length(), node::url::kUnknownState,
+             &data, false, nullptr, false);
+  ASSERT_FALSE(data.flags & URL_FLAGS_FAILED);
+
+  uint32_t components[node::url::kURLComponentsCount];
+  std::string href = URL::SerializeURL(&data, components);
+  EXPECT_EQ(href, input);
+  EXPECT_EQ(components[node::url::kURLComponentFlags],
+            static_cast<uint32_t>(data.flags));
+  EXPECT_EQ(href.substr(0, components[node::url::kURLComponentSchemeEnd]),
+            "https:");
+  EXPECT_EQ(components[node::url::kURLComponentUsernameStart], 8u);
+  EXPECT_EQ(components[node::url::kURLComponentUsernameEnd], 12u);
+  EXPECT_EQ(components[node::url::kURLComponentPasswordStart], 12u);
+  EXPECT_EQ(components[node::url::kURLComponentPasswordEnd], 12u);
+  EXPECT_EQ(components[node::url::kURLComponentHostStart], 13u);
+  EXPECT_EQ(components[node::url::kURLComponentHostEnd], 24u);
+  EXPECT_EQ(components[node::url::kURLComponentPort], 81u);
+  EXPECT_EQ(components[node::url::kURLComponentPathStart], 27u);
+  EXPECT_EQ(components[node::url::kURLComponentPathEnd], 31u);
+  EXPECT_EQ(components[node::url::kURLComponentQueryStart], 32u);
+  EXPECT_EQ(components[node::url::kURLComponentFragmentStart], 38u);
+}
+
 TEST_F(URLTest, ForbiddenHostCodePoint) {
   URL error("https://exa|mple.org:81/a/b/c?query#fragment");
   EXPECT_TRUE(error.flags() & URL_FLAGS_FAILED);
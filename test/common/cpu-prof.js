@@ -6,6 +6,7 @@ require('./');
 const fs = require('fs');
 const path = require('path');
 const assert = require('assert');
+const zlib = require('zlib');
 
 function getCpuProfiles(dir) {
   const list = fs.readdirSync(dir);
@@ -14,6 +15,56 @@ function getCpuProfiles(dir) {
     .map((file) => path.join(dir, file));
 }
 
+function getPprofProfiles(dir) {
+  const list = fs.readdirSync(dir);
+  return list
+    .filter((file) => file.endsWith('.pb.gz'))
+    .map((file) => path.join(dir, file));
+}
+
+// Returns the string table of a gzipped pprof profile, which contains the
+// names of all the functions in it. Only the top-level fields of the
+// `Profile` message are decoded.
+function getPprofStrings(file) {
+  const data = zlib.gunzipSync(fs.readFileSync(file));
+  let offset = 0;
+  function readVarInt() {
+    let value = 0;
+    let shift = 0;
+    let byte;
+    do {
+      byte = data[offset++];
+      value += (byte & 0x7f) * 2 ** shift;
+      shift += 7;
+    } while (byte & 0x80);
+    return value;
+  }
+  const strings = [];
+  while (offset < data.length) {
+    const tag = readVarInt();
+    const field = Math.floor(tag / 8);
+    switch (tag & 7) {
+      case 0:
+        readVarInt();
+        break;
+      case 1:
+        offset += 8;
+        break;
+      case 2: {
+        const length = readVarInt();
+        if (field === 6) {
+          strings.push(data.toString('utf8', offset, offset + length));
+        }
+        offset += length;
+        break;
+      }
+      default:
+        assert.fail(`Unexpected wire type in ${file}: ${tag & 7}`);
+    }
+  }
+  return strings;
+}
+
 function getFrames(file, suffix) {
   const data = fs.readFileSync(file, 'utf8');
   const profile = JSON.parse(data);
@@ -45,6 +96,8 @@ const env = {
 
 module.exports = {
   getCpuProfiles,
+  getPprofProfiles,
+  getPprofStrings,
   kCpuProfInterval,
   env,
   getFrames,
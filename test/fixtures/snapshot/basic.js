@@ -0,0 +1,37 @@
+'use strict';
+
+const fs = require('fs');
+const path = require('path');
+const assert = require('assert');
+const {
+  isBuildingSnapshot,
+  addSerializeCallback,
+  addDeserializeCallback,
+  setDeserializeMainFunction
+} = require('v8').startupSnapshot;
+
+assert(isBuildingSnapshot());
+
+const state = {
+  text: fs.readFileSync(path.join(__dirname, '..', 'x1024.txt'), 'utf8'),
+  serialized: false,
+  deserialized: false,
+};
+
+addSerializeCallback((state) => {
+  state.serialized = true;
+}, state);
+
+addDeserializeCallback((state) => {
+  state.deserialized = true;
+}, state);
+
+setDeserializeMainFunction((state) => {
+  assert(!isBuildingSnapshot());
+  console.log(JSON.stringify({
+    length: state.text.length,
+    serialized: state.serialized,
+    deserialized: state.deserialized,
+    argv: process.argv.slice(1),
+  }));
+}, state);
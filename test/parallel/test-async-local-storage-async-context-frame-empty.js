@@ -0,0 +1,32 @@
+// Flags: --experimental-async-context-frame
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { AsyncLocalStorage, AsyncResource } = require('async_hooks');
+
+// Promise reactions that are created while there is no AsyncContextFrame do
+// not run in whichever frame is current when they run. Here, that is the one
+// entered at the end of the file, as these are the first reactions to run.
+
+const als = new AsyncLocalStorage();
+
+// The resource is created without a frame, so running in its scope clears the
+// current frame.
+const resource = new AsyncResource('test');
+als.run('elsewhere', common.mustCall(() => {
+  resource.runInAsyncScope(common.mustCall(() => {
+    assert.strictEqual(als.getStore(), undefined);
+    Promise.resolve().then(common.mustCall(() => {
+      assert.strictEqual(als.getStore(), undefined);
+    }));
+  }));
+}));
+
+Promise.resolve().then(common.mustCall(() => {
+  assert.strictEqual(als.getStore(), undefined);
+}));
+
+als.enterWith('entered');
+setImmediate(common.mustCall(() => {
+  assert.strictEqual(als.getStore(), 'entered');
+}));
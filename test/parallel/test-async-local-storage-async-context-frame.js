@@ -0,0 +1,75 @@
+// Flags: --experimental-async-context-frame --expose-internals
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const { AsyncLocalStorage, AsyncResource } = require('async_hooks');
+const { getHookArrays } = require('internal/async_hooks');
+
+const als = new AsyncLocalStorage();
+const other = new AsyncLocalStorage();
+
+als.run('outer', common.mustCall(() => {
+  other.run('other', common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'outer');
+    assert.strictEqual(other.getStore(), 'other');
+  }));
+  assert.strictEqual(other.getStore(), undefined);
+
+  als.run('inner', () => {
+    assert.strictEqual(als.getStore(), 'inner');
+  });
+  assert.strictEqual(als.getStore(), 'outer');
+
+  als.exit(() => {
+    assert.strictEqual(als.getStore(), undefined);
+  });
+
+  // Promise reactions.
+  Promise.resolve().then(common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'outer');
+  }));
+  (async () => {
+    await null;
+    assert.strictEqual(als.getStore(), 'outer');
+  })().then(common.mustCall());
+
+  // Timers and the next tick queue.
+  setTimeout(common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'outer');
+  }), 1);
+  setImmediate(common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'outer');
+  }));
+  process.nextTick(common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'outer');
+  }));
+  queueMicrotask(common.mustCall(() => {
+    assert.strictEqual(als.getStore(), 'outer');
+  }));
+
+  // Native resources.
+  fs.stat(__filename, common.mustSucceed(() => {
+    assert.strictEqual(als.getStore(), 'outer');
+  }));
+
+  // AsyncResource.
+  const resource = new AsyncResource('test');
+  als.run('elsewhere', () => {
+    resource.runInAsyncScope(() => {
+      assert.strictEqual(als.getStore(), 'outer');
+    });
+  });
+}));
+
+assert.strictEqual(als.getStore(), undefined);
+
+als.enterWith('entered');
+setImmediate(common.mustCall(() => {
+  assert.strictEqual(als.getStore(), 'entered');
+  als.disable();
+  assert.strictEqual(als.getStore(), undefined);
+}));
+
+// Propagation does not rely on async_hooks.
+assert.strictEqual(getHookArrays()[0].length, 0);
@@ -20,6 +20,7 @@ const expectedModules = new Set([
   'Internal Binding fs_event_wrap',
   'Internal Binding heap_utils',
   'Internal Binding messaging',
+  'Internal Binding mksnapshot',
   'Internal Binding module_wrap',
   'Internal Binding native_module',
   'Internal Binding options',
@@ -43,6 +44,7 @@ const expectedModules = new Set([
   'NativeModule fs',
   'NativeModule internal/abort_controller',
   'NativeModule internal/assert',
+  'NativeModule internal/async_context_frame',
   'NativeModule internal/async_hooks',
   'NativeModule internal/bootstrap/pre_execution',
   'NativeModule internal/buffer',
@@ -109,6 +111,7 @@ const expectedModules = new Set([
   'NativeModule internal/util/inspect',
   'NativeModule internal/util/iterable_weak_map',
   'NativeModule internal/util/types',
+  'NativeModule internal/v8/startup_snapshot',
   'NativeModule internal/validators',
   'NativeModule internal/vm/module',
   'NativeModule internal/worker/io',
@@ -148,6 +151,7 @@ if (!common.isMainThread) {
     'NativeModule internal/streams/state',
     'NativeModule internal/worker',
     'NativeModule internal/worker/io',
+    'NativeModule internal/worker/pool',
     'NativeModule stream',
     'NativeModule worker_threads',
   ].forEach(expectedModules.add.bind(expectedModules));
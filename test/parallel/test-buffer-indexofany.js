@@ -0,0 +1,50 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+
+const b = Buffer.from('--boundary\r\ncontent\r\n--boundary--\r\n');
+
+assert.strictEqual(b.indexOfAny(['\r\n', '--']), 0);
+assert.strictEqual(b.indexOfAny(['\r\n', '--'], 1), 10);
+assert.strictEqual(b.indexOfAny(['\r\n--', 'content']), 12);
+assert.strictEqual(b.indexOfAny([Buffer.from('\r\n--'), 'content'], 13), 19);
+assert.strictEqual(b.indexOfAny(['nope', 'missing']), -1);
+assert.strictEqual(b.indexOfAny([]), -1);
+
+// Numbers are searched for as single bytes.
+assert.strictEqual(b.indexOfAny([0x0a, 0x0d]), 10);
+assert.strictEqual(b.indexOfAny([0x10a]), 11);
+
+// Negative offsets count from the end of the buffer.
+assert.strictEqual(b.indexOfAny(['--'], -4), 31);
+assert.strictEqual(b.indexOfAny(['--'], -100), 0);
+assert.strictEqual(b.indexOfAny(['--'], b.length), -1);
+
+// An empty value matches at the offset.
+assert.strictEqual(b.indexOfAny(['content', ''], 5), 5);
+
+// Strings are encoded with the given encoding.
+assert.strictEqual(b.indexOfAny(['636f6e74656e74'], 'hex'), 12);
+assert.strictEqual(b.indexOfAny(['636f6e74656e74'], 0, 'hex'), 12);
+assert.strictEqual(Buffer.from('aébc', 'latin1').indexOfAny(['é'], 'latin1'),
+                   1);
+
+// Longer needles and haystacks exercise the word-at-a-time search.
+{
+  const haystack = Buffer.alloc(1000, '-');
+  haystack.write('--X', 700);
+  haystack.write('-Y', 500);
+  assert.strictEqual(haystack.indexOfAny(['--X', '-Y']), 500);
+  assert.strictEqual(haystack.indexOfAny(['--X', '-Z']), 700);
+  assert.strictEqual(haystack.indexOfAny(['--X'], 701), -1);
+}
+
+assert.throws(() => b.indexOfAny('--'), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  name: 'TypeError'
+});
+assert.throws(() => b.indexOfAny(['--', {}]), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  name: 'TypeError',
+  message: /values\[1\]/
+});
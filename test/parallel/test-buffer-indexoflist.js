@@ -0,0 +1,52 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+
+const list = [
+  Buffer.from('--boun'),
+  Buffer.from('dary\r'),
+  Buffer.alloc(0),
+  new Uint8Array([0x0a]),
+  Buffer.from('content\r\n--boundary--'),
+];
+const all = Buffer.concat(list);
+
+for (const needle of ['--boundary', 'boundary', 'ary\r\nc', '\r\n', 'n', '\n',
+                      'content', '--', 'boundary--', 'missing']) {
+  for (let offset = -all.length - 1; offset <= all.length + 1; offset++) {
+    assert.strictEqual(Buffer.indexOfList(list, needle, offset),
+                       all.indexOf(needle, offset),
+                       `${JSON.stringify(needle)} at ${offset}`);
+  }
+}
+
+// Matches spanning more than two buffers.
+{
+  const chunks = ['ab', 'c', 'd', 'ef', 'g'].map((s) => Buffer.from(s));
+  assert.strictEqual(Buffer.indexOfList(chunks, 'bcdef'), 1);
+  assert.strictEqual(Buffer.indexOfList(chunks, 'cdefg'), 2);
+  assert.strictEqual(Buffer.indexOfList(chunks, 'cdefg', 3), -1);
+}
+
+assert.strictEqual(Buffer.indexOfList([], 'a'), -1);
+assert.strictEqual(Buffer.indexOfList([], ''), 0);
+assert.strictEqual(Buffer.indexOfList(list, '', 3), 3);
+assert.strictEqual(Buffer.indexOfList(list, '', 100), all.length);
+assert.strictEqual(Buffer.indexOfList(list, 0x0a), 11);
+assert.strictEqual(Buffer.indexOfList(list, Buffer.from('\r\n--')), 19);
+assert.strictEqual(Buffer.indexOfList(list, '0d0a', 'hex'), 10);
+assert.strictEqual(Buffer.indexOfList(list, '0d0a', 11, 'hex'), 19);
+
+assert.throws(() => Buffer.indexOfList('abc', 'a'), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  name: 'TypeError'
+});
+assert.throws(() => Buffer.indexOfList([Buffer.from('a'), 'b'], 'a'), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  name: 'TypeError',
+  message: /list\[1\]/
+});
+assert.throws(() => Buffer.indexOfList([Buffer.from('a')], {}), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  name: 'TypeError'
+});
@@ -0,0 +1,53 @@
+'use strict';
+
+// Tests that child processes created with `fastSpawn` behave like any other
+// child process. The option only changes how the process is created on Linux.
+
+const common = require('../common');
+const assert = require('assert');
+const os = require('os');
+const { spawn, spawnSync } = require('child_process');
+
+const script = 'console.log(process.env.FOO, process.cwd()); process.exit(3)';
+const cwd = os.tmpdir();
+const env = { ...process.env, FOO: 'bar' };
+
+{
+  const result = spawnSync(process.execPath, ['-e', script], {
+    fastSpawn: true, cwd, env, encoding: 'utf8'
+  });
+  assert.strictEqual(result.status, 3);
+  assert.strictEqual(result.stdout, `bar ${cwd}\n`);
+}
+
+{
+  // A missing executable is reported like without `fastSpawn`.
+  const result = spawnSync('node-fast-spawn-does-not-exist', {
+    fastSpawn: true
+  });
+  assert.strictEqual(result.error.code, 'ENOENT');
+}
+
+{
+  const child = spawn(process.execPath, ['-e', script], {
+    fastSpawn: true, cwd, env
+  });
+  let stdout = '';
+  child.stdout.setEncoding('utf8');
+  child.stdout.on('data', (chunk) => stdout += chunk);
+  child.on('close', common.mustCall((code) => {
+    assert.strictEqual(code, 3);
+    assert.strictEqual(stdout, `bar ${cwd}\n`);
+  }));
+}
+
+{
+  const child = spawn('node-fast-spawn-does-not-exist', { fastSpawn: true });
+  child.on('error', common.mustCall((err) => {
+    assert.strictEqual(err.code, 'ENOENT');
+  }));
+}
+
+assert.throws(() => spawn(process.execPath, { fastSpawn: 1 }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
@@ -0,0 +1,67 @@
+'use strict';
+
+// Tests the `onLine` option of spawnSync() and execFileSync(), and that large
+// outputs are collected correctly.
+
+const common = require('../common');
+const assert = require('assert');
+const { spawnSync, execFileSync } = require('child_process');
+
+function run(script, options) {
+  return spawnSync(process.execPath, ['-e', script], options);
+}
+
+{
+  const lines = { 1: [], 2: [] };
+  const result = run(
+    'process.stdout.write("a\\nb\\r\\n\\nc");' +
+    'process.stderr.write("err\\n");',
+    {
+      encoding: 'utf8',
+      onLine: common.mustCall((line, fd) => lines[fd].push(line), 5)
+    });
+  assert.strictEqual(result.status, 0);
+  assert.deepStrictEqual(lines[1], ['a', 'b', '', 'c']);
+  assert.deepStrictEqual(lines[2], ['err']);
+  assert.strictEqual(result.stdout, 'a\nb\r\n\nc');
+  assert.strictEqual(result.stderr, 'err\n');
+}
+
+{
+  // Without an encoding, lines are passed as Buffers.
+  const lines = [];
+  const output = execFileSync(process.execPath, ['-e', 'console.log("x")'], {
+    onLine: common.mustCall((line, fd) => {
+      assert.strictEqual(fd, 1);
+      lines.push(line);
+    })
+  });
+  assert.deepStrictEqual(lines, [Buffer.from('x')]);
+  assert.deepStrictEqual(output, Buffer.from('x\n'));
+}
+
+{
+  // An exception thrown by the callback kills the child process and is
+  // rethrown.
+  const error = new Error('boom');
+  assert.throws(() => {
+    run('console.log("x"); setInterval(() => {}, 1000);', {
+      onLine: common.mustCall(() => { throw error; })
+    });
+  }, error);
+}
+
+assert.throws(() => run('', { onLine: 'nope' }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+
+{
+  // Output that spans many reads ends up in a single Buffer.
+  const size = 5 * 1024 * 1024;
+  const result = run(`process.stdout.write(Buffer.alloc(${size}, 'x'))`, {
+    maxBuffer: Infinity
+  });
+  assert.strictEqual(result.status, 0);
+  assert.strictEqual(result.stdout.length, size);
+  assert(result.stdout.every((byte) => byte === 0x78));
+}
@@ -0,0 +1,56 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+// Datagrams are passed to 'messages' listeners in batches, and to 'message'
+// listeners one by one if there are any.
+const total = 50;
+const receiver = dgram.createSocket({ type: 'udp4', recvBatch: true });
+const sender = dgram.createSocket('udp4');
+const viaBatch = [];
+const viaMessage = [];
+
+receiver.on('messages', common.mustCallAtLeast((batch) => {
+  const { count, buffer, offsets, lengths, addresses, ports, family } = batch;
+  assert.ok(count >= 1);
+  assert.ok(Buffer.isBuffer(buffer));
+  assert.strictEqual(offsets.length, count);
+  assert.strictEqual(lengths.length, count);
+  assert.strictEqual(addresses.length, count);
+  assert.strictEqual(ports.length, count);
+  assert.strictEqual(family, 'IPv4');
+  for (let i = 0; i < count; i++) {
+    assert.strictEqual(addresses[i], '127.0.0.1');
+    assert.strictEqual(ports[i], sender.address().port);
+    viaBatch.push(
+      buffer.toString('latin1', offsets[i], offsets[i] + lengths[i]));
+  }
+}));
+
+receiver.on('message', common.mustCall((msg, rinfo) => {
+  assert.strictEqual(rinfo.size, msg.length);
+  assert.strictEqual(rinfo.family, 'IPv4');
+  assert.strictEqual(rinfo.address, '127.0.0.1');
+  viaMessage.push(msg.toString('latin1'));
+  if (viaMessage.length === total) {
+    const expected = [];
+    for (let i = 0; i < total; i++)
+      expected.push(i % 10 === 0 ? '' : `metric.${i}:1|c`);
+    assert.deepStrictEqual(viaBatch, expected);
+    assert.deepStrictEqual(viaMessage, expected);
+    receiver.close();
+    sender.close();
+  }
+}, total));
+
+receiver.bind(0, '127.0.0.1', common.mustCall(() => {
+  const list = [];
+  for (let i = 0; i < total; i++)
+    list.push(i % 10 === 0 ? '' : `metric.${i}:1|c`);
+  sender.sendBatch(list, receiver.address().port, '127.0.0.1');
+}));
+
+assert.throws(() => dgram.createSocket({ type: 'udp4', recvBatch: 1 }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
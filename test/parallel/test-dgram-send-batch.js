@@ -0,0 +1,63 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+// Each element passed to sendBatch() is sent as a separate datagram.
+const data = ['foo', Buffer.from('bar'), new Uint8Array([98, 97, 122]), ''];
+
+const receiver = dgram.createSocket('udp4');
+const sender = dgram.createSocket('udp4');
+const received = [];
+
+function onmessage(msg, rinfo) {
+  assert.strictEqual(rinfo.port, sender.address().port);
+  received.push(msg.toString());
+  if (received.length === data.length) {
+    receiver.removeListener('message', onmessage);
+    assert.deepStrictEqual(received, ['foo', 'bar', 'baz', '']);
+    sendMany();
+  }
+}
+receiver.on('message', onmessage);
+
+function sendMany() {
+  // Enough datagrams to need more than one sendmmsg() call. Some of them may
+  // be dropped by the receiver, so only the callback is checked.
+  const list = [];
+  for (let i = 0; i < 2000; i++)
+    list.push(`${i}`);
+  sender.sendBatch(list, receiver.address().port, common.mustSucceed((n) => {
+    assert.strictEqual(n, list.join('').length);
+    receiver.close();
+    sender.close();
+  }));
+}
+
+receiver.bind(0, common.mustCall(() => {
+  const { port } = receiver.address();
+  sender.sendBatch(data, port, 'localhost', common.mustSucceed((n) => {
+    assert.strictEqual(n, 9);
+  }));
+}));
+
+{
+  const socket = dgram.createSocket('udp4');
+  socket.sendBatch([], 1234, common.mustSucceed((n) => {
+    assert.strictEqual(n, 0);
+    socket.close();
+  }));
+
+  assert.throws(() => socket.sendBatch('foo', 1234), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  assert.throws(() => socket.sendBatch([{}], 1234), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  assert.throws(() => socket.sendBatch(['foo']), {
+    code: 'ERR_SOCKET_BAD_PORT'
+  });
+  assert.throws(() => socket.sendBatch(['foo'], 1234, 'localhost', 'cb'), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
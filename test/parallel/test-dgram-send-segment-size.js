@@ -0,0 +1,45 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const dgram = require('dgram');
+
+const socket = dgram.createSocket('udp4');
+
+assert.throws(() => socket.setSendSegmentSize(1400), {
+  code: common.isLinux ? 'EBADF' : 'ENOTSUP',
+  syscall: 'setSendSegmentSize'
+});
+
+socket.bind(0, common.mustCall(() => {
+  assert.throws(() => socket.setSendSegmentSize(-1), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+  assert.throws(() => socket.setSendSegmentSize('1400'), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+
+  try {
+    socket.setSendSegmentSize(1400);
+  } catch (err) {
+    // UDP_SEGMENT is only supported on Linux 4.18 and later.
+    assert.ok(['ENOTSUP', 'ENOPROTOOPT', 'EINVAL'].includes(err.code), err);
+    assert.strictEqual(err.syscall, 'setSendSegmentSize');
+    socket.close();
+    return;
+  }
+
+  // A datagram that is larger than the segment size arrives as several.
+  const receiver = dgram.createSocket('udp4');
+  const received = [];
+  receiver.on('message', common.mustCall((msg) => {
+    received.push(msg.length);
+    if (received.length === 3) {
+      assert.deepStrictEqual(received, [1400, 1400, 200]);
+      receiver.close();
+      socket.close();
+    }
+  }, 3));
+  receiver.bind(0, '127.0.0.1', common.mustCall(() => {
+    socket.send(Buffer.alloc(3000), receiver.address().port, '127.0.0.1');
+  }));
+}));
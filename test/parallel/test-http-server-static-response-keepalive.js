@@ -0,0 +1,29 @@
+'use strict';
+
+const common = require('../common');
+
+// This test ensures that the keep-alive timeout applies to connections
+// whose requests have only been answered by the parser with static
+// responses.
+const assert = require('assert');
+const http = require('http');
+const net = require('net');
+
+const server = http.createServer(common.mustNotCall());
+server.keepAliveTimeout = common.platformTimeout(100);
+server.setStaticResponse('GET', '/healthz', { body: 'ok' });
+
+server.listen(0, common.mustCall(() => {
+  const socket = net.connect(server.address().port);
+  let response = '';
+  socket.setEncoding('utf8');
+  socket.on('data', (chunk) => response += chunk);
+  socket.on('end', common.mustCall(() => {
+    assert.match(response, /^HTTP\/1\.1 200 OK\r\n/);
+    assert(response.endsWith('\r\n\r\nok'));
+    assert.strictEqual(server.getStaticResponseHits('GET', '/healthz'), 1);
+    socket.end();
+    server.close();
+  }));
+  socket.write('GET /healthz HTTP/1.1\r\nHost: localhost\r\n\r\n');
+}));
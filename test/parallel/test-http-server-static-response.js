@@ -0,0 +1,90 @@
+'use strict';
+
+const common = require('../common');
+
+// This test ensures that requests that match a static response registered
+// with server.setStaticResponse() are answered without emitting a 'request'
+// event, both when the parser answers them by itself and when they reach JS.
+const assert = require('assert');
+const http = require('http');
+
+const server = http.createServer(common.mustCall((req, res) => {
+  assert.strictEqual(req.url, '/');
+  res.end('hello');
+}));
+
+assert.throws(() => server.setStaticResponse('GET', '/', { statusCode: 99 }), {
+  code: 'ERR_HTTP_INVALID_STATUS_CODE',
+});
+assert.throws(() => server.setStaticResponse('GET', '/', { body: 1 }), {
+  code: 'ERR_INVALID_ARG_TYPE',
+});
+assert.throws(() => server.setStaticResponse('GET', 1), {
+  code: 'ERR_INVALID_ARG_TYPE',
+});
+for (const name of ['Content-Length', 'connection', 'Transfer-Encoding']) {
+  assert.throws(() => server.setStaticResponse('GET', '/', {
+    headers: { [name]: '1' },
+  }), {
+    code: 'ERR_INVALID_ARG_VALUE',
+  });
+}
+
+server.setStaticResponse('GET', '/healthz', {
+  headers: { 'x-health': 'ok' },
+  body: 'ok',
+});
+server.setStaticResponse('*', '/ping', { body: 'pong' });
+server.setStaticResponse('DELETE', '*', { statusCode: 405 });
+server.setStaticResponse('GET', '/gone', { statusCode: 410 });
+server.deleteStaticResponse('GET', '/gone');
+
+const agent = new http.Agent({ keepAlive: true, maxSockets: 1 });
+
+function request(method, path) {
+  return new Promise((resolve) => {
+    http.request({ port: server.address().port, method, path, agent },
+                 (res) => {
+                   let body = '';
+                   res.setEncoding('utf8');
+                   res.on('data', (chunk) => body += chunk);
+                   res.on('end', () => resolve({ res, body }));
+                 }).end();
+  });
+}
+
+server.listen(0, common.mustCall(async () => {
+  // Answered by the parser, on a new connection.
+  let { res, body } = await request('GET', '/healthz');
+  assert.strictEqual(res.statusCode, 200);
+  assert.strictEqual(res.headers['x-health'], 'ok');
+  assert.strictEqual(res.headers['content-length'], '2');
+  assert.strictEqual(body, 'ok');
+
+  ({ res, body } = await request('HEAD', '/ping'));
+  assert.strictEqual(res.statusCode, 200);
+  assert.strictEqual(res.headers['content-length'], '4');
+  assert.strictEqual(body, '');
+
+  ({ res, body } = await request('DELETE', '/anything'));
+  assert.strictEqual(res.statusCode, 405);
+  assert.strictEqual(body, '');
+
+  ({ res, body } = await request('GET', '/'));
+  assert.strictEqual(body, 'hello');
+
+  // This connection has passed a request to JS, so the static response is
+  // sent from JS now.
+  ({ res, body } = await request('GET', '/healthz'));
+  assert.strictEqual(res.statusCode, 200);
+  assert.strictEqual(res.headers['x-health'], 'ok');
+  assert.strictEqual(body, 'ok');
+
+  assert.strictEqual(server.getStaticResponseHits('GET', '/healthz'), 2);
+  assert.strictEqual(server.getStaticResponseHits('*', '/ping'), 1);
+  assert.strictEqual(server.getStaticResponseHits('DELETE', '*'), 1);
+  assert.strictEqual(server.getStaticResponseHits('GET', '/gone'), 0);
+
+  agent.destroy();
+  server.close();
+}));
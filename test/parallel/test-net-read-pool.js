@@ -0,0 +1,51 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+const { MessageChannel } = require('worker_threads');
+
+// Small reads are served from slabs that are shared between sockets. Chunks
+// that are kept around must not be overwritten by later reads, and the
+// shared ArrayBuffer must not be transferable.
+
+const N = 20;
+const MESSAGES = 50;
+let done = 0;
+
+const server = net.createServer(common.mustCall((socket) => {
+  const chunks = [];
+  socket.on('data', (chunk) => chunks.push(chunk));
+  socket.on('end', common.mustCall(() => {
+    const data = Buffer.concat(chunks).toString();
+    const id = data.slice(0, data.indexOf(':'));
+    let expected = '';
+    for (let i = 0; i < MESSAGES; i++)
+      expected += `${id}:${i};`;
+    assert.strictEqual(data, expected);
+
+    const chunk = chunks[0];
+    assert.ok(chunk.byteOffset + chunk.length <= chunk.buffer.byteLength);
+    const { port1, port2 } = new MessageChannel();
+    port1.postMessage(chunk, [chunk.buffer]);
+    assert.notStrictEqual(chunk.buffer.byteLength, 0);
+    port1.close();
+    port2.close();
+
+    socket.end();
+    if (++done === N)
+      server.close();
+  }));
+}, N));
+
+server.listen(0, common.mustCall(() => {
+  for (let n = 0; n < N; n++) {
+    const client = net.connect(server.address().port);
+    let i = 0;
+    (function writeNext() {
+      if (i === MESSAGES)
+        return client.end();
+      client.write(`${n}:${i++};`, () => setImmediate(writeNext));
+    })();
+    client.resume();
+  }
+}));
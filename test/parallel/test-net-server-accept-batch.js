@@ -0,0 +1,36 @@
+'use strict';
+
+const common = require('../common');
+
+// This test ensures that a server that uses the `acceptBatch` option still
+// emits a 'connection' event for each accepted connection.
+const assert = require('assert');
+const net = require('net');
+
+assert.throws(() => net.createServer({ acceptBatch: 'yes' }), {
+  code: 'ERR_INVALID_ARG_TYPE',
+});
+
+const N = 20;
+const server = net.createServer({ acceptBatch: true });
+
+server.on('connection', common.mustCall((socket) => {
+  assert.strictEqual(socket.server, server);
+  socket.end('ok');
+}, N));
+
+server.listen(0, common.mustCall(() => {
+  const { port } = server.address();
+  let closed = 0;
+  for (let i = 0; i < N; i++) {
+    const socket = net.connect(port);
+    socket.setEncoding('utf8');
+    socket.on('data', common.mustCall((data) => {
+      assert.strictEqual(data, 'ok');
+    }));
+    socket.on('close', common.mustCall(() => {
+      if (++closed === N)
+        server.close();
+    }));
+  }
+}));
@@ -0,0 +1,38 @@
+'use strict';
+
+const common = require('../common');
+
+// This test ensures that connections from addresses that are denied by the
+// `blockList` option of a server are dropped before a socket is created for
+// them, and that rules added later on apply to new connections.
+const assert = require('assert');
+const net = require('net');
+
+assert.throws(() => net.createServer({ blockList: {} }), {
+  code: 'ERR_INVALID_ARG_TYPE',
+});
+
+const blockList = new net.BlockList();
+let connections = 0;
+const server = net.createServer({ blockList }, common.mustCall((socket) => {
+  connections++;
+  socket.end('ok');
+}));
+
+server.listen(0, '127.0.0.1', common.mustCall(() => {
+  const { port } = server.address();
+
+  net.connect(port, '127.0.0.1').on('data', common.mustCall((data) => {
+    assert.strictEqual(data.toString(), 'ok');
+
+    blockList.addAddress('127.0.0.1');
+    const socket = net.connect(port, '127.0.0.1');
+    socket.on('data', common.mustNotCall());
+    socket.on('close', common.mustCall(() => {
+      assert.strictEqual(connections, 1);
+      server.close();
+    }));
+    // The connection is reset by the server.
+    socket.on('error', () => {});
+  }));
+}));
@@ -0,0 +1,35 @@
+'use strict';
+
+const common = require('../common');
+if (!common.isLinux)
+  common.skip('SO_REUSEPORT load balancing is only tested on Linux');
+
+// This test ensures that two servers can listen on the same port when both
+// of them set the `reusePort` option, and that they cannot otherwise.
+const assert = require('assert');
+const net = require('net');
+
+assert.throws(() => net.createServer().listen({ port: 0, reusePort: 1 }), {
+  code: 'ERR_INVALID_ARG_TYPE',
+});
+
+const first = net.createServer(common.mustNotCall());
+first.listen({ port: 0, host: '127.0.0.1', reusePort: true },
+             common.mustCall(() => {
+               const { port } = first.address();
+
+               const other = net.createServer();
+               other.listen({ port, host: '127.0.0.1' });
+               other.on('error', common.mustCall((err) => {
+                 assert.strictEqual(err.code, 'EADDRINUSE');
+
+                 const second = net.createServer();
+                 second.listen({ port, host: '127.0.0.1', reusePort: true },
+                               common.mustCall(() => {
+                                 assert.strictEqual(second.address().port,
+                                                    port);
+                                 second.close();
+                                 first.close();
+                               }));
+               }));
+             }));
@@ -0,0 +1,55 @@
+// Flags: --expose-internals
+'use strict';
+
+// Tests that the timeout of a socket with a TCP handle is kept natively, is
+// refreshed by the data that is read without a JS timer and still fires once
+// the socket goes idle.
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+const { kTimeout } = require('internal/timers');
+
+const kTimeoutMs = common.platformTimeout(200);
+const kChunks = 10;
+
+const server = net.createServer(common.mustCall((conn) => {
+  let sent = 0;
+  const interval = setInterval(() => {
+    conn.write('x');
+    if (++sent === kChunks)
+      clearInterval(interval);
+  }, kTimeoutMs / 4);
+  conn.on('error', () => {});
+}, 2));
+
+server.listen(0, common.mustCall(() => {
+  const { port } = server.address();
+
+  const socket = net.connect(port, common.mustCall(() => {
+    socket.setTimeout(kTimeoutMs, common.mustCall(() => {
+      assert.strictEqual(received, kChunks);
+      assert(Date.now() - lastRead >= kTimeoutMs - 1);
+      socket.destroy();
+      server.close();
+    }));
+    assert.strictEqual(socket[kTimeout], null);
+    assert.strictEqual(socket.timeout, kTimeoutMs);
+  }));
+
+  let received = 0;
+  let lastRead;
+  socket.on('data', (data) => {
+    received += data.length;
+    lastRead = Date.now();
+  });
+
+  // A timeout that is disabled again does not fire.
+  const other = net.connect(port, common.mustCall(() => {
+    other.setTimeout(1);
+    other.setTimeout(0);
+    other.on('timeout', common.mustNotCall());
+    socket.on('close', () => other.destroy());
+  }));
+  other.resume();
+}));
@@ -0,0 +1,107 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+// Small writes made from separate ticks while write coalescing is enabled
+// arrive intact and in order, interleaved with writes that are too large to
+// be coalesced.
+
+const chunks = [];
+for (let i = 0; i < 200; i++)
+  chunks.push(i % 50 === 0 ? 'x'.repeat(32 * 1024) : `chunk ${i};`);
+const expected = chunks.join('');
+
+const server = net.createServer(common.mustCall((socket) => {
+  assert.strictEqual(socket.setWriteCoalescing(), socket);
+
+  let i = 0;
+  function writeNext() {
+    if (i === chunks.length) {
+      socket.end(common.mustCall(() => {
+        assert.strictEqual(socket.bytesWritten, expected.length);
+      }));
+      return;
+    }
+    const chunk = chunks[i++];
+    // Alternate between the string and the buffer code paths.
+    socket.write(i % 2 ? chunk : Buffer.from(chunk), common.mustSucceed());
+    if (i % 3 === 0)
+      setImmediate(writeNext);
+    else
+      process.nextTick(writeNext);
+  }
+  writeNext();
+}));
+
+server.listen(0, common.mustCall(() => {
+  const client = net.connect(server.address().port);
+  let received = '';
+  client.setEncoding('utf8');
+  client.on('data', (data) => received += data);
+  client.on('end', common.mustCall(() => {
+    assert.strictEqual(received, expected);
+    server.close();
+  }));
+}));
+
+{
+  // Data that has been reported as written is not lost when the socket is
+  // ended before the coalesced writes have been written out.
+  const data = 'y'.repeat(1024);
+  const server = net.createServer(common.mustCall((socket) => {
+    socket.setWriteCoalescing();
+    for (let i = 0; i < 32; i++)
+      socket.write(data, common.mustSucceed());
+    socket.end();
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    const client = net.connect(server.address().port);
+    let received = 0;
+    client.on('data', (chunk) => received += chunk.length);
+    client.on('end', common.mustCall(() => {
+      assert.strictEqual(received, 32 * data.length);
+      server.close();
+    }));
+  }));
+}
+
+{
+  // Destroying the socket closes it right away, even while coalesced data
+  // cannot be written out because the peer does not read.
+  const data = 'z'.repeat(16 * 1024);
+  let client;
+  const server = net.createServer(common.mustCall((socket) => {
+    socket.setWriteCoalescing();
+    socket.on('close', common.mustCall(() => {
+      client.destroy();
+      server.close();
+    }));
+    function writeMore() {
+      for (let i = 0; i < 64; i++)
+        socket.write(data);
+      if (socket.writableLength === 0) {
+        setImmediate(writeMore);
+        return;
+      }
+      // The kernel buffers are full and the write of the remainder of the
+      // coalesced data is pending.
+      socket.destroy();
+    }
+    writeMore();
+  }));
+
+  server.listen(0, common.mustCall(() => {
+    client = net.connect(server.address().port);
+    client.pause();
+  }));
+}
+
+{
+  const socket = new net.Socket();
+  assert.throws(() => socket.setWriteCoalescing('yes'), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+  assert.strictEqual(socket.setWriteCoalescing(false), socket);
+}
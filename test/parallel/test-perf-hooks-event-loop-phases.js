@@ -0,0 +1,64 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const net = require('net');
+const { monitorEventLoopPhases } = require('perf_hooks');
+
+const monitor = monitorEventLoopPhases();
+assert.strictEqual(monitorEventLoopPhases(), monitor);
+assert.throws(() => new monitor.constructor(), {
+  name: 'TypeError',
+  message: 'illegal constructor',
+});
+
+const phases = ['timers', 'pending', 'poll', 'check', 'close'];
+
+function assertEmpty(snapshot) {
+  assert.strictEqual(snapshot.iterations, 0);
+  assert.deepStrictEqual(Object.keys(snapshot.phases), phases);
+  for (const phase of phases)
+    assert.deepStrictEqual(snapshot.phases[phase], { count: 0, duration: 0 });
+  assert.deepStrictEqual(snapshot.providers, {});
+}
+
+assertEmpty(monitor.snapshot());
+assert.strictEqual(monitor.enable(), true);
+assert.strictEqual(monitor.enable(), false);
+
+setTimeout(common.mustCall(() => {
+  setImmediate(common.mustCall(() => {
+    fs.readFile(__filename, common.mustSucceed(() => {
+      const server = net.createServer((socket) => socket.end());
+      server.listen(0, common.mustCall(() => {
+        const client = net.connect(server.address().port);
+        client.resume();
+        client.on('close', common.mustCall(() => {
+          server.close(common.mustCall(() => setTimeout(check, 1)));
+        }));
+      }));
+    }));
+  }));
+}), 1);
+
+function check() {
+  const snapshot = monitor.snapshot();
+  assert(snapshot.iterations > 0);
+  for (const phase of ['timers', 'poll', 'check', 'close']) {
+    const { count, duration } = snapshot.phases[phase];
+    assert(count > 0, `no callbacks in the ${phase} phase`);
+    assert(duration >= 0);
+  }
+  assert(snapshot.providers.NONE.count > 0);
+  assert(snapshot.providers.FSREQCALLBACK.count > 0);
+  assert(snapshot.providers.TCPWRAP.count > 0);
+  assert.strictEqual(snapshot.providers.HTTPPARSER, undefined);
+
+  monitor.reset();
+  assert.strictEqual(monitor.disable(), true);
+  assert.strictEqual(monitor.disable(), false);
+  setImmediate(common.mustCall(() => {
+    assertEmpty(monitor.snapshot());
+  }));
+}
@@ -0,0 +1,56 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const { monitorEventLoopStalls } = require('perf_hooks');
+
+[1, '', null, false].forEach((options) => {
+  assert.throws(() => monitorEventLoopStalls(options), {
+    code: 'ERR_INVALID_ARG_TYPE',
+  });
+});
+
+['a', null, false, {}, []].forEach((threshold) => {
+  assert.throws(() => monitorEventLoopStalls({ threshold }), {
+    code: 'ERR_INVALID_ARG_TYPE',
+  });
+});
+
+[-1, 0, 1.5, 2 ** 32, Infinity].forEach((threshold) => {
+  assert.throws(() => monitorEventLoopStalls({ threshold }), {
+    code: 'ERR_OUT_OF_RANGE',
+  });
+});
+
+[1, 'a', null, {}].forEach((report) => {
+  assert.throws(() => monitorEventLoopStalls({ report }), {
+    code: 'ERR_INVALID_ARG_TYPE',
+  });
+});
+
+function blockEventLoop(ms) {
+  const end = Date.now() + ms;
+  while (Date.now() < end);
+}
+
+{
+  const monitor = monitorEventLoopStalls({ threshold: 50 });
+  assert.strictEqual(monitor.enable(), true);
+  assert.strictEqual(monitor.enable(), false);
+
+  // The monitor does not keep the process alive.
+  const keepAlive = setInterval(() => {}, 1000);
+
+  monitor.on('stall', common.mustCall(({ duration, stack }) => {
+    assert(duration >= 50, `duration ${duration} is too short`);
+    assert.match(stack, /^ {4}at blockEventLoop \(.+:\d+:\d+\)$/m);
+    assert.strictEqual(monitor.disable(), true);
+    assert.strictEqual(monitor.disable(), false);
+    clearInterval(keepAlive);
+
+    // Nothing is detected once the monitor is disabled.
+    blockEventLoop(200);
+  }));
+
+  setTimeout(common.mustCall(() => blockEventLoop(500)), 10);
+}
@@ -4,9 +4,11 @@ const common = require('../common');
 const assert = require('assert');
 const {
   createHistogram,
+  importHistogram,
   monitorEventLoopDelay,
 } = require('perf_hooks');
 const { inspect } = require('util');
+const { Worker } = require('worker_threads');
 
 {
   const h = createHistogram();
@@ -83,3 +85,122 @@ const { inspect } = require('util');
     /^TypeError: illegal constructor$/
   );
 }
+
+{
+  [1, 'foo', null].forEach((options) => {
+    assert.throws(() => createHistogram(options), {
+      code: 'ERR_INVALID_ARG_TYPE'
+    });
+  });
+  [
+    { min: 0 }, { min: 0n }, { max: 1 }, { min: 10, max: 19 },
+    { min: 10n, max: 19n }, { figures: 0 }, { figures: 6 },
+  ].forEach((options) => {
+    assert.throws(() => createHistogram(options), {
+      code: 'ERR_OUT_OF_RANGE'
+    });
+  });
+  assert.throws(() => createHistogram({ atomic: 1 }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+
+  const h = createHistogram({ min: 1n, max: 100n, figures: 1 });
+  h.record(50);
+  assert.strictEqual(h.count, 1);
+}
+
+{
+  const h1 = createHistogram();
+  const h2 = createHistogram();
+  for (let i = 1; i <= 100; i++) {
+    h1.record(i);
+    h2.record(i + 100);
+  }
+  h1.add(h2);
+  assert.strictEqual(h1.count, 200);
+  assert.strictEqual(h1.min, 1);
+  assert.strictEqual(h1.max, 200);
+  assert.strictEqual(h1.percentile(50), 100);
+  assert.strictEqual(h2.count, 100);
+
+  h1.add(h1);
+  assert.strictEqual(h1.count, 400);
+
+  // Values that are out of range are counted as exceeding it.
+  const large = createHistogram();
+  large.record(1e9);
+  large.record(1e9);
+  const small = createHistogram({ max: 10 });
+  small.add(large);
+  assert.strictEqual(small.count, 0);
+  assert.strictEqual(small.exceeds, 2);
+
+  [1, {}, null].forEach((i) => {
+    assert.throws(() => h1.add(i), {
+      code: 'ERR_INVALID_ARG_TYPE'
+    });
+  });
+}
+
+{
+  const h = createHistogram();
+  // The V2 compressed encoding starts with the bytes 0x1c849314.
+  assert(h.export().toString('base64').startsWith('HISTF'));
+  assert.strictEqual(importHistogram(h.export()).count, 0);
+
+  for (let i = 1; i <= 10000; i++)
+    h.record(i * 7);
+  const data = h.export();
+  assert(Buffer.isBuffer(data));
+  const copy = importHistogram(data);
+  assert.strictEqual(copy.count, h.count);
+  assert.strictEqual(copy.min, h.min);
+  assert.strictEqual(copy.max, h.max);
+  assert.strictEqual(copy.mean, h.mean);
+  assert.deepStrictEqual(copy.percentiles, h.percentiles);
+  copy.record(1);
+  assert.strictEqual(copy.count, h.count + 1);
+
+  assert.deepStrictEqual(
+    importHistogram(new Uint8Array(data)).percentiles, h.percentiles);
+  assert.throws(() => importHistogram(data.subarray(0, data.length - 1)), {
+    code: 'ERR_INVALID_ARG_VALUE'
+  });
+  assert.throws(() => importHistogram(Buffer.from('foo')), {
+    code: 'ERR_INVALID_ARG_VALUE'
+  });
+  ['foo', 1, {}].forEach((i) => {
+    assert.throws(() => importHistogram(i), {
+      code: 'ERR_INVALID_ARG_TYPE'
+    });
+  });
+  assert.throws(() => importHistogram(data, { atomic: 'yes' }), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+
+{
+  // Atomic histograms can be recorded into from several threads at once.
+  const h = createHistogram({ atomic: true });
+  const kWorkers = 4;
+  let done = 0;
+  for (let n = 0; n < kWorkers; n++) {
+    const worker = new Worker(`
+      const { parentPort } = require('worker_threads');
+      parentPort.once('message', (h) => {
+        for (let i = 1; i <= 1000; i++)
+          h.record(i);
+        parentPort.postMessage('done');
+      });
+    `, { eval: true });
+    worker.postMessage(h);
+    worker.once('message', common.mustCall(() => {
+      worker.terminate();
+      if (++done < kWorkers)
+        return;
+      assert.strictEqual(h.count, kWorkers * 1000);
+      assert.strictEqual(h.min, 1);
+      assert.strictEqual(h.max, 1000);
+    }));
+  }
+}
@@ -0,0 +1,88 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const http = require('http');
+const { once } = require('events');
+const {
+  createHistogram,
+  monitorHttpRoutes,
+} = require('perf_hooks');
+
+const monitor = monitorHttpRoutes();
+assert.strictEqual(monitorHttpRoutes(), monitor);
+assert.throws(
+  () => new monitor.constructor(),
+  /^TypeError: illegal constructor$/
+);
+
+const parse = createHistogram();
+const response = createHistogram();
+const bytes = createHistogram();
+const other = createHistogram();
+monitor.setRoute(1, { parse, response, bytes });
+monitor.setRoute(0, { response: other });
+
+[-1, 0x10000, 1.5].forEach((id) => {
+  assert.throws(() => monitor.setRoute(id, {}), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+});
+[null, 1].forEach((histograms) => {
+  assert.throws(() => monitor.setRoute(1, histograms), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+});
+assert.throws(() => monitor.setRoute(1, { parse: {} }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => monitor.setRequestRoute({}, 1), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+
+assert.strictEqual(monitor.enable(), true);
+assert.strictEqual(monitor.enable(), false);
+
+const body = 'x'.repeat(100);
+const kDelay = 10;
+
+const server = http.createServer(common.mustCall((req, res) => {
+  if (req.url === '/one')
+    monitor.setRequestRoute(req, 1);
+  req.resume();
+  req.on('end', () => setTimeout(() => res.end('ok'), kDelay));
+}, 4));
+
+async function request(path) {
+  const req = http.request({
+    port: server.address().port,
+    method: 'POST',
+    path,
+  });
+  req.end(body);
+  const [res] = await once(req, 'response');
+  res.resume();
+  await once(res, 'end');
+}
+
+server.listen(0, common.mustCall(async () => {
+  await request('/one');
+  await request('/two');
+  await request('/one');
+
+  assert.strictEqual(parse.count, 2);
+  assert.strictEqual(response.count, 2);
+  assert.strictEqual(bytes.count, 2);
+  assert.strictEqual(other.count, 1);
+  assert(response.min >= (kDelay - 1) * 1e6, `${response.min}`);
+  // The URL, the headers and the body.
+  assert(bytes.min > '/one'.length + body.length, `${bytes.min}`);
+
+  // Nothing is recorded while the monitor is disabled.
+  assert.strictEqual(monitor.disable(), true);
+  assert.strictEqual(monitor.disable(), false);
+  await request('/one');
+  assert.strictEqual(response.count, 2);
+
+  server.close();
+}));
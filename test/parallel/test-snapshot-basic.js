@@ -0,0 +1,83 @@
+'use strict';
+
+// This tests that a user-land snapshot can be built from a single-file
+// application and that the application can be started from it.
+
+require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const tmpdir = require('../common/tmpdir');
+const fixtures = require('../common/fixtures');
+const path = require('path');
+const fs = require('fs');
+
+tmpdir.refresh();
+const blobPath = path.join(tmpdir.path, 'snapshot.blob');
+const entry = fixtures.path('snapshot', 'basic.js');
+
+{
+  // --build-snapshot requires an entry point script.
+  const child = spawnSync(process.execPath, [
+    '--snapshot-blob',
+    blobPath,
+    '--build-snapshot',
+  ], {
+    cwd: tmpdir.path
+  });
+  assert.strictEqual(child.status, 9);
+  assert.match(child.stderr.toString(), /must be used with an entry point/);
+}
+
+{
+  const child = spawnSync(process.execPath, [
+    '--snapshot-blob',
+    blobPath,
+    '--build-snapshot',
+    entry,
+  ], {
+    cwd: tmpdir.path
+  });
+  if (child.status !== 0) {
+    console.log(child.stderr.toString());
+    console.log(child.stdout.toString());
+    assert.strictEqual(child.status, 0);
+  }
+  const stats = fs.statSync(blobPath);
+  assert(stats.isFile());
+}
+
+{
+  const child = spawnSync(process.execPath, [
+    '--snapshot-blob',
+    blobPath,
+    'hello',
+    'world',
+  ], {
+    cwd: tmpdir.path
+  });
+  if (child.status !== 0) {
+    console.log(child.stderr.toString());
+    console.log(child.stdout.toString());
+    assert.strictEqual(child.status, 0);
+  }
+  assert.deepStrictEqual(JSON.parse(child.stdout.toString()), {
+    length: fs.readFileSync(fixtures.path('x1024.txt'), 'utf8').length,
+    serialized: true,
+    deserialized: true,
+    argv: ['hello', 'world'],
+  });
+}
+
+{
+  // A blob that is not written by --build-snapshot is rejected.
+  const invalidBlobPath = path.join(tmpdir.path, 'invalid.blob');
+  fs.writeFileSync(invalidBlobPath, 'invalid');
+  const child = spawnSync(process.execPath, [
+    '--snapshot-blob',
+    invalidBlobPath,
+  ], {
+    cwd: tmpdir.path
+  });
+  assert.strictEqual(child.status, 1);
+  assert.match(child.stderr.toString(), /Cannot load snapshot blob/);
+}
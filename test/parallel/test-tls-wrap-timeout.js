@@ -2,7 +2,7 @@
 
 'use strict';
 const common = require('../common');
-const { kTimeout, TIMEOUT_MAX } = require('internal/timers');
+const { kTimeout } = require('internal/timers');
 
 if (!common.hasCrypto)
   common.skip('missing crypto');
@@ -17,39 +17,52 @@ const options = {
   cert: fixtures.readKey('agent1-cert.pem')
 };
 
+// The server keeps sending data for longer than the timeout of the client's
+// underlying socket, so that the timeout only stays silent if the TLS traffic
+// refreshes it.
+const timeout = common.platformTimeout(500);
+const writes = 20;
+const interval = timeout / 10;
+
 const server = tls.createServer(options, common.mustCall((c) => {
-  setImmediate(() => {
-    c.write('hello', () => {
-      setImmediate(() => {
-        c.destroy();
-        server.close();
-      });
-    });
-  });
+  let count = 0;
+  const timer = setInterval(() => {
+    c.write('hello');
+    if (++count === writes) {
+      clearInterval(timer);
+      c.end();
+      server.close();
+    }
+  }, interval);
 }));
 
 let socket;
-let lastIdleStart;
 
 server.listen(0, () => {
   socket = net.connect(server.address().port, function() {
-    const s = socket.setTimeout(TIMEOUT_MAX, function() {
-      throw new Error('timeout');
-    });
+    const s = socket.setTimeout(timeout, common.mustNotCall('timeout'));
     assert.ok(s instanceof net.Socket);
 
-    assert.notStrictEqual(socket[kTimeout]._idleTimeout, -1);
-    lastIdleStart = socket[kTimeout]._idleStart;
+    // The timeout is kept by the TCP handle, which also refreshes it for the
+    // data read and written through the TLS socket wrapping it.
+    assert.strictEqual(socket[kTimeout], null);
+    assert.strictEqual(socket.timeout, timeout);
 
     const tsocket = tls.connect({
       socket: socket,
       rejectUnauthorized: false
     });
-    tsocket.resume();
+    let received = '';
+    tsocket.setEncoding('utf8');
+    tsocket.on('data', (data) => received += data);
+    tsocket.on('end', common.mustCall(() => {
+      assert.strictEqual(received, 'hello'.repeat(writes));
+      socket.setTimeout(0);
+      tsocket.destroy();
+    }));
   });
 });
 
 process.on('exit', () => {
-  assert.strictEqual(socket[kTimeout]._idleTimeout, -1);
-  assert(lastIdleStart < socket[kTimeout]._idleStart);
+  assert.strictEqual(socket[kTimeout], null);
 });
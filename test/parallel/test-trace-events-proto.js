@@ -0,0 +1,102 @@
+'use strict';
+const common = require('../common');
+const tmpdir = require('../common/tmpdir');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+// Tests that --trace-event-format=proto writes a Perfetto protobuf trace.
+
+tmpdir.refresh();
+
+const CODE =
+  'setTimeout(() => { for (let i = 0; i < 100000; i++) { "test" + i } }, 1)';
+
+function readVarInt(data, state) {
+  let value = 0;
+  let shift = 0;
+  let byte;
+  do {
+    byte = data[state.pos++];
+    value += (byte & 0x7f) * 2 ** shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return value;
+}
+
+// Returns the field numbers and payloads of the length-delimited fields of a
+// message, skipping varint fields. Fails on other wire types.
+function readFields(data) {
+  const fields = [];
+  const state = { pos: 0 };
+  while (state.pos < data.length) {
+    const tag = readVarInt(data, state);
+    const field = Math.floor(tag / 8);
+    const wireType = tag % 8;
+    if (wireType === 0) {
+      readVarInt(data, state);
+    } else if (wireType === 1) {
+      state.pos += 8;
+    } else {
+      assert.strictEqual(wireType, 2);
+      const length = readVarInt(data, state);
+      fields.push({ field, payload: data.subarray(state.pos,
+                                                  state.pos + length) });
+      state.pos += length;
+    }
+  }
+  assert.strictEqual(state.pos, data.length);
+  return fields;
+}
+
+const proc = cp.spawn(process.execPath, [
+  '--trace-events-enabled',
+  '--trace-event-format=proto',
+  '--trace-event-file-pattern',
+  // eslint-disable-next-line no-template-curly-in-string
+  '${pid}-${rotation}.pftrace',
+  '-e', CODE,
+], { cwd: tmpdir.path });
+
+proc.once('exit', common.mustCall(() => {
+  const file = path.join(tmpdir.path, `${proc.pid}-1.pftrace`);
+  const data = fs.readFileSync(file);
+
+  // The file is a `Trace` message, i.e. a sequence of `TracePacket`s in
+  // field 1.
+  const packets = readFields(data);
+  assert(packets.length > 0);
+  for (const { field } of packets)
+    assert.strictEqual(field, 1);
+
+  // Timestamps are relative to the clock snapshot in the first packet.
+  const first = readFields(packets[0].payload).map(({ field }) => field);
+  assert(first.includes(6));  // clock_snapshot
+
+  let trackEvents = 0;
+  const interned = new Set();
+  for (const { payload } of packets) {
+    for (const { field, payload: value } of readFields(payload)) {
+      if (field === 11) {  // track_event
+        trackEvents++;
+      } else if (field === 12) {  // interned_data
+        for (const { payload: entry } of readFields(value)) {
+          for (const { payload: name } of readFields(entry))
+            interned.add(name.toString());
+        }
+      }
+    }
+  }
+  assert(trackEvents > 0);
+  // Category names are interned.
+  assert(interned.has('v8') || interned.has('node'), [...interned].join());
+}));
+
+{
+  const { status, stderr } = cp.spawnSync(process.execPath, [
+    '--trace-event-format=xml', '-e', '0',
+  ]);
+  assert.notStrictEqual(status, 0);
+  assert.match(stderr.toString(), /invalid value for --trace-event-format/);
+}
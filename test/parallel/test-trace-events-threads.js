@@ -0,0 +1,67 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const { Worker, isMainThread } = require('worker_threads');
+
+// Records complete trace events from several threads at once. There are
+// enough of them for the trace buffer to write out full chunks while the
+// threads are still running, but not enough for any event to be dropped.
+
+const kWorkers = 4;
+const kRuns = 20000;
+const kSlowRuns = 20;
+const kSlowRunUs = 2000;
+
+if (!isMainThread) {
+  const vm = require('vm');
+  const fast = new vm.Script('1 + 1');
+  const slow = new vm.Script(`
+    const start = process.hrtime.bigint();
+    while (process.hrtime.bigint() - start < ${kSlowRunUs * 1000}n);
+  `);
+  for (let i = 0; i < kRuns; i++) {
+    fast.runInThisContext();
+    if (i % (kRuns / kSlowRuns) === 0)
+      slow.runInThisContext();
+  }
+} else if (process.argv[2] === 'child') {
+  for (let i = 0; i < kWorkers; i++)
+    new Worker(__filename);
+} else {
+  const tmpdir = require('../common/tmpdir');
+  tmpdir.refresh();
+
+  const proc = cp.fork(__filename,
+                       [ 'child' ], {
+                         cwd: tmpdir.path,
+                         execArgv: [
+                           '--trace-event-categories',
+                           'v8',
+                         ]
+                       });
+
+  proc.once('exit', common.mustCall((code) => {
+    assert.strictEqual(code, 0);
+    const file = path.join(tmpdir.path, 'node_trace.1.log');
+    fs.readFile(file, common.mustSucceed((data) => {
+      const executions = JSON.parse(data.toString()).traceEvents
+        .filter((trace) => trace.name === 'V8.Execute' && trace.ph === 'X');
+
+      // Every worker thread has recorded its own events.
+      const threads = new Set(executions.map((trace) => trace.tid));
+      assert(threads.size >= kWorkers);
+      assert(executions.length >= kWorkers * (kRuns + kSlowRuns));
+
+      // The durations of complete events are recorded even when other
+      // threads cause chunks to be written out in the meantime.
+      for (const trace of executions)
+        assert.strictEqual(typeof trace.dur, 'number');
+      const slow = executions.filter((trace) => trace.dur >= kSlowRunUs);
+      assert(slow.length >= kWorkers * kSlowRuns,
+             `${slow.length} slow events`);
+    }));
+  }));
+}
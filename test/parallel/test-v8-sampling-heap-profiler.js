@@ -0,0 +1,82 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const v8 = require('v8');
+const { getPprofStrings } = require('../common/cpu-prof');
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+
+assert.throws(() => v8.writeHeapProfile(), {
+  code: 'ERR_INVALID_STATE'
+});
+
+for (const options of [null, 'foo', 1]) {
+  assert.throws(() => v8.startSamplingHeapProfiler(options), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+assert.throws(() => v8.startSamplingHeapProfiler({ samplingInterval: 0 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
+assert.throws(() => v8.startSamplingHeapProfiler({ stackDepth: 1.5 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
+assert.throws(() => v8.startSamplingHeapProfiler({ writeInterval: -1 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
+
+// Stopping the profiler when it is not running does nothing.
+v8.stopSamplingHeapProfiler();
+
+const retained = [];
+function allocateRetainedArrays() {
+  for (let i = 0; i < 1000; i++)
+    retained.push(new Array(1000).fill(i));
+}
+
+{
+  v8.startSamplingHeapProfiler({ samplingInterval: 1024 });
+  assert.throws(() => v8.startSamplingHeapProfiler(), {
+    code: 'ERR_INVALID_STATE'
+  });
+  allocateRetainedArrays();
+
+  const file = path.join(tmpdir.path, 'profile.pb.gz');
+  assert.strictEqual(v8.writeHeapProfile(file), file);
+  const strings = getPprofStrings(file);
+  assert.strictEqual(strings[0], '');
+  assert(strings.includes('objects'));
+  assert(strings.includes('space'));
+  assert(strings.includes('bytes'));
+  assert(strings.includes('allocateRetainedArrays'));
+  assert(strings.includes(__filename));
+  // Native memory retained by Node.js objects is included as well.
+  assert(strings.includes('(native)'));
+
+  v8.stopSamplingHeapProfiler();
+  assert.throws(() => v8.writeHeapProfile(), {
+    code: 'ERR_INVALID_STATE'
+  });
+}
+
+// Profiles are written periodically with `writeInterval`.
+{
+  const directory = path.join(tmpdir.path, 'periodic');
+  fs.mkdirSync(directory);
+  v8.startSamplingHeapProfiler({ writeInterval: 10, directory });
+  const interval = setInterval(common.mustCallAtLeast(() => {
+    allocateRetainedArrays();
+    const files = fs.readdirSync(directory);
+    if (files.length < 2)
+      return;
+    clearInterval(interval);
+    v8.stopSamplingHeapProfiler();
+    for (const file of files) {
+      assert.match(file, /^Heap\..+\.pb\.gz$/);
+      getPprofStrings(path.join(directory, file));
+    }
+  }), 10);
+}
@@ -0,0 +1,111 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fixtures = require('../common/fixtures');
+const { WorkerPool, resourceLimits } = require('worker_threads');
+
+// Do not use isMainThread so that this test itself can be run inside a Worker.
+if (process.env.HAS_STARTED_WORKER) {
+  module.exports = (task) => {
+    switch (task.type) {
+      case 'square':
+        return task.n * task.n;
+      case 'async':
+        return new Promise((resolve) => setImmediate(resolve, task.n));
+      case 'throw':
+        throw new Error('boom');
+      case 'add':
+        return Atomics.add(task.shared, 0, 1);
+      case 'length':
+        return task.buffer.byteLength;
+      case 'limits':
+        return resourceLimits.maxOldGenerationSizeMb;
+      case 'exit':
+        process.exit(0);
+        break;
+      case 'crash':
+        setImmediate(() => {
+          throw new Error('crash');
+        });
+        return new Promise(() => {});
+    }
+  };
+} else {
+  process.env.HAS_STARTED_WORKER = 1;
+
+  const pool = new WorkerPool(__filename, {
+    size: 2,
+    resourceLimits: { maxOldGenerationSizeMb: 64 },
+  });
+  assert.strictEqual(pool.size, 2);
+  pool.on('error', common.mustCall((err) => {
+    assert.strictEqual(err.message, 'crash');
+  }));
+
+  (async () => {
+    const numbers = Array.from({ length: 100 }, (_, i) => i);
+    const results =
+      await Promise.all(numbers.map((n) => pool.run({ type: 'square', n })));
+    assert.deepStrictEqual(results, numbers.map((n) => n * n));
+
+    assert.strictEqual(await pool.run({ type: 'async', n: 3 }), 3);
+    await assert.rejects(pool.run({ type: 'throw' }), { message: 'boom' });
+
+    // SharedArrayBuffers are shared with the workers, not copied.
+    const shared = new Int32Array(new SharedArrayBuffer(4));
+    await Promise.all(
+      numbers.slice(0, 10).map(() => pool.run({ type: 'add', shared })));
+    assert.strictEqual(shared[0], 10);
+
+    const buffer = new ArrayBuffer(8);
+    const length =
+      await pool.run({ type: 'length', buffer }, { transferList: [buffer] });
+    assert.strictEqual(length, 8);
+    assert.strictEqual(buffer.byteLength, 0);
+
+    assert.strictEqual(await pool.run({ type: 'limits' }), 64);
+
+    // The task of a worker that exits is rejected, and the worker replaced.
+    await assert.rejects(pool.run({ type: 'exit' }), {
+      code: 'ERR_WORKER_NOT_RUNNING'
+    });
+    assert.strictEqual(await pool.run({ type: 'square', n: 2 }), 4);
+
+    // The same goes for a worker that fails after its script has been loaded.
+    await assert.rejects(pool.run({ type: 'crash' }), {
+      code: 'ERR_WORKER_NOT_RUNNING'
+    });
+    assert.strictEqual(await pool.run({ type: 'square', n: 3 }), 9);
+
+    await assert.rejects(pool.run(() => {}), { name: 'DataCloneError' });
+    assert.throws(() => pool.run(1, { transferList: 1 }), {
+      code: 'ERR_INVALID_ARG_TYPE'
+    });
+
+    const closed = pool.close();
+    await assert.rejects(pool.run({ type: 'square', n: 2 }), {
+      code: 'ERR_WORKER_NOT_RUNNING'
+    });
+    await closed;
+    assert.strictEqual(pool.size, 0);
+  })().then(common.mustCall());
+
+  {
+    // A worker whose script does not export a function fails and is not
+    // replaced, and the tasks are rejected once no worker is left.
+    const pool = new WorkerPool(fixtures.path('empty.js'), { size: 1 });
+    pool.on('error', common.mustCall((err) => {
+      assert.match(err.message, /"default export" argument must be of type/);
+    }));
+    assert.rejects(pool.run(1), {
+      code: 'ERR_WORKER_NOT_RUNNING'
+    }).then(common.mustCall());
+  }
+
+  assert.throws(() => new WorkerPool(__filename, { size: 0 }), {
+    code: 'ERR_OUT_OF_RANGE'
+  });
+  assert.throws(() => new WorkerPool(new URL('http://example.com/')), {
+    code: 'ERR_INVALID_URL_SCHEME'
+  });
+}
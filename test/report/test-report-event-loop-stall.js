@@ -0,0 +1,32 @@
+'use strict';
+// Test producing a report when the event loop is stalled.
+const common = require('../common');
+const assert = require('assert');
+const helper = require('../common/report');
+const tmpdir = require('../common/tmpdir');
+const { monitorEventLoopStalls } = require('perf_hooks');
+
+tmpdir.refresh();
+process.report.directory = tmpdir.path;
+
+const monitor = monitorEventLoopStalls({ threshold: 50, report: true });
+monitor.enable();
+
+const keepAlive = setInterval(() => {}, 1000);
+
+monitor.on('stall', common.mustCall(() => {
+  monitor.disable();
+  clearInterval(keepAlive);
+
+  const reports = helper.findReports(process.pid, tmpdir.path);
+  assert.strictEqual(reports.length, 1);
+  helper.validate(reports[0], [
+    ['header.event', 'Event loop stall'],
+    ['header.trigger', 'EventLoopStall'],
+  ]);
+}));
+
+setTimeout(common.mustCall(() => {
+  const end = Date.now() + 500;
+  while (Date.now() < end);
+}), 10);
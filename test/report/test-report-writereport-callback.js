@@ -0,0 +1,69 @@
+'use strict';
+
+// Test writing a report on the threadpool by passing a callback.
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { Worker } = require('worker_threads');
+const { once } = require('events');
+const helper = require('../common/report');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+process.report.directory = tmpdir.path;
+
+function writeReport(...args) {
+  return new Promise((resolve, reject) => {
+    let returned;
+    const cb = common.mustCall((err, filename) => {
+      if (err) return reject(err);
+      assert.strictEqual(filename, returned);
+      resolve(filename);
+    });
+    returned = process.report.writeReport(...args, cb);
+    assert.strictEqual(typeof returned, 'string');
+  });
+}
+
+(async function() {
+  {
+    // Test with only a callback.
+    const file = await writeReport();
+    helper.validate(path.join(tmpdir.path, file));
+  }
+
+  {
+    // Test with a file and an error argument.
+    const error = new Error();
+    error.foo = 'goo';
+    const file = await writeReport('custom-name-1.json', error);
+    assert.strictEqual(file, 'custom-name-1.json');
+    helper.validate(path.join(tmpdir.path, file),
+                    [['javascriptStack.errorProperties.foo', 'goo']]);
+  }
+
+  {
+    // Test that the reports of Worker threads are still included.
+    const w = new Worker('while (true);', { eval: true });
+    await once(w, 'online');
+    const file = await writeReport('custom-name-2.json');
+    const report = JSON.parse(fs.readFileSync(path.join(tmpdir.path, file)));
+    helper.validateContent(report);
+    assert.strictEqual(report.workers.length, 1);
+    helper.validateContent(report.workers[0]);
+    assert.strictEqual(report.workers[0].header.threadId, w.threadId);
+    await w.terminate();
+  }
+
+  {
+    // Test that errors are passed to the callback.
+    process.report.directory = path.join(tmpdir.path, 'does-not-exist');
+    await assert.rejects(writeReport(), { code: 'ENOENT', syscall: 'open' });
+    process.report.directory = tmpdir.path;
+  }
+
+  assert.throws(() => process.report.writeReport('file', {}, 'foo'), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+})().then(common.mustCall());
@@ -214,6 +214,23 @@ if (common.hasCrypto) { // eslint-disable-line node-core/crypto-check
   testInitialized(new Signal(), 'Signal');
 }
 
+{
+  const { LoopStallWatchdog } = internalBinding('watchdog');
+  testInitialized(new LoopStallWatchdog(1000, false), 'LoopStallWatchdog');
+}
+
+{
+  const { WorkerPoolHandle } = internalBinding('worker');
+  const handle = new WorkerPoolHandle();
+  testInitialized(handle, 'WorkerPoolHandle');
+  handle.close();
+}
+
+{
+  const { ReportWriteWrap } = internalBinding('report');
+  testInitialized(new ReportWriteWrap(), 'ReportWriteWrap');
+}
+
 {
   async function openTest() {
     const fd = await fsPromises.open(__filename, 'r');
@@ -0,0 +1,114 @@
+'use strict';
+
+// This tests that --cpu-prof-continuous writes a pprof profile every
+// --cpu-prof-rotate-interval seconds and before exit.
+
+const common = require('../common');
+common.skipIfInspectorDisabled();
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { spawnSync } = require('child_process');
+
+const tmpdir = require('../common/tmpdir');
+const {
+  getPprofProfiles,
+  getPprofStrings,
+  kCpuProfInterval,
+  env
+} = require('../common/cpu-prof');
+
+// Keep the CPU busy in `fib` for a bit more than two rotations, returning to
+// the event loop regularly so that the profile can be rotated.
+const workload = `
+function fib(n) {
+  if (n === 0 || n === 1) return n;
+  return fib(n - 1) + fib(n - 2);
+}
+let rounds = 0;
+function work() {
+  const start = Date.now();
+  while (Date.now() - start < 500) fib(20);
+  if (++rounds < 5) setTimeout(work, 0);
+}
+work();
+`;
+
+{
+  tmpdir.refresh();
+  const output = spawnSync(process.execPath, [
+    '--cpu-prof-continuous',
+    '--cpu-prof-rotate-interval',
+    '1',
+    '--cpu-prof-interval',
+    kCpuProfInterval,
+    '--cpu-prof-dir',
+    'prof',
+    '-e',
+    workload,
+  ], {
+    cwd: tmpdir.path,
+    env
+  });
+  if (output.status !== 0) {
+    console.log(output.stderr.toString());
+  }
+  assert.strictEqual(output.status, 0);
+  const dir = path.join(tmpdir.path, 'prof');
+  assert(fs.existsSync(dir));
+  const profiles = getPprofProfiles(dir);
+  assert(profiles.length >= 2, `Expected rotated profiles in ${profiles}`);
+  for (const profile of profiles) {
+    assert.match(path.basename(profile), /^CPU\..*\.pb\.gz$/);
+    const strings = getPprofStrings(profile);
+    assert.strictEqual(strings[0], '');
+    assert(strings.includes('cpu'));
+    assert(strings.includes('nanoseconds'));
+  }
+  const found = profiles.some((profile) => {
+    return getPprofStrings(profile).includes('fib');
+  });
+  if (!found) {
+    console.log(output.stderr.toString());
+  }
+  assert(found);
+}
+
+// --cpu-prof-rotate-interval without --cpu-prof-continuous
+{
+  tmpdir.refresh();
+  const output = spawnSync(process.execPath, [
+    '--cpu-prof-rotate-interval',
+    '10',
+    '-e',
+    '',
+  ], {
+    cwd: tmpdir.path,
+    env
+  });
+  assert.strictEqual(output.status, 9);
+  assert.strictEqual(
+    output.stderr.toString().trim(),
+    `${process.execPath}: --cpu-prof-rotate-interval must be used with ` +
+    '--cpu-prof-continuous');
+}
+
+// --cpu-prof-rotate-interval 0
+{
+  tmpdir.refresh();
+  const output = spawnSync(process.execPath, [
+    '--cpu-prof-continuous',
+    '--cpu-prof-rotate-interval',
+    '0',
+    '-e',
+    '',
+  ], {
+    cwd: tmpdir.path,
+    env
+  });
+  assert.strictEqual(output.status, 9);
+  assert.strictEqual(
+    output.stderr.toString().trim(),
+    `${process.execPath}: --cpu-prof-rotate-interval must be greater than 0`);
+}
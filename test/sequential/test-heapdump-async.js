@@ -0,0 +1,98 @@
+'use strict';
+
+const common = require('../common');
+
+if (!common.isMainThread)
+  common.skip('process.chdir is not available in Workers');
+
+const { setFlagsFromString, writeHeapSnapshot } = require('v8');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const zlib = require('zlib');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+process.chdir(tmpdir.path);
+
+// Kept alive so that it shows up in the snapshots.
+const retained = 'y'.repeat(10000) + Math.random();
+
+// Serialization in the background.
+{
+  const filename = writeHeapSnapshot('async.heapsnapshot',
+                                     common.mustSucceed((result) => {
+                                       assert.strictEqual(result, filename);
+                                       const data =
+                                         fs.readFileSync(filename, 'utf8');
+                                       JSON.parse(data);
+                                       assert(data.includes('y'.repeat(1000)));
+                                     }));
+  assert.strictEqual(filename, 'async.heapsnapshot');
+}
+
+// Compressed output, both synchronously and in the background.
+{
+  const filename = writeHeapSnapshot('sync.heapsnapshot.gz',
+                                     { compress: true });
+  JSON.parse(zlib.gunzipSync(fs.readFileSync(filename)));
+
+  writeHeapSnapshot(undefined, { compress: true },
+                    common.mustSucceed((filename) => {
+                      assert.match(filename, /^Heap\..+\.heapsnapshot\.gz$/);
+                      JSON.parse(zlib.gunzipSync(fs.readFileSync(filename)));
+                    }));
+}
+
+// Long strings can be truncated further to speed up the capture.
+{
+  const filename = writeHeapSnapshot('short.heapsnapshot',
+                                     { maxStringLength: 10 });
+  const data = fs.readFileSync(filename, 'utf8');
+  JSON.parse(data);
+  assert(!data.includes('y'.repeat(11)));
+
+  // The limit is restored afterwards.
+  const next = fs.readFileSync(writeHeapSnapshot('next.heapsnapshot'), 'utf8');
+  assert(next.includes('y'.repeat(1000)));
+
+  // Including a limit that was set at runtime.
+  setFlagsFromString('--heap-snapshot-string-limit=20');
+  writeHeapSnapshot('short2.heapsnapshot', { maxStringLength: 10 });
+  const limited =
+    fs.readFileSync(writeHeapSnapshot('limited.heapsnapshot'), 'utf8');
+  assert(limited.includes('y'.repeat(20)));
+  assert(!limited.includes('y'.repeat(21)));
+  setFlagsFromString('--heap-snapshot-string-limit=1024');
+}
+
+// Errors are passed to the callback.
+{
+  const filename = path.join('does-not-exist', 'error.heapsnapshot');
+  writeHeapSnapshot(filename, common.mustCall((err) => {
+    assert.strictEqual(err.code, 'ENOENT');
+    assert.strictEqual(err.syscall, 'open');
+    assert.strictEqual(err.path, filename);
+  }));
+}
+
+[1, 'foo', null].forEach((options) => {
+  assert.throws(() => writeHeapSnapshot('invalid.heapsnapshot', options), {
+    code: 'ERR_INVALID_ARG_TYPE',
+  });
+});
+assert.throws(() => writeHeapSnapshot('invalid.heapsnapshot', {
+  compress: 1
+}), {
+  code: 'ERR_INVALID_ARG_TYPE',
+});
+assert.throws(() => writeHeapSnapshot('invalid.heapsnapshot', {
+  maxStringLength: -1
+}), {
+  code: 'ERR_OUT_OF_RANGE',
+});
+assert.throws(() => writeHeapSnapshot('invalid.heapsnapshot', {}, 'foo'), {
+  code: 'ERR_INVALID_ARG_TYPE',
+});
+
+assert.strictEqual(typeof retained, 'string');
@@ -0,0 +1,50 @@
+'use strict';
+const common = require('../common');
+
+if (common.isWindows)
+  common.skip('test not supported on Windows');
+
+const assert = require('assert');
+
+if (process.argv[2] === 'child') {
+  const fs = require('fs');
+  const { getPprofStrings } = require('../common/cpu-prof');
+
+  assert.strictEqual(process.listenerCount('SIGUSR2'), 1);
+  // The first signal starts the profiler, the second one writes a profile.
+  process.kill(process.pid, 'SIGUSR2');
+
+  const retained = [];
+  (function allocate() {
+    for (let i = 0; i < 100; i++)
+      retained.push(new Array(1000).fill(i));
+    if (retained.length < 1000)
+      return setImmediate(allocate);
+
+    process.kill(process.pid, 'SIGUSR2');
+
+    // Asynchronously wait for the profile.
+    (function validate() {
+      const files = fs.readdirSync(process.cwd());
+
+      if (files.length === 0)
+        return setImmediate(validate);
+
+      assert.strictEqual(files.length, 1);
+      assert.match(files[0], /^Heap\..+\.pb\.gz$/);
+      assert(getPprofStrings(files[0]).includes('allocate'));
+    })();
+  })();
+} else {
+  const { spawnSync } = require('child_process');
+  const tmpdir = require('../common/tmpdir');
+
+  tmpdir.refresh();
+  const args = ['--heapprofile-signal', 'SIGUSR2', __filename, 'child'];
+  const child = spawnSync(process.execPath, args, { cwd: tmpdir.path });
+
+  if (child.status !== 0)
+    console.log(child.stderr.toString());
+  assert.strictEqual(child.status, 0);
+  assert.strictEqual(child.signal, null);
+}
@@ -180,7 +180,12 @@ const customTypesMap = {
 
   'os.constants.dlopen': 'os.html#os_dlopen_constants',
 
+  'EventLoopPhaseMonitor':
+    'perf_hooks.html#perf_hooks_class_eventloopphasemonitor',
+  'EventLoopStallMonitor':
+    'perf_hooks.html#perf_hooks_class_eventloopstallmonitor',
   'Histogram': 'perf_hooks.html#perf_hooks_class_histogram',
+  'HttpRouteMonitor': 'perf_hooks.html#perf_hooks_class_httproutemonitor',
   'IntervalHistogram':
      'perf_hooks.html#perf_hooks_class_intervalhistogram_extends_histogram',
   'RecordableHistogram':